@@ -0,0 +1,101 @@
+#include "benchmark.hpp"
+#include "cointegration_engine.hpp"
+#include <cmath>
+#include <random>
+
+namespace arbitrage {
+
+// One grid step over 512 pairs (after a book update): the SIMD moment pass,
+// which also appends the step to the history ring, against the same moment
+// update as a per-pair scalar loop over an array of structs; plus the cost
+// of the per-tick z-score refresh alone
+ARBITRAGE_BENCHMARK(CointegrationGridStep) {
+    const size_t count = 512;
+    std::mt19937_64 rng(46);
+    std::uniform_real_distribution<double> price(90.0, 110.0);
+    
+    CointegrationConfig config;
+    config.sample_interval = std::chrono::milliseconds(1);
+    CointegrationEngine engine(config);
+    struct Moments {
+        double y, x, n, mean_x, mean_y, var_x, var_y, cov, beta, mean, sd, z;
+    };
+    std::vector<Moments> moments(count);
+    std::vector<TopOfBook> tops;
+    for (size_t i = 0; i < count; ++i) {
+        std::string n = std::to_string(i);
+        engine.addPair("Y" + n, "X" + n);
+        for (const char* leg : {"Y", "X"}) {
+            TopOfBook top;
+            top.instrument_id = leg + n;
+            top.bid_price = price(rng);
+            top.ask_price = top.bid_price * 1.0002;
+            top.bid_volume = top.ask_volume = 1.0;
+            engine.onTopOfBook(top);
+            tops.push_back(top);
+        }
+        moments[i] = Moments();
+        moments[i].y = std::log(0.5 * (tops[2 * i].bid_price + tops[2 * i].ask_price));
+        moments[i].x = std::log(0.5 * (tops[2 * i + 1].bid_price + tops[2 * i + 1].ask_price));
+    }
+    
+    // Each step one book moves between two prices, so the moments never settle
+    auto moveBook = [&tops](size_t step) {
+        TopOfBook& top = tops[step % tops.size()];
+        double factor = (step / tops.size()) % 2 == 0 ? 1.001 : 1.0 / 1.001;
+        top.bid_price *= factor;
+        top.ask_price *= factor;
+        return std::log(0.5 * (top.bid_price + top.ask_price));
+    };
+    
+    Timestamp now = getCurrentTimestamp();
+    size_t step = 0;
+    double vector_ns = bench::measureNs([&]() {
+        moveBook(step);
+        engine.onTopOfBook(tops[step++ % tops.size()]);
+        now += config.sample_interval;
+        engine.sample(now);
+    });
+    
+    const double alpha = config.ewma_alpha;
+    step = 0;
+    double scalar_ns = bench::measureNs([&]() {
+        Moments& moved = moments[(step % tops.size()) / 2];
+        (step % 2 == 0 ? moved.y : moved.x) = moveBook(step);
+        ++step;
+        for (Moments& m : moments) {
+            if (!std::isfinite(m.y) || !std::isfinite(m.x)) {
+                continue;
+            }
+            if (m.n == 0.0) {
+                m.mean_x = m.x;
+                m.mean_y = m.y;
+            }
+            double dx = m.x - m.mean_x, dy = m.y - m.mean_y;
+            m.var_x = (1.0 - alpha) * (m.var_x + alpha * dx * dx);
+            m.var_y = (1.0 - alpha) * (m.var_y + alpha * dy * dy);
+            m.cov = (1.0 - alpha) * (m.cov + alpha * dx * dy);
+            m.mean_x += alpha * dx;
+            m.mean_y += alpha * dy;
+            m.n += 1.0;
+            if (m.n >= config.min_samples && m.var_x > 0.0) {
+                m.beta = m.cov / m.var_x;
+                m.mean = m.mean_y - m.beta * m.mean_x;
+                m.sd = std::sqrt(std::max(m.var_y - m.beta * m.cov, 0.0));
+                m.z = m.sd > 0.0 ? (m.y - m.beta * m.x - m.mean) / m.sd : 0.0;
+            }
+        }
+        bench::doNotOptimize(moments.data());
+    });
+    
+    size_t next = 0;
+    double tick_ns = bench::measureNs([&]() {
+        engine.onTopOfBook(tops[next]);
+        next = (next + 1) % tops.size();
+    });
+    
+    std::printf("%zu pairs: grid step vector %.0f ns, scalar %.0f ns; tick %.1f ns\n",
+                count, vector_ns, scalar_ns, tick_ns);
+}
+
+} // namespace arbitrage
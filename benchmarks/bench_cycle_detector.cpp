@@ -0,0 +1,72 @@
+#include "benchmark.hpp"
+#include "cycle_detector.hpp"
+#include <random>
+
+namespace arbitrage {
+
+// Per-tick cost of incremental cycle search on a universe of 60 assets quoted
+// against USDT, USDC and BTC on three venues (549 books)
+ARBITRAGE_BENCHMARK(CurrencyCycleDetection) {
+    const char* venues[] = {"OKX", "BINANCE", "BYBIT"};
+    const char* quotes[] = {"USDT", "USDC", "BTC"};
+    std::mt19937_64 rng(13);
+    std::uniform_real_distribution<double> base_price(0.5, 500.0);
+    std::normal_distribution<double> noise(0.0, 0.0002);
+    
+    CycleDetectorConfig config;
+    config.max_cycle_length = 3;
+    CurrencyCycleDetector detector(config);
+    std::vector<TopOfBook> books;
+    std::vector<double> fair;
+    auto addBook = [&](const std::string& base, const std::string& quote, const char* venue, double price) {
+        std::string id = base + "/" + quote + "@" + venue;
+        detector.addPair(id, base, quote);
+        TopOfBook top;
+        top.instrument_id = id;
+        top.bid_volume = top.ask_volume = 1.0;
+        books.push_back(top);
+        fair.push_back(price);
+    };
+    for (const char* venue : venues) {
+        addBook("BTC", "USDT", venue, 40000.0);
+        addBook("BTC", "USDC", venue, 40000.0);
+        addBook("USDC", "USDT", venue, 1.0);
+    }
+    for (int asset = 0; asset < 60; ++asset) {
+        double usd = base_price(rng);
+        for (const char* venue : venues) {
+            for (const char* quote : quotes) {
+                addBook("ASSET" + std::to_string(asset), quote, venue,
+                        quote[0] == 'B' ? usd / 40000.0 : usd);
+            }
+        }
+    }
+    
+    Timestamp now = getCurrentTimestamp();
+    std::vector<ArbitrageOpportunity> out;
+    auto tick = [&](size_t i) {
+        double mid = fair[i] * (1.0 + noise(rng));
+        books[i].bid_price = mid * 0.9999;
+        books[i].ask_price = mid * 1.0001;
+        detector.onTopOfBook(books[i], now, out);
+    };
+    for (size_t i = 0; i < books.size(); ++i) {
+        tick(i);
+    }
+    
+    uint64_t paths = detector.getPathCount();
+    uint64_t updates = 0;
+    std::uniform_int_distribution<size_t> pick(0, books.size() - 1);
+    double ns = bench::measureNs([&]() {
+        for (int i = 0; i < 256; ++i) {
+            tick(pick(rng));
+            out.clear();
+        }
+        updates += 256;
+    });
+    std::printf("%zu currencies, %zu books: %.0f ns/update, %.1f paths/update\n",
+                detector.getCurrencyCount(), detector.getPairCount(), ns / 256,
+                static_cast<double>(detector.getPathCount() - paths) / updates);
+}
+
+} // namespace arbitrage
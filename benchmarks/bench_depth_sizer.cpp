@@ -0,0 +1,38 @@
+#include "benchmark.hpp"
+#include "depth_sizer.hpp"
+#include <random>
+
+namespace arbitrage {
+
+// Sizing a spot/perp candidate against two 1000-level books whose edge decays
+// with depth, so the walk visits most levels before the edge fails
+ARBITRAGE_BENCHMARK(DepthSizing) {
+    const size_t depth = 1000;
+    std::mt19937_64 rng(3);
+    std::uniform_real_distribution<double> volume(0.01, 0.5);
+    
+    OrderBook spot, perp;
+    for (size_t level = 0; level < depth; ++level) {
+        spot.asks.emplace_back(40000.0 + 0.5 * level, volume(rng), Timestamp());
+        perp.bids.emplace_back(40200.0 - 0.5 * level, volume(rng), Timestamp());
+    }
+    
+    DepthSizerConfig config;
+    config.max_position_size = 1e12;
+    DepthSizer sizer(config);
+    SizingLeg legs[2];
+    legs[0].book = &spot;
+    legs[0].side = OrderSide::BUY;
+    legs[1].book = &perp;
+    legs[1].side = OrderSide::SELL;
+    
+    SizingResult result;
+    double ns = bench::measureNs([&]() {
+        sizer.size(legs, 2, result);
+        bench::doNotOptimize(result);
+    });
+    std::printf("%zu levels per book: %.0f ns/sizing, %zu segments, size %.2f, profit %.0f\n",
+                depth, ns, sizer.getCurve().size(), result.size, result.profit);
+}
+
+} // namespace arbitrage
@@ -0,0 +1,38 @@
+#include "benchmark.hpp"
+#include "funding_history.hpp"
+#include <random>
+
+namespace arbitrage {
+
+// Cost of recording a print and reading the rolling/EWMA statistics, as done
+// on every funding tick
+ARBITRAGE_BENCHMARK(FundingHistoryRecord) {
+    std::mt19937_64 rng(5);
+    std::normal_distribution<double> noise(0.0001, 0.00005);
+    std::vector<double> rates(4096);
+    for (double& rate : rates) {
+        rate = noise(rng);
+    }
+    
+    FundingHistory history;
+    Timestamp time = Timestamp(std::chrono::hours(1));
+    double ns = bench::measureNs([&]() {
+        for (double rate : rates) {
+            time += std::chrono::hours(8);
+            history.record(time, rate);
+            FundingStats rolling = history.getRollingStats();
+            bench::doNotOptimize(rolling.volatility + history.getEwma());
+        }
+    });
+    std::printf("record + rolling stats: %.2f ns/print (capacity %zu)\n", ns / rates.size(), history.capacity());
+    
+    double query_ns = bench::measureNs([&]() {
+        for (size_t i = 0; i < 1024; ++i) {
+            FundingStats range = history.query(history.getTime(i % 512), history.getTime(512 + i % 512));
+            bench::doNotOptimize(range.mean);
+        }
+    });
+    std::printf("time-range query:       %.2f ns/query\n", query_ns / 1024);
+}
+
+} // namespace arbitrage
@@ -0,0 +1,57 @@
+#include "benchmark.hpp"
+#include "funding_scanner.hpp"
+
+namespace arbitrage {
+
+// Event-driven re-rank cost: a funding print on one of 64 underlyings (three
+// venues each) against a basis tick that cannot move the ranking, and the
+// polling alternative of re-evaluating every underlying on each tick
+ARBITRAGE_BENCHMARK(FundingScannerRerank) {
+    const size_t underlyings = 64;
+    const char* venues[] = {"OKX", "BINANCE", "BYBIT"};
+    FundingRateScanner scanner;
+    std::vector<ArbitrageOpportunity> out;
+    Timestamp now = getCurrentTimestamp();
+    for (size_t i = 0; i < underlyings; ++i) {
+        std::string perp = "PERP" + std::to_string(i);
+        size_t index = scanner.addPerpetual(perp, "U" + std::to_string(i));
+        scanner.onBasis(index, 0.0, 99.95, 100.05, now, out);
+        for (size_t v = 0; v < 3; ++v) {
+            FundingRate funding;
+            funding.instrument_id = perp;
+            funding.exchange_id = venues[v];
+            funding.current_rate = 0.0001 * static_cast<double>(v);
+            scanner.onFundingRate(funding, now, out);
+        }
+    }
+    
+    FundingRate funding;
+    funding.exchange_id = "BYBIT";
+    std::vector<std::string> perps;
+    for (size_t i = 0; i < underlyings; ++i) {
+        perps.push_back("PERP" + std::to_string(i));
+    }
+    size_t step = 0;
+    double print_ns = bench::measureNs([&]() {
+        funding.instrument_id = perps[step % underlyings];
+        funding.current_rate = 0.0002 + 0.00001 * static_cast<double>(step % 5);
+        scanner.onFundingRate(funding, now, out);
+        out.clear();
+        ++step;
+    });
+    double basis_ns = bench::measureNs([&]() {
+        scanner.onBasis(step % underlyings, 0.0001 * static_cast<double>(step % 3), 99.95, 100.05, now, out);
+        ++step;
+    });
+    double poll_ns = bench::measureNs([&]() {
+        for (size_t group = 0; group < underlyings; ++group) {
+            scanner.reevaluate(group, now, out);
+        }
+        out.clear();
+    });
+    
+    std::printf("%zu underlyings x 3 venues: funding print %.1f ns, basis tick %.1f ns, full poll %.1f ns\n",
+                underlyings, print_ns, basis_ns, poll_ns);
+}
+
+} // namespace arbitrage
@@ -0,0 +1,30 @@
+#include "benchmark.hpp"
+#include "latency_budget.hpp"
+
+namespace arbitrage {
+
+// Cost of stamping and checking a three-leg candidate, half of them over
+// budget (each rejection also bumps the monitor's counters)
+ARBITRAGE_BENCHMARK(LatencyBudgetAdmit) {
+    LatencyBudget budget;
+    const Timestamp now = getCurrentTimestamp();
+    ArbitrageOpportunity opportunity;
+    opportunity.leg_exchanges = {Exchange::OKX, Exchange::BINANCE, Exchange::BYBIT};
+    InputTimes legs[3];
+    for (auto& leg : legs) {
+        leg.exchange_time = now - std::chrono::milliseconds(3);
+        leg.receive_time = now - std::chrono::milliseconds(2);
+    }
+    
+    size_t step = 0;
+    uint64_t admitted = 0;
+    double admit_ns = bench::measureNs([&]() {
+        legs[2].receive_time = now - std::chrono::milliseconds((step++ & 1) ? 2 : 20);
+        admitted += budget.admit(opportunity, legs, 3, DetectionStage::SHARD, now);
+    });
+    
+    std::printf("3 legs: admit %.1f ns (%llu admitted, %llu rejected)\n", admit_ns,
+                static_cast<unsigned long long>(admitted), static_cast<unsigned long long>(budget.getRejectedCount()));
+}
+
+} // namespace arbitrage
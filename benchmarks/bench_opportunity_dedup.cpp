@@ -0,0 +1,41 @@
+#include "benchmark.hpp"
+#include "opportunity_dedup.hpp"
+
+namespace arbitrage {
+
+// Cost of classifying a merged opportunity: hashing its legs and one table
+// probe, against 256 live records repeated tick after tick
+ARBITRAGE_BENCHMARK(OpportunityDedupOffer) {
+    const size_t records = 256;
+    std::vector<ArbitrageOpportunity> opportunities(records);
+    Timestamp now = getCurrentTimestamp();
+    for (size_t i = 0; i < records; ++i) {
+        auto& opportunity = opportunities[i];
+        opportunity.type = ArbitrageType::CROSS_SYNTHETIC;
+        opportunity.leg_instruments = {"BTC/USDT_SPOT", "ETH/BTC_SPOT", "ETH-" + std::to_string(i) + "/USDT_SPOT"};
+        opportunity.leg_exchanges = {Exchange::OKX, Exchange::BINANCE, Exchange::BYBIT};
+        opportunity.leg_sides = {OrderSide::BUY, OrderSide::BUY, OrderSide::SELL};
+        opportunity.expected_profit_percentage = 0.001;
+        opportunity.expiry_time = now + std::chrono::seconds(1);
+    }
+    
+    size_t step = 0;
+    double key_ns = bench::measureNs([&]() {
+        bench::doNotOptimize(OpportunityDeduplicator::computeKey(opportunities[step++ % records]));
+    });
+    
+    OpportunityDeduplicator dedup;
+    uint64_t emitted = 0;
+    double offer_ns = bench::measureNs([&]() {
+        // A fresh copy has no key yet, as a detector's report would not
+        ArbitrageOpportunity& opportunity = opportunities[step++ % records];
+        opportunity.opportunity_key = 0;
+        emitted += dedup.offer(opportunity, now) == DedupAction::EMIT;
+    });
+    
+    std::printf("%zu records: key %.1f ns, offer %.1f ns (%llu of %llu offers emitted)\n", records, key_ns,
+                offer_ns, static_cast<unsigned long long>(emitted),
+                static_cast<unsigned long long>(dedup.getEmitCount() + dedup.getUpdateCount()));
+}
+
+} // namespace arbitrage
@@ -0,0 +1,50 @@
+#include "benchmark.hpp"
+#include "opportunity_ranking.hpp"
+#include <algorithm>
+#include <random>
+
+namespace arbitrage {
+
+// Re-score one of 10000 live opportunities and read the top 16: indexed heaps
+// against re-selecting the top 16 from the full score vector
+ARBITRAGE_BENCHMARK(OpportunityRankingUpdate) {
+    const size_t count = 10000;
+    const size_t k = 16;
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> profit(0.0, 1000.0);
+    std::uniform_int_distribution<size_t> pick(0, count - 1);
+    
+    OpportunityRanking ranking(k);
+    std::vector<std::string> ids;
+    std::vector<double> scores;
+    for (size_t i = 0; i < count; ++i) {
+        ids.push_back("OPP" + std::to_string(i));
+        scores.push_back(profit(rng));
+        ArbitrageOpportunity opportunity;
+        opportunity.opportunity_id = ids.back();
+        opportunity.expected_profit = scores.back();
+        ranking.upsert(opportunity);
+    }
+    
+    double indexed_ns = bench::measureNs([&]() {
+        size_t i = pick(rng);
+        ranking.updateScore(ids[i], profit(rng));
+        bench::doNotOptimize(ranking.getTopK().front());
+    });
+    
+    std::vector<size_t> order(count);
+    double resort_ns = bench::measureNs([&]() {
+        scores[pick(rng)] = profit(rng);
+        for (size_t i = 0; i < count; ++i) {
+            order[i] = i;
+        }
+        std::partial_sort(order.begin(), order.begin() + k, order.end(),
+                          [&scores](size_t a, size_t b) { return scores[a] > scores[b]; });
+        bench::doNotOptimize(order.front());
+    });
+    
+    std::printf("%zu opportunities, top %zu: indexed %.0f ns/update, re-select %.0f ns/update\n",
+                count, k, indexed_ns, resort_ns);
+}
+
+} // namespace arbitrage
@@ -0,0 +1,86 @@
+#include "benchmark.hpp"
+#include "option_pricer.hpp"
+#include "implied_vol.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace arbitrage {
+
+namespace {
+
+OptionBatch makeChain(size_t strikes) {
+    std::mt19937_64 rng(3);
+    std::uniform_real_distribution<double> vol(0.4, 1.2);
+    const double expiries[] = {7.0 / 365.0, 30.0 / 365.0, 90.0 / 365.0, 180.0 / 365.0};
+    
+    OptionBatch batch;
+    for (size_t i = 0; i < strikes; ++i) {
+        double strike = 20000.0 + 40000.0 * i / strikes;
+        batch.add(40000.0, strike, expiries[i % 4], vol(rng), 0.05, 0.0, i % 2 == 0);
+    }
+    return batch;
+}
+
+} // namespace
+
+// Full-chain Black-Scholes + Greeks: SIMD batch vs scalar libm reference
+ARBITRAGE_BENCHMARK(BlackScholesChain) {
+    for (size_t strikes : {256, 4096, 65536}) {
+        OptionBatch simd_batch = makeChain(strikes);
+        OptionBatch reference = simd_batch;
+        
+        double simd_ns = bench::measureNs([&]() {
+            BlackScholesPricer::priceBatch(simd_batch);
+            bench::doNotOptimize(simd_batch.price[0]);
+        });
+        double scalar_ns = bench::measureNs([&]() {
+            BlackScholesPricer::priceReference(reference);
+            bench::doNotOptimize(reference.price[0]);
+        });
+        
+        double max_error = 0.0;
+        for (size_t i = 0; i < strikes; ++i) {
+            max_error = std::max(max_error, std::fabs(simd_batch.price[i] - reference.price[i]));
+        }
+        std::printf("%6zu options: simd %8.2f us (%5.2f ns/option), scalar %8.2f us (%5.2f ns/option), "
+                    "speedup %.1fx, max |price diff| %.2e\n",
+                    strikes, simd_ns / 1e3, simd_ns / strikes, scalar_ns / 1e3, scalar_ns / strikes,
+                    scalar_ns / simd_ns, max_error);
+    }
+}
+
+// Full-chain implied vol from quotes: SIMD batch vs one-at-a-time scalar,
+// cold (rational guess) and warm (previous vols) starts
+ARBITRAGE_BENCHMARK(ImpliedVolChain) {
+    for (size_t strikes : {256, 4096, 65536}) {
+        OptionBatch quotes = makeChain(strikes);
+        BlackScholesPricer::priceReference(quotes);
+        quotes.market_price = quotes.price;
+        
+        ImpliedVolSolver solver;
+        OptionBatch batch = quotes;
+        ImpliedVolStats stats;
+        double cold_ns = bench::measureNs([&]() {
+            stats = solver.solve(batch);
+            bench::doNotOptimize(batch.volatility[0]);
+        });
+        double warm_ns = bench::measureNs([&]() {
+            solver.solve(batch, true);
+            bench::doNotOptimize(batch.volatility[0]);
+        });
+        OptionBatch reference = quotes;
+        double scalar_ns = bench::measureNs([&]() {
+            solver.solveReference(reference);
+            bench::doNotOptimize(reference.volatility[0]);
+        });
+        
+        std::printf("%6zu options: simd %6.2f ns/option (warm %6.2f), scalar %7.2f ns/option, speedup %.1fx, "
+                    "avg %.2f / max %u iterations, %lu unconverged\n",
+                    strikes, cold_ns / strikes, warm_ns / strikes, scalar_ns / strikes, scalar_ns / cold_ns,
+                    stats.averageIterations(), stats.max_iterations,
+                    static_cast<unsigned long>(stats.unconverged));
+    }
+}
+
+} // namespace arbitrage
@@ -0,0 +1,27 @@
+#include "benchmark.hpp"
+#include "perpetual_pricer.hpp"
+#include "engine_clock.hpp"
+
+namespace arbitrage {
+
+// Full SoA repricing of every perp, as on a funding update
+ARBITRAGE_BENCHMARK(PerpetualFairValueAll) {
+    for (size_t perps : {100, 1000, 10000}) {
+        PerpetualFairValueEngine engine;
+        Timestamp now = getEngineTimestamp();
+        for (size_t i = 0; i < perps; ++i) {
+            std::string n = std::to_string(i);
+            engine.addPerpetual("PERP" + n, "SPOT" + n);
+            engine.updateSpotPrice("SPOT" + n, 100.0 + i);
+            engine.updatePerpPrice("PERP" + n, 100.5 + i);
+        }
+        
+        double ns = bench::measureNs([&]() {
+            engine.computeAll(now);
+            bench::doNotOptimize(engine.getFairValue(0));
+        });
+        std::printf("%6zu perps: %8.3f us per full pass\n", perps, ns / 1e3);
+    }
+}
+
+} // namespace arbitrage
@@ -0,0 +1,57 @@
+#include "benchmark.hpp"
+#include "synthetic_construction.hpp"
+#include <random>
+
+namespace arbitrage {
+
+namespace {
+
+// count constructions of the given shape over a pool of 1024 instruments
+SyntheticConstructionEngine makeEngine(size_t count, ConstructionShape shape, size_t legs) {
+    std::mt19937 rng(9);
+    std::uniform_int_distribution<int> instrument(0, 1023);
+    
+    SyntheticConstructionEngine engine;
+    for (size_t i = 0; i < count; ++i) {
+        SyntheticDefinition definition;
+        definition.id = "SYN" + std::to_string(i);
+        definition.shape = shape;
+        for (size_t leg = 0; leg < legs; ++leg) {
+            definition.legs.push_back("INST" + std::to_string(instrument(rng)));
+            definition.weights.push_back(leg % 2 == 0 ? 1.0 : -1.0);
+        }
+        engine.add(definition);
+    }
+    for (int i = 0; i < 1024; ++i) {
+        engine.updatePrice("INST" + std::to_string(i), 100.0 + i);
+    }
+    return engine;
+}
+
+} // namespace
+
+// Specialized kernel vs the generic runtime loop for the same constructions
+ARBITRAGE_BENCHMARK(SyntheticConstructionKernels) {
+    const size_t count = 4096;
+    const std::pair<ConstructionShape, size_t> shapes[] = {
+        {ConstructionShape::SPOT_PERP, 2}, {ConstructionShape::BOX, 4}};
+    Timestamp now = getCurrentTimestamp();
+    
+    for (const auto& [shape, legs] : shapes) {
+        SyntheticConstructionEngine specialized = makeEngine(count, shape, legs);
+        SyntheticConstructionEngine generic = makeEngine(count, ConstructionShape::GENERIC, legs);
+        
+        double specialized_ns = bench::measureNs([&]() {
+            specialized.evaluateAll(now);
+            bench::doNotOptimize(specialized.getValue(0));
+        });
+        double generic_ns = bench::measureNs([&]() {
+            generic.evaluateAll(now);
+            bench::doNotOptimize(generic.getValue(0));
+        });
+        std::printf("%-9s x %zu: specialized %5.2f ns/synthetic, generic %5.2f ns/synthetic\n",
+                    constructionShapeToString(shape).c_str(), count, specialized_ns / count, generic_ns / count);
+    }
+}
+
+} // namespace arbitrage
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace arbitrage {
+namespace bench {
+
+// Minimal self-registering micro-benchmark harness; see benchmark_main.cpp
+using BenchmarkFn = std::function<void()>;
+
+inline std::vector<std::pair<std::string, BenchmarkFn>>& registry() {
+    static std::vector<std::pair<std::string, BenchmarkFn>> benchmarks;
+    return benchmarks;
+}
+
+struct Registration {
+    Registration(const char* name, BenchmarkFn fn) {
+        registry().emplace_back(name, std::move(fn));
+    }
+};
+
+// Keep a computed value alive without the optimizer removing the work
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+// Run fn repeatedly for at least min_seconds; returns nanoseconds per call
+template <typename Fn>
+double measureNs(Fn&& fn, double min_seconds = 0.2) {
+    fn();  // warm-up
+    size_t iterations = 1;
+    while (true) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            fn();
+        }
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (elapsed >= min_seconds) {
+            return elapsed * 1e9 / iterations;
+        }
+        iterations *= 2;
+    }
+}
+
+} // namespace bench
+} // namespace arbitrage
+
+#define ARBITRAGE_BENCHMARK(name)                                                       \
+    static void name();                                                                 \
+    static ::arbitrage::bench::Registration name##_registration(#name, name);           \
+    static void name()
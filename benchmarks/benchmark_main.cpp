@@ -0,0 +1,18 @@
+#include "benchmark.hpp"
+#include "simd.hpp"
+#include <cstring>
+
+// Usage: micro_benchmarks [name-substring]
+int main(int argc, char* argv[]) {
+    const char* filter = argc > 1 ? argv[1] : "";
+    std::printf("SIMD: %s (%zu double lanes)\n", arbitrage::simd::kIsaName, arbitrage::simd::kLanes);
+    
+    for (const auto& [name, fn] : arbitrage::bench::registry()) {
+        if (std::strstr(name.c_str(), filter) == nullptr) {
+            continue;
+        }
+        std::printf("\n== %s ==\n", name.c_str());
+        fn();
+    }
+    return 0;
+}
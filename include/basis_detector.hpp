@@ -0,0 +1,95 @@
+#pragma once
+
+#include "types.hpp"
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace arbitrage {
+
+struct BasisDetectorConfig {
+    double min_basis = 0.001;                   // |basis| / fair value needed to report
+    double z_threshold = 3.0;                   // Deviation from the rolling mean, in deviations
+    double z_exit = 1.0;                        // An anomaly ends when |z| falls under this
+    std::chrono::milliseconds time_constant{60000};  // Decay time of the rolling statistics
+    size_t min_samples = 100;                   // Observations before a contract can report
+    std::chrono::milliseconds opportunity_ttl{500};
+};
+
+// BASIS_SPREAD_ARBITRAGE detector: for every perp and dated future the
+// relative basis
+//   basis = (derivative_mid - fair_value) / fair_value
+// (fair value from PerpetualFairValueEngine or FuturesCarryPricer) is
+// compared with its own rolling distribution. The mean and variance are
+// exponentially weighted by elapsed time, alpha = dt / (dt + time_constant),
+// and updated Welford-style, so an update is O(1), a burst of ticks at one
+// timestamp carries no extra weight and nothing is ever recomputed over a
+// window.
+//
+// A contract reports when |basis| clears min_basis and its z-score against
+// the statistics before this observation clears z_threshold. It then stays
+// anomalous, and silent, until |z| drops under z_exit or the basis under
+// min_basis, so one excursion is one opportunity: sell the rich side, buy
+// the cheap one, one unit each at the mids. The shard sizes it on depth with
+// the spot leg weighted to fair value, so the edge it walks for is the
+// deviation from carry, not the carry itself.
+//
+// Per-contract state is SoA and the update touches one lane with no
+// allocation, which keeps it well under the cost of the book update that
+// triggers it. Single-threaded: one detector per strategy shard.
+class BasisSpreadDetector {
+public:
+    explicit BasisSpreadDetector(const BasisDetectorConfig& config = BasisDetectorConfig());
+    
+    // Register a derivative priced off a spot book; returns its index
+    size_t addContract(const InstrumentId& derivative_id, Exchange derivative_exchange,
+                       const InstrumentId& spot_id, Exchange spot_exchange);
+    
+    // New prices for a contract; emits an opportunity when an anomaly starts
+    // and returns true if it did. Non-positive prices are ignored.
+    bool update(size_t index, Price derivative_mid, Price fair_value, Price spot_mid, Timestamp now,
+                std::vector<ArbitrageOpportunity>& out);
+    
+    // Accessors
+    size_t size() const { return derivative_ids_.size(); }
+    bool find(const InstrumentId& derivative_id, size_t& index) const;
+    const InstrumentId& getDerivativeId(size_t index) const { return derivative_ids_[index]; }
+    double getBasis(size_t index) const { return basis_[index]; }
+    double getMean(size_t index) const { return mean_[index]; }
+    double getStdDev(size_t index) const;
+    double getZScore(size_t index) const { return z_score_[index]; }  // Against the prior statistics
+    bool isAnomalous(size_t index) const { return anomalous_[index] != 0; }
+    
+    // Statistics
+    uint64_t getUpdateCount() const { return update_count_; }
+    uint64_t getAnomalyCount() const { return anomaly_count_; }
+
+private:
+    void emit(size_t index, Price derivative_mid, Price fair_value, Price spot_mid, Timestamp now,
+              std::vector<ArbitrageOpportunity>& out);
+    
+    BasisDetectorConfig config_;
+    double time_constant_s_;
+    
+    // Contract metadata
+    std::vector<InstrumentId> derivative_ids_;
+    std::vector<InstrumentId> spot_ids_;
+    std::vector<Exchange> derivative_exchanges_;
+    std::vector<Exchange> spot_exchanges_;
+    std::unordered_map<InstrumentId, size_t> index_;
+    
+    // Per-contract state (SoA)
+    std::vector<double> basis_;
+    std::vector<double> mean_;
+    std::vector<double> variance_;
+    std::vector<double> z_score_;
+    std::vector<Timestamp> last_update_;
+    std::vector<uint32_t> samples_;
+    std::vector<uint8_t> anomalous_;
+    
+    uint64_t update_count_ = 0;
+    uint64_t anomaly_count_ = 0;
+};
+
+} // namespace arbitrage
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "types.hpp"
+#include "timing_wheel.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace arbitrage {
+
+struct CointegrationConfig {
+    std::chrono::milliseconds sample_interval{1000};  // Timestamp grid shared by every pair
+    double ewma_alpha = 0.02;              // Weight of the newest grid sample in the moments
+    size_t min_samples = 50;               // Grid samples before a pair produces z-scores
+    size_t history_length = 512;           // Grid samples kept for the cointegration test
+    std::chrono::milliseconds test_interval{60000};
+    double adf_critical_value = -3.34;     // Engle-Granger 5% critical value, two series
+    double min_correlation = 0.8;          // |EWMA correlation| a pair needs to signal
+    double entry_z = 2.0;                  // Open when |z| reaches this
+    double exit_z = 0.5;                   // Close when |z| falls back under this
+};
+
+// Streaming pairs engine: for every pair (y, x) of log mid prices it keeps
+// exponentially weighted moments updated Welford-style, which give in O(1)
+//   hedge ratio    beta = cov(x, y) / var(x)
+//   spread         s = y - beta * x, mean my - beta * mx,
+//                  variance var(y) - cov(x, y)^2 / var(x)
+//   z-score        (s - mean) / sd
+// without ever revisiting a window.
+//
+// Pairs share one timestamp grid: each grid step updates the moments of
+// every pair in a single SIMD pass over padded SoA columns (unpriced legs
+// and padding are NaN and keep their previous state) and appends the grid
+// row to a ring of history. Between grid steps a book update only refreshes
+// the z-score and signal of the pairs that use it, from the current moments.
+//
+// Engle-Granger tests (OLS hedge ratio over the retained history, then a
+// Dickey-Fuller t-statistic on its residuals) are too expensive for the
+// update path, so every test_interval the history is copied to a background
+// worker and the results are picked up by a later grid step. A pair signals
+// only while its last test passed and its correlation clears min_correlation;
+// signals use entry/exit hysteresis: -1 short the spread, +1 long, 0 flat.
+//
+// Signals are advisory: a spread position has no locked-in edge or expiry,
+// so they go to the signal callback (the engine logs them) rather than into
+// the opportunity stream.
+//
+// All methods except the test worker run on one thread (the opportunity
+// merger); the worker only sees snapshots.
+class CointegrationEngine {
+public:
+    // Pair index, new signal and the z-score that caused it
+    using SignalCallback = std::function<void(size_t pair, int signal, double z_score)>;
+    
+    explicit CointegrationEngine(const CointegrationConfig& config = CointegrationConfig());
+    ~CointegrationEngine();
+    
+    CointegrationEngine(const CointegrationEngine&) = delete;
+    CointegrationEngine& operator=(const CointegrationEngine&) = delete;
+    
+    // Every two spot books quoted in the same currency; returns the number of pairs added
+    size_t addInstruments(const std::vector<Instrument>& instruments);
+    bool addPair(const InstrumentId& y_id, const InstrumentId& x_id);
+    void setSignalCallback(SignalCallback callback);
+    
+    // Background cointegration worker; without it no pair is ever tested
+    void start();
+    void stop();
+    bool isRunning() const { return running_; }
+    
+    // Store a book's mid and refresh the z-scores of its pairs; false if no pair uses it
+    bool onTopOfBook(const TopOfBook& top);
+    
+    // Take a grid sample if now has reached the next grid point, hand the
+    // history to the worker when a test is due and apply finished tests
+    bool sample(Timestamp now);
+    // Call sample() on wheel at every grid point from now on
+    void startSampleTimer(TimingWheel& wheel);
+    
+    // Accessors (NaN while a pair is warming up)
+    size_t size() const { return pairs_.size(); }
+    bool find(const InstrumentId& y_id, const InstrumentId& x_id, size_t& index) const;
+    double getHedgeRatio(size_t index) const { return beta_[index]; }
+    double getSpreadMean(size_t index) const { return spread_mean_[index]; }
+    double getSpreadStdDev(size_t index) const { return spread_sd_[index]; }
+    double getCorrelation(size_t index) const;
+    double getZScore(size_t index) const { return z_score_[index]; }
+    double getTestStatistic(size_t index) const { return test_statistic_[index]; }
+    bool isCointegrated(size_t index) const { return cointegrated_[index] != 0; }
+    int getSignal(size_t index) const { return signal_[index]; }
+    
+    // Statistics
+    uint64_t getSampleCount() const { return sample_count_; }
+    uint64_t getTestsCompleted() const { return tests_completed_; }  // Any thread
+    uint64_t getSignalChanges() const { return signal_changes_; }
+
+private:
+    struct Pair {
+        uint32_t y;     // Book slots
+        uint32_t x;
+    };
+    
+    struct Dependent {
+        uint32_t pair;
+        bool is_y;
+    };
+    
+    uint32_t bookSlot(const InstrumentId& instrument_id);
+    void resizeColumns();
+    void updateSignal(size_t index);
+    void submitTest();
+    void applyTestResults();
+    void workerLoop();
+    
+    CointegrationConfig config_;
+    
+    std::vector<Pair> pairs_;
+    std::vector<double> book_mid_;     // Latest log mid per book (NaN if one-sided)
+    std::unordered_map<InstrumentId, uint32_t> book_slots_;
+    std::vector<std::vector<Dependent>> book_dependents_;
+    std::unordered_map<uint64_t, size_t> pair_index_;  // (y slot, x slot) -> pair
+    SignalCallback signal_callback_;
+    
+    // SoA columns, padded to a whole number of SIMD vectors (NaN padding)
+    std::vector<double> y_;            // Latest log mids
+    std::vector<double> x_;
+    std::vector<double> count_;        // Grid samples taken
+    std::vector<double> mean_x_;       // EWMA moments
+    std::vector<double> mean_y_;
+    std::vector<double> var_x_;
+    std::vector<double> var_y_;
+    std::vector<double> cov_xy_;
+    std::vector<double> beta_;         // Derived at the last grid step
+    std::vector<double> spread_mean_;
+    std::vector<double> spread_sd_;
+    std::vector<double> z_score_;      // Refreshed per tick
+    std::vector<double> test_statistic_;
+    std::vector<uint8_t> cointegrated_;
+    std::vector<int8_t> signal_;
+    std::vector<uint32_t> tradable_pairs_;  // Cointegrated at the last test
+    
+    // Grid history ring, row-major: row r holds every pair's sample r
+    std::vector<double> history_y_;
+    std::vector<double> history_x_;
+    size_t stride_ = 0;                // Padded pair count the ring was laid out for
+    uint64_t rows_ = 0;                // Rows written
+    Timestamp next_sample_{};
+    Timestamp next_test_{};
+    
+    // Worker hand-off: the job is the history in time order, results the
+    // per-pair t-statistic (NaN if too few samples)
+    struct TestJob {
+        std::vector<double> y;
+        std::vector<double> x;
+        size_t rows = 0;
+        size_t pairs = 0;
+        size_t stride = 0;
+    };
+    TestJob job_;
+    bool job_pending_ = false;
+    std::vector<double> results_;
+    std::atomic<bool> results_ready_{false};
+    std::mutex mutex_;
+    std::condition_variable job_ready_;
+    
+    std::atomic<bool> running_{false};
+    std::unique_ptr<std::thread> thread_;
+    std::atomic<uint64_t> tests_completed_{0};
+    uint64_t sample_count_ = 0;
+    uint64_t signal_changes_ = 0;
+};
+
+} // namespace arbitrage
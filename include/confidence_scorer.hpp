@@ -0,0 +1,103 @@
+#pragma once
+
+#include "types.hpp"
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace arbitrage {
+
+struct ConfidenceConfig {
+    double threshold = 0.95;                                  // Minimum accepted confidence
+    std::chrono::milliseconds freshness_half_life{200};       // Age at which a leg's freshness halves
+    size_t depth_levels = 5;                                  // Book levels counted per side
+    double liquidity_threshold = 10000.0;                     // Notional per side for full depth score
+    double spread_alpha = 0.05;                               // EWMA weight of the newest spread
+    double spread_tolerance = 0.5;                            // Spread deviation / mean still counted as steady
+};
+
+// Confidence in a price built from several order books, as the weakest of its
+// legs. A leg's confidence is the product of three features in [0, 1]:
+//   depth      min(bid notional, ask notional) over the top levels / liquidity_threshold
+//   stability  1 / (1 + max(s / m - spread_tolerance, 0)) for the EWMA mean m
+//              and deviation s of the relative spread
+//   freshness  2^(-age / freshness_half_life)
+// Depth and stability change only with the leg's own book, so they are folded
+// into a per-leg static score on every update; scoring then costs one exp()
+// per leg. Legs are checked in order and a candidate is rejected at the first
+// leg below the threshold, using the static score before the exp(), so weak
+// candidates are dropped before any sizing. Single-threaded: one per shard.
+//
+// Calibrated so a healthy book scores near 1 and the threshold keeps its
+// meaning as a product: a deep book whose spread flips between one and two
+// ticks (s / m about 1/3) is fully stable, and with the half-life at 20x
+// the latency budget (as the engine configures it) such a book still scores
+// ~0.97 at the edge of the budget. Only shard reports are scored; candidates
+// built on the merger from published tops keep confidence_score 0.
+class ConfidenceScorer {
+public:
+    explicit ConfidenceScorer(const ConfidenceConfig& config = ConfidenceConfig());
+    
+    // Rescales every leg's static score
+    void setConfig(const ConfidenceConfig& config);
+    
+    // Legs
+    size_t addInstrument(const InstrumentId& instrument_id);
+    bool find(const InstrumentId& instrument_id, size_t& index) const;
+    
+    // Update a leg's features; update_time is when the book was valid
+    void onBookUpdate(size_t index, const OrderBook& book, Timestamp update_time);
+    bool onBookUpdate(const InstrumentId& instrument_id, const OrderBook& book, Timestamp update_time);
+    
+    // Confidence of one leg, or of a set of legs (the weakest); 0 for legs
+    // without a book
+    double getLegScore(size_t index, Timestamp now) const;
+    double score(const size_t* legs, size_t count, Timestamp now) const;
+    
+    // Early-reject check: false as soon as a leg falls below the threshold.
+    // `out` is the full score when accepted, or the failing leg's bound.
+    bool accept(const size_t* legs, size_t count, Timestamp now, double& out);
+    
+    // Score by instrument ids and store the result in confidence_score;
+    // false (rejected) below the threshold or if a leg is unknown
+    bool scoreSynthetic(SyntheticPrice& synthetic, Timestamp now);
+    bool scoreOpportunity(ArbitrageOpportunity& opportunity, Timestamp now);
+    
+    // Features
+    size_t size() const { return instrument_ids_.size(); }
+    double getStaticScore(size_t index) const { return static_score_[index]; }
+    double getDepthNotional(size_t index) const { return depth_notional_[index]; }
+    double getSpreadMean(size_t index) const { return spread_mean_[index]; }
+    double getSpreadVolatility(size_t index) const;
+    const ConfidenceConfig& getConfig() const { return config_; }
+    
+    // Statistics
+    uint64_t getAcceptedCount() const { return accepted_count_; }
+    uint64_t getRejectedCount() const { return rejected_count_; }
+    uint64_t getEarlyRejectCount() const { return early_reject_count_; }  // Rejected without an exp()
+
+private:
+    bool acceptIds(const std::vector<InstrumentId>& legs, Timestamp now, double& out);
+    void refreshStatic(size_t index);
+    
+    ConfidenceConfig config_;
+    double decay_per_ns_;  // ln 2 / half-life
+    
+    std::vector<InstrumentId> instrument_ids_;
+    std::unordered_map<InstrumentId, size_t> instrument_index_;
+    
+    // Per-leg features (SoA)
+    std::vector<int64_t> update_ns_;        // 0 until the first book
+    std::vector<double> depth_notional_;
+    std::vector<double> spread_mean_;
+    std::vector<double> spread_variance_;
+    std::vector<double> static_score_;      // depth * stability
+    std::vector<size_t> scratch_;           // Leg indices for id-based scoring
+    
+    uint64_t accepted_count_ = 0;
+    uint64_t rejected_count_ = 0;
+    uint64_t early_reject_count_ = 0;
+};
+
+} // namespace arbitrage
@@ -22,6 +22,7 @@ public:
     
     // Get specific configuration values
     bool isExchangeEnabled(const std::string& exchange_name) const;
+    // Dated contracts already expired by the engine clock are skipped
     std::vector<Instrument> getEnabledInstruments() const;
     std::vector<std::string> getEnabledExchanges() const;
     
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "types.hpp"
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace arbitrage {
+
+// Multi-producer / single-consumer handoff that bounds book backlog under
+// backpressure. A book update for an instrument that already has an unread
+// book update replaces it in place (keeping its queue position and the first
+// sequence number of the merged run), so a slow consumer sees the current
+// book late rather than every stale book in order. Trades and funding events
+// are never conflated, and a book update never moves ahead of one queued for
+// the same instrument: such an event ends that instrument's conflation run.
+class ConflatingEventQueue {
+public:
+    ConflatingEventQueue() = default;
+    
+    ConflatingEventQueue(const ConflatingEventQueue&) = delete;
+    ConflatingEventQueue& operator=(const ConflatingEventQueue&) = delete;
+    
+    // Returns true if the queue went from empty to non-empty (the consumer
+    // needs a wakeup)
+    bool push(MarketEvent event);
+    
+    // Move all pending events into out in queue order; returns the count
+    size_t drain(std::vector<MarketEvent>& out);
+    
+    size_t size() const;
+    bool empty() const;
+    
+    // Book updates absorbed into an already-queued update
+    uint64_t getConflatedCount() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<MarketEvent> events_;
+    std::unordered_map<InstrumentId, size_t> pending_books_;  // instrument -> index in events_
+    std::atomic<uint64_t> conflated_count_{0};
+};
+
+} // namespace arbitrage
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "quote_normalizer.hpp"
+#include "types.hpp"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace arbitrage {
+
+struct CycleDetectorConfig {
+    size_t max_cycle_length = 4;                    // Edges per cycle (2 = cross-venue round trip)
+    double min_profit = 0.001;                      // Relative edge required to report a cycle
+    double fee_rate = 0.0;                          // Taker fee charged on every leg
+    // Report three-book triangles of raw edges; off when a SpotSpreadScanner
+    // already prices every such triangle
+    bool report_triangles = true;
+    std::chrono::milliseconds opportunity_ttl{500};
+};
+
+// CROSS_SYNTHETIC detector: negative cycles in the currency graph built from
+// every spot book on every venue.
+//
+// Each book base/quote contributes two directed edges, sell base at the bid
+// (base -> quote, weight -log(bid)) and buy base at the ask (quote -> base,
+// weight log(ask)), so a cycle whose weights sum below zero converts a
+// currency back into more of itself. Books for the same pair on different
+// venues are parallel edges; only the cheapest of them can close a best
+// cycle, so the search runs over the per-pair best edge.
+//
+// Rather than Bellman-Ford over the whole graph on every tick, an update
+// re-examines only cycles through the edges it touched: when the best edge
+// of a pair changes, a depth-bounded search looks for simple paths back from
+// its head to its tail. Both edges of a book are checked, so cycles are found
+// in both directions. A cycle can only turn negative when one of its edges
+// changes, so nothing is missed between updates.
+//
+// With a quote normalizer bound, a book quoted in a currency that has a
+// direct conversion book to the normalizer's pivot (BTC/USDC next to
+// USDC/USDT) is re-quoted into the pivot and becomes a parallel edge of the
+// pivot book (BTC/USDT), so cross-quote venues compare directly. Its edges
+// are executable trades through the conversion book: selling BTC/USDC at its
+// bid then the USDC at the conversion bid, or buying the USDC at the
+// conversion ask first, each leg paying its fee. A reported cycle lists the
+// conversion trade as a leg of its own, so it closes in the currency it
+// started in and the conversion book is invalidated and aged like any other
+// leg. The conversion books stay raw edges, and a conversion tick re-prices
+// every book quoted through it. Currencies without a direct book (USD at a
+// fixed rate) are not normalized. max_cycle_length counts graph edges, so a
+// cycle may report up to twice as many legs. Single-threaded: runs on the
+// opportunity merger thread.
+class CurrencyCycleDetector {
+public:
+    explicit CurrencyCycleDetector(const CycleDetectorConfig& config = CycleDetectorConfig());
+    
+    // Normalize cross-quote books through `normalizer` (not owned); must be set
+    // before addInstruments
+    void setQuoteNormalizer(const QuoteNormalizer* normalizer) { normalizer_ = normalizer; }
+    
+    // Register spot books; returns the number of pairs added
+    size_t addInstruments(const std::vector<Instrument>& instruments);
+    bool addPair(const InstrumentId& instrument_id, const std::string& base, const std::string& quote,
+                 Exchange exchange = Exchange::UNKNOWN);
+    
+    // Reprice a book's two edges and search the cycles through them; emits one
+    // CROSS_SYNTHETIC opportunity per profitable cycle and returns the count
+    size_t onTopOfBook(const TopOfBook& top, Timestamp now, std::vector<ArbitrageOpportunity>& out);
+    
+    // Accessors
+    size_t getCurrencyCount() const { return currencies_.size(); }
+    size_t getPairCount() const { return pairs_.size(); }
+    size_t getNormalizedPairCount() const { return normalized_pairs_.size(); }
+    // Best edge weight from one currency to another (+inf if none is priced)
+    double getEdgeWeight(const std::string& from, const std::string& to) const;
+    
+    // Statistics
+    uint64_t getSearchCount() const { return search_count_; }    // Edges searched through
+    uint64_t getPathCount() const { return path_count_; }        // Paths expanded
+    uint64_t getCycleCount() const { return cycle_count_; }      // Profitable cycles found
+
+private:
+    static constexpr uint32_t kNoEdge = UINT32_MAX;
+    static constexpr uint32_t kNoPair = UINT32_MAX;
+    
+    struct Pair {
+        InstrumentId instrument_id;
+        Exchange exchange;
+        uint32_t base;
+        uint32_t quote;
+        uint32_t conversion = kNoPair;       // Conversion book into the pivot, if normalized
+        bool conversion_inverted = false;    // Conversion book is pivot/quote rather than quote/pivot
+        Price raw_bid = 0.0;                 // As quoted; reported as leg prices
+        Price raw_ask = 0.0;
+        Price bid = 0.0;                     // In the edge's quote currency (pivot if normalized)
+        Price ask = 0.0;
+        Volume bid_volume = 0.0;
+        Volume ask_volume = 0.0;
+    };
+    
+    // Outgoing links of a currency: parallel edges to one neighbour and the cheapest
+    struct Link {
+        uint32_t to;
+        uint32_t best = kNoEdge;
+        double weight;  // Of the best edge
+        std::vector<uint32_t> edges;
+    };
+    
+    // Edge 2p sells pair p's base at the bid, edge 2p + 1 buys it at the ask
+    uint32_t edgeFrom(uint32_t edge) const;
+    uint32_t edgeTo(uint32_t edge) const;
+    uint32_t addCurrency(const std::string& currency);
+    size_t reprice(uint32_t index, Timestamp now, std::vector<ArbitrageOpportunity>& out);
+    void expand(const std::vector<uint32_t>& cycle);
+    Link* findLink(uint32_t from, uint32_t to);
+    const Link* findLink(uint32_t from, uint32_t to) const;
+    bool refreshBest(uint32_t from, uint32_t to);
+    void search(uint32_t edge, Timestamp now, std::vector<ArbitrageOpportunity>& out, size_t& found);
+    void extend(uint32_t node, uint32_t target, double weight, Timestamp now,
+                std::vector<ArbitrageOpportunity>& out, size_t& found);
+    bool reported();
+    void emit(double weight, Timestamp now, std::vector<ArbitrageOpportunity>& out);
+    
+    CycleDetectorConfig config_;
+    const QuoteNormalizer* normalizer_ = nullptr;
+    double log_fee_;        // -log(1 - fee_rate), added to every edge
+    double max_weight_;     // Cycles below this weight clear min_profit
+    
+    std::vector<std::string> currencies_;
+    std::unordered_map<std::string, uint32_t> currency_index_;
+    std::vector<std::vector<Link>> links_;
+    std::unordered_map<uint64_t, uint32_t> link_slot_;  // (from, to) -> index in links_[from]
+    
+    std::vector<Pair> pairs_;
+    std::unordered_map<InstrumentId, uint32_t> pair_index_;
+    std::vector<double> weights_;                       // Per edge; +inf until priced
+    std::vector<uint32_t> normalized_pairs_;            // Re-priced on their conversion book's ticks
+    
+    // Search state
+    std::vector<uint32_t> path_;
+    std::vector<uint8_t> on_path_;
+    std::vector<uint32_t> legs_;  // Path expanded into raw book edges
+    
+    uint64_t search_count_ = 0;
+    uint64_t path_count_ = 0;
+    uint64_t cycle_count_ = 0;
+};
+
+} // namespace arbitrage
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "types.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace arbitrage {
+
+// Reverse-dependency index from instruments to the synthetics and detectors
+// that consume them, with dirty-flag batching.
+//
+// Market data only marks nodes dirty (a node marked several times in a batch
+// is queued once); flush() then recomputes each dirty node exactly once, in
+// rank order, so a detector that reads several synthetics runs after all of
+// them. A node's recompute returns true when its output changed, which marks
+// its downstream nodes for the same flush. Single-threaded: one graph per
+// strategy shard.
+class DependencyGraph {
+public:
+    using NodeId = uint32_t;
+    using RecomputeFn = std::function<bool(Timestamp now)>;
+    
+    static constexpr NodeId kInvalidNode = UINT32_MAX;
+    
+    DependencyGraph() = default;
+    
+    DependencyGraph(const DependencyGraph&) = delete;
+    DependencyGraph& operator=(const DependencyGraph&) = delete;
+    
+    // Nodes
+    NodeId addNode(const std::string& name, RecomputeFn recompute);
+    
+    // Node fed by the synthetic's component_instruments
+    NodeId addSynthetic(const SyntheticPrice& synthetic, RecomputeFn recompute);
+    
+    // Edges: instrument -> node, and node -> node. addNodeDependency() returns
+    // false (and adds nothing) if the edge would create a cycle.
+    void addDependency(const InstrumentId& instrument_id, NodeId node);
+    bool addNodeDependency(NodeId upstream, NodeId downstream);
+    
+    // Mark every consumer of an instrument; returns the number newly queued
+    size_t markInstrumentDirty(const InstrumentId& instrument_id);
+    bool markDirty(NodeId node);
+    
+    // Recompute dirty nodes once each, upstream first; returns the count
+    size_t flush(Timestamp now);
+    
+    // Accessors
+    size_t size() const { return nodes_.size(); }
+    bool hasPending() const { return pending_ > 0; }
+    bool isDirty(NodeId node) const { return nodes_[node].dirty; }
+    const std::string& getNodeName(NodeId node) const { return nodes_[node].name; }
+    uint32_t getRank(NodeId node) const { return nodes_[node].rank; }
+    const std::vector<NodeId>& getDependents(const InstrumentId& instrument_id) const;
+    
+    // Statistics
+    uint64_t getMarkCount() const { return mark_count_; }            // Nodes queued
+    uint64_t getCoalescedCount() const { return coalesced_count_; }  // Marks absorbed by an already dirty node
+    uint64_t getRecomputeCount() const { return recompute_count_; }
+    uint64_t getFlushCount() const { return flush_count_; }
+
+private:
+    struct Node {
+        std::string name;
+        RecomputeFn recompute;
+        std::vector<NodeId> downstream;
+        uint32_t rank = 0;  // 1 + highest upstream rank
+        bool dirty = false;
+    };
+    
+    bool reaches(NodeId from, NodeId to) const;
+    void raiseRank(NodeId node, uint32_t rank);
+    
+    std::vector<Node> nodes_;
+    std::unordered_map<InstrumentId, std::vector<NodeId>> dependents_;
+    
+    // Dirty queue bucketed by rank
+    std::vector<std::vector<NodeId>> dirty_by_rank_;
+    size_t pending_ = 0;
+    
+    uint64_t mark_count_ = 0;
+    uint64_t coalesced_count_ = 0;
+    uint64_t recompute_count_ = 0;
+    uint64_t flush_count_ = 0;
+};
+
+} // namespace arbitrage
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "types.hpp"
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace arbitrage {
+
+struct DepthSizerConfig {
+    double min_profit = 0.001;          // Marginal edge (profit / cost) the last unit must clear
+    double max_position_size = 10000.0; // Cap on the cost of the buy legs
+    size_t max_curve_points = 256;      // Curve segments kept per sizing
+};
+
+// One leg of a candidate: trades ratio * size on its book, buying through the
+// asks or selling into the bids. weight converts the leg's price into the
+// currency profit is measured in (1 when every leg shares a quote currency).
+struct SizingLeg {
+    const OrderBook* book = nullptr;
+    OrderSide side = OrderSide::BUY;
+    double ratio = 1.0;
+    double weight = 1.0;
+};
+
+// Profit-vs-size curve, one point per end of a segment with constant
+// marginal prices; cumulative values at that size
+struct SizingPoint {
+    double size;
+    double cost;            // Spent on the buy legs
+    double profit;
+    double marginal_edge;   // Edge of the segment ending here
+};
+
+struct SizingResult {
+    double size = 0.0;
+    double cost = 0.0;
+    double profit = 0.0;
+    bool capped = false;    // Stopped by max_position_size rather than depth or edge
+};
+
+// Depth-aware sizing: walks the opposing books of all legs together. Between
+// two consecutive level boundaries (of any leg) every leg trades at a fixed
+// price, so marginal profit per unit size is constant; the walk advances to
+// the nearest boundary, accumulates profit and cost, and stops at the first
+// segment whose marginal edge falls below min_profit (books only get worse,
+// so later segments cannot recover), when a book runs out, or where the cost
+// reaches max_position_size (inside the segment). Levels are visited once in
+// price order, O(total levels). Leg cursors are fixed-size and the curve
+// buffer is reserved up front, so sizing never allocates. Single-threaded:
+// one per shard.
+//
+// Only candidates built on a shard's own books are sized here. Cross-shard
+// candidates (currency cycles, spot spread triangles) are built on the
+// merger, which sees only the published top of each book, so their
+// detectors size them to the top level; funding reports carry no price edge
+// to walk and stay unsized.
+class DepthSizer {
+public:
+    static constexpr size_t kMaxLegs = 8;
+    
+    explicit DepthSizer(const DepthSizerConfig& config = DepthSizerConfig());
+    
+    void setConfig(const DepthSizerConfig& config);
+    const DepthSizerConfig& getConfig() const { return config_; }
+    
+    // Largest size whose last unit still clears min_profit; false (empty
+    // result) if not even the first unit does or the legs are unusable
+    bool size(const SizingLeg* legs, size_t count, SizingResult& result);
+    
+    // Curve of the last size() call
+    const std::vector<SizingPoint>& getCurve() const { return curve_; }
+    
+    // Average price each leg filled at in the last size() call
+    double getAveragePrice(size_t leg) const;
+    
+    // Size an opportunity on the given books (one per leg, in leg order).
+    // Leg ratios come from its current leg_volumes (1:1 if unset), leg
+    // weights from `weights` (all 1 if null), e.g. carry fair value over spot
+    // for the spot leg of a basis trade, so the edge is measured against
+    // fair value rather than the raw price gap. Rewrites leg_volumes,
+    // leg_prices (average fill), expected_profit and
+    // expected_profit_percentage. False (opportunity unchanged) if no size
+    // clears min_profit.
+    bool sizeOpportunity(ArbitrageOpportunity& opportunity, const OrderBook* const* books,
+                         const double* weights = nullptr);
+
+private:
+    struct Cursor {
+        size_t level;
+        double filled;      // At the current level, in leg units
+        double volume;      // Total, in leg units
+        double notional;
+    };
+    
+    DepthSizerConfig config_;
+    std::array<Cursor, kMaxLegs> cursors_;
+    std::array<SizingLeg, kMaxLegs> legs_;
+    std::vector<SizingPoint> curve_;
+};
+
+} // namespace arbitrage
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "types.hpp"
+#include <atomic>
+#include <cstdint>
+
+namespace arbitrage {
+
+// Time source for the strategy pipeline. Production reads the system clock;
+// replay switches to a simulated clock that only moves when advanceTo() is
+// called, so timers, staleness checks and expiries are driven by recorded
+// event times and a replay is reproducible run to run. Wall-clock concerns
+// (logging, CPU/memory sampling) keep using getCurrentTimestamp().
+class EngineClock {
+public:
+    static EngineClock& getInstance();
+    
+    Timestamp now() const {
+        if (simulated_.load(std::memory_order_relaxed)) {
+            return Timestamp(Timestamp::duration(sim_time_ns_.load(std::memory_order_relaxed)));
+        }
+        return getCurrentTimestamp();
+    }
+    
+    // Switch to simulated time starting at start_time
+    void useSimulatedTime(Timestamp start_time);
+    void useRealTime();
+    
+    // Move simulated time forward; earlier times are ignored
+    void advanceTo(Timestamp time);
+    
+    bool isSimulated() const { return simulated_.load(std::memory_order_relaxed); }
+
+private:
+    EngineClock() = default;
+    EngineClock(const EngineClock&) = delete;
+    EngineClock& operator=(const EngineClock&) = delete;
+    
+    std::atomic<bool> simulated_{false};
+    std::atomic<int64_t> sim_time_ns_{0};
+};
+
+// Shorthand for EngineClock::getInstance().now()
+inline Timestamp getEngineTimestamp() {
+    return EngineClock::getInstance().now();
+}
+
+} // namespace arbitrage
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace arbitrage {
+
+// epoll-based event loop. Timers are timerfds, cross-thread wakeups are
+// eventfds and signals arrive through a signalfd, so the owning thread sleeps
+// in the kernel until there is work and reacts to it immediately instead of
+// polling on a fixed sleep interval.
+class EventLoop {
+public:
+    using Callback = std::function<void()>;
+    using SignalCallback = std::function<void(int)>;
+    using SourceId = uint64_t;  // 0 means "invalid"
+    
+    EventLoop();
+    ~EventLoop();
+    
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+    
+    // Timers (CLOCK_MONOTONIC). A zero interval makes the timer one-shot.
+    SourceId addTimer(std::chrono::nanoseconds initial_delay,
+                      std::chrono::nanoseconds interval, Callback callback);
+    bool rearmTimer(SourceId timer_id, std::chrono::nanoseconds initial_delay,
+                    std::chrono::nanoseconds interval);
+    // Stop a timer from firing until it is re-armed
+    bool disarmTimer(SourceId timer_id);
+    
+    // Wakeups; notify() may be called from any thread
+    SourceId addWakeup(Callback callback);
+    void notify(SourceId wakeup_id);
+    
+    // Signals must already be blocked in every thread (see blockSignals)
+    SourceId addSignalHandler(const std::vector<int>& signals, SignalCallback callback);
+    static bool blockSignals(const std::vector<int>& signals);
+    
+    // Remove any timer, wakeup or signal source
+    bool remove(SourceId source_id);
+    
+    // Dispatch until stop() is called
+    void run();
+    
+    // Wait at most timeout_ms (-1 = forever) and dispatch ready sources
+    size_t runOnce(int timeout_ms);
+    
+    // Thread-safe; run() returns after the current dispatch round. A stopped
+    // loop stays stopped (a stop issued before run() is not lost).
+    void stop();
+    
+    bool isValid() const { return epoll_fd_ >= 0 && stop_fd_ >= 0; }
+    bool isStopRequested() const { return stop_requested_; }
+
+private:
+    enum class SourceType { TIMER, WAKEUP, SIGNAL };
+    
+    struct Source {
+        SourceType type;
+        int fd;
+        bool active;
+        Callback callback;
+        SignalCallback signal_callback;
+    };
+    
+    SourceId addSource(SourceType type, int fd, Callback callback, SignalCallback signal_callback);
+    void dispatch(Source& source);
+    
+    int epoll_fd_{-1};
+    int stop_fd_{-1};
+    SourceId next_id_{1};
+    std::unordered_map<SourceId, Source> sources_;
+    std::unordered_map<SourceId, int> wakeup_fds_;  // read-only once running
+    std::vector<SourceId> pending_removal_;
+    std::atomic<bool> stop_requested_{false};
+};
+
+} // namespace arbitrage
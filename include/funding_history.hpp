@@ -0,0 +1,121 @@
+#pragma once
+
+#include "types.hpp"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace arbitrage {
+
+struct FundingHistoryConfig {
+    size_t capacity = 1024;      // Prints retained per series (rounded up to a power of two)
+    size_t rolling_window = 21;  // Prints in the rolling mean/volatility (7 days of 8h funding)
+    double ewma_alpha = 0.1;     // Weight of the newest print
+};
+
+// Summary of a run of funding prints
+struct FundingStats {
+    size_t count = 0;
+    double sum = 0.0;         // Cumulative rate over the run
+    double mean = 0.0;
+    double volatility = 0.0;  // Sample standard deviation (0 with fewer than two prints)
+};
+
+// Fixed-capacity funding history of one perpetual on one venue.
+//
+// Prints are keyed by funding time: a venue streams the rate for the upcoming
+// settlement many times before it settles, so a print for the newest funding
+// time replaces it in place and a later funding time appends. Every slot keeps
+// the running sums of all earlier prints (offset by the first rate to limit
+// cancellation), which makes the rolling window and any retained time range a
+// difference of two prefixes: recording is O(1), rolling and EWMA statistics
+// are O(1) to read and a range query is a binary search plus O(1).
+class FundingHistory {
+public:
+    explicit FundingHistory(const FundingHistoryConfig& config = FundingHistoryConfig());
+    
+    // Returns false (and records nothing) for a print older than the newest
+    bool record(Timestamp funding_time, double rate);
+    
+    // Rolling window, EWMA and latest print
+    FundingStats getRollingStats() const;
+    double getEwma() const { return ewma_; }
+    double getEwmaVolatility() const;
+    double getLatestRate() const;
+    Timestamp getLatestTime() const;
+    
+    // Prints with funding time in [from, to] that are still retained
+    FundingStats query(Timestamp from, Timestamp to) const;
+    
+    // Accessors; index 0 is the oldest retained print
+    size_t size() const { return static_cast<size_t>(total_ < capacity() ? total_ : capacity()); }
+    size_t capacity() const { return rates_.size(); }
+    bool empty() const { return total_ == 0; }
+    double getRate(size_t index) const { return rates_[slot(oldest() + index)]; }
+    Timestamp getTime(size_t index) const;
+    uint64_t getTotalRecorded() const { return total_; }
+
+private:
+    size_t slot(uint64_t sequence) const { return static_cast<size_t>(sequence) & mask_; }
+    uint64_t oldest() const { return total_ - size(); }
+    // Statistics of the retained sequences [first, last)
+    FundingStats summarize(uint64_t first, uint64_t last) const;
+    void updateEwma(double rate);
+    
+    size_t mask_;
+    size_t rolling_window_;
+    double alpha_;
+    
+    // Ring columns
+    std::vector<int64_t> times_;         // Funding time, ns since epoch
+    std::vector<double> rates_;
+    std::vector<double> prefix_sum_;     // Offset sums of all earlier prints
+    std::vector<double> prefix_square_;
+    
+    uint64_t total_ = 0;
+    double reference_ = 0.0;  // First rate; all sums are offset by it
+    double running_sum_ = 0.0;
+    double running_square_ = 0.0;
+    
+    // EWMA with the state before the newest print, so a replacement can redo it
+    double ewma_ = 0.0;
+    double ewma_variance_ = 0.0;
+    double previous_ewma_ = 0.0;
+    double previous_variance_ = 0.0;
+};
+
+// Funding histories of every perpetual and venue seen by a shard. A perp
+// listed on several venues shares its instrument id, so series are keyed by
+// (instrument, exchange). Single-threaded: one store per strategy shard.
+class FundingHistoryStore {
+public:
+    explicit FundingHistoryStore(const FundingHistoryConfig& config = FundingHistoryConfig());
+    
+    // Record a funding event (by funding_time, or timestamp when unset);
+    // creates the series on first sight. Returns false for stale prints.
+    bool record(const FundingRate& funding);
+    
+    // Lookup
+    bool find(const InstrumentId& instrument_id, const ExchangeId& exchange_id, size_t& index) const;
+    const FundingHistory* get(const InstrumentId& instrument_id, const ExchangeId& exchange_id) const;
+    
+    // Series of an instrument across venues (empty if unseen)
+    const std::vector<size_t>& getVenueSeries(const InstrumentId& instrument_id) const;
+    
+    // Accessors
+    size_t size() const { return series_.size(); }
+    const FundingHistory& getSeries(size_t index) const { return series_[index]; }
+    const InstrumentId& getInstrumentId(size_t index) const { return instrument_ids_[index]; }
+    const ExchangeId& getExchangeId(size_t index) const { return exchange_ids_[index]; }
+    uint64_t getStaleCount() const { return stale_count_; }
+
+private:
+    FundingHistoryConfig config_;
+    std::vector<FundingHistory> series_;
+    std::vector<InstrumentId> instrument_ids_;
+    std::vector<ExchangeId> exchange_ids_;
+    std::unordered_map<InstrumentId, std::vector<size_t>> by_instrument_;
+    uint64_t stale_count_ = 0;
+};
+
+} // namespace arbitrage
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "types.hpp"
+#include "funding_history.hpp"
+#include "timing_wheel.hpp"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace arbitrage {
+
+struct FundingScannerConfig {
+    double min_rate_spread = 0.0001;                // Net funding spread per window needed to report
+    double volatility_penalty = 0.5;                // EWMA volatilities of the spread held back from the edge
+    std::chrono::milliseconds lead_time{60000};     // Re-evaluate this long before each venue's snapshot
+    std::chrono::milliseconds opportunity_ttl{1000};
+};
+
+// FUNDING_RATE_ARBITRAGE scanner: for every underlying, the perps listed on
+// OKX, Binance and Bybit are compared venue against venue. Going long on
+// venue a and short on venue b earns, per funding window,
+//   edge = (expected_b - expected_a) - penalty * sqrt(var_a + var_b)
+//          - max(0, basis_a - basis_b) - spread_a - spread_b
+// With a funding history attached, a venue's expected rate is the EWMA of
+// its prints and var its EWMA variance, so one spiking print does not open
+// a spread the venue has never paid; without one (or before the venue's
+// first recorded print) it is the current rate with no variance. The basis
+// term is what entering a rich perp against a cheap one costs (zero when
+// both legs are the same contract) and spread is a leg's (ask - bid) / mid,
+// the cost of crossing its book. Pairs whose predicted rates reverse the
+// spread for the next window are skipped.
+//
+// Nothing polls: an underlying is re-ranked only when one of its venues
+// prints a funding rate, the basis of one of its perps moves (and only
+// when it has more than one perp, since otherwise the basis cannot change
+// the ranking) or a perp's quoted spread widens or narrows. With snapshot timers attached, every venue print also
+// schedules a re-evaluation lead_time before that venue's next funding time
+// on the shard's timing wheel, so an open spread is reported again while
+// there is still time to put it on.
+//
+// An underlying reports when its best pair clears min_rate_spread, again
+// when the best pair changes, and at each pre-snapshot re-evaluation (as a
+// reannounce, so downstream dedup publishes it again); a re-rank that leaves
+// the same pair open is silent. A pair is only considered once both perps
+// have a quote: the long leg is priced at its ask, the short leg at its bid.
+// Single-threaded: one scanner per strategy shard (perps of an underlying
+// share a shard).
+class FundingRateScanner {
+public:
+    // Called with an underlying's group when one of its venues nears a snapshot
+    using ReevaluateCallback = std::function<void(size_t group)>;
+    
+    explicit FundingRateScanner(const FundingScannerConfig& config = FundingScannerConfig());
+    
+    // Register a perp under its underlying; returns the perp's index
+    size_t addPerpetual(const InstrumentId& perp_id, const std::string& underlying);
+    
+    // Register every perpetual swap, grouped by base asset; returns the
+    // number of perps registered
+    size_t addInstruments(const std::vector<Instrument>& instruments);
+    
+    // Schedule pre-snapshot re-evaluations on wheel from now on
+    void setSnapshotTimers(TimingWheel& wheel, ReevaluateCallback callback);
+    
+    // Price expected funding from history (which must record every print
+    // before it reaches onFundingRate, as the strategy shard does)
+    void setFundingHistory(const FundingHistoryStore& history) { history_ = &history; }
+    
+    // A venue's funding print: records it (creating the venue on first
+    // sight), reschedules its snapshot timer and re-ranks the underlying.
+    // Returns true if an opportunity was emitted; unknown perps are ignored.
+    bool onFundingRate(const FundingRate& funding, Timestamp now, std::vector<ArbitrageOpportunity>& out);
+    
+    // A perp's relative basis and quote moved; re-ranks only if that can
+    // change its underlying's best pair (the basis moved with a second perp
+    // listed, the quoted spread changed or the perp was unquoted until now)
+    bool onBasis(size_t perp, double basis, Price perp_bid, Price perp_ask, Timestamp now,
+                 std::vector<ArbitrageOpportunity>& out);
+    
+    // Pre-snapshot re-evaluation: re-ranks and reports an open spread again
+    bool reevaluate(size_t group, Timestamp now, std::vector<ArbitrageOpportunity>& out);
+    
+    // Accessors
+    size_t size() const { return perp_ids_.size(); }
+    size_t getGroupCount() const { return underlyings_.size(); }
+    size_t getVenueCount() const { return venue_exchanges_.size(); }
+    bool findPerpetual(const InstrumentId& perp_id, size_t& index) const;
+    bool findGroup(const std::string& underlying, size_t& group) const;
+    const InstrumentId& getPerpetualId(size_t index) const { return perp_ids_[index]; }
+    size_t getGroup(size_t perp) const { return perp_groups_[perp]; }
+    const std::string& getUnderlying(size_t group) const { return underlyings_[group]; }
+    
+    // Best pair of an underlying; edge is -infinity until two venues printed
+    double getBestEdge(size_t group) const { return best_edge_[group]; }
+    const ExchangeId& getLongVenue(size_t group) const;
+    const ExchangeId& getShortVenue(size_t group) const;
+    bool isOpen(size_t group) const { return open_[group] != 0; }
+    
+    // Underlyings by best edge, best first
+    const std::vector<size_t>& getRanking() const { return ranking_; }
+    
+    // Statistics
+    uint64_t getEvaluationCount() const { return evaluation_count_; }
+    uint64_t getReportCount() const { return report_count_; }
+
+private:
+    static constexpr size_t kNone = std::numeric_limits<size_t>::max();
+    
+    size_t findOrAddVenue(size_t perp, const ExchangeId& exchange_id);
+    void scheduleSnapshot(size_t venue);
+    // Expected rate of a venue's next window and its variance
+    double expectedRate(size_t venue, double& variance) const;
+    bool evaluate(size_t group, Timestamp now, bool snapshot, std::vector<ArbitrageOpportunity>& out);
+    void rerank(size_t group);
+    void emit(size_t group, Timestamp now, bool snapshot, std::vector<ArbitrageOpportunity>& out);
+    
+    FundingScannerConfig config_;
+    TimingWheel* wheel_ = nullptr;
+    ReevaluateCallback reevaluate_callback_;
+    const FundingHistoryStore* history_ = nullptr;
+    
+    // Per-perp state
+    std::vector<InstrumentId> perp_ids_;
+    std::vector<size_t> perp_groups_;
+    std::vector<double> basis_;
+    std::vector<Price> perp_bid_;   // 0 until the first quote
+    std::vector<Price> perp_ask_;
+    std::unordered_map<InstrumentId, size_t> perp_index_;
+    
+    // Per-venue state (one entry per perp and exchange, SoA)
+    std::vector<size_t> venue_perps_;
+    std::vector<ExchangeId> venue_exchanges_;
+    std::vector<double> current_rate_;
+    std::vector<double> predicted_rate_;
+    std::vector<Timestamp> next_funding_time_;
+    std::vector<TimingWheel::TimerHandle> snapshot_timers_;
+    std::vector<size_t> venue_series_;  // Index in history_, kNone until recorded
+    
+    // Per-underlying state
+    std::vector<std::string> underlyings_;
+    std::vector<std::vector<size_t>> group_perps_;
+    std::vector<std::vector<size_t>> group_venues_;
+    std::vector<double> best_edge_;
+    std::vector<size_t> best_long_;   // Venue entries, kNone without a pair
+    std::vector<size_t> best_short_;
+    std::vector<uint8_t> open_;
+    std::unordered_map<std::string, size_t> group_index_;
+    std::vector<size_t> ranking_;
+    
+    // Scratch for evaluate: expected rate and variance per venue of the group
+    std::vector<double> expected_;
+    std::vector<double> variance_;
+    
+    uint64_t evaluation_count_ = 0;
+    uint64_t report_count_ = 0;
+};
+
+} // namespace arbitrage
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "types.hpp"
+#include "timing_wheel.hpp"
+#include "dependency_graph.hpp"
+#include <chrono>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace arbitrage {
+
+// Cost-of-carry fair value for dated futures:
+//   fair_value   = spot_mid * exp(rate * T) = spot_mid / discount_factor
+//   basis_spread = future_mid - fair_value
+// with T the year fraction to expiry and rate the annual carry rate of the
+// contract's rate key (its quote asset by default).
+//
+// T and the discount factor live in a per-contract expiry table that is only
+// refreshed on a coarse timer (they drift by microseconds per tick). A spot or
+// rate change marks just its dependent contracts dirty and reprice() touches
+// only those, so the cost of a tick scales with the inputs that changed rather
+// than with the length of the curve. Single-threaded: one pricer per shard.
+class FuturesCarryPricer {
+public:
+    // Called with a contract's index each time its basis changes (a reprice
+    // or a futures book tick)
+    using BasisCallback = std::function<void(size_t index)>;
+    
+    explicit FuturesCarryPricer(std::chrono::milliseconds refresh_interval = std::chrono::seconds(1));
+    
+    // Register a contract; returns its index
+    size_t addFuture(const InstrumentId& future_id, const InstrumentId& spot_id,
+                     const std::string& rate_key, Timestamp expiry_time, Timestamp now);
+    
+    // Pair every dated future with the spot of the same base/quote, preferring
+    // the future's own exchange; returns the number of contracts registered
+    size_t addInstruments(const std::vector<Instrument>& instruments, Timestamp now);
+    
+    void setBasisCallback(BasisCallback callback);
+    
+    // Inputs; mark dependent contracts dirty
+    void setRate(const std::string& rate_key, double annual_rate);
+    void updateSpotPrice(const InstrumentId& spot_id, Price mid);
+    void updateFuturePrice(const InstrumentId& future_id, Price mid);
+    
+    // Reprice dirty contracts only; returns how many were repriced
+    size_t reprice(Timestamp now);
+    
+    // Recompute time-to-expiry and discount factors for the whole table,
+    // then reprice everything (the only full pass)
+    void refreshExpiryTable(Timestamp now);
+    
+    // Refresh the table every refresh interval on the given wheel; the pricer
+    // must outlive the wheel (both belong to the same shard)
+    void startRefreshTimer(TimingWheel& wheel);
+    
+    // Register a single graph node fed by every spot and future book. From
+    // then on book updates only record inputs and the graph runs reprice()
+    // once per event batch; the node reports a change when any fair value or
+    // basis moved. Returns the node.
+    DependencyGraph::NodeId registerDependencies(DependencyGraph& graph);
+    
+    // Apply a shard event and reprice what it affects; returns true if any
+    // fair value was recomputed
+    bool onMarketEvent(const MarketEvent& event, Timestamp now);
+    
+    // Fills fair_value/basis_spread; false if unknown or inputs missing
+    bool getSyntheticPrice(const InstrumentId& future_id, SyntheticPrice& out) const;
+    
+    // Accessors
+    size_t size() const { return future_ids_.size(); }
+    bool findFuture(const InstrumentId& future_id, size_t& index) const;
+    const InstrumentId& getFutureId(size_t index) const { return future_ids_[index]; }
+    const InstrumentId& getSpotId(size_t index) const { return spot_ids_[index]; }
+    Price getFuturePrice(size_t index) const { return future_mid_[index]; }
+    Price getSpotPrice(size_t index) const { return spot_mid_[index]; }
+    Price getFairValue(size_t index) const { return fair_value_[index]; }
+    Price getBasisSpread(size_t index) const { return basis_spread_[index]; }
+    double getTimeToExpiry(size_t index) const { return time_to_expiry_[index]; }
+    double getDiscountFactor(size_t index) const { return discount_factor_[index]; }
+    
+    // Annualized carry implied by the market price: ln(future / spot) / T
+    double getImpliedCarry(size_t index) const;
+    
+    uint64_t getRepriceCount() const { return reprice_count_; }
+    uint64_t getRefreshCount() const { return refresh_count_; }
+
+private:
+    void markDirty(size_t index);
+    void refreshContract(size_t index, Timestamp now);
+    void priceContract(size_t index, Timestamp now);
+    
+    std::chrono::milliseconds refresh_interval_;
+    BasisCallback basis_callback_;
+    
+    // Contract metadata
+    std::vector<InstrumentId> future_ids_;
+    std::vector<InstrumentId> spot_ids_;
+    std::vector<size_t> rate_slot_;
+    std::vector<Timestamp> expiry_time_;
+    std::vector<Timestamp> calculation_time_;
+    std::unordered_map<InstrumentId, size_t> future_index_;
+    std::unordered_map<InstrumentId, std::vector<size_t>> spot_dependents_;
+    
+    // Rate keys -> slot; each slot lists the contracts that carry at that rate
+    std::unordered_map<std::string, size_t> rate_slots_;
+    std::vector<double> rates_;
+    std::vector<std::vector<size_t>> rate_dependents_;
+    
+    // Expiry table (coarse refresh) and prices
+    std::vector<double> time_to_expiry_;   // Years
+    std::vector<double> discount_factor_;  // exp(-rate * T)
+    std::vector<double> spot_mid_;
+    std::vector<double> future_mid_;
+    std::vector<double> fair_value_;
+    std::vector<double> basis_spread_;
+    
+    // Dirty-set batching
+    std::vector<uint8_t> dirty_;
+    std::vector<size_t> dirty_list_;
+    DependencyGraph::NodeId graph_node_ = DependencyGraph::kInvalidNode;
+    bool basis_moved_ = false;  // A future mid changed since the last graph recompute
+    
+    uint64_t reprice_count_ = 0;
+    uint64_t refresh_count_ = 0;
+};
+
+} // namespace arbitrage
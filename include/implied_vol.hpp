@@ -0,0 +1,59 @@
+#pragma once
+
+#include "option_pricer.hpp"
+#include <cstdint>
+
+namespace arbitrage {
+
+struct ImpliedVolConfig {
+    double tolerance = 1e-10;      // |vol step| at which an option counts as solved
+    int max_iterations = 12;
+    double min_volatility = 1e-4;
+    double max_volatility = 8.0;
+};
+
+// Convergence counters; returned per solve and accumulated by the solver
+struct ImpliedVolStats {
+    uint64_t batches = 0;
+    uint64_t options = 0;
+    uint64_t converged = 0;
+    uint64_t unconverged = 0;    // Still moving after max_iterations
+    uint64_t out_of_bounds = 0;  // Quote outside the no-arbitrage bounds
+    uint64_t iterations = 0;     // Newton/Halley steps summed over options
+    uint32_t max_iterations = 0; // Most steps any single option needed
+    
+    double averageIterations() const {
+        return options > out_of_bounds ? static_cast<double>(iterations) / (options - out_of_bounds) : 0.0;
+    }
+    void merge(const ImpliedVolStats& other);
+};
+
+// Batch implied-volatility solver over OptionBatch columns: inverts
+// market_price into volatility for every option in the batch.
+//
+// Each option starts from the Corrado-Miller rational approximation (or from
+// its current volatility when warm starting, e.g. re-solving a chain after the
+// underlying ticked), then all SIMD lanes take Halley steps together, falling
+// back to Newton where the Halley correction is unstable. Lanes freeze as
+// they converge and the loop ends once every lane has. Quotes outside the
+// no-arbitrage bounds get a NaN volatility. Single-threaded.
+class ImpliedVolSolver {
+public:
+    ImpliedVolSolver() = default;
+    explicit ImpliedVolSolver(const ImpliedVolConfig& config) : config_(config) {}
+    
+    ImpliedVolStats solve(OptionBatch& batch, bool warm_start = false);
+    
+    // Same iteration one option at a time with libm; validates and benchmarks solve()
+    ImpliedVolStats solveReference(OptionBatch& batch, bool warm_start = false);
+    
+    const ImpliedVolStats& getStats() const { return stats_; }
+    void resetStats() { stats_ = ImpliedVolStats(); }
+    const ImpliedVolConfig& getConfig() const { return config_; }
+
+private:
+    ImpliedVolConfig config_;
+    ImpliedVolStats stats_;
+};
+
+} // namespace arbitrage
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "types.hpp"
+#include <chrono>
+#include <cstdint>
+
+namespace arbitrage {
+
+struct LatencyBudgetConfig {
+    std::chrono::milliseconds max_age{10};  // 0 stamps ages but rejects nothing
+};
+
+// When the venue produced, and when we received, the input behind one leg of
+// an opportunity; an unset (epoch) time is unknown and does not count
+struct InputTimes {
+    Timestamp exchange_time;
+    Timestamp receive_time;
+};
+
+// Enforces the detection latency budget (ArbitrageConfig::max_latency_ms).
+// A detector hands every candidate over with the input times of its legs;
+// the candidate is stamped with the age of its oldest input both by the
+// venue's clock (exchange_time to now) and by ours (receive_time to now), and
+// rejected if either exceeds max_age: a spread against a book that may have
+// moved since is not there to trade. Rejections are exported through the
+// PerformanceMonitor by the venue of the oldest leg and the detecting stage,
+// so a venue whose feed lags shows up by name. Each stage owns its budget.
+class LatencyBudget {
+public:
+    explicit LatencyBudget(const LatencyBudgetConfig& config = LatencyBudgetConfig());
+    
+    void setConfig(const LatencyBudgetConfig& config) { config_ = config; }
+    const LatencyBudgetConfig& getConfig() const { return config_; }
+    
+    // Stamp exchange_age/receive_age from one InputTimes per leg; false (and
+    // the rejection recorded) if the oldest input is over budget
+    bool admit(ArbitrageOpportunity& opportunity, const InputTimes* legs, size_t count, DetectionStage stage,
+               Timestamp now);
+    
+    // Statistics
+    uint64_t getAdmittedCount() const { return admitted_count_; }
+    uint64_t getRejectedCount() const { return rejected_count_; }
+
+private:
+    LatencyBudgetConfig config_;
+    uint64_t admitted_count_ = 0;
+    uint64_t rejected_count_ = 0;
+};
+
+} // namespace arbitrage
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "types.hpp"
+#include "shard_manager.hpp"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace arbitrage {
+
+// Recorded market events are stored one JSON object per line, timestamps in
+// nanoseconds since the epoch:
+//   {"type":"BOOK_UPDATE","instrument":"BTC/USDT_SPOT","exchange":"OKX","seq":1,
+//    "exchange_ts":...,"receive_ts":...,"bids":[[price,volume],...],"asks":[...]}
+// TRADE events carry a "trade" object (id, price, volume, side) and
+// FUNDING_RATE events a "funding" object (rate, predicted, funding_ts,
+// next_funding_ts).
+std::string marketEventToJson(const MarketEvent& event);
+bool marketEventFromJson(const std::string& line, MarketEvent& event);
+
+struct ReplayStats {
+    uint64_t events_replayed{0};
+    uint64_t opportunities{0};
+    uint64_t opportunity_digest{0};  // Order-sensitive hash of every opportunity seen
+    double wall_time_seconds{0.0};
+    double events_per_second{0.0};
+    Timestamp first_event_time;
+    Timestamp last_event_time;
+};
+
+// Deterministic backtest driver. Events are parsed up front, then fed in file
+// order through a stopped ShardManager on the calling thread: the simulated
+// EngineClock is moved to each event's receive time, due timers fire, and the
+// event runs through the same shard stages and merger as in production.
+// Throughput therefore measures the pipeline, not JSON parsing or I/O.
+class MarketReplay {
+public:
+    // Polled every 1024 events; returning false stops the replay early
+    using ContinueCheck = std::function<bool()>;
+    
+    MarketReplay() = default;
+    
+    // Load a recording; unparsable lines are logged and skipped
+    bool load(const std::string& file_path);
+    void addEvent(MarketEvent event);
+    
+    const std::vector<MarketEvent>& getEvents() const { return events_; }
+    size_t getSkippedLines() const { return skipped_lines_; }
+    
+    // Time of the first event; the simulated clock should start here before
+    // any shard is built so timers share the recording's time base
+    Timestamp getStartTime() const;
+    
+    // Replay every event; the manager must not be started
+    ReplayStats run(ShardManager& manager, const ContinueCheck& should_continue = nullptr);
+    
+    // Feed from the merger's opportunity callback to build the run digest
+    void recordOpportunity(const ArbitrageOpportunity& opportunity);
+
+private:
+    std::vector<MarketEvent> events_;
+    size_t skipped_lines_ = 0;
+    uint64_t opportunities_ = 0;
+    uint64_t digest_ = 0;
+};
+
+} // namespace arbitrage
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "types.hpp"
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace arbitrage {
+
+struct DedupConfig {
+    double exit_ratio = 0.5;      // An open record closes when a repeat's edge falls under this x its opening edge
+    double reentry_ratio = 1.25;  // Inside rearm_interval a closed key needs this x its last opening edge
+    std::chrono::milliseconds rearm_interval{250};
+    size_t initial_capacity = 1024;
+};
+
+enum class DedupAction {
+    EMIT,      // New record: publish it
+    UPDATE,    // Repeat of an open record: refresh it in place, publish nothing
+    CLOSE,     // Repeat that fell through the exit threshold: retire the record
+    SUPPRESS   // Closed key flapping back too soon or too weak: drop it
+};
+
+// Deduplicates the merged opportunity stream. Every opportunity is keyed by
+// a 64-bit hash of its type and legs (instrument, exchange and side per leg,
+// in leg order), so the same mispricing maps to the same key whatever its
+// prices, sizes or id. A key's record is open from the report that created
+// it until it is closed: by a repeat whose edge (expected_profit_percentage)
+// falls under exit_ratio times the edge it opened with, or from outside when
+// the record expires or a book moves through it.
+//
+// The two ratios form a hysteresis band around the opening edge: while open,
+// repeats only refresh the record; once closed, the key re-emits within
+// rearm_interval only if it comes back at reentry_ratio times that edge, so
+// a mispricing oscillating around a detector's threshold, or invalidated and
+// re-detected on every tick, is reported once. After rearm_interval a closed
+// key is new again. Opportunities without legs or an expiry_time have no
+// identity or lifetime and are always emitted; a reannounce (a detector's
+// scheduled re-report) is emitted too and reopens its key at its own edge.
+//
+// Keys live in an open-addressing table (linear probing, power-of-two
+// capacity kept at most half full) with state in parallel columns, so an
+// offer is one hash and, typically, one probe. When the table fills up,
+// closed keys past rearm_interval are dropped before it doubles, so its size
+// follows the live mispricings rather than everything ever seen.
+// Single-threaded: owned by the opportunity merger thread.
+class OpportunityDeduplicator {
+public:
+    explicit OpportunityDeduplicator(const DedupConfig& config = DedupConfig());
+    
+    void setConfig(const DedupConfig& config) { config_ = config; }
+    const DedupConfig& getConfig() const { return config_; }
+    
+    // Hash of type and legs; never 0 (0 means "no key")
+    static uint64_t computeKey(const ArbitrageOpportunity& opportunity);
+    
+    // Classify a merged opportunity; fills in its opportunity_key
+    DedupAction offer(ArbitrageOpportunity& opportunity, Timestamp now);
+    
+    // The record of key ended outside the stream (expiry, invalidation);
+    // false if it was not open
+    bool close(uint64_t key, Timestamp now);
+    void clear();
+    
+    // Accessors
+    bool isOpen(uint64_t key) const;
+    size_t size() const { return size_; }
+    size_t capacity() const { return keys_.size(); }
+    
+    // Statistics
+    uint64_t getEmitCount() const { return emit_count_; }
+    uint64_t getUpdateCount() const { return update_count_; }
+    uint64_t getCloseCount() const { return close_count_; }
+    uint64_t getSuppressCount() const { return suppress_count_; }
+
+private:
+    size_t probe(uint64_t key) const;
+    size_t insert(uint64_t key, Timestamp now);
+    void rebuild(Timestamp now);
+    
+    DedupConfig config_;
+    
+    // Table columns; key 0 marks an empty slot
+    std::vector<uint64_t> keys_;
+    std::vector<uint8_t> open_;
+    std::vector<double> opening_edge_;
+    std::vector<int64_t> closed_at_;   // ns since epoch
+    size_t mask_ = 0;
+    size_t size_ = 0;
+    
+    uint64_t emit_count_ = 0;
+    uint64_t update_count_ = 0;
+    uint64_t close_count_ = 0;
+    uint64_t suppress_count_ = 0;
+};
+
+} // namespace arbitrage
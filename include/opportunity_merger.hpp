@@ -0,0 +1,135 @@
+#pragma once
+
+#include "types.hpp"
+#include "event_loop.hpp"
+#include "timing_wheel.hpp"
+#include "quote_normalizer.hpp"
+#include "opportunity_ranking.hpp"
+#include "opportunity_store.hpp"
+#include "opportunity_dedup.hpp"
+#include "latency_budget.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace arbitrage {
+
+// Collects opportunities from all strategy shards and runs detectors whose legs
+// span more than one shard against the published top-of-book table, once per
+// drained batch with the instruments whose tops changed in it. The merger
+// thread mirrors the table and copies only the changed entries per batch. Merged
+// opportunities with an expiry_time are tracked on a timing wheel and reported
+// through the expiry callback once they lapse, or as soon as a published top
+// moves through one of their leg prices; until then they are ranked by
+// risk-adjusted profit. Repeats of a live opportunity (same type and legs)
+// refresh its record in place instead of being published again, and
+// opportunities flapping around their threshold are suppressed (see
+// OpportunityDeduplicator). Cross-shard detections are checked against the
+// latency budget using the published times of the tops they were built from.
+class OpportunityMerger {
+public:
+    using OpportunityCallback = std::function<void(const ArbitrageOpportunity&)>;
+    using ExpiryCallback = std::function<void(const std::string& opportunity_id)>;
+    using TopOfBookTable = std::unordered_map<InstrumentId, TopOfBook>;
+    using CrossShardDetector = std::function<void(const TopOfBookTable& tops,
+                                                  const std::vector<InstrumentId>& changed_instruments,
+                                                  std::vector<ArbitrageOpportunity>& out)>;
+    
+    OpportunityMerger();
+    ~OpportunityMerger();
+    
+    OpportunityMerger(const OpportunityMerger&) = delete;
+    OpportunityMerger& operator=(const OpportunityMerger&) = delete;
+    
+    // Configuration (must be called before start)
+    void setOpportunityCallback(OpportunityCallback callback);
+    void addCrossShardDetector(CrossShardDetector detector);
+    void setExpiryCallback(ExpiryCallback callback);
+    
+    // Start/stop the merger thread
+    void start(int cpu_core = -1);
+    void stop();
+    
+    // Called from shard threads
+    void publishTopOfBook(const TopOfBook& top);
+    void publishOpportunities(std::vector<ArbitrageOpportunity>& opportunities);
+    
+    // Drain pending work / fire expiries on the calling thread (only while stopped)
+    void processPending();
+    void advanceTimers(Timestamp now);
+    
+    // Accessors
+    bool getTopOfBook(const InstrumentId& instrument_id, TopOfBook& top) const;
+    
+    // Pivot-currency prices of the published tops, updated before the
+    // detectors run. Configure before start; read from detectors only.
+    QuoteNormalizer& getQuoteNormalizer() { return quote_normalizer_; }
+    // Live (not yet expired) opportunities by risk-adjusted profit. Read on
+    // the merger thread (callbacks) or while stopped.
+    const OpportunityRanking& getRanking() const { return ranking_; }
+    const OpportunityStore& getOpportunityStore() const { return store_; }
+    // Repeat and flap suppression. Configure before start.
+    OpportunityDeduplicator& getDeduplicator() { return dedup_; }
+    // Budget for cross-shard detections. Configure before start.
+    LatencyBudget& getLatencyBudget() { return latency_budget_; }
+    // Merger-thread timers: opportunity expiries and periodic detector work.
+    // Schedule before start or from the merger thread.
+    TimingWheel& getTimingWheel() { return expiry_wheel_; }
+    uint64_t getOpportunitiesMerged() const;
+    uint64_t getCrossShardOpportunities() const;
+    uint64_t getOpportunitiesExpired() const;
+    uint64_t getOpportunitiesInvalidated() const;
+    uint64_t getOpportunitiesUpdated() const;      // Repeats folded into a live record
+    uint64_t getOpportunitiesSuppressed() const;   // Flaps and repeats under the exit threshold
+
+private:
+    void mergeLoop();
+    void drain(std::unique_lock<std::mutex>& lock);
+    void armTimer();
+    void scheduleExpiry(const ArbitrageOpportunity& opportunity);
+    void retire(const std::string& opportunity_id);
+    
+    std::vector<CrossShardDetector> detectors_;
+    OpportunityCallback opportunity_callback_;
+    ExpiryCallback expiry_callback_;
+    
+    // State shared with shard threads
+    TopOfBookTable tops_;
+    std::vector<InstrumentId> dirty_instruments_;
+    std::unordered_set<InstrumentId> dirty_set_;
+    std::vector<ArbitrageOpportunity> pending_;
+    mutable std::mutex mutex_;
+    EventLoop event_loop_;
+    EventLoop::SourceId wakeup_id_{0};
+    
+    // Merger thread scratch space; snapshot_ mirrors tops_ as of the last drain
+    TopOfBookTable snapshot_;
+    std::vector<InstrumentId> changed_;
+    std::vector<ArbitrageOpportunity> batch_;
+    QuoteNormalizer quote_normalizer_;
+    TimingWheel expiry_wheel_;
+    EventLoop::SourceId wheel_timer_id_{0};
+    Timestamp armed_deadline_;  // Unset while the timer is disarmed
+    std::unordered_map<std::string, TimingWheel::TimerHandle> expiry_timers_;
+    OpportunityRanking ranking_;
+    OpportunityStore store_;
+    OpportunityDeduplicator dedup_;
+    LatencyBudget latency_budget_;
+    std::vector<InputTimes> leg_times_;
+    
+    std::atomic<bool> running_{false};
+    std::unique_ptr<std::thread> thread_;
+    std::atomic<uint64_t> opportunities_merged_{0};
+    std::atomic<uint64_t> cross_shard_opportunities_{0};
+    std::atomic<uint64_t> opportunities_expired_{0};
+    std::atomic<uint64_t> opportunities_invalidated_{0};
+    std::atomic<uint64_t> opportunities_updated_{0};
+    std::atomic<uint64_t> opportunities_suppressed_{0};
+};
+
+} // namespace arbitrage
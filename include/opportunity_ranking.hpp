@@ -0,0 +1,82 @@
+#pragma once
+
+#include "types.hpp"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace arbitrage {
+
+// Live opportunities ranked by risk-adjusted expected profit,
+//   score = expected_profit * (1 - clamp(risk_score, 0, 1))
+// addressed by opportunity_id so a re-evaluated opportunity is re-scored in
+// place instead of re-sorting everything.
+//
+// Two indexed binary heaps split the set at rank K: a min-heap holding the K
+// best (its root is the K-th best) and a max-heap holding the rest (its root
+// is the best outside the top K). Every slot knows its heap position, so
+// insert, re-score and remove by id are O(log n) followed by at most one
+// root swap between the heaps. The top K are read as a list that is only
+// re-sorted (O(K log K), independent of n) after the top tier changed.
+// Single-threaded: owned by the opportunity merger thread.
+class OpportunityRanking {
+public:
+    explicit OpportunityRanking(size_t top_k = 16);
+    
+    // Insert, or replace and re-score an existing id; false for an empty id
+    bool upsert(const ArbitrageOpportunity& opportunity);
+    
+    // Change an existing opportunity's score; false if the id is unknown
+    bool updateScore(const std::string& opportunity_id, double score);
+    bool remove(const std::string& opportunity_id);
+    void clear();
+    
+    // Best K (fewer if smaller), best first
+    const std::vector<const ArbitrageOpportunity*>& getTopK() const;
+    const ArbitrageOpportunity* getBest() const;
+    
+    // Lookup
+    bool contains(const std::string& opportunity_id) const { return index_.count(opportunity_id) != 0; }
+    bool getScore(const std::string& opportunity_id, double& score) const;
+    
+    // Accessors
+    size_t size() const { return index_.size(); }
+    bool empty() const { return index_.empty(); }
+    size_t getTopKCapacity() const { return top_k_; }
+    
+    static double riskAdjustedProfit(const ArbitrageOpportunity& opportunity);
+
+private:
+    struct Entry {
+        ArbitrageOpportunity opportunity;
+        double score = 0.0;
+        uint32_t position = 0;
+        bool in_top = false;
+    };
+    
+    // The top tier is a min-heap, the rest a max-heap: "above" means closer
+    // to the root of the entry's own heap
+    bool above(uint32_t a, uint32_t b, bool top) const;
+    void place(std::vector<uint32_t>& heap, uint32_t position, uint32_t slot);
+    void siftUp(std::vector<uint32_t>& heap, uint32_t position, bool top);
+    void siftDown(std::vector<uint32_t>& heap, uint32_t position, bool top);
+    void push(uint32_t slot, bool top);
+    uint32_t pop(bool top);
+    void erase(uint32_t slot);
+    void restore(uint32_t slot);
+    void rebalance();
+    
+    size_t top_k_;
+    std::vector<Entry> entries_;
+    std::vector<uint32_t> free_slots_;
+    std::unordered_map<std::string, uint32_t> index_;
+    std::vector<uint32_t> top_;   // Min-heap of the best top_k_
+    std::vector<uint32_t> rest_;  // Max-heap of everything else
+    
+    // Sorted top-K view, rebuilt on read after the top tier changed
+    mutable std::vector<const ArbitrageOpportunity*> top_view_;
+    mutable bool top_dirty_ = false;
+};
+
+} // namespace arbitrage
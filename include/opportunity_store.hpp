@@ -0,0 +1,107 @@
+#pragma once
+
+#include "types.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace arbitrage {
+
+// Reference to a stored opportunity; stale once the slot is invalidated or
+// reused (its generation moved on)
+struct OpportunityHandle {
+    static constexpr uint32_t kNoSlot = UINT32_MAX;
+    
+    uint32_t slot = kNoSlot;
+    uint32_t generation = 0;
+    
+    bool isNull() const { return slot == kNoSlot; }
+};
+
+// Live opportunities in fixed-capacity slots, invalidated as soon as a book
+// one of their legs trades on moves through the leg's price (the ask above a
+// buy, the bid below a sell).
+//
+// Slot state is kept as structure-of-arrays (generation, profit, leg count,
+// payload) and each leg is a node of an intrusive doubly linked list headed
+// by its instrument; node storage is slot * kMaxLegs + leg, so linking and
+// unlinking never allocate. A book update walks only its instrument's list,
+// and invalidating an opportunity unlinks its legs in O(legs). Every
+// invalidation bumps the slot's atomic generation, so a handle held on
+// another thread can be checked with isLive() without a lock; the payload
+// itself is owner-thread only.
+class OpportunityStore {
+public:
+    static constexpr size_t kMaxLegs = 8;
+    using InvalidationCallback = std::function<void(const ArbitrageOpportunity&)>;
+    
+    explicit OpportunityStore(size_t capacity = 4096);
+    
+    OpportunityStore(const OpportunityStore&) = delete;
+    OpportunityStore& operator=(const OpportunityStore&) = delete;
+    
+    // Called with the opportunity just before its slot is released by a book
+    // update (not for explicit remove/replace)
+    void setInvalidationCallback(InvalidationCallback callback);
+    
+    // Store an opportunity with a price per leg; an opportunity with the same
+    // id is replaced. Null handle if the store is full or the legs are
+    // malformed (empty, more than kMaxLegs, or lengths differ).
+    OpportunityHandle insert(const ArbitrageOpportunity& opportunity);
+    bool remove(OpportunityHandle handle);
+    bool remove(const std::string& opportunity_id);
+    void clear();
+    
+    // Invalidate every opportunity the new top has moved against; returns the count
+    size_t onTopOfBook(const TopOfBook& top);
+    
+    // Lock-free from any thread
+    bool isLive(OpportunityHandle handle) const;
+    
+    // Owner thread only; nullptr for a stale handle
+    const ArbitrageOpportunity* get(OpportunityHandle handle) const;
+    OpportunityHandle find(const std::string& opportunity_id) const;
+    
+    // Accessors
+    size_t size() const { return capacity_ - free_slots_.size(); }
+    size_t capacity() const { return capacity_; }
+    size_t getDependentCount(const InstrumentId& instrument_id) const;
+    uint64_t getInvalidatedCount() const { return invalidated_count_; }
+
+private:
+    static constexpr uint32_t kNoLink = UINT32_MAX;
+    
+    uint32_t instrumentSlot(const InstrumentId& instrument_id);
+    void link(uint32_t node, uint32_t instrument);
+    void unlink(uint32_t node);
+    void release(uint32_t slot);
+    
+    size_t capacity_;
+    InvalidationCallback invalidation_callback_;
+    
+    // Slots (SoA)
+    std::unique_ptr<std::atomic<uint32_t>[]> generation_;
+    std::vector<uint8_t> leg_count_;          // 0 while free
+    std::vector<ArbitrageOpportunity> payload_;
+    std::vector<uint32_t> free_slots_;
+    std::unordered_map<std::string, uint32_t> id_index_;
+    
+    // Leg nodes (SoA), node = slot * kMaxLegs + leg
+    std::vector<uint32_t> node_next_;
+    std::vector<uint32_t> node_prev_;
+    std::vector<uint32_t> node_instrument_;
+    std::vector<double> node_price_;
+    std::vector<int8_t> node_side_;           // +1 buy (ask must stay <= price), -1 sell
+    
+    // Per-instrument list heads
+    std::vector<uint32_t> instrument_head_;
+    std::unordered_map<InstrumentId, uint32_t> instrument_index_;
+    
+    uint64_t invalidated_count_ = 0;
+};
+
+} // namespace arbitrage
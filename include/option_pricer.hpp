@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace arbitrage {
+
+// European options laid out as structure-of-arrays columns. Columns are padded
+// to the SIMD width with benign inputs, so kernels run whole vectors only.
+struct OptionBatch {
+    // Inputs
+    std::vector<double> spot;
+    std::vector<double> strike;
+    std::vector<double> time_to_expiry;  // Years
+    std::vector<double> volatility;      // Annualized
+    std::vector<double> rate;            // Continuously compounded
+    std::vector<double> carry;           // Dividend / borrow yield q
+    std::vector<double> sign;            // +1 call, -1 put
+    std::vector<double> market_price;    // Quote to invert (ImpliedVolSolver)
+    
+    // Outputs
+    std::vector<double> price;
+    std::vector<double> delta;
+    std::vector<double> gamma;
+    std::vector<double> vega;   // Per 1.00 of vol
+    std::vector<double> theta;  // Per year
+    
+    size_t add(double spot_price, double strike_price, double years, double vol,
+               double rate_value, double carry_value, bool is_call);
+    void resize(size_t count);
+    void setSpot(double spot_price);
+    void clear() { resize(0); }
+    
+    size_t size() const { return count_; }
+    size_t paddedSize() const { return spot.size(); }
+
+private:
+    size_t count_ = 0;
+};
+
+// Black-Scholes-Merton price and Greeks. priceBatch() evaluates the whole
+// batch in SIMD lanes using the approximations in simd_math.hpp (price error
+// well below 1e-9 of spot); priceReference() is the scalar libm version used
+// to validate and benchmark it.
+class BlackScholesPricer {
+public:
+    static void priceBatch(OptionBatch& batch);
+    static void priceReference(OptionBatch& batch);
+};
+
+} // namespace arbitrage
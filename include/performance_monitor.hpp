@@ -1,6 +1,7 @@
 #pragma once
 
 #include "types.hpp"
+#include "event_loop.hpp"
 #include <chrono>
 #include <thread>
 #include <atomic>
@@ -25,6 +26,10 @@ public:
     void recordMessageProcessed();
     void recordOpportunityDetected();
     void recordTradeExecuted();
+    void recordConflatedUpdates(uint64_t count);
+    // An opportunity rejected for stale inputs, charged to the venue of its
+    // oldest leg and the stage that detected it
+    void recordStaleRejection(Exchange exchange, DetectionStage stage);
     void recordLatency(double latency_ms);
     void recordMemoryUsage(double memory_mb);
     void recordCpuUsage(double cpu_percentage);
@@ -39,6 +44,9 @@ public:
     uint64_t getMessagesProcessed() const;
     uint64_t getOpportunitiesDetected() const;
     uint64_t getTradesExecuted() const;
+    uint64_t getConflatedUpdates() const;
+    uint64_t getStaleRejections() const;
+    uint64_t getStaleRejections(Exchange exchange, DetectionStage stage) const;
     double getAverageLatency() const;
     double getMaxLatency() const;
     double getMemoryUsage() const;
@@ -61,8 +69,9 @@ private:
     PerformanceMonitor(const PerformanceMonitor&) = delete;
     PerformanceMonitor& operator=(const PerformanceMonitor&) = delete;
     
-    // Background monitoring thread
+    // Background monitoring thread (event loop with a periodic timer)
     void monitoringLoop();
+    void collectMetrics();
     
     // System metrics collection
     double getCurrentMemoryUsage();
@@ -75,8 +84,14 @@ private:
     std::atomic<bool> running_{false};
     std::atomic<bool> monitoring_enabled_{false};
     std::unique_ptr<std::thread> monitoring_thread_;
+    std::unique_ptr<EventLoop> event_loop_;
     int monitoring_interval_ms_{1000};
     
+    // Stale rejections by [exchange][stage]
+    static constexpr size_t kExchangeCount = static_cast<size_t>(Exchange::UNKNOWN) + 1;
+    static constexpr size_t kStageCount = static_cast<size_t>(DetectionStage::UNKNOWN) + 1;
+    std::atomic<uint64_t> stale_rejections_[kExchangeCount][kStageCount] = {};
+    
     // Latency tracking
     std::atomic<uint64_t> latency_count_{0};
     std::atomic<double> latency_sum_{0.0};
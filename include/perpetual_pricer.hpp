@@ -0,0 +1,94 @@
+#pragma once
+
+#include "types.hpp"
+#include "dependency_graph.hpp"
+#include <chrono>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace arbitrage {
+
+// Synthetic perpetual fair value: spot carried to the next funding snapshot,
+//   fair_value   = spot_mid * (1 + funding_rate * tau)
+//   basis_spread = perp_mid - fair_value
+// where tau = time to next funding / funding interval, clamped to [0, 1].
+//
+// Inputs and outputs live in padded structure-of-arrays columns so a funding
+// update reprices every perp in one AVX-512/AVX2 pass (see simd.hpp); a book
+// update reprices only the perps that use that book. Single-threaded: one
+// engine per strategy shard.
+class PerpetualFairValueEngine {
+public:
+    // Called with a perp's index each time its fair value and basis are recomputed
+    using BasisCallback = std::function<void(size_t index)>;
+    
+    explicit PerpetualFairValueEngine(std::chrono::seconds funding_interval = std::chrono::hours(8));
+    
+    // Register a perp priced off a spot book; returns its index
+    size_t addPerpetual(const InstrumentId& perp_id, const InstrumentId& spot_id);
+    
+    // Pair every perp with the spot of the same base/quote, preferring the
+    // perp's own exchange; returns the number of perps registered
+    size_t addInstruments(const std::vector<Instrument>& instruments);
+    
+    void setBasisCallback(BasisCallback callback);
+    
+    // Inputs (mid prices); prices take effect on the next compute
+    void updateSpotPrice(const InstrumentId& spot_id, Price mid);
+    void updatePerpPrice(const InstrumentId& perp_id, Price mid);
+    void updateFundingRate(const FundingRate& funding);
+    
+    // Reprice every perp in one SoA pass / reprice a single perp
+    void computeAll(Timestamp now);
+    void compute(size_t index, Timestamp now);
+    
+    // Register one graph node per perp, fed by its perp and spot books. From
+    // then on book updates only store mids and the graph reprices each
+    // affected perp once per event batch. Returns the number of nodes added.
+    size_t registerDependencies(DependencyGraph& graph);
+    DependencyGraph::NodeId getGraphNode(size_t index) const { return graph_nodes_[index]; }
+    
+    // Apply a shard event and reprice what it affects; returns true if any
+    // fair value was recomputed
+    bool onMarketEvent(const MarketEvent& event, Timestamp now);
+    
+    // Fills fair_value/basis_spread; false if unknown or inputs missing
+    bool getSyntheticPrice(const InstrumentId& perp_id, SyntheticPrice& out) const;
+    
+    // Accessors
+    size_t size() const { return perp_ids_.size(); }
+    bool findPerpetual(const InstrumentId& perp_id, size_t& index) const;
+    const InstrumentId& getPerpetualId(size_t index) const { return perp_ids_[index]; }
+    const InstrumentId& getSpotId(size_t index) const { return spot_ids_[index]; }
+    Price getPerpPrice(size_t index) const { return perp_mid_[index]; }
+    Price getSpotPrice(size_t index) const { return spot_mid_[index]; }
+    Price getFairValue(size_t index) const { return fair_value_[index]; }
+    Price getBasisSpread(size_t index) const { return basis_spread_[index]; }
+
+private:
+    double toSeconds(Timestamp time) const;
+    void resizeColumns();
+    
+    double funding_interval_s_;
+    Timestamp origin_;
+    BasisCallback basis_callback_;
+    
+    // Per-perp metadata
+    std::vector<InstrumentId> perp_ids_;
+    std::vector<InstrumentId> spot_ids_;
+    std::vector<Timestamp> calculation_time_;
+    std::unordered_map<InstrumentId, size_t> perp_index_;
+    std::unordered_map<InstrumentId, std::vector<size_t>> spot_dependents_;
+    std::vector<DependencyGraph::NodeId> graph_nodes_;  // Empty unless graph-driven
+    
+    // SoA columns, padded to a whole number of SIMD vectors
+    std::vector<double> spot_mid_;
+    std::vector<double> perp_mid_;
+    std::vector<double> funding_rate_;
+    std::vector<double> next_funding_s_;  // Seconds since origin_
+    std::vector<double> fair_value_;
+    std::vector<double> basis_spread_;
+};
+
+} // namespace arbitrage
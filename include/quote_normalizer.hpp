@@ -0,0 +1,117 @@
+#pragma once
+
+#include "types.hpp"
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace arbitrage {
+
+struct QuoteNormalizerConfig {
+    std::string pivot = "USDT";  // Currency every price is normalized into
+    // Rates (in pivot) for currencies no conversion book reaches; USD has no
+    // book on the supported venues and is carried at par until one is listed
+    std::vector<std::pair<std::string, double>> fixed_rates = {{"USD", 1.0}};
+};
+
+// Normalizes instrument prices quoted in different currencies (USDT, USDC,
+// USD, ...) into one pivot currency so BTC/USDT on one venue and BTC/USDC on
+// another compare directly.
+//
+// Conversion rates come from the mids of stablecoin books (instruments whose
+// base and quote are both quote currencies, e.g. USDC/USDT). Each currency is
+// reached from the pivot through a spanning tree of those books, so every
+// entry of the rate matrix is to_pivot[i] / to_pivot[j] and the matrix is
+// consistent (rate(a, b) * rate(b, c) == rate(a, c)) after every tick. A
+// conversion tick rescales only the currencies below its tree edge and the
+// instruments quoted in them; an instrument tick rescales only itself.
+// Single-threaded: owned by the opportunity merger thread.
+class QuoteNormalizer {
+public:
+    explicit QuoteNormalizer(const QuoteNormalizerConfig& config = QuoteNormalizerConfig());
+    
+    // Register instruments by quote asset; stablecoin pairs also become
+    // conversion books. Returns the number of conversion books.
+    size_t addInstruments(const std::vector<Instrument>& instruments);
+    size_t addInstrument(const InstrumentId& instrument_id, const std::string& quote_asset);
+    bool addConversionBook(const InstrumentId& instrument_id, const std::string& base_currency,
+                           const std::string& quote_currency);
+    
+    // Feed a top of book (conversion book and/or quoted instrument); returns
+    // true if any normalized price changed
+    bool onTopOfBook(const TopOfBook& top);
+    
+    // Rate matrix: units of `to` per unit of `from`; NaN if either currency
+    // is unknown or not yet priced
+    double getRate(const std::string& from, const std::string& to) const;
+    double getRate(size_t from, size_t to) const { return rates_[from * currencies_.size() + to]; }
+    double convert(Price price, const std::string& from, const std::string& to) const;
+    
+    // Normalized (pivot) prices; NaN until both the instrument and its
+    // conversion path are priced
+    bool find(const InstrumentId& instrument_id, size_t& index) const;
+    bool isConversionBook(const InstrumentId& instrument_id) const { return book_index_.count(instrument_id) != 0; }
+    Price getNormalizedBid(size_t index) const { return bid_[index]; }
+    Price getNormalizedAsk(size_t index) const { return ask_[index]; }
+    Price getNormalizedMid(size_t index) const { return 0.5 * (bid_[index] + ask_[index]); }
+    
+    // Relative edge of selling `sell` at its bid and buying `buy` at its ask,
+    // in pivot terms: (bid_sell - ask_buy) / ask_buy. NaN if either is unpriced.
+    double getRelativeSpread(size_t sell, size_t buy) const;
+    
+    // Accessors
+    size_t size() const { return instrument_ids_.size(); }
+    bool empty() const { return instrument_ids_.empty(); }
+    size_t getCurrencyCount() const { return currencies_.size(); }
+    bool findCurrency(const std::string& currency, size_t& index) const;
+    const std::string& getPivot() const { return currencies_[0]; }
+    double getPivotRate(size_t currency) const { return to_pivot_[currency]; }
+    uint64_t getRenormalizedCount() const { return renormalized_count_; }
+
+private:
+    struct ConversionBook {
+        size_t base;
+        size_t quote;
+        double mid;
+        std::vector<size_t> subtree;  // Currencies re-derived when this edge ticks (tree edges only)
+    };
+    
+    size_t addCurrency(const std::string& currency);
+    void rebuildTree();
+    void derive(size_t currency);
+    void refreshMatrix(size_t currency);
+    void renormalize(size_t instrument);
+    bool updateConversion(size_t book, double mid);
+    
+    QuoteNormalizerConfig config_;
+    
+    // Currencies; index 0 is the pivot
+    std::vector<std::string> currencies_;
+    std::unordered_map<std::string, size_t> currency_index_;
+    std::vector<double> to_pivot_;
+    std::vector<double> fixed_rate_;           // NaN when none
+    std::vector<double> rates_;                // Row-major N x N
+    std::vector<std::vector<size_t>> quoted_;  // Currency -> instruments quoted in it
+    
+    // Spanning tree: how each currency is derived from its parent
+    std::vector<size_t> parent_book_;  // kNone for the pivot and fixed/unreached currencies
+    std::vector<size_t> parent_;
+    
+    // Conversion books
+    std::vector<ConversionBook> books_;
+    std::unordered_map<InstrumentId, size_t> book_index_;
+    
+    // Instruments (SoA)
+    std::vector<InstrumentId> instrument_ids_;
+    std::unordered_map<InstrumentId, size_t> instrument_index_;
+    std::vector<size_t> quote_currency_;
+    std::vector<double> raw_bid_;
+    std::vector<double> raw_ask_;
+    std::vector<double> bid_;
+    std::vector<double> ask_;
+    
+    uint64_t renormalized_count_ = 0;
+};
+
+} // namespace arbitrage
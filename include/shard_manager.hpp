@@ -0,0 +1,61 @@
+#pragma once
+
+#include "types.hpp"
+#include "strategy_shard.hpp"
+#include "opportunity_merger.hpp"
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace arbitrage {
+
+// Partitions instruments into strategy shards by base asset so each asset's
+// books, pricing and detection run on their own core, and routes incoming
+// market events to the owning shard.
+class ShardManager {
+public:
+    // Called once per shard to install that shard's own stage instances
+    using ShardInitializer = std::function<void(StrategyShard&)>;
+    
+    ShardManager() = default;
+    ~ShardManager();
+    
+    ShardManager(const ShardManager&) = delete;
+    ShardManager& operator=(const ShardManager&) = delete;
+    
+    // Build the partition; shard count is capped by the number of base assets
+    bool initialize(const std::vector<Instrument>& instruments, size_t max_shards);
+    void configureShards(const ShardInitializer& initializer);
+    
+    // Start/stop shard and merger threads. While stopped, submit() processes
+    // events synchronously on the calling thread.
+    void start(bool pin_threads = true);
+    void stop();
+    
+    // Route an event to its shard
+    void submit(MarketEvent event);
+    
+    // Fire due shard and merger timers on the calling thread (only while
+    // stopped; running shards drive their own timers)
+    void advanceTimers(Timestamp now);
+    
+    // Partition lookups
+    size_t getShardForInstrument(const InstrumentId& instrument_id) const;
+    size_t getShardForAsset(const std::string& base_asset) const;
+    size_t getShardCount() const { return shards_.size(); }
+    
+    StrategyShard& getShard(size_t shard_id) { return *shards_.at(shard_id); }
+    OpportunityMerger& getMerger() { return merger_; }
+    bool isRunning() const { return running_; }
+
+private:
+    OpportunityMerger merger_;
+    std::vector<std::unique_ptr<StrategyShard>> shards_;
+    std::unordered_map<std::string, size_t> asset_to_shard_;
+    std::unordered_map<InstrumentId, size_t> instrument_to_shard_;
+    bool running_ = false;
+};
+
+} // namespace arbitrage
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace arbitrage {
+namespace simd {
+
+// Thin wrapper over the widest double-precision vector the build targets
+// (CMake compiles with -march=native): AVX-512 (8 lanes), AVX2 (4 lanes) or a
+// scalar fallback (1 lane). Kernels are written once against VecD/MaskD and
+// process SoA arrays in steps of kLanes; callers pad arrays with padLanes() so
+// there is no scalar tail.
+
+#if defined(__AVX512F__)
+
+constexpr size_t kLanes = 8;
+constexpr const char* kIsaName = "AVX-512";
+
+// Several unmasked AVX-512 intrinsics trip GCC 12's -Wmaybe-uninitialized;
+// the all-lanes maskz forms below compile to the same instructions
+
+struct MaskD {
+    __mmask8 m;
+};
+
+struct VecD {
+    __m512d v;
+    
+    static VecD load(const double* p) { return {_mm512_loadu_pd(p)}; }
+    static VecD broadcast(double x) { return {_mm512_set1_pd(x)}; }
+    void store(double* p) const { _mm512_storeu_pd(p, v); }
+};
+
+inline VecD operator+(VecD a, VecD b) { return {_mm512_add_pd(a.v, b.v)}; }
+inline VecD operator-(VecD a, VecD b) { return {_mm512_sub_pd(a.v, b.v)}; }
+inline VecD operator*(VecD a, VecD b) { return {_mm512_mul_pd(a.v, b.v)}; }
+inline VecD operator/(VecD a, VecD b) { return {_mm512_div_pd(a.v, b.v)}; }
+inline VecD fma(VecD a, VecD b, VecD c) { return {_mm512_fmadd_pd(a.v, b.v, c.v)}; }  // a * b + c
+inline VecD min(VecD a, VecD b) { return {_mm512_maskz_min_pd(0xFF, a.v, b.v)}; }
+inline VecD max(VecD a, VecD b) { return {_mm512_maskz_max_pd(0xFF, a.v, b.v)}; }
+inline VecD sqrt(VecD a) { return {_mm512_maskz_sqrt_pd(0xFF, a.v)}; }
+inline VecD abs(VecD a) { return {_mm512_abs_pd(a.v)}; }
+
+inline MaskD operator>(VecD a, VecD b) { return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_GT_OQ)}; }
+inline MaskD operator<(VecD a, VecD b) { return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_LT_OQ)}; }
+inline MaskD operator>=(VecD a, VecD b) { return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_GE_OQ)}; }
+inline MaskD operator&(MaskD a, MaskD b) { return {static_cast<__mmask8>(a.m & b.m)}; }
+inline MaskD operator|(MaskD a, MaskD b) { return {static_cast<__mmask8>(a.m | b.m)}; }
+inline VecD select(MaskD mask, VecD if_true, VecD if_false) {
+    return {_mm512_mask_blend_pd(mask.m, if_false.v, if_true.v)};
+}
+inline uint32_t toBits(MaskD mask) { return mask.m; }
+
+// Round to nearest integer
+inline VecD round(VecD a) { return {_mm512_maskz_roundscale_pd(0xFF, a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)}; }
+// p * 2^n for integral n in [-1022, 1023]
+inline VecD scale2(VecD p, VecD n) { return {_mm512_maskz_scalef_pd(0xFF, p.v, n.v)}; }
+// x = mantissa * 2^exponent with mantissa in [1, 2); x must be positive and normal
+inline void splitExponent(VecD x, VecD& mantissa, VecD& exponent) {
+    mantissa.v = _mm512_maskz_getmant_pd(0xFF, x.v, _MM_MANT_NORM_1_2, _MM_MANT_SIGN_zero);
+    exponent.v = _mm512_maskz_getexp_pd(0xFF, x.v);
+}
+
+#elif defined(__AVX2__)
+
+constexpr size_t kLanes = 4;
+constexpr const char* kIsaName = "AVX2";
+
+struct MaskD {
+    __m256d m;
+};
+
+struct VecD {
+    __m256d v;
+    
+    static VecD load(const double* p) { return {_mm256_loadu_pd(p)}; }
+    static VecD broadcast(double x) { return {_mm256_set1_pd(x)}; }
+    void store(double* p) const { _mm256_storeu_pd(p, v); }
+};
+
+inline VecD operator+(VecD a, VecD b) { return {_mm256_add_pd(a.v, b.v)}; }
+inline VecD operator-(VecD a, VecD b) { return {_mm256_sub_pd(a.v, b.v)}; }
+inline VecD operator*(VecD a, VecD b) { return {_mm256_mul_pd(a.v, b.v)}; }
+inline VecD operator/(VecD a, VecD b) { return {_mm256_div_pd(a.v, b.v)}; }
+#if defined(__FMA__)
+inline VecD fma(VecD a, VecD b, VecD c) { return {_mm256_fmadd_pd(a.v, b.v, c.v)}; }
+#else
+inline VecD fma(VecD a, VecD b, VecD c) { return a * b + c; }
+#endif
+inline VecD min(VecD a, VecD b) { return {_mm256_min_pd(a.v, b.v)}; }
+inline VecD max(VecD a, VecD b) { return {_mm256_max_pd(a.v, b.v)}; }
+inline VecD sqrt(VecD a) { return {_mm256_sqrt_pd(a.v)}; }
+inline VecD abs(VecD a) { return {_mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v)}; }
+
+inline MaskD operator>(VecD a, VecD b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ)}; }
+inline MaskD operator<(VecD a, VecD b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ)}; }
+inline MaskD operator>=(VecD a, VecD b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_GE_OQ)}; }
+inline MaskD operator&(MaskD a, MaskD b) { return {_mm256_and_pd(a.m, b.m)}; }
+inline MaskD operator|(MaskD a, MaskD b) { return {_mm256_or_pd(a.m, b.m)}; }
+inline VecD select(MaskD mask, VecD if_true, VecD if_false) {
+    return {_mm256_blendv_pd(if_false.v, if_true.v, mask.m)};
+}
+inline uint32_t toBits(MaskD mask) { return static_cast<uint32_t>(_mm256_movemask_pd(mask.m)); }
+
+inline VecD round(VecD a) { return {_mm256_round_pd(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)}; }
+inline VecD scale2(VecD p, VecD n) {
+    // Integral double -> int64 via the 1.5 * 2^52 trick, then add n to the
+    // biased exponent field of p
+    const __m256d magic = _mm256_set1_pd(6755399441055744.0);
+    __m256i bits = _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(n.v, magic)),
+                                    _mm256_castpd_si256(magic));
+    return {_mm256_castsi256_pd(_mm256_add_epi64(_mm256_castpd_si256(p.v), _mm256_slli_epi64(bits, 52)))};
+}
+inline void splitExponent(VecD x, VecD& mantissa, VecD& exponent) {
+    const __m256i bits = _mm256_castpd_si256(x.v);
+    const __m256i mantissa_mask = _mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL);
+    const __m256d two_52 = _mm256_set1_pd(4503599627370496.0);
+    mantissa.v = _mm256_or_pd(_mm256_castsi256_pd(_mm256_and_si256(bits, mantissa_mask)), _mm256_set1_pd(1.0));
+    // Biased exponent (< 2^52) -> double by splicing it under 2^52
+    __m256d biased = _mm256_sub_pd(
+        _mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(bits, 52), _mm256_castpd_si256(two_52))), two_52);
+    exponent.v = _mm256_sub_pd(biased, _mm256_set1_pd(1023.0));
+}
+
+#else
+
+constexpr size_t kLanes = 1;
+constexpr const char* kIsaName = "scalar";
+
+struct MaskD {
+    bool m;
+};
+
+struct VecD {
+    double v;
+    
+    static VecD load(const double* p) { return {*p}; }
+    static VecD broadcast(double x) { return {x}; }
+    void store(double* p) const { *p = v; }
+};
+
+inline VecD operator+(VecD a, VecD b) { return {a.v + b.v}; }
+inline VecD operator-(VecD a, VecD b) { return {a.v - b.v}; }
+inline VecD operator*(VecD a, VecD b) { return {a.v * b.v}; }
+inline VecD operator/(VecD a, VecD b) { return {a.v / b.v}; }
+inline VecD fma(VecD a, VecD b, VecD c) { return {std::fma(a.v, b.v, c.v)}; }
+inline VecD min(VecD a, VecD b) { return {a.v < b.v ? a.v : b.v}; }
+inline VecD max(VecD a, VecD b) { return {a.v > b.v ? a.v : b.v}; }
+inline VecD sqrt(VecD a) { return {std::sqrt(a.v)}; }
+inline VecD abs(VecD a) { return {std::fabs(a.v)}; }
+
+inline MaskD operator>(VecD a, VecD b) { return {a.v > b.v}; }
+inline MaskD operator<(VecD a, VecD b) { return {a.v < b.v}; }
+inline MaskD operator>=(VecD a, VecD b) { return {a.v >= b.v}; }
+inline MaskD operator&(MaskD a, MaskD b) { return {a.m && b.m}; }
+inline MaskD operator|(MaskD a, MaskD b) { return {a.m || b.m}; }
+inline VecD select(MaskD mask, VecD if_true, VecD if_false) { return mask.m ? if_true : if_false; }
+inline uint32_t toBits(MaskD mask) { return mask.m ? 1u : 0u; }
+
+inline VecD round(VecD a) { return {std::nearbyint(a.v)}; }
+inline VecD scale2(VecD p, VecD n) { return {std::ldexp(p.v, static_cast<int>(n.v))}; }
+inline void splitExponent(VecD x, VecD& mantissa, VecD& exponent) {
+    int e = 0;
+    mantissa.v = 2.0 * std::frexp(x.v, &e);
+    exponent.v = e - 1;
+}
+
+#endif
+
+inline VecD operator-(VecD a) { return VecD::broadcast(0.0) - a; }
+
+// Round a count up to a whole number of vectors
+inline size_t padLanes(size_t count) {
+    return (count + kLanes - 1) / kLanes * kLanes;
+}
+
+} // namespace simd
+} // namespace arbitrage
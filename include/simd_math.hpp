@@ -0,0 +1,110 @@
+#pragma once
+
+#include "simd.hpp"
+
+namespace arbitrage {
+namespace simd {
+
+// Vectorized transcendental approximations for the pricing kernels. Bounds
+// are measured against libm over the stated domain (tests/test_option_pricer.cpp
+// checks them); all are far below the noise in market data.
+//
+//   exp(x)      relative error < 1e-15 for x in [-708, 709]; clamped outside
+//   log(x)      relative error < 2e-15 for positive normal x (absolute < 1e-15
+//               on [0.5, 2])
+//   normCdf(x)  absolute error < 1e-15 everywhere; relative error < 1e-8 in
+//               the lower tail (x < 0)
+//   normPdf(x)  relative error < 1e-15 (via exp)
+
+// exp: x = n*ln2 + r with |r| <= ln2/2, degree-12 Taylor polynomial in r,
+// then scale by 2^n
+inline VecD exp(VecD x) {
+    x = min(max(x, VecD::broadcast(-708.0)), VecD::broadcast(709.0));
+    VecD n = round(x * VecD::broadcast(1.4426950408889634));
+    VecD r = fma(n, VecD::broadcast(-6.93145751953125e-1), x);
+    r = fma(n, VecD::broadcast(-1.42860682030941723212e-6), r);
+    
+    VecD p = VecD::broadcast(1.0 / 479001600.0);
+    p = fma(p, r, VecD::broadcast(1.0 / 39916800.0));
+    p = fma(p, r, VecD::broadcast(1.0 / 3628800.0));
+    p = fma(p, r, VecD::broadcast(1.0 / 362880.0));
+    p = fma(p, r, VecD::broadcast(1.0 / 40320.0));
+    p = fma(p, r, VecD::broadcast(1.0 / 5040.0));
+    p = fma(p, r, VecD::broadcast(1.0 / 720.0));
+    p = fma(p, r, VecD::broadcast(1.0 / 120.0));
+    p = fma(p, r, VecD::broadcast(1.0 / 24.0));
+    p = fma(p, r, VecD::broadcast(1.0 / 6.0));
+    p = fma(p, r, VecD::broadcast(0.5));
+    p = fma(p, r, VecD::broadcast(1.0));
+    p = fma(p, r, VecD::broadcast(1.0));
+    return scale2(p, n);
+}
+
+// log: x = m * 2^e with m in [sqrt(1/2), sqrt(2)), then
+// log(m) = 2 atanh(s), s = (m - 1) / (m + 1), |s| <= 0.1716, odd series to s^17
+inline VecD log(VecD x) {
+    VecD m, e;
+    splitExponent(x, m, e);
+    MaskD high = m > VecD::broadcast(1.4142135623730951);
+    m = select(high, m * VecD::broadcast(0.5), m);
+    e = select(high, e + VecD::broadcast(1.0), e);
+    
+    VecD s = (m - VecD::broadcast(1.0)) / (m + VecD::broadcast(1.0));
+    VecD s2 = s * s;
+    VecD p = VecD::broadcast(2.0 / 17.0);
+    p = fma(p, s2, VecD::broadcast(2.0 / 15.0));
+    p = fma(p, s2, VecD::broadcast(2.0 / 13.0));
+    p = fma(p, s2, VecD::broadcast(2.0 / 11.0));
+    p = fma(p, s2, VecD::broadcast(2.0 / 9.0));
+    p = fma(p, s2, VecD::broadcast(2.0 / 7.0));
+    p = fma(p, s2, VecD::broadcast(2.0 / 5.0));
+    p = fma(p, s2, VecD::broadcast(2.0 / 3.0));
+    p = fma(p, s2, VecD::broadcast(2.0));
+    VecD log_m = p * s;
+    
+    // e * ln2 split hi/lo so large exponents keep full precision
+    return fma(e, VecD::broadcast(6.93145751953125e-1),
+               fma(e, VecD::broadcast(1.42860682030941723212e-6), log_m));
+}
+
+// Standard normal density
+inline VecD normPdf(VecD x) {
+    return exp(x * x * VecD::broadcast(-0.5)) * VecD::broadcast(0.39894228040143267794);
+}
+
+// Standard normal CDF, Hart's double-precision algorithm as given by West
+// (2005): a rational function of |x| below 7.07, a continued fraction above
+inline VecD normCdf(VecD x) {
+    VecD a = abs(x);
+    VecD e = exp(a * a * VecD::broadcast(-0.5));
+    
+    VecD num = VecD::broadcast(3.52624965998911e-02);
+    num = fma(num, a, VecD::broadcast(0.700383064443688));
+    num = fma(num, a, VecD::broadcast(6.37396220353165));
+    num = fma(num, a, VecD::broadcast(33.912866078383));
+    num = fma(num, a, VecD::broadcast(112.079291497871));
+    num = fma(num, a, VecD::broadcast(221.213596169931));
+    num = fma(num, a, VecD::broadcast(220.206867912376));
+    VecD den = VecD::broadcast(8.83883476483184e-02);
+    den = fma(den, a, VecD::broadcast(1.75566716318264));
+    den = fma(den, a, VecD::broadcast(16.064177579207));
+    den = fma(den, a, VecD::broadcast(86.7807322029461));
+    den = fma(den, a, VecD::broadcast(296.564248779674));
+    den = fma(den, a, VecD::broadcast(637.333633378831));
+    den = fma(den, a, VecD::broadcast(793.826512519948));
+    den = fma(den, a, VecD::broadcast(440.413735824752));
+    VecD near_tail = e * num / den;
+    
+    VecD cf = a + VecD::broadcast(0.65);
+    cf = a + VecD::broadcast(4.0) / cf;
+    cf = a + VecD::broadcast(3.0) / cf;
+    cf = a + VecD::broadcast(2.0) / cf;
+    cf = a + VecD::broadcast(1.0) / cf;
+    VecD far_tail = e / cf * VecD::broadcast(0.39894228040143267794);
+    
+    VecD tail = select(a < VecD::broadcast(7.07106781186547), near_tail, far_tail);
+    return select(x > VecD::broadcast(0.0), VecD::broadcast(1.0) - tail, tail);
+}
+
+} // namespace simd
+} // namespace arbitrage
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "types.hpp"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace arbitrage {
+
+struct SpreadScannerConfig {
+    double min_profit = 0.001;                      // Net relative edge required to report a pair
+    double fee_rate = 0.0;                          // Taker fee charged on each of the three legs
+    std::chrono::milliseconds opportunity_ttl{500};
+};
+
+// REAL_VS_SYNTHETIC_SPOT scanner: every spot book A/B against the synthetic
+// A/B replicated through a third currency C,
+//   synthetic = (A/C) * (C/B)
+// where each leg is a listed book in either orientation (C/A and B/C are
+// inverted at update time).
+//
+// Real and synthetic leg bid/ask live in padded SoA columns, one lane per
+// pair, so the net edges in both directions,
+//   sell real, buy synthetic   real_bid * fees / (leg1_ask * leg2_ask) - 1
+//   buy real, sell synthetic   leg1_bid * leg2_bid * fees / real_ask - 1
+// are compared with min_profit for a whole vector of pairs at once (cross-
+// multiplied, so the pass has no divisions) and only the lanes of the
+// survivor mask are priced and turned into opportunities.
+// Unpriced legs are NaN, which fails every comparison, so the pass has no
+// per-pair branches. A book update marks the vectors holding its pairs and
+// scan() evaluates only those. Parallel books for a pair on different
+// venues each get their own lanes, one per combination of books; each
+// triangle is registered once, so the same three books are not reported
+// from every corner. Single-threaded: runs on the opportunity merger thread.
+class SpotSpreadScanner {
+public:
+    explicit SpotSpreadScanner(const SpreadScannerConfig& config = SpreadScannerConfig());
+    
+    // Register every triangle the spot books close, across venues; returns the
+    // number of pairs added
+    size_t addInstruments(const std::vector<Instrument>& instruments);
+    // Real A/B against leg1 (A/C, or C/A if inverted) times leg2 (C/B, or B/C if inverted)
+    bool addPair(const InstrumentId& real_id, const InstrumentId& leg1_id, bool leg1_inverted,
+                 const InstrumentId& leg2_id, bool leg2_inverted);
+    
+    // Store a book's prices in the pairs using it; false if no pair does
+    bool onTopOfBook(const TopOfBook& top);
+    
+    // Evaluate the pairs touched since the last scan / every pair; emits one
+    // opportunity per surviving direction and returns the count
+    size_t scan(Timestamp now, std::vector<ArbitrageOpportunity>& out);
+    size_t scanAll(Timestamp now, std::vector<ArbitrageOpportunity>& out);
+    
+    // Accessors
+    size_t size() const { return pairs_.size(); }
+    bool find(const InstrumentId& real_id, size_t& index) const;  // First pair using the real book
+    const InstrumentId& getRealId(size_t index) const;
+    double getSyntheticBid(size_t index) const { return leg1_bid_[index] * leg2_bid_[index]; }
+    double getSyntheticAsk(size_t index) const { return leg1_ask_[index] * leg2_ask_[index]; }
+    // Net edges at the stored prices (NaN until every leg is priced)
+    double getSellRealEdge(size_t index) const;
+    double getBuyRealEdge(size_t index) const;
+    
+    // Statistics
+    uint64_t getScannedCount() const { return scanned_count_; }    // Pairs evaluated
+    uint64_t getSurvivorCount() const { return survivor_count_; }  // Directions emitted
+
+private:
+    struct Pair {
+        uint32_t real;      // Book slots
+        uint32_t leg1;
+        uint32_t leg2;
+        bool leg1_inverted;
+        bool leg2_inverted;
+    };
+    
+    // Which column a book feeds for one pair
+    struct Dependent {
+        uint32_t pair;
+        uint8_t role;       // 0 real, 1 leg1, 2 leg2
+    };
+    
+    uint32_t bookSlot(const InstrumentId& instrument_id);
+    void store(const Dependent& dependent, const TopOfBook& top);
+    void markDirty(uint32_t pair);
+    void emit(uint32_t index, bool sell_real, Timestamp now, std::vector<ArbitrageOpportunity>& out);
+    void resizeColumns();
+    
+    SpreadScannerConfig config_;
+    double fee_factor_;     // (1 - fee_rate)^3
+    
+    std::vector<Pair> pairs_;
+    std::unordered_map<InstrumentId, size_t> pair_index_;  // By real book
+    std::unordered_map<std::string, size_t> triangles_;    // Sorted book ids -> pair
+    
+    // Books
+    std::vector<TopOfBook> books_;
+    std::vector<Exchange> book_exchanges_;
+    std::unordered_map<InstrumentId, uint32_t> book_slots_;
+    std::vector<std::vector<Dependent>> book_dependents_;
+    
+    // SoA columns, padded to a whole number of SIMD vectors (NaN padding)
+    std::vector<double> real_bid_;
+    std::vector<double> real_ask_;
+    std::vector<double> leg1_bid_;  // Oriented A/C
+    std::vector<double> leg1_ask_;
+    std::vector<double> leg2_bid_;  // Oriented C/B
+    std::vector<double> leg2_ask_;
+    
+    // Vectors touched since the last scan
+    std::vector<uint8_t> dirty_;
+    std::vector<uint32_t> dirty_blocks_;
+    
+    uint64_t scanned_count_ = 0;
+    uint64_t survivor_count_ = 0;
+};
+
+} // namespace arbitrage
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "types.hpp"
+#include "event_loop.hpp"
+#include "conflating_queue.hpp"
+#include "timing_wheel.hpp"
+#include "dependency_graph.hpp"
+#include "funding_history.hpp"
+#include "confidence_scorer.hpp"
+#include "depth_sizer.hpp"
+#include "latency_budget.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace arbitrage {
+
+class OpportunityMerger;
+
+// A strategy shard owns the order books, pricing and detection state for a
+// subset of instruments and processes their events on its own thread. Nothing
+// in a shard is shared with other shards; cross-shard work goes through the
+// OpportunityMerger.
+class StrategyShard {
+public:
+    // Pricing/detection stage invoked for every event routed to this shard
+    using EventHandler = std::function<void(StrategyShard&, const MarketEvent&)>;
+    
+    StrategyShard(size_t shard_id, OpportunityMerger* merger);
+    ~StrategyShard();
+    
+    StrategyShard(const StrategyShard&) = delete;
+    StrategyShard& operator=(const StrategyShard&) = delete;
+    
+    // Register a stage (must be called before start)
+    void addEventHandler(EventHandler handler);
+    
+    // Assign an instrument to this shard; futures/options get an expiry timer
+    void addInstrument(const Instrument& instrument);
+    
+    // Start/stop the shard thread, optionally pinned to a CPU core
+    void start(int cpu_core = -1);
+    void stop();
+    
+    // Queue an event for the shard thread; book updates for an instrument
+    // that is still queued are conflated into the newest book
+    void submit(MarketEvent event);
+    
+    // Process an event on the calling thread
+    void processEvent(const MarketEvent& event);
+    
+    // Process a batch on the calling thread; dependent synthetics and
+    // detectors are recomputed once for the whole batch
+    void processBatch(const std::vector<MarketEvent>& events);
+    
+    // Shard event loop; stages may register timers on it before start() or
+    // from the shard thread
+    EventLoop& getEventLoop() { return event_loop_; }
+    
+    // Shard scheduler for funding times, expiries and other deadlines. Driven
+    // by the shard loop while running (a one-shot timer for the next
+    // deadline); call advanceTimers() otherwise.
+    TimingWheel& getTimingWheel() { return timing_wheel_; }
+    void advanceTimers(Timestamp now);
+    
+    // Instrument -> synthetic/detector dependencies. Book updates mark their
+    // consumers dirty; the graph is flushed after each event batch (or after
+    // each event processed outside a batch).
+    DependencyGraph& getDependencyGraph() { return dependency_graph_; }
+    
+    // Shard-local state (only valid from the shard's own thread)
+    const OrderBook* getOrderBook(const InstrumentId& instrument_id) const;
+    const FundingRate* getFundingRate(const InstrumentId& instrument_id) const;
+    const FundingHistoryStore& getFundingHistory() const { return funding_history_; }
+    // Per-instrument confidence features, updated before dispatch
+    ConfidenceScorer& getConfidenceScorer() { return confidence_scorer_; }
+    // Size an opportunity against the full depth of its legs' books (leg
+    // weights as in DepthSizer::sizeOpportunity); false (unchanged) if a leg
+    // is not on this shard or no size clears the edge
+    DepthSizer& getDepthSizer() { return depth_sizer_; }
+    bool sizeOpportunity(ArbitrageOpportunity& opportunity, const double* weights = nullptr);
+    const Instrument* getInstrument(const InstrumentId& instrument_id) const;
+    const std::vector<Instrument>& getInstruments() const { return instruments_; }
+    // Stamp the input ages of an opportunity's legs; false (counted against
+    // the venue) if one is over the latency budget
+    LatencyBudget& getLatencyBudget() { return latency_budget_; }
+    bool admitOpportunity(ArbitrageOpportunity& opportunity);
+    // Queue an admitted opportunity for the merger
+    void emitOpportunity(ArbitrageOpportunity opportunity);
+    // A detector's candidate: checked against the latency budget first, so a
+    // stale one costs no scoring or depth walk, then scored on its legs'
+    // books and, for emitSized, sized before it is queued; false if it was
+    // dropped at any step
+    bool emitScored(ArbitrageOpportunity opportunity);
+    bool emitSized(ArbitrageOpportunity opportunity, const double* weights = nullptr);
+    
+    // Statistics
+    size_t getShardId() const { return shard_id_; }
+    uint64_t getEventsProcessed() const;
+    size_t getQueueDepth() const;
+    uint64_t getConflatedUpdates() const;
+    bool isRunning() const { return running_; }
+
+private:
+    void processingLoop();
+    void drainQueue();
+    void armTimer();
+    void publishTopOfBook(const OrderBook& book, const MarketEvent& event);
+    void dispatch(const MarketEvent& event);
+    void flushDependencies();
+    void publishOpportunities();
+    void scheduleFundingTime(const FundingRate& funding);
+    void expireInstrument(const InstrumentId& instrument_id);
+    
+    size_t shard_id_;
+    OpportunityMerger* merger_;
+    std::vector<EventHandler> handlers_;
+    
+    // Shard-local market state
+    std::unordered_map<InstrumentId, OrderBook> books_;
+    std::unordered_map<InstrumentId, FundingRate> funding_rates_;
+    FundingHistoryStore funding_history_;  // Per (perp, venue), recorded before dispatch
+    ConfidenceScorer confidence_scorer_;
+    DepthSizer depth_sizer_;
+    LatencyBudget latency_budget_;
+    std::unordered_map<InstrumentId, InputTimes> input_times_;  // Of the latest book per instrument
+    std::vector<InputTimes> leg_times_;                          // Emission scratch
+    std::unordered_map<InstrumentId, TopOfBook> last_tops_;
+    std::vector<Instrument> instruments_;  // Assignment order
+    std::unordered_map<InstrumentId, size_t> instrument_index_;
+    std::vector<ArbitrageOpportunity> pending_opportunities_;
+    
+    // Inbound queue; producers signal the wakeup only on empty -> non-empty
+    ConflatingEventQueue queue_;
+    std::vector<MarketEvent> batch_;
+    EventLoop event_loop_;
+    EventLoop::SourceId wakeup_id_{0};
+    
+    // Incremental recomputation
+    DependencyGraph dependency_graph_;
+    bool in_batch_{false};
+    
+    // Scheduled events
+    TimingWheel timing_wheel_;
+    EventLoop::SourceId wheel_timer_id_{0};
+    Timestamp armed_deadline_;  // Unset while the timer is disarmed
+    std::unordered_map<InstrumentId, TimingWheel::TimerHandle> funding_timers_;
+    std::unordered_map<InstrumentId, TimingWheel::TimerHandle> expiry_timers_;
+    
+    std::atomic<bool> running_{false};
+    std::unique_ptr<std::thread> thread_;
+    int cpu_core_{-1};
+    std::atomic<uint64_t> events_processed_{0};
+};
+
+} // namespace arbitrage
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "types.hpp"
+#include "synthetic_kernels.hpp"
+#include "dependency_graph.hpp"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace arbitrage {
+
+// Evaluates configured synthetic constructions. Each definition is bound to
+// a kernel when it is added: the common shapes (2-leg spot/perp, 3-leg
+// triangular, 4-leg box) get a kernel specialized for their leg count and
+// sign pattern, anything else runs the generic weighted-sum loop. Leg prices
+// live in one table shared by all constructions, so a synthetic costs one
+// indirect call plus its legs' loads. Single-threaded: one engine per shard.
+class SyntheticConstructionEngine {
+public:
+    SyntheticConstructionEngine() = default;
+    
+    // Validate a definition and select its kernel; false (nothing added) if
+    // the legs do not fit the shape
+    bool add(const SyntheticDefinition& definition);
+    
+    // Leg input; takes effect on the next evaluate
+    void updatePrice(const InstrumentId& instrument_id, Price price);
+    
+    // Evaluate one / every construction; NaN until all legs have a price
+    double evaluate(size_t index, Timestamp now);
+    void evaluateAll(Timestamp now);
+    
+    // One graph node per construction, fed by its legs. From then on book
+    // updates only store mids and the graph evaluates each affected
+    // construction once per event batch. Returns the number of nodes added.
+    size_t registerDependencies(DependencyGraph& graph);
+    DependencyGraph::NodeId getGraphNode(size_t index) const { return graph_nodes_[index]; }
+    
+    // Apply a shard event; returns true if any construction was evaluated
+    bool onMarketEvent(const MarketEvent& event, Timestamp now);
+    
+    // Runtime view of a construction; false if unknown or not yet priced
+    bool getSyntheticPrice(const std::string& synthetic_id, SyntheticPrice& out) const;
+    
+    // Accessors
+    size_t size() const { return definitions_.size(); }
+    bool find(const std::string& synthetic_id, size_t& index) const;
+    const SyntheticDefinition& getDefinition(size_t index) const { return definitions_[index]; }
+    bool isSpecialized(size_t index) const { return specialized_[index] != 0; }
+    double getValue(size_t index) const { return value_[index]; }
+    size_t getSpecializedCount() const;
+
+private:
+    uint32_t priceSlot(const InstrumentId& instrument_id);
+    
+    // Construction metadata; legs and weights are flattened
+    std::vector<SyntheticDefinition> definitions_;
+    std::vector<ConstructionKernel> kernel_;
+    std::vector<uint8_t> specialized_;
+    std::vector<uint32_t> leg_offset_;
+    std::vector<uint32_t> leg_count_;
+    std::vector<uint32_t> leg_slots_;
+    std::vector<double> leg_weights_;
+    std::unordered_map<std::string, size_t> definition_index_;
+    
+    // Outputs
+    std::vector<double> value_;
+    std::vector<Timestamp> calculation_time_;
+    
+    // Leg price table
+    std::vector<double> prices_;
+    std::unordered_map<InstrumentId, uint32_t> price_slots_;
+    std::vector<std::vector<size_t>> slot_dependents_;
+    
+    std::vector<DependencyGraph::NodeId> graph_nodes_;  // Empty unless graph-driven
+};
+
+} // namespace arbitrage
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "types.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace arbitrage {
+
+// Construction kernels: evaluate one synthetic from the shared leg price
+// table. prices[slots[i]] is leg i's price and weights[i] its multiplier
+// (magnitude only for the specialized kernels; their signs are template
+// parameters).
+using ConstructionKernel = double (*)(const double* prices, const uint32_t* slots,
+                                      const double* weights, size_t legs);
+
+namespace kernels {
+
+constexpr double legSign(unsigned negative_mask, size_t leg) {
+    return (negative_mask >> leg) & 1u ? -1.0 : 1.0;
+}
+
+template <unsigned InverseMask, size_t Leg>
+inline double legFactor(double price) {
+    if constexpr (((InverseMask >> Leg) & 1u) != 0) {
+        return 1.0 / price;
+    } else {
+        return price;
+    }
+}
+
+template <unsigned NegativeMask, size_t... Leg>
+inline double signedSum(const double* prices, const uint32_t* slots, const double* weights,
+                        std::index_sequence<Leg...>) {
+    return ((legSign(NegativeMask, Leg) * weights[Leg] * prices[slots[Leg]]) + ...);
+}
+
+template <unsigned InverseMask, size_t... Leg>
+inline double product(const double* prices, const uint32_t* slots, std::index_sequence<Leg...>) {
+    return (legFactor<InverseMask, Leg>(prices[slots[Leg]]) * ...);
+}
+
+// Leg count and sign pattern fixed at compile time: the sum unrolls into a
+// straight chain of multiply-adds/subtracts with no loop or branch
+template <size_t Legs, unsigned NegativeMask>
+struct LinearKernel {
+    static double evaluate(const double* prices, const uint32_t* slots, const double* weights, size_t) {
+        return signedSum<NegativeMask>(prices, slots, weights, std::make_index_sequence<Legs>());
+    }
+};
+
+// Product of leg prices, inverting the legs in InverseMask (weights unused)
+template <size_t Legs, unsigned InverseMask>
+struct ProductKernel {
+    static double evaluate(const double* prices, const uint32_t* slots, const double*, size_t) {
+        return product<InverseMask>(prices, slots, std::make_index_sequence<Legs>());
+    }
+};
+
+// Runtime path for any other shape; weights are signed
+inline double genericLinear(const double* prices, const uint32_t* slots, const double* weights, size_t legs) {
+    double value = 0.0;
+    for (size_t leg = 0; leg < legs; ++leg) {
+        value += weights[leg] * prices[slots[leg]];
+    }
+    return value;
+}
+
+// One instantiation per sign pattern, indexed by the pattern's bit mask
+template <size_t Legs, size_t... Mask>
+constexpr std::array<ConstructionKernel, sizeof...(Mask)> linearTable(std::index_sequence<Mask...>) {
+    return {&LinearKernel<Legs, static_cast<unsigned>(Mask)>::evaluate...};
+}
+
+template <size_t Legs, size_t... Mask>
+constexpr std::array<ConstructionKernel, sizeof...(Mask)> productTable(std::index_sequence<Mask...>) {
+    return {&ProductKernel<Legs, static_cast<unsigned>(Mask)>::evaluate...};
+}
+
+inline constexpr auto kSpotPerpKernels = linearTable<2>(std::make_index_sequence<4>());
+inline constexpr auto kTriangularKernels = productTable<3>(std::make_index_sequence<8>());
+inline constexpr auto kBoxKernels = linearTable<4>(std::make_index_sequence<16>());
+
+} // namespace kernels
+
+// Leg count of a specialized shape (0 for GENERIC)
+constexpr size_t constructionLegCount(ConstructionShape shape) {
+    switch (shape) {
+        case ConstructionShape::SPOT_PERP: return 2;
+        case ConstructionShape::TRIANGULAR: return 3;
+        case ConstructionShape::BOX: return 4;
+        default: return 0;
+    }
+}
+
+} // namespace arbitrage
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <thread>
+
+namespace arbitrage {
+
+// Pin a thread to a single CPU core (core index is taken modulo the number of
+// online cores). Returns false if the affinity could not be set.
+bool pinThreadToCore(std::thread& thread, int cpu_core);
+
+} // namespace arbitrage
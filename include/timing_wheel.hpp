@@ -0,0 +1,108 @@
+#pragma once
+
+#include "types.hpp"
+#include "engine_clock.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace arbitrage {
+
+// Hierarchical timing wheel (4 levels x 256 slots) for large numbers of
+// scheduled events such as funding snapshots, opportunity and instrument
+// expiries and reconnect backoff. Insert and cancel are O(1); advancing skips
+// empty stretches using per-level occupancy bitmaps, so the cost of a tick
+// depends on the timers that fire, not on how many are scheduled.
+//
+// The wheel has no clock of its own: the owner drives it with advance(now)
+// from the engine clock. Not thread-safe; each thread owns its own wheel.
+class TimingWheel {
+public:
+    using Callback = std::function<void()>;
+    using TimerHandle = uint64_t;  // 0 means "invalid"
+    
+    explicit TimingWheel(std::chrono::nanoseconds resolution = std::chrono::milliseconds(1),
+                         Timestamp start_time = getEngineTimestamp());
+    
+    TimingWheel(const TimingWheel&) = delete;
+    TimingWheel& operator=(const TimingWheel&) = delete;
+    
+    // Schedule a callback; deadlines at or before now() fire on the next advance()
+    TimerHandle scheduleAt(Timestamp deadline, Callback callback);
+    TimerHandle scheduleAfter(std::chrono::nanoseconds delay, Callback callback);
+    
+    // Returns false for unknown, fired or already cancelled handles
+    bool cancel(TimerHandle handle);
+    
+    // Fire every timer due at or before now; returns the number fired.
+    // Callbacks may schedule and cancel timers but must not call advance().
+    size_t advance(Timestamp now);
+    
+    // Earliest time at which advance() has work (a timer firing or a
+    // higher-level slot cascading); false if nothing is scheduled. Owners
+    // arm a one-shot timer for it instead of ticking at the resolution.
+    bool nextDeadline(Timestamp& deadline) const;
+    
+    // Accessors
+    Timestamp now() const { return current_time_; }
+    size_t size() const { return active_count_; }
+    bool empty() const { return active_count_ == 0; }
+    std::chrono::nanoseconds getResolution() const { return resolution_; }
+
+private:
+    static constexpr int kLevels = 4;
+    static constexpr int kSlotBits = 8;
+    static constexpr uint32_t kSlots = 1u << kSlotBits;
+    static constexpr uint32_t kSlotMask = kSlots - 1;
+    static constexpr uint32_t kNil = UINT32_MAX;
+    static constexpr uint8_t kDueLevel = 0xFF;
+    
+    struct Node {
+        Callback callback;
+        uint64_t expiry_tick = 0;
+        uint32_t next = kNil;
+        uint32_t prev = kNil;
+        uint32_t generation = 0;
+        uint8_t level = 0;
+        uint8_t slot = 0;
+        bool active = false;
+    };
+    
+    struct Level {
+        std::array<uint32_t, kSlots> heads;
+        std::array<uint32_t, kSlots> tails;
+        std::array<uint64_t, kSlots / 64> occupied;
+    };
+    
+    uint64_t toTick(Timestamp time) const;
+    uint32_t allocateNode();
+    void releaseNode(uint32_t index);
+    void place(uint32_t index);
+    void link(uint32_t index, int level, uint32_t slot);
+    void unlink(uint32_t index);
+    void cascade(int level, uint32_t slot);
+    size_t fireSlot(uint32_t slot);
+    size_t fireDue();
+    int nextOccupiedSlot(int level, uint32_t from) const;
+    uint64_t nextEventTick() const;
+    
+    static TimerHandle makeHandle(uint32_t index, uint32_t generation) {
+        return (static_cast<uint64_t>(generation) << 32) | (static_cast<uint64_t>(index) + 1);
+    }
+    
+    std::chrono::nanoseconds resolution_;
+    Timestamp origin_;
+    Timestamp current_time_;
+    uint64_t current_tick_ = 0;
+    size_t active_count_ = 0;
+    
+    std::array<Level, kLevels> levels_;
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> free_nodes_;
+    std::vector<uint32_t> due_;
+    std::vector<uint32_t> firing_;
+};
+
+} // namespace arbitrage
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <map>
@@ -53,6 +54,31 @@ enum class ArbitrageType {
     UNKNOWN
 };
 
+// Where an opportunity was detected: a strategy shard's local detectors or
+// the merger's cross-shard ones
+enum class DetectionStage {
+    SHARD,
+    MERGER,
+    UNKNOWN
+};
+
+// Leg shapes with compile-time specialized construction kernels
+enum class ConstructionShape {
+    SPOT_PERP,   // 2 legs, signed weighted sum (e.g. perp - spot basis)
+    TRIANGULAR,  // 3 legs, product of prices or their inverses (cycle rate)
+    BOX,         // 4 legs, signed weighted sum (e.g. option box)
+    GENERIC      // Any leg count, runtime weighted sum
+};
+
+enum class MarketEventType {
+    BOOK_UPDATE,
+    TRADE,
+    FUNDING_RATE,
+    FUNDING_TIME,       // Scheduled: funding snapshot reached
+    INSTRUMENT_EXPIRY,  // Scheduled: future/option expired
+    UNKNOWN
+};
+
 enum class OrderBookLevel {
     L1,  // Best bid/ask
     L2,  // Full order book
@@ -122,6 +148,39 @@ struct FundingRate {
     FundingRate() : current_rate(0.0), predicted_rate(0.0) {}
 };
 
+// Normalized market data event as delivered to the strategy stage
+struct MarketEvent {
+    MarketEventType type;
+    InstrumentId instrument_id;
+    ExchangeId exchange_id;
+    uint64_t sequence;
+    uint64_t first_sequence;     // Earliest sequence folded into this event
+    uint32_t conflated_updates;  // Book updates merged into this one
+    Timestamp exchange_time;
+    Timestamp receive_time;
+    OrderBook book;        // BOOK_UPDATE
+    Trade trade;           // TRADE
+    FundingRate funding;   // FUNDING_RATE
+    
+    MarketEvent() : type(MarketEventType::UNKNOWN), sequence(0), first_sequence(0), conflated_updates(0) {}
+};
+
+// Best bid/ask snapshot published across shard boundaries
+struct TopOfBook {
+    InstrumentId instrument_id;
+    ExchangeId exchange_id;
+    Price bid_price;
+    Price ask_price;
+    Volume bid_volume;
+    Volume ask_volume;
+    Timestamp timestamp;
+    Timestamp exchange_time;  // Of the book update behind this top (unset if unknown)
+    Timestamp receive_time;
+    size_t shard_id;
+    
+    TopOfBook() : bid_price(0.0), ask_price(0.0), bid_volume(0.0), ask_volume(0.0), shard_id(0) {}
+};
+
 struct Instrument {
     InstrumentId id;
     std::string symbol;
@@ -154,6 +213,7 @@ struct SyntheticPrice {
 
 struct ArbitrageOpportunity {
     std::string opportunity_id;
+    uint64_t opportunity_key;  // Hash of type and legs, set by the merger (0 until then)
     ArbitrageType type;
     std::vector<InstrumentId> leg_instruments;
     std::vector<Exchange> leg_exchanges;
@@ -163,13 +223,19 @@ struct ArbitrageOpportunity {
     Price expected_profit;
     Price expected_profit_percentage;
     double risk_score;
-    double confidence_score;
+    double confidence_score;  // Weakest leg's book confidence; set on shard reports only (0 from the merger)
     Timestamp detection_time;
     Timestamp expiry_time;
+    // Age of the oldest input leg at detection, by the venue's clock and by
+    // ours (zero when no leg carried that timestamp)
+    std::chrono::nanoseconds exchange_age;
+    std::chrono::nanoseconds receive_age;
     bool is_active;
+    bool reannounce;  // Publish even if the same legs are already open (scheduled re-reports)
     
-    ArbitrageOpportunity() : expected_profit(0.0), expected_profit_percentage(0.0),
-                            risk_score(0.0), confidence_score(0.0), is_active(false) {}
+    ArbitrageOpportunity() : opportunity_key(0), expected_profit(0.0), expected_profit_percentage(0.0),
+                            risk_score(0.0), confidence_score(0.0), exchange_age(0), receive_age(0),
+                            is_active(false), reannounce(false) {}
 };
 
 struct RiskMetrics {
@@ -190,6 +256,8 @@ struct PerformanceMetrics {
     uint64_t messages_processed{0};
     uint64_t opportunities_detected{0};
     uint64_t trades_executed{0};
+    uint64_t conflated_updates{0};
+    uint64_t stale_rejections{0};
     double average_latency_ms{0.0};
     double max_latency_ms{0.0};
     double memory_usage_mb{0.0};
@@ -200,6 +268,8 @@ struct PerformanceMetrics {
         messages_processed = 0;
         opportunities_detected = 0;
         trades_executed = 0;
+        conflated_updates = 0;
+        stale_rejections = 0;
         average_latency_ms = 0.0;
         max_latency_ms = 0.0;
         memory_usage_mb = 0.0;
@@ -211,6 +281,8 @@ struct AtomicPerformanceMetrics {
     std::atomic<uint64_t> messages_processed{0};
     std::atomic<uint64_t> opportunities_detected{0};
     std::atomic<uint64_t> trades_executed{0};
+    std::atomic<uint64_t> conflated_updates{0};
+    std::atomic<uint64_t> stale_rejections{0};
     std::atomic<double> average_latency_ms{0.0};
     std::atomic<double> max_latency_ms{0.0};
     std::atomic<double> memory_usage_mb{0.0};
@@ -221,6 +293,8 @@ struct AtomicPerformanceMetrics {
         messages_processed = 0;
         opportunities_detected = 0;
         trades_executed = 0;
+        conflated_updates = 0;
+        stale_rejections = 0;
         average_latency_ms = 0.0;
         max_latency_ms = 0.0;
         memory_usage_mb = 0.0;
@@ -228,6 +302,18 @@ struct AtomicPerformanceMetrics {
     }
 };
 
+// Synthetic instrument built from legs, as configured. Weights carry the
+// sign pattern (and, for sums, the leg multipliers); triangular legs use
+// +1 for the price and -1 for its inverse.
+struct SyntheticDefinition {
+    std::string id;
+    ConstructionShape shape;
+    std::vector<InstrumentId> legs;
+    std::vector<double> weights;
+    
+    SyntheticDefinition() : shape(ConstructionShape::GENERIC) {}
+};
+
 // Configuration structures
 struct ExchangeConfig {
     bool enabled;
@@ -252,6 +338,12 @@ struct ArbitrageConfig {
     double max_leverage;
     double stop_loss_percentage;
     double take_profit_percentage;
+    double liquidity_threshold;  // Per-side book notional for full confidence
+    double correlation_threshold;  // Minimum |correlation| for a statistical pair to signal
+    double funding_rate_threshold;  // Minimum cross-venue funding spread per window
+    double basis_spread_threshold;  // Minimum |basis| / fair value for a basis anomaly
+    std::map<std::string, double> carry_rates;  // Annual carry rate per quote asset for dated futures
+    std::vector<SyntheticDefinition> constructions;
 };
 
 struct SystemConfig {
@@ -282,6 +374,14 @@ inline Exchange stringToExchange(const std::string& str) {
     return Exchange::UNKNOWN;
 }
 
+inline std::string detectionStageToString(DetectionStage stage) {
+    switch (stage) {
+        case DetectionStage::SHARD: return "SHARD";
+        case DetectionStage::MERGER: return "MERGER";
+        default: return "UNKNOWN";
+    }
+}
+
 inline std::string instrumentTypeToString(InstrumentType type) {
     switch (type) {
         case InstrumentType::SPOT: return "SPOT";
@@ -300,6 +400,42 @@ inline InstrumentType stringToInstrumentType(const std::string& str) {
     return InstrumentType::UNKNOWN;
 }
 
+inline std::string constructionShapeToString(ConstructionShape shape) {
+    switch (shape) {
+        case ConstructionShape::SPOT_PERP: return "SPOT_PERP";
+        case ConstructionShape::TRIANGULAR: return "TRIANGULAR";
+        case ConstructionShape::BOX: return "BOX";
+        default: return "GENERIC";
+    }
+}
+
+inline ConstructionShape stringToConstructionShape(const std::string& str) {
+    if (str == "SPOT_PERP") return ConstructionShape::SPOT_PERP;
+    if (str == "TRIANGULAR") return ConstructionShape::TRIANGULAR;
+    if (str == "BOX") return ConstructionShape::BOX;
+    return ConstructionShape::GENERIC;
+}
+
+inline std::string marketEventTypeToString(MarketEventType type) {
+    switch (type) {
+        case MarketEventType::BOOK_UPDATE: return "BOOK_UPDATE";
+        case MarketEventType::TRADE: return "TRADE";
+        case MarketEventType::FUNDING_RATE: return "FUNDING_RATE";
+        case MarketEventType::FUNDING_TIME: return "FUNDING_TIME";
+        case MarketEventType::INSTRUMENT_EXPIRY: return "INSTRUMENT_EXPIRY";
+        default: return "UNKNOWN";
+    }
+}
+
+inline MarketEventType stringToMarketEventType(const std::string& str) {
+    if (str == "BOOK_UPDATE") return MarketEventType::BOOK_UPDATE;
+    if (str == "TRADE") return MarketEventType::TRADE;
+    if (str == "FUNDING_RATE") return MarketEventType::FUNDING_RATE;
+    if (str == "FUNDING_TIME") return MarketEventType::FUNDING_TIME;
+    if (str == "INSTRUMENT_EXPIRY") return MarketEventType::INSTRUMENT_EXPIRY;
+    return MarketEventType::UNKNOWN;
+}
+
 inline Timestamp getCurrentTimestamp() {
     return std::chrono::high_resolution_clock::now();
 }
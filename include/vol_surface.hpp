@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace arbitrage {
+
+// Raw SVI smile in total implied variance w = vol^2 * T against log-moneyness
+// k = ln(strike / forward):
+//   w(k) = a + b * (rho * (k - m) + sqrt((k - m)^2 + sigma^2))
+struct SviParams {
+    double a = 0.0;
+    double b = 0.1;
+    double rho = 0.0;
+    double m = 0.0;
+    double sigma = 0.1;
+    
+    double totalVariance(double k) const;
+};
+
+struct VolSurfaceConfig {
+    double vol_tolerance = 0.0005;       // Quote move (absolute vol) that triggers a refit
+    double forward_tolerance = 0.0005;   // Relative forward move that triggers a refit
+    int max_fit_iterations = 50;
+    double max_years = 4.0;              // Span of the expiry lookup table
+    size_t time_buckets = 4096;
+};
+
+struct VolSurfaceStats {
+    uint64_t refits = 0;          // Slices refit
+    uint64_t clean_skips = 0;     // Slices left alone by refit() because nothing moved
+    uint64_t fit_iterations = 0;  // Levenberg-Marquardt iterations over all refits
+    double last_rmse = 0.0;       // Vol RMSE of the most recent slice fit
+};
+
+// Volatility surface built from one SVI fit per expiry slice.
+//
+// Quote and forward updates only mark their slice dirty when they move beyond
+// the configured tolerance; refit() then fits just the dirty slices, warm
+// starting Levenberg-Marquardt from the slice's previous parameters, so an
+// underlying tick that leaves most of the surface alone costs almost nothing.
+// Lookups evaluate the SVI closed form and locate expiries through a bucketed
+// time table, so getVolatility() is O(1) for any strike and expiry. Between
+// slices total variance is interpolated linearly in time; outside them vol is
+// held flat. Single-threaded: one surface per shard.
+class VolatilitySurface {
+public:
+    VolatilitySurface() : VolatilitySurface(VolSurfaceConfig()) {}
+    explicit VolatilitySurface(const VolSurfaceConfig& config);
+    
+    // Slices; returns the slice index
+    size_t addExpiry(double years, double forward);
+    void setTimeToExpiry(size_t slice, double years);
+    void setForward(size_t slice, double forward);
+    
+    // Quotes; returns the quote index within the slice. NaN vols (e.g. from
+    // out-of-bounds solves) are excluded from the fit.
+    size_t addQuote(size_t slice, double strike, double vol, double weight = 1.0);
+    void updateQuote(size_t slice, size_t quote, double vol);
+    
+    // Refit dirty slices only; returns how many were refit
+    size_t refit();
+    
+    // Lookups
+    double getVolatility(double strike, double years) const;
+    double getSliceVolatility(size_t slice, double strike) const;
+    
+    // Accessors
+    size_t size() const { return slices_.size(); }
+    bool isDirty(size_t slice) const { return slices_[slice].dirty; }
+    const SviParams& getParams(size_t slice) const { return slices_[slice].params; }
+    double getTimeToExpiry(size_t slice) const { return slices_[slice].years; }
+    double getForward(size_t slice) const { return slices_[slice].forward; }
+    const VolSurfaceStats& getStats() const { return stats_; }
+
+private:
+    struct Slice {
+        double years = 0.0;
+        double forward = 0.0;
+        double fitted_forward = 0.0;
+        double fitted_years = 0.0;
+        SviParams params;
+        bool fitted = false;
+        bool dirty = true;
+        
+        // Quotes (SoA); fitted_vol is the quote as of the last fit
+        std::vector<double> strike;
+        std::vector<double> vol;
+        std::vector<double> weight;
+        std::vector<double> fitted_vol;
+    };
+    
+    void fitSlice(Slice& slice);
+    void rebuildTimeIndex();
+    double sliceTotalVariance(size_t slice, double strike) const;
+    
+    VolSurfaceConfig config_;
+    VolSurfaceStats stats_;
+    std::vector<Slice> slices_;
+    
+    // Slices ordered by expiry, and bucket -> last ordered position at or
+    // before the bucket start
+    std::vector<size_t> order_;
+    std::vector<uint32_t> time_index_;
+    double bucket_years_ = 0.0;
+    
+    // Fit scratch, reused so refits do not allocate
+    std::vector<double> fit_k_;
+    std::vector<double> fit_w_;
+    std::vector<double> fit_weight_;
+};
+
+} // namespace arbitrage
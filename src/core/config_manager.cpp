@@ -1,10 +1,37 @@
 #include "config_manager.hpp"
+#include "engine_clock.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <ctime>
 #include <fstream>
 #include <iostream>
 #include <stdexcept>
 
 namespace arbitrage {
 
+namespace {
+
+// Contract expiry as "YYYY-MM-DD" or "YYYY-MM-DDTHH:MM:SSZ" (UTC)
+Timestamp parseExpiry(const std::string& text) {
+    std::tm tm{};
+    int date_length = 0, time_length = 0;
+    bool valid = std::sscanf(text.c_str(), "%4d-%2d-%2d%n", &tm.tm_year, &tm.tm_mon, &tm.tm_mday, &date_length) == 3;
+    if (valid && static_cast<size_t>(date_length) != text.size()) {
+        valid = std::sscanf(text.c_str() + date_length, "T%2d:%2d:%2dZ%n", &tm.tm_hour, &tm.tm_min, &tm.tm_sec,
+                            &time_length) == 3 &&
+                static_cast<size_t>(date_length + time_length) == text.size();
+    }
+    if (!valid) {
+        throw std::runtime_error("Invalid expiry: " + text);
+    }
+    tm.tm_year -= 1900;
+    tm.tm_mon -= 1;
+    return Timestamp(std::chrono::seconds(timegm(&tm)));
+}
+
+} // namespace
+
 ConfigManager& ConfigManager::getInstance() {
     static ConfigManager instance;
     return instance;
@@ -23,6 +50,10 @@ bool ConfigManager::loadConfig(const std::string& config_file) {
         nlohmann::json json;
         file >> json;
         
+        // Start from a clean slate so reloads don't accumulate entries
+        system_config_.exchanges.clear();
+        system_config_.instruments.clear();
+        
         // Parse configuration sections
         parseSystemConfig(json["system"]);
         parseExchangeConfig(json["exchanges"]);
@@ -91,9 +122,13 @@ std::vector<Instrument> ConfigManager::getEnabledInstruments() const {
         throw std::runtime_error("Configuration not loaded");
     }
     
+    // A replay sets the engine clock first, so its contracts are judged at
+    // the recorded time
+    const Timestamp now = getEngineTimestamp();
     std::vector<Instrument> enabled_instruments;
     for (const auto& instrument : system_config_.instruments) {
-        if (instrument.is_active) {
+        bool expired = instrument.expiry_time.time_since_epoch().count() != 0 && instrument.expiry_time <= now;
+        if (instrument.is_active && !expired) {
             enabled_instruments.push_back(instrument);
         }
     }
@@ -176,6 +211,16 @@ bool ConfigManager::validateConfiguration() const {
                 std::cerr << "Invalid tick size for instrument: " << instrument.symbol << std::endl;
                 return false;
             }
+            bool dated = instrument.type == InstrumentType::FUTURES || instrument.type == InstrumentType::OPTION;
+            if (dated && instrument.expiry_time.time_since_epoch().count() == 0) {
+                std::cerr << "Expiry not specified for instrument: " << instrument.symbol << std::endl;
+                return false;
+            }
+            // Not fatal: a replay may still trade it, and live runs skip it
+            if (dated && instrument.expiry_time <= getEngineTimestamp()) {
+                std::cerr << "Warning: instrument " << instrument.symbol
+                          << " has expired and will be skipped; roll it in the configuration" << std::endl;
+            }
         }
     }
     
@@ -195,6 +240,39 @@ bool ConfigManager::validateConfiguration() const {
         return false;
     }
     
+    if (system_config_.arbitrage.confidence_threshold < 0 || system_config_.arbitrage.confidence_threshold > 1) {
+        std::cerr << "Invalid confidence threshold" << std::endl;
+        return false;
+    }
+    
+    if (system_config_.arbitrage.correlation_threshold < 0 || system_config_.arbitrage.correlation_threshold > 1) {
+        std::cerr << "Invalid correlation threshold" << std::endl;
+        return false;
+    }
+    
+    if (system_config_.arbitrage.funding_rate_threshold < 0) {
+        std::cerr << "Invalid funding rate threshold" << std::endl;
+        return false;
+    }
+    
+    if (system_config_.arbitrage.basis_spread_threshold < 0) {
+        std::cerr << "Invalid basis spread threshold" << std::endl;
+        return false;
+    }
+    
+    if (system_config_.arbitrage.max_latency_ms < 0) {
+        std::cerr << "Invalid maximum latency" << std::endl;
+        return false;
+    }
+    
+    for (const auto& construction : system_config_.arbitrage.constructions) {
+        if (construction.id.empty() || construction.legs.empty() ||
+            construction.weights.size() != construction.legs.size()) {
+            std::cerr << "Invalid synthetic construction: " << construction.id << std::endl;
+            return false;
+        }
+    }
+    
     return true;
 }
 
@@ -254,11 +332,18 @@ void ConfigManager::parseInstrumentConfig(const nlohmann::json& json) {
             instrument.symbol = deriv_json.value("symbol", "");
             instrument.base_asset = deriv_json.value("underlying", "");
             instrument.quote_asset = deriv_json.value("quote", "");
-            instrument.type = stringToInstrumentType(deriv_json.value("type", ""));
+            // Config uses lowercase type names (e.g. "perpetual_swap")
+            std::string type_str = deriv_json.value("type", "");
+            std::transform(type_str.begin(), type_str.end(), type_str.begin(),
+                           [](unsigned char c) { return std::toupper(c); });
+            instrument.type = stringToInstrumentType(type_str);
             instrument.is_active = deriv_json.value("enabled", false);
             instrument.contract_size = deriv_json.value("contract_size", 1.0);
             instrument.tick_size = deriv_json.value("tick_size", 0.01);
             instrument.min_notional = 10.0;
+            if (deriv_json.contains("expiry")) {
+                instrument.expiry_time = parseExpiry(deriv_json["expiry"].get<std::string>());
+            }
             
             // Generate instrument ID
             instrument.id = instrument.symbol + "_" + instrumentTypeToString(instrument.type);
@@ -281,6 +366,33 @@ void ConfigManager::parseArbitrageConfig(const nlohmann::json& json) {
     system_config_.arbitrage.max_leverage = risk_mgmt.value("max_leverage", 10.0);
     system_config_.arbitrage.stop_loss_percentage = risk_mgmt.value("stop_loss_percentage", 0.02);
     system_config_.arbitrage.take_profit_percentage = risk_mgmt.value("take_profit_percentage", 0.01);
+    
+    const auto synthetic = json.value("synthetic_construction", nlohmann::json::object());
+    system_config_.arbitrage.liquidity_threshold = synthetic.value("liquidity_threshold", 10000.0);
+    system_config_.arbitrage.correlation_threshold = synthetic.value("correlation_threshold", 0.8);
+    system_config_.arbitrage.funding_rate_threshold = synthetic.value("funding_rate_threshold", 0.0001);
+    system_config_.arbitrage.basis_spread_threshold = synthetic.value("basis_spread_threshold", 0.001);
+    system_config_.arbitrage.carry_rates =
+        synthetic.value("carry_rates", std::map<std::string, double>());
+    
+    // Synthetic constructions; the kernel for each is selected from its shape
+    // when the strategy shards are configured
+    system_config_.arbitrage.constructions.clear();
+    if (synthetic.contains("constructions")) {
+        for (const auto& construction_json : synthetic["constructions"]) {
+            SyntheticDefinition definition;
+            definition.id = construction_json.value("id", "");
+            definition.legs = construction_json.value("legs", std::vector<InstrumentId>());
+            definition.weights = construction_json.value("weights", std::vector<double>(definition.legs.size(), 1.0));
+            
+            std::string shape_str = construction_json.value("shape", "generic");
+            std::transform(shape_str.begin(), shape_str.end(), shape_str.begin(),
+                           [](unsigned char c) { return std::toupper(c); });
+            definition.shape = stringToConstructionShape(shape_str);
+            
+            system_config_.arbitrage.constructions.push_back(definition);
+        }
+    }
 }
 
 } // namespace arbitrage
@@ -0,0 +1,58 @@
+#include "conflating_queue.hpp"
+
+namespace arbitrage {
+
+bool ConflatingEventQueue::push(MarketEvent event) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool was_empty = events_.empty();
+    
+    if (event.first_sequence == 0) {
+        event.first_sequence = event.sequence;
+    }
+    
+    if (event.type == MarketEventType::BOOK_UPDATE) {
+        auto it = pending_books_.find(event.instrument_id);
+        if (it != pending_books_.end()) {
+            // Merge into the queued update: newest book and timestamps, but
+            // the run still starts at the oldest sequence that was queued
+            MarketEvent& queued = events_[it->second];
+            event.first_sequence = queued.first_sequence;
+            event.conflated_updates += queued.conflated_updates + 1;
+            queued = std::move(event);
+            conflated_count_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        pending_books_.emplace(event.instrument_id, events_.size());
+    } else {
+        // A later book must not overtake this event: close the instrument's
+        // conflation window so its next book is appended after it
+        pending_books_.erase(event.instrument_id);
+    }
+    
+    events_.push_back(std::move(event));
+    return was_empty;
+}
+
+size_t ConflatingEventQueue::drain(std::vector<MarketEvent>& out) {
+    out.clear();
+    std::lock_guard<std::mutex> lock(mutex_);
+    out.swap(events_);
+    pending_books_.clear();
+    return out.size();
+}
+
+size_t ConflatingEventQueue::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return events_.size();
+}
+
+bool ConflatingEventQueue::empty() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return events_.empty();
+}
+
+uint64_t ConflatingEventQueue::getConflatedCount() const {
+    return conflated_count_.load(std::memory_order_relaxed);
+}
+
+} // namespace arbitrage
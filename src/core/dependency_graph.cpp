@@ -0,0 +1,142 @@
+#include "dependency_graph.hpp"
+#include <algorithm>
+
+namespace arbitrage {
+
+DependencyGraph::NodeId DependencyGraph::addNode(const std::string& name, RecomputeFn recompute) {
+    Node node;
+    node.name = name;
+    node.recompute = std::move(recompute);
+    nodes_.push_back(std::move(node));
+    if (dirty_by_rank_.empty()) {
+        dirty_by_rank_.emplace_back();
+    }
+    return static_cast<NodeId>(nodes_.size() - 1);
+}
+
+DependencyGraph::NodeId DependencyGraph::addSynthetic(const SyntheticPrice& synthetic, RecomputeFn recompute) {
+    NodeId node = addNode(synthetic.synthetic_instrument_id, std::move(recompute));
+    for (const auto& component : synthetic.component_instruments) {
+        addDependency(component, node);
+    }
+    return node;
+}
+
+void DependencyGraph::addDependency(const InstrumentId& instrument_id, NodeId node) {
+    auto& consumers = dependents_[instrument_id];
+    if (std::find(consumers.begin(), consumers.end(), node) == consumers.end()) {
+        consumers.push_back(node);
+    }
+}
+
+bool DependencyGraph::addNodeDependency(NodeId upstream, NodeId downstream) {
+    if (upstream == downstream || reaches(downstream, upstream)) {
+        return false;
+    }
+    
+    auto& edges = nodes_[upstream].downstream;
+    if (std::find(edges.begin(), edges.end(), downstream) == edges.end()) {
+        edges.push_back(downstream);
+    }
+    raiseRank(downstream, nodes_[upstream].rank + 1);
+    return true;
+}
+
+size_t DependencyGraph::markInstrumentDirty(const InstrumentId& instrument_id) {
+    auto it = dependents_.find(instrument_id);
+    if (it == dependents_.end()) {
+        return 0;
+    }
+    
+    size_t queued = 0;
+    for (NodeId node : it->second) {
+        queued += markDirty(node) ? 1 : 0;
+    }
+    return queued;
+}
+
+bool DependencyGraph::markDirty(NodeId node) {
+    Node& entry = nodes_[node];
+    if (entry.dirty) {
+        ++coalesced_count_;
+        return false;
+    }
+    
+    entry.dirty = true;
+    dirty_by_rank_[entry.rank].push_back(node);
+    ++pending_;
+    ++mark_count_;
+    return true;
+}
+
+size_t DependencyGraph::flush(Timestamp now) {
+    if (pending_ == 0) {
+        return 0;
+    }
+    ++flush_count_;
+    
+    // Recomputing a node can only queue nodes of a higher rank, so one pass
+    // over the ranks drains everything. Flags clear before the callback so a
+    // throwing node does not wedge the rest of the queue.
+    size_t recomputed = 0;
+    for (auto& bucket : dirty_by_rank_) {
+        for (size_t i = 0; i < bucket.size(); ++i) {
+            NodeId node = bucket[i];
+            Node& entry = nodes_[node];
+            entry.dirty = false;
+            --pending_;
+            
+            ++recompute_count_;
+            ++recomputed;
+            if (entry.recompute && entry.recompute(now)) {
+                for (NodeId next : nodes_[node].downstream) {
+                    markDirty(next);
+                }
+            }
+        }
+        bucket.clear();
+    }
+    return recomputed;
+}
+
+const std::vector<DependencyGraph::NodeId>& DependencyGraph::getDependents(const InstrumentId& instrument_id) const {
+    static const std::vector<NodeId> kEmpty;
+    auto it = dependents_.find(instrument_id);
+    return it == dependents_.end() ? kEmpty : it->second;
+}
+
+bool DependencyGraph::reaches(NodeId from, NodeId to) const {
+    std::vector<NodeId> stack = {from};
+    std::vector<bool> visited(nodes_.size(), false);
+    while (!stack.empty()) {
+        NodeId node = stack.back();
+        stack.pop_back();
+        if (node == to) {
+            return true;
+        }
+        if (visited[node]) {
+            continue;
+        }
+        visited[node] = true;
+        for (NodeId next : nodes_[node].downstream) {
+            stack.push_back(next);
+        }
+    }
+    return false;
+}
+
+void DependencyGraph::raiseRank(NodeId node, uint32_t rank) {
+    // Graph construction only; edges are acyclic so this terminates
+    if (nodes_[node].rank >= rank) {
+        return;
+    }
+    nodes_[node].rank = rank;
+    if (dirty_by_rank_.size() <= rank) {
+        dirty_by_rank_.resize(rank + 1);
+    }
+    for (NodeId next : nodes_[node].downstream) {
+        raiseRank(next, rank + 1);
+    }
+}
+
+} // namespace arbitrage
@@ -0,0 +1,27 @@
+#include "engine_clock.hpp"
+
+namespace arbitrage {
+
+EngineClock& EngineClock::getInstance() {
+    static EngineClock instance;
+    return instance;
+}
+
+void EngineClock::useSimulatedTime(Timestamp start_time) {
+    sim_time_ns_.store(start_time.time_since_epoch().count(), std::memory_order_relaxed);
+    simulated_.store(true, std::memory_order_release);
+}
+
+void EngineClock::useRealTime() {
+    simulated_.store(false, std::memory_order_release);
+}
+
+void EngineClock::advanceTo(Timestamp time) {
+    int64_t target = time.time_since_epoch().count();
+    int64_t current = sim_time_ns_.load(std::memory_order_relaxed);
+    while (target > current &&
+           !sim_time_ns_.compare_exchange_weak(current, target, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace arbitrage
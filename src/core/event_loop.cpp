@@ -0,0 +1,280 @@
+#include "event_loop.hpp"
+#include "logger.hpp"
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace arbitrage {
+
+namespace {
+
+constexpr int kMaxEventsPerWait = 64;
+constexpr uint64_t kStopSourceId = 0;
+
+itimerspec toTimerSpec(std::chrono::nanoseconds initial_delay, std::chrono::nanoseconds interval) {
+    // A zero it_value disarms a timerfd, so "fire now" becomes 1ns
+    if (initial_delay.count() <= 0) {
+        initial_delay = std::chrono::nanoseconds(1);
+    }
+    
+    itimerspec spec{};
+    spec.it_value.tv_sec = initial_delay.count() / 1000000000LL;
+    spec.it_value.tv_nsec = initial_delay.count() % 1000000000LL;
+    spec.it_interval.tv_sec = interval.count() / 1000000000LL;
+    spec.it_interval.tv_nsec = interval.count() % 1000000000LL;
+    return spec;
+}
+
+} // namespace
+
+EventLoop::EventLoop() {
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0) {
+        LOG_ERROR("epoll_create1 failed: {}", std::strerror(errno));
+        return;
+    }
+    
+    stop_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (stop_fd_ < 0) {
+        LOG_ERROR("eventfd failed: {}", std::strerror(errno));
+        return;
+    }
+    
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = kStopSourceId;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, stop_fd_, &ev);
+}
+
+EventLoop::~EventLoop() {
+    for (auto& [id, source] : sources_) {
+        if (source.active) {
+            close(source.fd);
+        }
+    }
+    if (stop_fd_ >= 0) {
+        close(stop_fd_);
+    }
+    if (epoll_fd_ >= 0) {
+        close(epoll_fd_);
+    }
+}
+
+EventLoop::SourceId EventLoop::addTimer(std::chrono::nanoseconds initial_delay,
+                                        std::chrono::nanoseconds interval, Callback callback) {
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd < 0) {
+        LOG_ERROR("timerfd_create failed: {}", std::strerror(errno));
+        return 0;
+    }
+    
+    itimerspec spec = toTimerSpec(initial_delay, interval);
+    if (timerfd_settime(fd, 0, &spec, nullptr) < 0) {
+        LOG_ERROR("timerfd_settime failed: {}", std::strerror(errno));
+        close(fd);
+        return 0;
+    }
+    
+    return addSource(SourceType::TIMER, fd, std::move(callback), nullptr);
+}
+
+bool EventLoop::rearmTimer(SourceId timer_id, std::chrono::nanoseconds initial_delay,
+                           std::chrono::nanoseconds interval) {
+    auto it = sources_.find(timer_id);
+    if (it == sources_.end() || !it->second.active || it->second.type != SourceType::TIMER) {
+        return false;
+    }
+    
+    itimerspec spec = toTimerSpec(initial_delay, interval);
+    return timerfd_settime(it->second.fd, 0, &spec, nullptr) == 0;
+}
+
+bool EventLoop::disarmTimer(SourceId timer_id) {
+    auto it = sources_.find(timer_id);
+    if (it == sources_.end() || !it->second.active || it->second.type != SourceType::TIMER) {
+        return false;
+    }
+    
+    itimerspec spec{};
+    return timerfd_settime(it->second.fd, 0, &spec, nullptr) == 0;
+}
+
+EventLoop::SourceId EventLoop::addWakeup(Callback callback) {
+    int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd < 0) {
+        LOG_ERROR("eventfd failed: {}", std::strerror(errno));
+        return 0;
+    }
+    
+    SourceId id = addSource(SourceType::WAKEUP, fd, std::move(callback), nullptr);
+    if (id != 0) {
+        wakeup_fds_[id] = fd;
+    }
+    return id;
+}
+
+void EventLoop::notify(SourceId wakeup_id) {
+    auto it = wakeup_fds_.find(wakeup_id);
+    if (it == wakeup_fds_.end()) {
+        return;
+    }
+    
+    uint64_t one = 1;
+    ssize_t rc = write(it->second, &one, sizeof(one));
+    (void)rc;  // EAGAIN only when the counter is saturated, i.e. already signalled
+}
+
+EventLoop::SourceId EventLoop::addSignalHandler(const std::vector<int>& signals,
+                                                SignalCallback callback) {
+    sigset_t mask;
+    sigemptyset(&mask);
+    for (int sig : signals) {
+        sigaddset(&mask, sig);
+    }
+    
+    int fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (fd < 0) {
+        LOG_ERROR("signalfd failed: {}", std::strerror(errno));
+        return 0;
+    }
+    
+    return addSource(SourceType::SIGNAL, fd, nullptr, std::move(callback));
+}
+
+bool EventLoop::blockSignals(const std::vector<int>& signals) {
+    sigset_t mask;
+    sigemptyset(&mask);
+    for (int sig : signals) {
+        sigaddset(&mask, sig);
+    }
+    // Threads created afterwards inherit the mask
+    return pthread_sigmask(SIG_BLOCK, &mask, nullptr) == 0;
+}
+
+bool EventLoop::remove(SourceId source_id) {
+    auto it = sources_.find(source_id);
+    if (it == sources_.end() || !it->second.active) {
+        return false;
+    }
+    
+    // Close now, erase after the current dispatch round so a callback can
+    // safely remove its own source
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, it->second.fd, nullptr);
+    close(it->second.fd);
+    it->second.active = false;
+    wakeup_fds_.erase(source_id);
+    pending_removal_.push_back(source_id);
+    return true;
+}
+
+void EventLoop::run() {
+    while (!stop_requested_) {
+        runOnce(-1);
+    }
+}
+
+size_t EventLoop::runOnce(int timeout_ms) {
+    if (!isValid()) {
+        return 0;
+    }
+    
+    epoll_event events[kMaxEventsPerWait];
+    int ready = epoll_wait(epoll_fd_, events, kMaxEventsPerWait, timeout_ms);
+    if (ready < 0) {
+        if (errno != EINTR) {
+            LOG_ERROR("epoll_wait failed: {}", std::strerror(errno));
+        }
+        return 0;
+    }
+    
+    size_t dispatched = 0;
+    for (int i = 0; i < ready; ++i) {
+        SourceId id = events[i].data.u64;
+        if (id == kStopSourceId) {
+            uint64_t value;
+            ssize_t rc = read(stop_fd_, &value, sizeof(value));
+            (void)rc;
+            continue;
+        }
+        
+        auto it = sources_.find(id);
+        if (it == sources_.end() || !it->second.active) {
+            continue;
+        }
+        
+        try {
+            dispatch(it->second);
+            ++dispatched;
+        } catch (const std::exception& e) {
+            LOG_ERROR("Exception in event loop callback: {}", e.what());
+        }
+    }
+    
+    for (SourceId id : pending_removal_) {
+        sources_.erase(id);
+    }
+    pending_removal_.clear();
+    
+    return dispatched;
+}
+
+void EventLoop::stop() {
+    stop_requested_ = true;
+    if (stop_fd_ >= 0) {
+        uint64_t one = 1;
+        ssize_t rc = write(stop_fd_, &one, sizeof(one));
+        (void)rc;
+    }
+}
+
+EventLoop::SourceId EventLoop::addSource(SourceType type, int fd, Callback callback,
+                                         SignalCallback signal_callback) {
+    SourceId id = next_id_++;
+    
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = id;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        LOG_ERROR("epoll_ctl failed: {}", std::strerror(errno));
+        close(fd);
+        return 0;
+    }
+    
+    sources_[id] = Source{type, fd, true, std::move(callback), std::move(signal_callback)};
+    return id;
+}
+
+void EventLoop::dispatch(Source& source) {
+    switch (source.type) {
+        case SourceType::TIMER:
+        case SourceType::WAKEUP: {
+            // Both timerfd and eventfd deliver an 8-byte counter; reading it
+            // clears readiness. Missed timer expirations are coalesced.
+            uint64_t count;
+            if (read(source.fd, &count, sizeof(count)) != sizeof(count)) {
+                return;
+            }
+            if (source.callback) {
+                source.callback();
+            }
+            break;
+        }
+        case SourceType::SIGNAL: {
+            signalfd_siginfo info;
+            while (read(source.fd, &info, sizeof(info)) == sizeof(info)) {
+                if (source.signal_callback) {
+                    source.signal_callback(static_cast<int>(info.ssi_signo));
+                }
+            }
+            break;
+        }
+    }
+}
+
+} // namespace arbitrage
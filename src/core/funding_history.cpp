@@ -0,0 +1,208 @@
+#include "funding_history.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace arbitrage {
+
+namespace {
+
+int64_t toNanos(Timestamp time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+size_t roundUpPowerOfTwo(size_t value) {
+    size_t power = 1;
+    while (power < value) {
+        power <<= 1;
+    }
+    return power;
+}
+
+} // namespace
+
+FundingHistory::FundingHistory(const FundingHistoryConfig& config) {
+    size_t capacity = roundUpPowerOfTwo(std::max<size_t>(config.capacity, 2));
+    mask_ = capacity - 1;
+    rolling_window_ = std::clamp<size_t>(config.rolling_window, 1, capacity);
+    alpha_ = std::clamp(config.ewma_alpha, 1e-6, 1.0);
+    
+    times_.assign(capacity, 0);
+    rates_.assign(capacity, 0.0);
+    prefix_sum_.assign(capacity, 0.0);
+    prefix_square_.assign(capacity, 0.0);
+}
+
+bool FundingHistory::record(Timestamp funding_time, double rate) {
+    int64_t time = toNanos(funding_time);
+    
+    if (total_ > 0) {
+        size_t last = slot(total_ - 1);
+        if (time < times_[last]) {
+            return false;
+        }
+        if (time == times_[last]) {
+            // Same settlement: replace the newest print in place
+            double offset = rate - reference_;
+            rates_[last] = rate;
+            running_sum_ = prefix_sum_[last] + offset;
+            running_square_ = prefix_square_[last] + offset * offset;
+            ewma_ = previous_ewma_;
+            ewma_variance_ = previous_variance_;
+            updateEwma(rate);
+            return true;
+        }
+    } else {
+        reference_ = rate;
+        ewma_ = rate;
+    }
+    
+    size_t index = slot(total_);
+    times_[index] = time;
+    rates_[index] = rate;
+    prefix_sum_[index] = running_sum_;
+    prefix_square_[index] = running_square_;
+    
+    double offset = rate - reference_;
+    running_sum_ += offset;
+    running_square_ += offset * offset;
+    ++total_;
+    
+    previous_ewma_ = ewma_;
+    previous_variance_ = ewma_variance_;
+    updateEwma(rate);
+    return true;
+}
+
+FundingStats FundingHistory::getRollingStats() const {
+    return summarize(total_ - std::min<uint64_t>(rolling_window_, size()), total_);
+}
+
+double FundingHistory::getEwmaVolatility() const {
+    return std::sqrt(ewma_variance_);
+}
+
+double FundingHistory::getLatestRate() const {
+    return total_ > 0 ? rates_[slot(total_ - 1)] : 0.0;
+}
+
+Timestamp FundingHistory::getLatestTime() const {
+    return total_ > 0 ? getTime(size() - 1) : Timestamp();
+}
+
+Timestamp FundingHistory::getTime(size_t index) const {
+    return Timestamp(std::chrono::duration_cast<Timestamp::duration>(
+        std::chrono::nanoseconds(times_[slot(oldest() + index)])));
+}
+
+FundingStats FundingHistory::query(Timestamp from, Timestamp to) const {
+    int64_t from_ns = toNanos(from);
+    int64_t to_ns = toNanos(to);
+    if (total_ == 0 || to_ns < from_ns) {
+        return FundingStats();
+    }
+    
+    // Funding times increase along the ring: binary search in sequence space
+    auto lowerBound = [this](int64_t time) {
+        uint64_t low = oldest();
+        uint64_t high = total_;
+        while (low < high) {
+            uint64_t mid = low + (high - low) / 2;
+            if (times_[slot(mid)] < time) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        return low;
+    };
+    
+    uint64_t first = lowerBound(from_ns);
+    uint64_t last = to_ns == INT64_MAX ? total_ : lowerBound(to_ns + 1);
+    return summarize(first, last);
+}
+
+FundingStats FundingHistory::summarize(uint64_t first, uint64_t last) const {
+    FundingStats stats;
+    if (last <= first) {
+        return stats;
+    }
+    
+    auto sumBefore = [this](uint64_t sequence, const std::vector<double>& prefix, double running) {
+        return sequence == total_ ? running : prefix[slot(sequence)];
+    };
+    double sum = sumBefore(last, prefix_sum_, running_sum_) - prefix_sum_[slot(first)];
+    double square = sumBefore(last, prefix_square_, running_square_) - prefix_square_[slot(first)];
+    
+    double n = static_cast<double>(last - first);
+    stats.count = static_cast<size_t>(last - first);
+    stats.mean = reference_ + sum / n;
+    stats.sum = reference_ * n + sum;
+    if (stats.count > 1) {
+        double variance = (square - sum * sum / n) / (n - 1.0);
+        stats.volatility = std::sqrt(std::max(variance, 0.0));
+    }
+    return stats;
+}
+
+void FundingHistory::updateEwma(double rate) {
+    if (total_ == 1) {
+        ewma_ = rate;
+        ewma_variance_ = 0.0;
+        return;
+    }
+    double diff = rate - ewma_;
+    double increment = alpha_ * diff;
+    ewma_ += increment;
+    ewma_variance_ = (1.0 - alpha_) * (ewma_variance_ + diff * increment);
+}
+
+FundingHistoryStore::FundingHistoryStore(const FundingHistoryConfig& config) : config_(config) {
+}
+
+bool FundingHistoryStore::record(const FundingRate& funding) {
+    size_t index;
+    if (!find(funding.instrument_id, funding.exchange_id, index)) {
+        index = series_.size();
+        series_.emplace_back(config_);
+        instrument_ids_.push_back(funding.instrument_id);
+        exchange_ids_.push_back(funding.exchange_id);
+        by_instrument_[funding.instrument_id].push_back(index);
+    }
+    
+    Timestamp time = funding.funding_time.time_since_epoch().count() != 0 ? funding.funding_time
+                                                                           : funding.timestamp;
+    if (!series_[index].record(time, funding.current_rate)) {
+        ++stale_count_;
+        return false;
+    }
+    return true;
+}
+
+bool FundingHistoryStore::find(const InstrumentId& instrument_id, const ExchangeId& exchange_id,
+                               size_t& index) const {
+    auto it = by_instrument_.find(instrument_id);
+    if (it == by_instrument_.end()) {
+        return false;
+    }
+    for (size_t candidate : it->second) {
+        if (exchange_ids_[candidate] == exchange_id) {
+            index = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+const FundingHistory* FundingHistoryStore::get(const InstrumentId& instrument_id,
+                                               const ExchangeId& exchange_id) const {
+    size_t index;
+    return find(instrument_id, exchange_id, index) ? &series_[index] : nullptr;
+}
+
+const std::vector<size_t>& FundingHistoryStore::getVenueSeries(const InstrumentId& instrument_id) const {
+    static const std::vector<size_t> kNone;
+    auto it = by_instrument_.find(instrument_id);
+    return it != by_instrument_.end() ? it->second : kNone;
+}
+
+} // namespace arbitrage
@@ -0,0 +1,47 @@
+#include "latency_budget.hpp"
+#include "performance_monitor.hpp"
+#include <algorithm>
+
+namespace arbitrage {
+
+LatencyBudget::LatencyBudget(const LatencyBudgetConfig& config) : config_(config) {
+}
+
+bool LatencyBudget::admit(ArbitrageOpportunity& opportunity, const InputTimes* legs, size_t count,
+                          DetectionStage stage, Timestamp now) {
+    std::chrono::nanoseconds exchange_age(0), receive_age(0), oldest(-1);
+    size_t oldest_leg = 0;
+    for (size_t leg = 0; leg < count; ++leg) {
+        // Clocks of different venues disagree; an input from the future is fresh
+        std::chrono::nanoseconds leg_age(-1);
+        if (legs[leg].exchange_time.time_since_epoch().count() != 0) {
+            auto age = std::max(std::chrono::nanoseconds(now - legs[leg].exchange_time), std::chrono::nanoseconds(0));
+            exchange_age = std::max(exchange_age, age);
+            leg_age = age;
+        }
+        if (legs[leg].receive_time.time_since_epoch().count() != 0) {
+            auto age = std::max(std::chrono::nanoseconds(now - legs[leg].receive_time), std::chrono::nanoseconds(0));
+            receive_age = std::max(receive_age, age);
+            leg_age = std::max(leg_age, age);
+        }
+        if (leg_age > oldest) {
+            oldest = leg_age;
+            oldest_leg = leg;
+        }
+    }
+    opportunity.exchange_age = exchange_age;
+    opportunity.receive_age = receive_age;
+    
+    if (config_.max_age.count() == 0 || (exchange_age <= config_.max_age && receive_age <= config_.max_age)) {
+        ++admitted_count_;
+        return true;
+    }
+    
+    ++rejected_count_;
+    Exchange venue = oldest_leg < opportunity.leg_exchanges.size() ? opportunity.leg_exchanges[oldest_leg]
+                                                                   : Exchange::UNKNOWN;
+    PerformanceMonitor::getInstance().recordStaleRejection(venue, stage);
+    return false;
+}
+
+} // namespace arbitrage
@@ -0,0 +1,181 @@
+#include "opportunity_dedup.hpp"
+#include <algorithm>
+
+namespace arbitrage {
+
+namespace {
+
+constexpr uint64_t kFnvOffset = 14695981039346656037ULL;
+constexpr uint64_t kFnvPrime = 1099511628211ULL;
+
+inline uint64_t fnvByte(uint64_t hash, uint8_t byte) {
+    return (hash ^ byte) * kFnvPrime;
+}
+
+// Final avalanche (splitmix64) so linear probing sees well-spread low bits
+inline uint64_t mix(uint64_t hash) {
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+    return hash ^ (hash >> 31);
+}
+
+int64_t toNanoseconds(Timestamp time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+} // namespace
+
+OpportunityDeduplicator::OpportunityDeduplicator(const DedupConfig& config) : config_(config) {
+    size_t capacity = 16;
+    while (capacity < config.initial_capacity) {
+        capacity *= 2;
+    }
+    keys_.assign(capacity, 0);
+    open_.assign(capacity, 0);
+    opening_edge_.assign(capacity, 0.0);
+    closed_at_.assign(capacity, 0);
+    mask_ = capacity - 1;
+}
+
+uint64_t OpportunityDeduplicator::computeKey(const ArbitrageOpportunity& opportunity) {
+    uint64_t hash = fnvByte(kFnvOffset, static_cast<uint8_t>(opportunity.type));
+    const size_t legs = opportunity.leg_instruments.size();
+    for (size_t leg = 0; leg < legs; ++leg) {
+        for (char c : opportunity.leg_instruments[leg]) {
+            hash = fnvByte(hash, static_cast<uint8_t>(c));
+        }
+        hash = fnvByte(hash, 0);  // Separator: "AB"+"C" and "A"+"BC" differ
+        Exchange exchange = leg < opportunity.leg_exchanges.size() ? opportunity.leg_exchanges[leg] : Exchange::UNKNOWN;
+        OrderSide side = leg < opportunity.leg_sides.size() ? opportunity.leg_sides[leg] : OrderSide::UNKNOWN;
+        hash = fnvByte(hash, static_cast<uint8_t>(exchange));
+        hash = fnvByte(hash, static_cast<uint8_t>(side));
+    }
+    hash = mix(hash);
+    return hash == 0 ? 1 : hash;
+}
+
+DedupAction OpportunityDeduplicator::offer(ArbitrageOpportunity& opportunity, Timestamp now) {
+    if (opportunity.leg_instruments.empty() || opportunity.expiry_time.time_since_epoch().count() == 0) {
+        ++emit_count_;
+        return DedupAction::EMIT;
+    }
+    if (opportunity.opportunity_key == 0) {
+        opportunity.opportunity_key = computeKey(opportunity);
+    }
+    
+    const double edge = opportunity.expected_profit_percentage;
+    size_t slot = probe(opportunity.opportunity_key);
+    if (keys_[slot] == 0) {
+        slot = insert(opportunity.opportunity_key, now);
+    } else if (opportunity.reannounce) {
+        // Scheduled re-report: reopen at its current edge and publish
+    } else if (open_[slot]) {
+        if (edge < config_.exit_ratio * opening_edge_[slot]) {
+            open_[slot] = 0;
+            closed_at_[slot] = toNanoseconds(now);
+            ++close_count_;
+            return DedupAction::CLOSE;
+        }
+        ++update_count_;
+        return DedupAction::UPDATE;
+    } else {
+        // Closed: flapping back inside the rearm interval needs a stronger edge
+        const int64_t rearm = std::chrono::duration_cast<std::chrono::nanoseconds>(config_.rearm_interval).count();
+        if (toNanoseconds(now) - closed_at_[slot] < rearm && edge < config_.reentry_ratio * opening_edge_[slot]) {
+            ++suppress_count_;
+            return DedupAction::SUPPRESS;
+        }
+    }
+    
+    open_[slot] = 1;
+    opening_edge_[slot] = edge;
+    ++emit_count_;
+    return DedupAction::EMIT;
+}
+
+bool OpportunityDeduplicator::close(uint64_t key, Timestamp now) {
+    if (key == 0) {
+        return false;
+    }
+    size_t slot = probe(key);
+    if (keys_[slot] == 0 || !open_[slot]) {
+        return false;
+    }
+    open_[slot] = 0;
+    closed_at_[slot] = toNanoseconds(now);
+    ++close_count_;
+    return true;
+}
+
+void OpportunityDeduplicator::clear() {
+    std::fill(keys_.begin(), keys_.end(), 0);
+    std::fill(open_.begin(), open_.end(), 0);
+    size_ = 0;
+}
+
+bool OpportunityDeduplicator::isOpen(uint64_t key) const {
+    if (key == 0) {
+        return false;
+    }
+    size_t slot = probe(key);
+    return keys_[slot] != 0 && open_[slot] != 0;
+}
+
+size_t OpportunityDeduplicator::probe(uint64_t key) const {
+    size_t slot = key & mask_;
+    while (keys_[slot] != 0 && keys_[slot] != key) {
+        slot = (slot + 1) & mask_;
+    }
+    return slot;
+}
+
+size_t OpportunityDeduplicator::insert(uint64_t key, Timestamp now) {
+    if (2 * (size_ + 1) > keys_.size()) {
+        rebuild(now);
+    }
+    size_t slot = probe(key);
+    keys_[slot] = key;
+    open_[slot] = 0;
+    opening_edge_[slot] = 0.0;
+    closed_at_[slot] = 0;
+    ++size_;
+    return slot;
+}
+
+void OpportunityDeduplicator::rebuild(Timestamp now) {
+    // Closed keys past their rearm interval behave exactly like unseen ones
+    const int64_t cutoff = toNanoseconds(now) -
+                           std::chrono::duration_cast<std::chrono::nanoseconds>(config_.rearm_interval).count();
+    std::vector<uint8_t> keep(keys_.size(), 0);
+    size_t live = 0;
+    for (size_t slot = 0; slot < keys_.size(); ++slot) {
+        keep[slot] = keys_[slot] != 0 && (open_[slot] || closed_at_[slot] >= cutoff);
+        live += keep[slot];
+    }
+    
+    // Double only if dropping them does not leave room (at most a quarter full)
+    size_t capacity = 4 * (live + 1) > keys_.size() ? keys_.size() * 2 : keys_.size();
+    std::vector<uint64_t> keys(capacity, 0);
+    std::vector<uint8_t> open(keys.size(), 0);
+    std::vector<double> opening_edge(keys.size(), 0.0);
+    std::vector<int64_t> closed_at(keys.size(), 0);
+    keys_.swap(keys);
+    open_.swap(open);
+    opening_edge_.swap(opening_edge);
+    closed_at_.swap(closed_at);
+    mask_ = keys_.size() - 1;
+    
+    size_ = live;
+    for (size_t old = 0; old < keys.size(); ++old) {
+        if (!keep[old]) {
+            continue;
+        }
+        size_t slot = probe(keys[old]);
+        keys_[slot] = keys[old];
+        open_[slot] = open[old];
+        opening_edge_[slot] = opening_edge[old];
+        closed_at_[slot] = closed_at[old];
+    }
+}
+
+} // namespace arbitrage
@@ -0,0 +1,303 @@
+#include "opportunity_merger.hpp"
+#include "performance_monitor.hpp"
+#include "thread_utils.hpp"
+#include "logger.hpp"
+
+namespace arbitrage {
+
+OpportunityMerger::OpportunityMerger() {
+    wakeup_id_ = event_loop_.addWakeup([this]() { processPending(); });
+    
+    store_.setInvalidationCallback([this](const ArbitrageOpportunity& opportunity) {
+        opportunities_invalidated_.fetch_add(1, std::memory_order_relaxed);
+        dedup_.close(opportunity.opportunity_key, getEngineTimestamp());
+        retire(opportunity.opportunity_id);
+    });
+    
+    // One-shot timer for the wheel's next expiry, re-armed after every drain
+    // and advance
+    wheel_timer_id_ = event_loop_.addTimer(expiry_wheel_.getResolution(), std::chrono::nanoseconds(0), [this]() {
+        armed_deadline_ = Timestamp();
+        advanceTimers(getEngineTimestamp());
+    });
+    event_loop_.disarmTimer(wheel_timer_id_);
+}
+
+OpportunityMerger::~OpportunityMerger() {
+    stop();
+}
+
+void OpportunityMerger::setOpportunityCallback(OpportunityCallback callback) {
+    opportunity_callback_ = std::move(callback);
+}
+
+void OpportunityMerger::addCrossShardDetector(CrossShardDetector detector) {
+    detectors_.push_back(std::move(detector));
+}
+
+void OpportunityMerger::setExpiryCallback(ExpiryCallback callback) {
+    expiry_callback_ = std::move(callback);
+}
+
+void OpportunityMerger::start(int cpu_core) {
+    if (running_.exchange(true)) {
+        LOG_WARN("Opportunity merger already running");
+        return;
+    }
+    
+    thread_ = std::make_unique<std::thread>(&OpportunityMerger::mergeLoop, this);
+    pinThreadToCore(*thread_, cpu_core);
+    
+    LOG_INFO("Opportunity merger started");
+}
+
+void OpportunityMerger::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    
+    event_loop_.stop();
+    if (thread_ && thread_->joinable()) {
+        thread_->join();
+    }
+    
+    LOG_INFO("Opportunity merger stopped");
+}
+
+void OpportunityMerger::publishTopOfBook(const TopOfBook& top) {
+    bool was_idle;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        was_idle = pending_.empty() && dirty_instruments_.empty();
+        tops_[top.instrument_id] = top;
+        // Changed tops feed the detectors and invalidate stored opportunities
+        if (!dirty_set_.insert(top.instrument_id).second) {
+            return;
+        }
+        dirty_instruments_.push_back(top.instrument_id);
+    }
+    if (was_idle && running_) {
+        event_loop_.notify(wakeup_id_);
+    }
+}
+
+void OpportunityMerger::publishOpportunities(std::vector<ArbitrageOpportunity>& opportunities) {
+    bool was_idle;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        was_idle = pending_.empty() && dirty_instruments_.empty();
+        for (auto& opportunity : opportunities) {
+            pending_.push_back(std::move(opportunity));
+        }
+    }
+    opportunities.clear();
+    if (was_idle && running_) {
+        event_loop_.notify(wakeup_id_);
+    }
+}
+
+void OpportunityMerger::processPending() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    try {
+        drain(lock);
+    } catch (const std::exception& e) {
+        LOG_ERROR("Error in opportunity merger: {}", e.what());
+        if (!lock.owns_lock()) {
+            lock.lock();
+        }
+        batch_.clear();
+        changed_.clear();
+    }
+    armTimer();
+}
+
+void OpportunityMerger::advanceTimers(Timestamp now) {
+    try {
+        expiry_wheel_.advance(now);
+    } catch (const std::exception& e) {
+        LOG_ERROR("Error in opportunity expiry callback: {}", e.what());
+    }
+    armTimer();
+}
+
+void OpportunityMerger::armTimer() {
+    Timestamp deadline;
+    if (!expiry_wheel_.nextDeadline(deadline)) {
+        if (armed_deadline_.time_since_epoch().count() != 0) {
+            event_loop_.disarmTimer(wheel_timer_id_);
+            armed_deadline_ = Timestamp();
+        }
+        return;
+    }
+    if (deadline != armed_deadline_) {
+        armed_deadline_ = deadline;
+        event_loop_.rearmTimer(wheel_timer_id_, deadline - getEngineTimestamp(), std::chrono::nanoseconds(0));
+    }
+}
+
+bool OpportunityMerger::getTopOfBook(const InstrumentId& instrument_id, TopOfBook& top) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = tops_.find(instrument_id);
+    if (it == tops_.end()) {
+        return false;
+    }
+    top = it->second;
+    return true;
+}
+
+uint64_t OpportunityMerger::getOpportunitiesMerged() const {
+    return opportunities_merged_.load(std::memory_order_relaxed);
+}
+
+uint64_t OpportunityMerger::getCrossShardOpportunities() const {
+    return cross_shard_opportunities_.load(std::memory_order_relaxed);
+}
+
+uint64_t OpportunityMerger::getOpportunitiesExpired() const {
+    return opportunities_expired_.load(std::memory_order_relaxed);
+}
+
+uint64_t OpportunityMerger::getOpportunitiesInvalidated() const {
+    return opportunities_invalidated_.load(std::memory_order_relaxed);
+}
+
+uint64_t OpportunityMerger::getOpportunitiesUpdated() const {
+    return opportunities_updated_.load(std::memory_order_relaxed);
+}
+
+uint64_t OpportunityMerger::getOpportunitiesSuppressed() const {
+    return opportunities_suppressed_.load(std::memory_order_relaxed);
+}
+
+void OpportunityMerger::mergeLoop() {
+    armTimer();
+    event_loop_.run();
+    
+    // Deliver anything published before stop()
+    processPending();
+}
+
+void OpportunityMerger::drain(std::unique_lock<std::mutex>& lock) {
+    // Take everything published so far, then work without holding the lock
+    batch_.swap(pending_);
+    changed_.swap(dirty_instruments_);
+    dirty_set_.clear();
+    for (const auto& instrument_id : changed_) {
+        snapshot_[instrument_id] = tops_.find(instrument_id)->second;
+    }
+    lock.unlock();
+    
+    // Normalize every changed top first so a conversion tick is visible to
+    // all detectors of the same batch, and drop what the tick moved against
+    for (const auto& instrument_id : changed_) {
+        auto it = snapshot_.find(instrument_id);
+        if (it != snapshot_.end()) {
+            quote_normalizer_.onTopOfBook(it->second);
+            store_.onTopOfBook(it->second);
+        }
+    }
+    
+    size_t shard_opportunities = batch_.size();
+    if (!changed_.empty()) {
+        for (auto& detector : detectors_) {
+            detector(snapshot_, changed_, batch_);
+        }
+    }
+    
+    // Shard opportunities were checked at emission; cross-shard ones are
+    // checked here against the times of the tops they were built from
+    const Timestamp now = getEngineTimestamp();
+    size_t kept = shard_opportunities;
+    for (size_t i = shard_opportunities; i < batch_.size(); ++i) {
+        auto& opportunity = batch_[i];
+        leg_times_.clear();
+        for (const auto& instrument_id : opportunity.leg_instruments) {
+            auto it = snapshot_.find(instrument_id);
+            leg_times_.push_back(it == snapshot_.end() ? InputTimes()
+                                                       : InputTimes{it->second.exchange_time, it->second.receive_time});
+        }
+        if (latency_budget_.admit(opportunity, leg_times_.data(), leg_times_.size(), DetectionStage::MERGER, now)) {
+            if (kept != i) {
+                batch_[kept] = std::move(opportunity);
+            }
+            ++kept;
+        }
+    }
+    batch_.resize(kept);
+    cross_shard_opportunities_.fetch_add(batch_.size() - shard_opportunities,
+                                         std::memory_order_relaxed);
+    
+    // Only new records go downstream (and count as detected); repeats
+    // refresh the live record and are counted as updated or suppressed
+    auto& perf_monitor = PerformanceMonitor::getInstance();
+    uint64_t updated = 0, suppressed = 0;
+    for (auto& opportunity : batch_) {
+        switch (dedup_.offer(opportunity, now)) {
+            case DedupAction::EMIT:
+                perf_monitor.recordOpportunityDetected();
+                if (opportunity_callback_) {
+                    opportunity_callback_(opportunity);
+                }
+                scheduleExpiry(opportunity);
+                break;
+            case DedupAction::UPDATE:
+                scheduleExpiry(opportunity);
+                ++updated;
+                break;
+            case DedupAction::CLOSE:
+                store_.remove(opportunity.opportunity_id);
+                retire(opportunity.opportunity_id);
+                ++suppressed;
+                break;
+            case DedupAction::SUPPRESS:
+                ++suppressed;
+                break;
+        }
+    }
+    opportunities_merged_.fetch_add(batch_.size(), std::memory_order_relaxed);
+    opportunities_updated_.fetch_add(updated, std::memory_order_relaxed);
+    opportunities_suppressed_.fetch_add(suppressed, std::memory_order_relaxed);
+    
+    batch_.clear();
+    changed_.clear();
+    lock.lock();
+}
+
+void OpportunityMerger::scheduleExpiry(const ArbitrageOpportunity& opportunity) {
+    if (opportunity.opportunity_id.empty() || opportunity.expiry_time.time_since_epoch().count() == 0) {
+        return;
+    }
+    
+    // A re-detected opportunity extends its lifetime, is re-scored and
+    // re-armed at its new leg prices
+    ranking_.upsert(opportunity);
+    store_.insert(opportunity);
+    auto& handle = expiry_timers_[opportunity.opportunity_id];
+    expiry_wheel_.cancel(handle);
+    
+    std::string opportunity_id = opportunity.opportunity_id;
+    uint64_t key = opportunity.opportunity_key;
+    handle = expiry_wheel_.scheduleAt(opportunity.expiry_time, [this, opportunity_id, key]() {
+        opportunities_expired_.fetch_add(1, std::memory_order_relaxed);
+        dedup_.close(key, expiry_wheel_.now());
+        store_.remove(opportunity_id);
+        retire(opportunity_id);
+    });
+}
+
+void OpportunityMerger::retire(const std::string& opportunity_id) {
+    auto it = expiry_timers_.find(opportunity_id);
+    if (it == expiry_timers_.end()) {
+        return;
+    }
+    // Copy first: the id may live in the entry being erased
+    std::string id = opportunity_id;
+    expiry_wheel_.cancel(it->second);
+    expiry_timers_.erase(it);
+    ranking_.remove(id);
+    if (expiry_callback_) {
+        expiry_callback_(id);
+    }
+}
+
+} // namespace arbitrage
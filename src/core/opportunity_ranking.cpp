@@ -0,0 +1,209 @@
+#include "opportunity_ranking.hpp"
+#include <algorithm>
+
+namespace arbitrage {
+
+OpportunityRanking::OpportunityRanking(size_t top_k) : top_k_(std::max<size_t>(top_k, 1)) {
+}
+
+bool OpportunityRanking::upsert(const ArbitrageOpportunity& opportunity) {
+    if (opportunity.opportunity_id.empty()) {
+        return false;
+    }
+    
+    auto it = index_.find(opportunity.opportunity_id);
+    if (it != index_.end()) {
+        Entry& entry = entries_[it->second];
+        entry.opportunity = opportunity;
+        entry.score = riskAdjustedProfit(opportunity);
+        restore(it->second);
+        rebalance();
+        return true;
+    }
+    
+    uint32_t slot;
+    if (!free_slots_.empty()) {
+        slot = free_slots_.back();
+        free_slots_.pop_back();
+    } else {
+        // Growing the slot table moves every entry the top-K view points at
+        top_dirty_ = top_dirty_ || entries_.size() == entries_.capacity();
+        slot = static_cast<uint32_t>(entries_.size());
+        entries_.emplace_back();
+    }
+    
+    Entry& entry = entries_[slot];
+    entry.opportunity = opportunity;
+    entry.score = riskAdjustedProfit(opportunity);
+    index_[opportunity.opportunity_id] = slot;
+    push(slot, false);
+    rebalance();
+    return true;
+}
+
+bool OpportunityRanking::updateScore(const std::string& opportunity_id, double score) {
+    auto it = index_.find(opportunity_id);
+    if (it == index_.end()) {
+        return false;
+    }
+    entries_[it->second].score = score;
+    restore(it->second);
+    rebalance();
+    return true;
+}
+
+bool OpportunityRanking::remove(const std::string& opportunity_id) {
+    auto it = index_.find(opportunity_id);
+    if (it == index_.end()) {
+        return false;
+    }
+    
+    uint32_t slot = it->second;
+    index_.erase(it);
+    erase(slot);
+    entries_[slot].opportunity = ArbitrageOpportunity();
+    free_slots_.push_back(slot);
+    rebalance();
+    return true;
+}
+
+void OpportunityRanking::clear() {
+    entries_.clear();
+    free_slots_.clear();
+    index_.clear();
+    top_.clear();
+    rest_.clear();
+    top_view_.clear();
+    top_dirty_ = false;
+}
+
+const std::vector<const ArbitrageOpportunity*>& OpportunityRanking::getTopK() const {
+    if (top_dirty_) {
+        std::vector<uint32_t> slots(top_);
+        std::sort(slots.begin(), slots.end(),
+                  [this](uint32_t a, uint32_t b) { return entries_[a].score > entries_[b].score; });
+        top_view_.clear();
+        for (uint32_t slot : slots) {
+            top_view_.push_back(&entries_[slot].opportunity);
+        }
+        top_dirty_ = false;
+    }
+    return top_view_;
+}
+
+const ArbitrageOpportunity* OpportunityRanking::getBest() const {
+    const auto& top = getTopK();
+    return top.empty() ? nullptr : top.front();
+}
+
+bool OpportunityRanking::getScore(const std::string& opportunity_id, double& score) const {
+    auto it = index_.find(opportunity_id);
+    if (it == index_.end()) {
+        return false;
+    }
+    score = entries_[it->second].score;
+    return true;
+}
+
+double OpportunityRanking::riskAdjustedProfit(const ArbitrageOpportunity& opportunity) {
+    return opportunity.expected_profit * (1.0 - std::clamp(opportunity.risk_score, 0.0, 1.0));
+}
+
+bool OpportunityRanking::above(uint32_t a, uint32_t b, bool top) const {
+    return top ? entries_[a].score < entries_[b].score : entries_[a].score > entries_[b].score;
+}
+
+void OpportunityRanking::place(std::vector<uint32_t>& heap, uint32_t position, uint32_t slot) {
+    heap[position] = slot;
+    entries_[slot].position = position;
+}
+
+void OpportunityRanking::siftUp(std::vector<uint32_t>& heap, uint32_t position, bool top) {
+    uint32_t slot = heap[position];
+    while (position > 0) {
+        uint32_t parent = (position - 1) / 2;
+        if (!above(slot, heap[parent], top)) {
+            break;
+        }
+        place(heap, position, heap[parent]);
+        position = parent;
+    }
+    place(heap, position, slot);
+}
+
+void OpportunityRanking::siftDown(std::vector<uint32_t>& heap, uint32_t position, bool top) {
+    uint32_t slot = heap[position];
+    uint32_t size = static_cast<uint32_t>(heap.size());
+    while (true) {
+        uint32_t child = 2 * position + 1;
+        if (child >= size) {
+            break;
+        }
+        if (child + 1 < size && above(heap[child + 1], heap[child], top)) {
+            ++child;
+        }
+        if (!above(heap[child], slot, top)) {
+            break;
+        }
+        place(heap, position, heap[child]);
+        position = child;
+    }
+    place(heap, position, slot);
+}
+
+void OpportunityRanking::push(uint32_t slot, bool top) {
+    auto& heap = top ? top_ : rest_;
+    entries_[slot].in_top = top;
+    heap.push_back(slot);
+    siftUp(heap, static_cast<uint32_t>(heap.size() - 1), top);
+    top_dirty_ = top_dirty_ || top;
+}
+
+uint32_t OpportunityRanking::pop(bool top) {
+    auto& heap = top ? top_ : rest_;
+    uint32_t root = heap.front();
+    uint32_t last = heap.back();
+    heap.pop_back();
+    if (!heap.empty()) {
+        place(heap, 0, last);
+        siftDown(heap, 0, top);
+    }
+    top_dirty_ = top_dirty_ || top;
+    return root;
+}
+
+void OpportunityRanking::erase(uint32_t slot) {
+    bool top = entries_[slot].in_top;
+    auto& heap = top ? top_ : rest_;
+    uint32_t position = entries_[slot].position;
+    uint32_t last = heap.back();
+    heap.pop_back();
+    if (position < heap.size()) {
+        place(heap, position, last);
+        restore(last);
+    }
+    top_dirty_ = top_dirty_ || top;
+}
+
+void OpportunityRanking::restore(uint32_t slot) {
+    bool top = entries_[slot].in_top;
+    auto& heap = top ? top_ : rest_;
+    siftUp(heap, entries_[slot].position, top);
+    siftDown(heap, entries_[slot].position, top);
+    top_dirty_ = top_dirty_ || top;
+}
+
+void OpportunityRanking::rebalance() {
+    while (top_.size() < top_k_ && !rest_.empty()) {
+        push(pop(false), true);
+    }
+    // One score change can only break the boundary by one entry
+    if (!top_.empty() && !rest_.empty() && entries_[rest_.front()].score > entries_[top_.front()].score) {
+        uint32_t demoted = pop(true);
+        uint32_t promoted = pop(false);
+        push(promoted, true);
+        push(demoted, false);
+    }
+}
+
+} // namespace arbitrage
@@ -0,0 +1,208 @@
+#include "opportunity_store.hpp"
+
+namespace arbitrage {
+
+OpportunityStore::OpportunityStore(size_t capacity)
+    : capacity_(capacity),
+      generation_(new std::atomic<uint32_t>[capacity]),
+      leg_count_(capacity, 0),
+      payload_(capacity),
+      node_next_(capacity * kMaxLegs, kNoLink),
+      node_prev_(capacity * kMaxLegs, kNoLink),
+      node_instrument_(capacity * kMaxLegs, 0),
+      node_price_(capacity * kMaxLegs, 0.0),
+      node_side_(capacity * kMaxLegs, 0) {
+    // Even generations are free slots, odd ones live; pop low slots first
+    free_slots_.reserve(capacity);
+    for (size_t slot = capacity; slot-- > 0;) {
+        generation_[slot].store(0, std::memory_order_relaxed);
+        free_slots_.push_back(static_cast<uint32_t>(slot));
+    }
+    id_index_.reserve(capacity);
+}
+
+void OpportunityStore::setInvalidationCallback(InvalidationCallback callback) {
+    invalidation_callback_ = std::move(callback);
+}
+
+OpportunityHandle OpportunityStore::insert(const ArbitrageOpportunity& opportunity) {
+    const size_t legs = opportunity.leg_instruments.size();
+    if (legs == 0 || legs > kMaxLegs || opportunity.leg_sides.size() != legs ||
+        opportunity.leg_prices.size() != legs) {
+        return OpportunityHandle();
+    }
+    for (OrderSide side : opportunity.leg_sides) {
+        if (side != OrderSide::BUY && side != OrderSide::SELL) {
+            return OpportunityHandle();
+        }
+    }
+    
+    // A re-detected opportunity replaces the old one and its leg prices
+    if (!opportunity.opportunity_id.empty()) {
+        remove(opportunity.opportunity_id);
+    }
+    if (free_slots_.empty()) {
+        return OpportunityHandle();
+    }
+    
+    uint32_t slot = free_slots_.back();
+    free_slots_.pop_back();
+    payload_[slot] = opportunity;
+    payload_[slot].is_active = true;
+    leg_count_[slot] = static_cast<uint8_t>(legs);
+    for (size_t leg = 0; leg < legs; ++leg) {
+        uint32_t node = slot * static_cast<uint32_t>(kMaxLegs) + static_cast<uint32_t>(leg);
+        node_price_[node] = opportunity.leg_prices[leg];
+        node_side_[node] = opportunity.leg_sides[leg] == OrderSide::BUY ? 1 : -1;
+        link(node, instrumentSlot(opportunity.leg_instruments[leg]));
+    }
+    if (!opportunity.opportunity_id.empty()) {
+        id_index_[opportunity.opportunity_id] = slot;
+    }
+    
+    uint32_t generation = generation_[slot].load(std::memory_order_relaxed) + 1;
+    generation_[slot].store(generation, std::memory_order_release);
+    return OpportunityHandle{slot, generation};
+}
+
+bool OpportunityStore::remove(OpportunityHandle handle) {
+    if (!isLive(handle)) {
+        return false;
+    }
+    release(handle.slot);
+    return true;
+}
+
+bool OpportunityStore::remove(const std::string& opportunity_id) {
+    auto it = id_index_.find(opportunity_id);
+    if (it == id_index_.end()) {
+        return false;
+    }
+    release(it->second);
+    return true;
+}
+
+void OpportunityStore::clear() {
+    for (uint32_t slot = 0; slot < capacity_; ++slot) {
+        if (leg_count_[slot] != 0) {
+            release(slot);
+        }
+    }
+}
+
+size_t OpportunityStore::onTopOfBook(const TopOfBook& top) {
+    auto it = instrument_index_.find(top.instrument_id);
+    if (it == instrument_index_.end()) {
+        return 0;
+    }
+    
+    // A leg survives while its side of the book still trades at its price;
+    // an empty side (price 0) fails too
+    size_t invalidated = 0;
+    uint32_t node = instrument_head_[it->second];
+    while (node != kNoLink) {
+        // Releasing unlinks every leg of the slot, possibly the next node too
+        uint32_t next = node_next_[node];
+        double price = node_price_[node];
+        bool holds = node_side_[node] > 0 ? top.ask_price > 0.0 && top.ask_price <= price
+                                          : top.bid_price > 0.0 && top.bid_price >= price;
+        if (!holds) {
+            uint32_t slot = node / static_cast<uint32_t>(kMaxLegs);
+            while (next != kNoLink && next / kMaxLegs == slot) {
+                next = node_next_[next];
+            }
+            if (invalidation_callback_) {
+                invalidation_callback_(payload_[slot]);
+            }
+            release(slot);
+            ++invalidated;
+        }
+        node = next;
+    }
+    invalidated_count_ += invalidated;
+    return invalidated;
+}
+
+bool OpportunityStore::isLive(OpportunityHandle handle) const {
+    return handle.slot < capacity_ && (handle.generation & 1u) != 0 &&
+           generation_[handle.slot].load(std::memory_order_acquire) == handle.generation;
+}
+
+const ArbitrageOpportunity* OpportunityStore::get(OpportunityHandle handle) const {
+    return isLive(handle) ? &payload_[handle.slot] : nullptr;
+}
+
+OpportunityHandle OpportunityStore::find(const std::string& opportunity_id) const {
+    auto it = id_index_.find(opportunity_id);
+    if (it == id_index_.end()) {
+        return OpportunityHandle();
+    }
+    return OpportunityHandle{it->second, generation_[it->second].load(std::memory_order_relaxed)};
+}
+
+size_t OpportunityStore::getDependentCount(const InstrumentId& instrument_id) const {
+    auto it = instrument_index_.find(instrument_id);
+    if (it == instrument_index_.end()) {
+        return 0;
+    }
+    size_t count = 0;
+    for (uint32_t node = instrument_head_[it->second]; node != kNoLink; node = node_next_[node]) {
+        ++count;
+    }
+    return count;
+}
+
+uint32_t OpportunityStore::instrumentSlot(const InstrumentId& instrument_id) {
+    auto it = instrument_index_.find(instrument_id);
+    if (it != instrument_index_.end()) {
+        return it->second;
+    }
+    uint32_t index = static_cast<uint32_t>(instrument_head_.size());
+    instrument_head_.push_back(kNoLink);
+    instrument_index_[instrument_id] = index;
+    return index;
+}
+
+void OpportunityStore::link(uint32_t node, uint32_t instrument) {
+    uint32_t head = instrument_head_[instrument];
+    node_instrument_[node] = instrument;
+    node_prev_[node] = kNoLink;
+    node_next_[node] = head;
+    if (head != kNoLink) {
+        node_prev_[head] = node;
+    }
+    instrument_head_[instrument] = node;
+}
+
+void OpportunityStore::unlink(uint32_t node) {
+    uint32_t prev = node_prev_[node];
+    uint32_t next = node_next_[node];
+    if (prev != kNoLink) {
+        node_next_[prev] = next;
+    } else {
+        instrument_head_[node_instrument_[node]] = next;
+    }
+    if (next != kNoLink) {
+        node_prev_[next] = prev;
+    }
+    node_prev_[node] = node_next_[node] = kNoLink;
+}
+
+void OpportunityStore::release(uint32_t slot) {
+    // Stale first, so a concurrent isLive() never sees a half-released slot as live
+    generation_[slot].store(generation_[slot].load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    
+    uint32_t first = slot * static_cast<uint32_t>(kMaxLegs);
+    for (uint32_t leg = 0; leg < leg_count_[slot]; ++leg) {
+        unlink(first + leg);
+    }
+    leg_count_[slot] = 0;
+    payload_[slot].is_active = false;
+    auto it = id_index_.find(payload_[slot].opportunity_id);
+    if (it != id_index_.end() && it->second == slot) {
+        id_index_.erase(it);
+    }
+    free_slots_.push_back(slot);
+}
+
+} // namespace arbitrage
@@ -0,0 +1,133 @@
+#include "shard_manager.hpp"
+#include "logger.hpp"
+#include <algorithm>
+
+namespace arbitrage {
+
+ShardManager::~ShardManager() {
+    stop();
+}
+
+bool ShardManager::initialize(const std::vector<Instrument>& instruments, size_t max_shards) {
+    if (running_) {
+        LOG_ERROR("Cannot re-partition shards while running");
+        return false;
+    }
+    
+    shards_.clear();
+    asset_to_shard_.clear();
+    instrument_to_shard_.clear();
+    
+    // Distinct base assets in configuration order, so the partition is stable
+    std::vector<std::string> assets;
+    for (const auto& instrument : instruments) {
+        if (std::find(assets.begin(), assets.end(), instrument.base_asset) == assets.end()) {
+            assets.push_back(instrument.base_asset);
+        }
+    }
+    
+    size_t shard_count = std::max<size_t>(1, std::min(max_shards, assets.size()));
+    for (size_t i = 0; i < shard_count; ++i) {
+        shards_.push_back(std::make_unique<StrategyShard>(i, &merger_));
+    }
+    
+    // Round-robin assets over shards; every instrument of an asset lands on
+    // the same shard so spot/perp/futures of one underlying never cross cores
+    for (size_t i = 0; i < assets.size(); ++i) {
+        asset_to_shard_[assets[i]] = i % shard_count;
+    }
+    for (const auto& instrument : instruments) {
+        size_t shard_id = asset_to_shard_[instrument.base_asset];
+        instrument_to_shard_[instrument.id] = shard_id;
+        shards_[shard_id]->addInstrument(instrument);
+    }
+    
+    // Quote normalization runs on the merger, which sees every shard's tops
+    auto& normalizer = merger_.getQuoteNormalizer();
+    size_t conversion_books = normalizer.addInstruments(instruments);
+    
+    LOG_INFO("Partitioned {} instruments ({} base assets) into {} strategy shards",
+             instruments.size(), assets.size(), shard_count);
+    LOG_INFO("Quote normalization into {}: {} currencies, {} conversion books",
+             normalizer.getPivot(), normalizer.getCurrencyCount(), conversion_books);
+    for (const auto& asset : assets) {
+        LOG_DEBUG("  {} -> shard {}", asset, asset_to_shard_[asset]);
+    }
+    return true;
+}
+
+void ShardManager::configureShards(const ShardInitializer& initializer) {
+    for (auto& shard : shards_) {
+        initializer(*shard);
+    }
+}
+
+void ShardManager::start(bool pin_threads) {
+    if (running_) {
+        LOG_WARN("Shard manager already running");
+        return;
+    }
+    
+    // Shard i runs on core i; the merger takes the next core after the shards
+    for (auto& shard : shards_) {
+        shard->start(pin_threads ? static_cast<int>(shard->getShardId()) : -1);
+    }
+    merger_.start(pin_threads ? static_cast<int>(shards_.size()) : -1);
+    running_ = true;
+}
+
+void ShardManager::stop() {
+    if (!running_) {
+        return;
+    }
+    
+    for (auto& shard : shards_) {
+        shard->stop();
+    }
+    merger_.stop();
+    running_ = false;
+}
+
+void ShardManager::submit(MarketEvent event) {
+    if (shards_.empty()) {
+        return;
+    }
+    
+    auto& shard = *shards_[getShardForInstrument(event.instrument_id)];
+    if (running_) {
+        shard.submit(std::move(event));
+    } else {
+        shard.processEvent(event);
+        merger_.processPending();
+    }
+}
+
+void ShardManager::advanceTimers(Timestamp now) {
+    if (running_) {
+        return;
+    }
+    for (auto& shard : shards_) {
+        shard->advanceTimers(now);
+    }
+    merger_.processPending();
+    merger_.advanceTimers(now);
+}
+
+size_t ShardManager::getShardForInstrument(const InstrumentId& instrument_id) const {
+    auto it = instrument_to_shard_.find(instrument_id);
+    if (it != instrument_to_shard_.end()) {
+        return it->second;
+    }
+    // Unconfigured instruments still get a stable home
+    return shards_.empty() ? 0 : std::hash<InstrumentId>{}(instrument_id) % shards_.size();
+}
+
+size_t ShardManager::getShardForAsset(const std::string& base_asset) const {
+    auto it = asset_to_shard_.find(base_asset);
+    if (it != asset_to_shard_.end()) {
+        return it->second;
+    }
+    return shards_.empty() ? 0 : std::hash<std::string>{}(base_asset) % shards_.size();
+}
+
+} // namespace arbitrage
@@ -0,0 +1,369 @@
+#include "strategy_shard.hpp"
+#include "opportunity_merger.hpp"
+#include "performance_monitor.hpp"
+#include "thread_utils.hpp"
+#include "logger.hpp"
+
+namespace arbitrage {
+
+StrategyShard::StrategyShard(size_t shard_id, OpportunityMerger* merger)
+    : shard_id_(shard_id), merger_(merger) {
+    wakeup_id_ = event_loop_.addWakeup([this]() { drainQueue(); });
+    
+    // One-shot timer for the wheel's next deadline, re-armed after every
+    // batch and advance; an empty wheel leaves the thread asleep
+    wheel_timer_id_ = event_loop_.addTimer(timing_wheel_.getResolution(), std::chrono::nanoseconds(0), [this]() {
+        armed_deadline_ = Timestamp();
+        advanceTimers(getEngineTimestamp());
+    });
+    event_loop_.disarmTimer(wheel_timer_id_);
+}
+
+StrategyShard::~StrategyShard() {
+    stop();
+}
+
+void StrategyShard::addEventHandler(EventHandler handler) {
+    handlers_.push_back(std::move(handler));
+}
+
+void StrategyShard::addInstrument(const Instrument& instrument) {
+    auto it = instrument_index_.find(instrument.id);
+    if (it != instrument_index_.end()) {
+        instruments_[it->second] = instrument;
+    } else {
+        instrument_index_[instrument.id] = instruments_.size();
+        instruments_.push_back(instrument);
+        confidence_scorer_.addInstrument(instrument.id);
+    }
+    
+    // One expiry per instrument; re-adding it replaces the pending one
+    auto timer = expiry_timers_.find(instrument.id);
+    if (timer != expiry_timers_.end()) {
+        timing_wheel_.cancel(timer->second);
+        expiry_timers_.erase(timer);
+    }
+    bool expires = instrument.type == InstrumentType::FUTURES || instrument.type == InstrumentType::OPTION;
+    if (expires && instrument.expiry_time.time_since_epoch().count() != 0) {
+        InstrumentId instrument_id = instrument.id;
+        expiry_timers_[instrument_id] = timing_wheel_.scheduleAt(instrument.expiry_time, [this, instrument_id]() {
+            expiry_timers_.erase(instrument_id);
+            expireInstrument(instrument_id);
+        });
+    }
+}
+
+void StrategyShard::start(int cpu_core) {
+    if (running_.exchange(true)) {
+        LOG_WARN("Strategy shard {} already running", shard_id_);
+        return;
+    }
+    
+    cpu_core_ = cpu_core;
+    thread_ = std::make_unique<std::thread>(&StrategyShard::processingLoop, this);
+    pinThreadToCore(*thread_, cpu_core_);
+    
+    LOG_INFO("Strategy shard {} started (core {})", shard_id_, cpu_core_);
+}
+
+void StrategyShard::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    
+    event_loop_.stop();
+    if (thread_ && thread_->joinable()) {
+        thread_->join();
+    }
+    
+    LOG_INFO("Strategy shard {} stopped after {} events", shard_id_, getEventsProcessed());
+}
+
+void StrategyShard::submit(MarketEvent event) {
+    if (queue_.push(std::move(event))) {
+        event_loop_.notify(wakeup_id_);
+    }
+}
+
+void StrategyShard::processEvent(const MarketEvent& event) {
+    switch (event.type) {
+        case MarketEventType::BOOK_UPDATE: {
+            auto& book = books_[event.instrument_id];
+            book = event.book;
+            if (book.instrument_id.empty()) {
+                book.instrument_id = event.instrument_id;
+            }
+            input_times_[event.instrument_id] = InputTimes{event.exchange_time, event.receive_time};
+            publishTopOfBook(book, event);
+            
+            // Freshness is measured from when the venue produced the book
+            Timestamp book_time = event.exchange_time.time_since_epoch().count() != 0 ? event.exchange_time
+                                : event.receive_time.time_since_epoch().count() != 0 ? event.receive_time
+                                : getEngineTimestamp();
+            confidence_scorer_.onBookUpdate(event.instrument_id, book, book_time);
+            dependency_graph_.markInstrumentDirty(event.instrument_id);
+            break;
+        }
+        case MarketEventType::FUNDING_RATE:
+            funding_rates_[event.instrument_id] = event.funding;
+            funding_history_.record(event.funding);
+            scheduleFundingTime(event.funding);
+            break;
+        default:
+            break;
+    }
+    
+    dispatch(event);
+    if (!in_batch_) {
+        flushDependencies();
+    }
+    
+    events_processed_.fetch_add(1, std::memory_order_relaxed);
+    
+    auto& perf_monitor = PerformanceMonitor::getInstance();
+    perf_monitor.recordMessageProcessed();
+    if (event.receive_time.time_since_epoch().count() != 0) {
+        auto latency = std::chrono::duration<double, std::milli>(
+            getEngineTimestamp() - event.receive_time).count();
+        perf_monitor.recordLatency(latency);
+    }
+}
+
+const OrderBook* StrategyShard::getOrderBook(const InstrumentId& instrument_id) const {
+    auto it = books_.find(instrument_id);
+    return it == books_.end() ? nullptr : &it->second;
+}
+
+const FundingRate* StrategyShard::getFundingRate(const InstrumentId& instrument_id) const {
+    auto it = funding_rates_.find(instrument_id);
+    return it == funding_rates_.end() ? nullptr : &it->second;
+}
+
+const Instrument* StrategyShard::getInstrument(const InstrumentId& instrument_id) const {
+    auto it = instrument_index_.find(instrument_id);
+    return it == instrument_index_.end() ? nullptr : &instruments_[it->second];
+}
+
+void StrategyShard::advanceTimers(Timestamp now) {
+    try {
+        timing_wheel_.advance(now);
+    } catch (const std::exception& e) {
+        LOG_ERROR("Strategy shard {} timer callback failed: {}", shard_id_, e.what());
+    }
+    
+    // Timer callbacks may emit (e.g. pre-snapshot funding re-evaluations)
+    publishOpportunities();
+    armTimer();
+}
+
+void StrategyShard::armTimer() {
+    Timestamp deadline;
+    if (!timing_wheel_.nextDeadline(deadline)) {
+        if (armed_deadline_.time_since_epoch().count() != 0) {
+            event_loop_.disarmTimer(wheel_timer_id_);
+            armed_deadline_ = Timestamp();
+        }
+        return;
+    }
+    if (deadline != armed_deadline_) {
+        armed_deadline_ = deadline;
+        event_loop_.rearmTimer(wheel_timer_id_, deadline - getEngineTimestamp(), std::chrono::nanoseconds(0));
+    }
+}
+
+bool StrategyShard::sizeOpportunity(ArbitrageOpportunity& opportunity, const double* weights) {
+    const size_t count = opportunity.leg_instruments.size();
+    if (count > DepthSizer::kMaxLegs || opportunity.leg_sides.size() != count) {
+        return false;
+    }
+    
+    std::array<const OrderBook*, DepthSizer::kMaxLegs> books;
+    for (size_t i = 0; i < count; ++i) {
+        books[i] = getOrderBook(opportunity.leg_instruments[i]);
+        if (books[i] == nullptr) {
+            return false;
+        }
+    }
+    return depth_sizer_.sizeOpportunity(opportunity, books.data(), weights);
+}
+
+bool StrategyShard::admitOpportunity(ArbitrageOpportunity& opportunity) {
+    leg_times_.clear();
+    for (const auto& instrument_id : opportunity.leg_instruments) {
+        auto it = input_times_.find(instrument_id);
+        leg_times_.push_back(it == input_times_.end() ? InputTimes() : it->second);
+    }
+    return latency_budget_.admit(opportunity, leg_times_.data(), leg_times_.size(), DetectionStage::SHARD,
+                                 getEngineTimestamp());
+}
+
+void StrategyShard::emitOpportunity(ArbitrageOpportunity opportunity) {
+    pending_opportunities_.push_back(std::move(opportunity));
+}
+
+bool StrategyShard::emitScored(ArbitrageOpportunity opportunity) {
+    if (!admitOpportunity(opportunity) || !confidence_scorer_.scoreOpportunity(opportunity, getEngineTimestamp())) {
+        return false;
+    }
+    emitOpportunity(std::move(opportunity));
+    return true;
+}
+
+bool StrategyShard::emitSized(ArbitrageOpportunity opportunity, const double* weights) {
+    if (!admitOpportunity(opportunity) || !confidence_scorer_.scoreOpportunity(opportunity, getEngineTimestamp()) ||
+        !sizeOpportunity(opportunity, weights)) {
+        return false;
+    }
+    emitOpportunity(std::move(opportunity));
+    return true;
+}
+
+uint64_t StrategyShard::getEventsProcessed() const {
+    return events_processed_.load(std::memory_order_relaxed);
+}
+
+size_t StrategyShard::getQueueDepth() const {
+    return queue_.size();
+}
+
+uint64_t StrategyShard::getConflatedUpdates() const {
+    return queue_.getConflatedCount();
+}
+
+void StrategyShard::processingLoop() {
+    armTimer();  // Stages may have scheduled before start()
+    event_loop_.run();
+    
+    // Deliver anything queued before stop()
+    drainQueue();
+}
+
+void StrategyShard::drainQueue() {
+    queue_.drain(batch_);
+    processBatch(batch_);
+    batch_.clear();
+    armTimer();
+}
+
+void StrategyShard::processBatch(const std::vector<MarketEvent>& events) {
+    uint64_t conflated = 0;
+    in_batch_ = true;
+    for (const auto& event : events) {
+        conflated += event.conflated_updates;
+        try {
+            processEvent(event);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Strategy shard {} failed to process event for {}: {}",
+                      shard_id_, event.instrument_id, e.what());
+        }
+    }
+    in_batch_ = false;
+    flushDependencies();
+    
+    if (conflated > 0) {
+        PerformanceMonitor::getInstance().recordConflatedUpdates(conflated);
+    }
+}
+
+void StrategyShard::publishTopOfBook(const OrderBook& book, const MarketEvent& event) {
+    if (!merger_) {
+        return;
+    }
+    
+    TopOfBook top;
+    top.instrument_id = book.instrument_id;
+    top.exchange_id = book.exchange_id;
+    top.bid_price = book.getBestBid();
+    top.ask_price = book.getBestAsk();
+    top.bid_volume = book.bids.empty() ? 0.0 : book.bids[0].volume;
+    top.ask_volume = book.asks.empty() ? 0.0 : book.asks[0].volume;
+    top.timestamp = book.timestamp;
+    top.exchange_time = event.exchange_time;
+    top.receive_time = event.receive_time;
+    top.shard_id = shard_id_;
+    
+    // Only cross the shard boundary when the top of book actually moved, or
+    // often enough (half the latency budget) that the merger's copy of a
+    // quiet but live book does not age out of its budget
+    auto& last = last_tops_[top.instrument_id];
+    if (last.bid_price == top.bid_price && last.ask_price == top.ask_price &&
+        last.bid_volume == top.bid_volume && last.ask_volume == top.ask_volume &&
+        !last.instrument_id.empty()) {
+        const auto refresh = latency_budget_.getConfig().max_age / 2;
+        const bool timed = top.receive_time.time_since_epoch().count() != 0 &&
+                           last.receive_time.time_since_epoch().count() != 0;
+        if (refresh.count() == 0 || !timed || top.receive_time - last.receive_time < refresh) {
+            return;
+        }
+    }
+    last = top;
+    merger_->publishTopOfBook(top);
+}
+
+void StrategyShard::dispatch(const MarketEvent& event) {
+    for (auto& handler : handlers_) {
+        handler(*this, event);
+    }
+    publishOpportunities();
+}
+
+void StrategyShard::flushDependencies() {
+    try {
+        dependency_graph_.flush(getEngineTimestamp());
+    } catch (const std::exception& e) {
+        LOG_ERROR("Strategy shard {} dependency recompute failed: {}", shard_id_, e.what());
+    }
+    publishOpportunities();
+}
+
+void StrategyShard::publishOpportunities() {
+    if (!pending_opportunities_.empty() && merger_) {
+        merger_->publishOpportunities(pending_opportunities_);
+    }
+}
+
+void StrategyShard::scheduleFundingTime(const FundingRate& funding) {
+    if (funding.next_funding_time.time_since_epoch().count() == 0 ||
+        funding.next_funding_time <= timing_wheel_.now()) {
+        return;
+    }
+    
+    // One pending funding snapshot per instrument; a newer print replaces it
+    auto& handle = funding_timers_[funding.instrument_id];
+    timing_wheel_.cancel(handle);
+    
+    InstrumentId instrument_id = funding.instrument_id;
+    handle = timing_wheel_.scheduleAt(funding.next_funding_time, [this, instrument_id]() {
+        funding_timers_.erase(instrument_id);
+        
+        MarketEvent event;
+        event.type = MarketEventType::FUNDING_TIME;
+        event.instrument_id = instrument_id;
+        if (const FundingRate* rate = getFundingRate(instrument_id)) {
+            event.funding = *rate;
+            event.exchange_id = rate->exchange_id;
+        }
+        event.exchange_time = timing_wheel_.now();
+        dispatch(event);
+    });
+}
+
+void StrategyShard::expireInstrument(const InstrumentId& instrument_id) {
+    auto it = instrument_index_.find(instrument_id);
+    if (it != instrument_index_.end()) {
+        instruments_[it->second].is_active = false;
+    }
+    books_.erase(instrument_id);
+    last_tops_.erase(instrument_id);
+    input_times_.erase(instrument_id);
+    
+    LOG_INFO("Strategy shard {}: instrument {} expired", shard_id_, instrument_id);
+    
+    MarketEvent event;
+    event.type = MarketEventType::INSTRUMENT_EXPIRY;
+    event.instrument_id = instrument_id;
+    event.exchange_time = timing_wheel_.now();
+    dispatch(event);
+}
+
+} // namespace arbitrage
@@ -0,0 +1,305 @@
+#include "timing_wheel.hpp"
+
+namespace arbitrage {
+
+TimingWheel::TimingWheel(std::chrono::nanoseconds resolution, Timestamp start_time)
+    : resolution_(resolution.count() > 0 ? resolution : std::chrono::nanoseconds(1)),
+      origin_(start_time),
+      current_time_(start_time) {
+    for (auto& level : levels_) {
+        level.heads.fill(kNil);
+        level.tails.fill(kNil);
+        level.occupied.fill(0);
+    }
+}
+
+TimingWheel::TimerHandle TimingWheel::scheduleAt(Timestamp deadline, Callback callback) {
+    // Round up so a timer never fires before its deadline
+    uint64_t tick = 0;
+    if (deadline > origin_) {
+        auto offset = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - origin_);
+        tick = (static_cast<uint64_t>(offset.count()) + resolution_.count() - 1) / resolution_.count();
+    }
+    
+    uint32_t index = allocateNode();
+    Node& node = nodes_[index];
+    node.callback = std::move(callback);
+    node.expiry_tick = tick;
+    node.active = true;
+    ++active_count_;
+    
+    place(index);
+    return makeHandle(index, node.generation);
+}
+
+TimingWheel::TimerHandle TimingWheel::scheduleAfter(std::chrono::nanoseconds delay, Callback callback) {
+    return scheduleAt(current_time_ + std::chrono::duration_cast<Timestamp::duration>(delay),
+                      std::move(callback));
+}
+
+bool TimingWheel::cancel(TimerHandle handle) {
+    if (handle == 0) {
+        return false;
+    }
+    
+    uint32_t index = static_cast<uint32_t>(handle & 0xFFFFFFFFu) - 1;
+    uint32_t generation = static_cast<uint32_t>(handle >> 32);
+    if (index >= nodes_.size()) {
+        return false;
+    }
+    
+    Node& node = nodes_[index];
+    if (!node.active || node.generation != generation) {
+        return false;
+    }
+    
+    --active_count_;
+    if (node.level == kDueLevel) {
+        // Already detached for firing; released when the due list drains
+        node.active = false;
+        node.callback = nullptr;
+        return true;
+    }
+    
+    unlink(index);
+    releaseNode(index);
+    return true;
+}
+
+size_t TimingWheel::advance(Timestamp now) {
+    Timestamp end_time = now > current_time_ ? now : current_time_;
+    uint64_t target = toTick(end_time);
+    
+    size_t fired = fireDue();
+    while (current_tick_ < target && active_count_ > 0) {
+        uint64_t tick = nextEventTick();
+        if (tick > target) {
+            break;
+        }
+        
+        // Callbacks see now() as their own deadline, so timers they schedule
+        // relative to now() land in the right place
+        current_tick_ = tick;
+        current_time_ = origin_ + std::chrono::duration_cast<Timestamp::duration>(resolution_ * tick);
+        
+        // Cascade higher levels whose block starts here, top-down, then fire
+        for (int level = kLevels - 1; level >= 1; --level) {
+            uint64_t lower_mask = (uint64_t(1) << (kSlotBits * level)) - 1;
+            if ((current_tick_ & lower_mask) == 0) {
+                cascade(level, static_cast<uint32_t>((current_tick_ >> (kSlotBits * level)) & kSlotMask));
+            }
+        }
+        fired += fireSlot(static_cast<uint32_t>(current_tick_ & kSlotMask));
+    }
+    
+    current_tick_ = target;
+    current_time_ = end_time;
+    return fired;
+}
+
+bool TimingWheel::nextDeadline(Timestamp& deadline) const {
+    if (!due_.empty()) {
+        deadline = current_time_;
+        return true;
+    }
+    uint64_t tick = active_count_ == 0 ? UINT64_MAX : nextEventTick();
+    if (tick == UINT64_MAX) {
+        return false;
+    }
+    deadline = origin_ + std::chrono::duration_cast<Timestamp::duration>(resolution_ * tick);
+    return true;
+}
+
+uint64_t TimingWheel::nextEventTick() const {
+    // Entries at level L always sit in a slot after the current digit of L,
+    // so the first occupied slot found from the bottom up is the next tick at
+    // which anything fires or cascades
+    for (int level = 0; level < kLevels; ++level) {
+        int shift = kSlotBits * level;
+        uint32_t digit = static_cast<uint32_t>((current_tick_ >> shift) & kSlotMask);
+        uint64_t block = (current_tick_ >> (shift + kSlotBits)) << (shift + kSlotBits);
+        
+        int slot = digit == kSlotMask ? -1 : nextOccupiedSlot(level, digit + 1);
+        if (slot >= 0) {
+            return block + (static_cast<uint64_t>(slot) << shift);
+        }
+        if (level == kLevels - 1) {
+            // Parked beyond-span entries: wrap into the next top-level cycle
+            slot = nextOccupiedSlot(level, 0);
+            if (slot >= 0) {
+                return block + (uint64_t(1) << (shift + kSlotBits)) + (static_cast<uint64_t>(slot) << shift);
+            }
+        }
+    }
+    return UINT64_MAX;
+}
+
+uint64_t TimingWheel::toTick(Timestamp time) const {
+    if (time <= origin_) {
+        return 0;
+    }
+    auto offset = std::chrono::duration_cast<std::chrono::nanoseconds>(time - origin_);
+    return static_cast<uint64_t>(offset.count()) / resolution_.count();
+}
+
+uint32_t TimingWheel::allocateNode() {
+    if (!free_nodes_.empty()) {
+        uint32_t index = free_nodes_.back();
+        free_nodes_.pop_back();
+        return index;
+    }
+    nodes_.emplace_back();
+    return static_cast<uint32_t>(nodes_.size() - 1);
+}
+
+void TimingWheel::releaseNode(uint32_t index) {
+    Node& node = nodes_[index];
+    node.callback = nullptr;
+    node.active = false;
+    node.next = kNil;
+    node.prev = kNil;
+    ++node.generation;
+    free_nodes_.push_back(index);
+}
+
+void TimingWheel::place(uint32_t index) {
+    Node& node = nodes_[index];
+    if (node.expiry_tick <= current_tick_) {
+        node.level = kDueLevel;
+        due_.push_back(index);
+        return;
+    }
+    
+    // Level = most significant 8-bit digit in which expiry and now differ;
+    // the entry cascades down when "now" reaches that digit's value
+    uint64_t diff = node.expiry_tick ^ current_tick_;
+    int level = (63 - __builtin_clzll(diff)) / kSlotBits;
+    uint32_t slot;
+    if (level >= kLevels) {
+        // Beyond the current top-level cycle: park in a top-level slot that is
+        // visited no later than the deadline's block and re-place it there.
+        // Deadlines early in the next cycle use their own slot (reached after
+        // the wrap); anything further parks in the last slot to be visited.
+        level = kLevels - 1;
+        int shift = kSlotBits * level;
+        uint32_t top_digit = static_cast<uint32_t>((current_tick_ >> shift) & kSlotMask);
+        uint32_t expiry_digit = static_cast<uint32_t>((node.expiry_tick >> shift) & kSlotMask);
+        bool next_cycle = (node.expiry_tick >> (shift + kSlotBits)) == (current_tick_ >> (shift + kSlotBits)) + 1;
+        slot = next_cycle && expiry_digit < top_digit ? expiry_digit : (top_digit + kSlotMask) & kSlotMask;
+    } else {
+        slot = static_cast<uint32_t>((node.expiry_tick >> (kSlotBits * level)) & kSlotMask);
+    }
+    link(index, level, slot);
+}
+
+void TimingWheel::link(uint32_t index, int level, uint32_t slot) {
+    Node& node = nodes_[index];
+    Level& wheel_level = levels_[level];
+    
+    node.level = static_cast<uint8_t>(level);
+    node.slot = static_cast<uint8_t>(slot);
+    node.next = kNil;
+    node.prev = wheel_level.tails[slot];
+    
+    // Append at the tail so same-tick timers fire in scheduling order
+    if (node.prev == kNil) {
+        wheel_level.heads[slot] = index;
+    } else {
+        nodes_[node.prev].next = index;
+    }
+    wheel_level.tails[slot] = index;
+    wheel_level.occupied[slot / 64] |= uint64_t(1) << (slot % 64);
+}
+
+void TimingWheel::unlink(uint32_t index) {
+    Node& node = nodes_[index];
+    Level& wheel_level = levels_[node.level];
+    uint32_t slot = node.slot;
+    
+    if (node.prev == kNil) {
+        wheel_level.heads[slot] = node.next;
+    } else {
+        nodes_[node.prev].next = node.next;
+    }
+    if (node.next == kNil) {
+        wheel_level.tails[slot] = node.prev;
+    } else {
+        nodes_[node.next].prev = node.prev;
+    }
+    
+    if (wheel_level.heads[slot] == kNil) {
+        wheel_level.occupied[slot / 64] &= ~(uint64_t(1) << (slot % 64));
+    }
+    node.next = kNil;
+    node.prev = kNil;
+}
+
+void TimingWheel::cascade(int level, uint32_t slot) {
+    Level& wheel_level = levels_[level];
+    uint32_t index = wheel_level.heads[slot];
+    wheel_level.heads[slot] = kNil;
+    wheel_level.tails[slot] = kNil;
+    wheel_level.occupied[slot / 64] &= ~(uint64_t(1) << (slot % 64));
+    
+    while (index != kNil) {
+        uint32_t next = nodes_[index].next;
+        place(index);
+        index = next;
+    }
+}
+
+size_t TimingWheel::fireSlot(uint32_t slot) {
+    // Move the slot onto the due list; cancel() handles due entries lazily,
+    // so callbacks may cancel timers later in the same batch
+    Level& wheel_level = levels_[0];
+    uint32_t index = wheel_level.heads[slot];
+    wheel_level.heads[slot] = kNil;
+    wheel_level.tails[slot] = kNil;
+    wheel_level.occupied[slot / 64] &= ~(uint64_t(1) << (slot % 64));
+    
+    while (index != kNil) {
+        uint32_t next = nodes_[index].next;
+        nodes_[index].level = kDueLevel;
+        due_.push_back(index);
+        index = next;
+    }
+    return fireDue();
+}
+
+size_t TimingWheel::fireDue() {
+    size_t fired = 0;
+    while (!due_.empty()) {
+        firing_.clear();
+        firing_.swap(due_);
+        
+        for (uint32_t index : firing_) {
+            if (!nodes_[index].active) {
+                releaseNode(index);  // cancelled while due
+                continue;
+            }
+            
+            Callback callback = std::move(nodes_[index].callback);
+            --active_count_;
+            releaseNode(index);
+            callback();
+            ++fired;
+        }
+    }
+    return fired;
+}
+
+int TimingWheel::nextOccupiedSlot(int level, uint32_t from) const {
+    const auto& occupied = levels_[level].occupied;
+    for (uint32_t word = from / 64; word < occupied.size(); ++word) {
+        uint64_t bits = occupied[word];
+        if (word == from / 64) {
+            bits &= ~uint64_t(0) << (from % 64);
+        }
+        if (bits != 0) {
+            return static_cast<int>(word * 64 + __builtin_ctzll(bits));
+        }
+    }
+    return -1;
+}
+
+} // namespace arbitrage
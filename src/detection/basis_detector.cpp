@@ -0,0 +1,121 @@
+#include "basis_detector.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace arbitrage {
+
+BasisSpreadDetector::BasisSpreadDetector(const BasisDetectorConfig& config)
+    : config_(config),
+      time_constant_s_(std::max(std::chrono::duration<double>(config.time_constant).count(), 1e-3)) {
+}
+
+size_t BasisSpreadDetector::addContract(const InstrumentId& derivative_id, Exchange derivative_exchange,
+                                        const InstrumentId& spot_id, Exchange spot_exchange) {
+    auto it = index_.find(derivative_id);
+    if (it != index_.end()) {
+        return it->second;
+    }
+    
+    size_t index = derivative_ids_.size();
+    derivative_ids_.push_back(derivative_id);
+    spot_ids_.push_back(spot_id);
+    derivative_exchanges_.push_back(derivative_exchange);
+    spot_exchanges_.push_back(spot_exchange);
+    index_[derivative_id] = index;
+    
+    basis_.push_back(std::numeric_limits<double>::quiet_NaN());
+    mean_.push_back(0.0);
+    variance_.push_back(0.0);
+    z_score_.push_back(std::numeric_limits<double>::quiet_NaN());
+    last_update_.emplace_back();
+    samples_.push_back(0);
+    anomalous_.push_back(0);
+    return index;
+}
+
+bool BasisSpreadDetector::update(size_t index, Price derivative_mid, Price fair_value, Price spot_mid,
+                                 Timestamp now, std::vector<ArbitrageOpportunity>& out) {
+    if (!(derivative_mid > 0.0) || !(fair_value > 0.0) || !(spot_mid > 0.0)) {
+        return false;
+    }
+    ++update_count_;
+    
+    // Score against the statistics before this observation
+    const double basis = (derivative_mid - fair_value) / fair_value;
+    const double deviation = basis - mean_[index];
+    const double variance = variance_[index];
+    const bool warm = samples_[index] >= config_.min_samples && variance > 0.0;
+    const double z = warm ? deviation / std::sqrt(variance) : std::numeric_limits<double>::quiet_NaN();
+    basis_[index] = basis;
+    z_score_[index] = z;
+    
+    // Time-weighted EWMA; the first observation seeds the mean
+    if (samples_[index] == 0) {
+        mean_[index] = basis;
+        samples_[index] = 1;
+    } else {
+        const double dt = std::chrono::duration<double>(now - last_update_[index]).count();
+        if (dt > 0.0) {
+            const double alpha = dt / (dt + time_constant_s_);
+            mean_[index] += alpha * deviation;
+            variance_[index] = (1.0 - alpha) * (variance + alpha * deviation * deviation);
+            ++samples_[index];
+        }
+    }
+    if (now > last_update_[index]) {
+        last_update_[index] = now;
+    }
+    
+    // One report per excursion
+    const bool beyond = std::fabs(basis) >= config_.min_basis;
+    if (anomalous_[index]) {
+        if (!beyond || !(std::fabs(z) >= config_.z_exit)) {
+            anomalous_[index] = 0;
+        }
+        return false;
+    }
+    if (!beyond || !(std::fabs(z) >= config_.z_threshold)) {
+        return false;
+    }
+    anomalous_[index] = 1;
+    ++anomaly_count_;
+    emit(index, derivative_mid, fair_value, spot_mid, now, out);
+    return true;
+}
+
+bool BasisSpreadDetector::find(const InstrumentId& derivative_id, size_t& index) const {
+    auto it = index_.find(derivative_id);
+    if (it == index_.end()) {
+        return false;
+    }
+    index = it->second;
+    return true;
+}
+
+double BasisSpreadDetector::getStdDev(size_t index) const {
+    return std::sqrt(variance_[index]);
+}
+
+void BasisSpreadDetector::emit(size_t index, Price derivative_mid, Price fair_value, Price spot_mid,
+                               Timestamp now, std::vector<ArbitrageOpportunity>& out) {
+    // Rich derivative: sell it and buy spot; cheap derivative: the reverse
+    const bool rich = basis_[index] > 0.0;
+    
+    ArbitrageOpportunity opportunity;
+    opportunity.type = ArbitrageType::BASIS_SPREAD_ARBITRAGE;
+    opportunity.opportunity_id = std::string("BASIS:") + (rich ? "S:" : "B:") + derivative_ids_[index];
+    opportunity.leg_instruments = {derivative_ids_[index], spot_ids_[index]};
+    opportunity.leg_exchanges = {derivative_exchanges_[index], spot_exchanges_[index]};
+    opportunity.leg_sides = {rich ? OrderSide::SELL : OrderSide::BUY, rich ? OrderSide::BUY : OrderSide::SELL};
+    opportunity.leg_prices = {derivative_mid, spot_mid};
+    opportunity.leg_volumes = {1.0, 1.0};
+    opportunity.expected_profit_percentage = std::fabs(basis_[index]);
+    opportunity.expected_profit = std::fabs(derivative_mid - fair_value);
+    opportunity.detection_time = now;
+    opportunity.expiry_time = now + config_.opportunity_ttl;
+    opportunity.is_active = true;
+    out.push_back(std::move(opportunity));
+}
+
+} // namespace arbitrage
@@ -0,0 +1,424 @@
+#include "cointegration_engine.hpp"
+#include "simd.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace arbitrage {
+
+namespace {
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+uint64_t pairKey(uint32_t y, uint32_t x) {
+    return (static_cast<uint64_t>(y) << 32) | x;
+}
+
+// Engle-Granger statistic of one pair over a time-ordered column of the
+// history: OLS y = a + b * x, then the Dickey-Fuller regression
+// de_t = gamma * e_{t-1} on the residuals; returns gamma's t-statistic
+// (NaN with fewer than min_samples complete rows)
+double engleGrangerStatistic(const double* y, const double* x, size_t rows, size_t stride, size_t min_samples) {
+    size_t n = 0;
+    double sum_x = 0.0, sum_y = 0.0;
+    for (size_t r = 0; r < rows; ++r) {
+        double yr = y[r * stride], xr = x[r * stride];
+        if (std::isfinite(yr) && std::isfinite(xr)) {
+            sum_x += xr;
+            sum_y += yr;
+            ++n;
+        }
+    }
+    if (n < std::max<size_t>(min_samples, 3)) {
+        return kNaN;
+    }
+    
+    const double mean_x = sum_x / n, mean_y = sum_y / n;
+    double sxx = 0.0, sxy = 0.0;
+    for (size_t r = 0; r < rows; ++r) {
+        double yr = y[r * stride], xr = x[r * stride];
+        if (std::isfinite(yr) && std::isfinite(xr)) {
+            sxx += (xr - mean_x) * (xr - mean_x);
+            sxy += (xr - mean_x) * (yr - mean_y);
+        }
+    }
+    if (!(sxx > 0.0)) {
+        return kNaN;
+    }
+    const double beta = sxy / sxx;
+    
+    // Gaps are skipped: consecutive complete rows count as adjacent
+    double lagged_sq = 0.0, cross = 0.0, diff_sq = 0.0, previous = kNaN;
+    size_t m = 0;
+    for (size_t r = 0; r < rows; ++r) {
+        double yr = y[r * stride], xr = x[r * stride];
+        if (!std::isfinite(yr) || !std::isfinite(xr)) {
+            continue;
+        }
+        double residual = (yr - mean_y) - beta * (xr - mean_x);
+        if (std::isfinite(previous)) {
+            double diff = residual - previous;
+            lagged_sq += previous * previous;
+            cross += previous * diff;
+            diff_sq += diff * diff;
+            ++m;
+        }
+        previous = residual;
+    }
+    if (m < 2 || !(lagged_sq > 0.0)) {
+        return kNaN;
+    }
+    
+    const double gamma = cross / lagged_sq;
+    const double ssr = std::max(diff_sq - gamma * cross, 0.0);
+    const double standard_error = std::sqrt(ssr / (m - 1) / lagged_sq);
+    return standard_error > 0.0 ? gamma / standard_error : -std::numeric_limits<double>::infinity();
+}
+
+} // namespace
+
+CointegrationEngine::CointegrationEngine(const CointegrationConfig& config)
+    : config_(config) {
+    config_.history_length = std::max<size_t>(config_.history_length, 2);
+    config_.ewma_alpha = std::min(std::max(config_.ewma_alpha, 1e-6), 1.0);
+    if (config_.sample_interval.count() <= 0) {
+        config_.sample_interval = std::chrono::milliseconds(1);
+    }
+}
+
+CointegrationEngine::~CointegrationEngine() {
+    stop();
+}
+
+size_t CointegrationEngine::addInstruments(const std::vector<Instrument>& instruments) {
+    std::vector<const Instrument*> spot;
+    for (const auto& instrument : instruments) {
+        if (instrument.type == InstrumentType::SPOT && !instrument.base_asset.empty() &&
+            !instrument.quote_asset.empty()) {
+            spot.push_back(&instrument);
+        }
+    }
+    
+    // Same quote currency, different base: both mids are prices of the bases
+    // in one unit, so their log spread is a relative value trade
+    size_t added = 0;
+    for (size_t i = 0; i < spot.size(); ++i) {
+        for (size_t j = i + 1; j < spot.size(); ++j) {
+            if (spot[i]->quote_asset == spot[j]->quote_asset && spot[i]->base_asset != spot[j]->base_asset &&
+                addPair(spot[i]->id, spot[j]->id)) {
+                ++added;
+            }
+        }
+    }
+    return added;
+}
+
+bool CointegrationEngine::addPair(const InstrumentId& y_id, const InstrumentId& x_id) {
+    if (y_id == x_id) {
+        return false;
+    }
+    uint32_t y = bookSlot(y_id);
+    uint32_t x = bookSlot(x_id);
+    if (pair_index_.count(pairKey(y, x)) != 0 || pair_index_.count(pairKey(x, y)) != 0) {
+        return false;
+    }
+    
+    uint32_t index = static_cast<uint32_t>(pairs_.size());
+    pairs_.push_back(Pair{y, x});
+    pair_index_[pairKey(y, x)] = index;
+    book_dependents_[y].push_back(Dependent{index, true});
+    book_dependents_[x].push_back(Dependent{index, false});
+    resizeColumns();
+    
+    // Seed the new lane from books already seen
+    y_[index] = book_mid_[y];
+    x_[index] = book_mid_[x];
+    return true;
+}
+
+void CointegrationEngine::setSignalCallback(SignalCallback callback) {
+    signal_callback_ = std::move(callback);
+}
+
+void CointegrationEngine::start() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_) {
+            return;
+        }
+        running_ = true;
+    }
+    thread_ = std::make_unique<std::thread>(&CointegrationEngine::workerLoop, this);
+}
+
+void CointegrationEngine::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    job_ready_.notify_all();
+    if (thread_ && thread_->joinable()) {
+        thread_->join();
+    }
+    thread_.reset();
+}
+
+bool CointegrationEngine::onTopOfBook(const TopOfBook& top) {
+    auto it = book_slots_.find(top.instrument_id);
+    if (it == book_slots_.end()) {
+        return false;
+    }
+    
+    // A one-sided book has no mid: its pairs go unpriced until it recovers
+    double mid = top.bid_price > 0.0 && top.ask_price > 0.0 ? std::log(0.5 * (top.bid_price + top.ask_price))
+                                                            : kNaN;
+    book_mid_[it->second] = mid;
+    for (const Dependent& dependent : book_dependents_[it->second]) {
+        const uint32_t pair = dependent.pair;
+        (dependent.is_y ? y_ : x_)[pair] = mid;
+        z_score_[pair] = (y_[pair] - beta_[pair] * x_[pair] - spread_mean_[pair]) / spread_sd_[pair];
+        updateSignal(pair);
+    }
+    return true;
+}
+
+void CointegrationEngine::startSampleTimer(TimingWheel& wheel) {
+    const auto interval = std::chrono::duration_cast<Timestamp::duration>(config_.sample_interval);
+    const Timestamp next((wheel.now().time_since_epoch() / interval + 1) * interval);
+    wheel.scheduleAt(next, [this, &wheel]() {
+        sample(wheel.now());
+        startSampleTimer(wheel);
+    });
+}
+
+bool CointegrationEngine::sample(Timestamp now) {
+    using simd::VecD;
+    using simd::MaskD;
+    
+    if (now < next_sample_) {
+        return false;
+    }
+    const auto interval = std::chrono::duration_cast<Timestamp::duration>(config_.sample_interval);
+    next_sample_ = Timestamp((now.time_since_epoch() / interval + 1) * interval);
+    
+    const VecD alpha = VecD::broadcast(config_.ewma_alpha);
+    const VecD keep = VecD::broadcast(1.0 - config_.ewma_alpha);
+    const VecD one = VecD::broadcast(1.0);
+    const VecD zero = VecD::broadcast(0.0);
+    const VecD nan = VecD::broadcast(kNaN);
+    const VecD lowest = VecD::broadcast(-std::numeric_limits<double>::infinity());
+    const VecD warm = VecD::broadcast(static_cast<double>(config_.min_samples));
+    const size_t row = static_cast<size_t>(rows_ % config_.history_length) * stride_;
+    
+    for (size_t i = 0; i < stride_; i += simd::kLanes) {
+        const VecD y = VecD::load(&y_[i]);
+        const VecD x = VecD::load(&x_[i]);
+        const MaskD valid = (y > lowest) & (x > lowest);  // NaN lanes fail
+        const VecD count = VecD::load(&count_[i]);
+        
+        // Incremental EWMA moments; a lane's first sample seeds the means
+        const MaskD first = count < one;
+        const VecD mean_x = simd::select(first, x, VecD::load(&mean_x_[i]));
+        const VecD mean_y = simd::select(first, y, VecD::load(&mean_y_[i]));
+        const VecD dx = x - mean_x;
+        const VecD dy = y - mean_y;
+        const VecD adx = alpha * dx;
+        const VecD var_x = simd::select(valid, keep * simd::fma(adx, dx, VecD::load(&var_x_[i])), VecD::load(&var_x_[i]));
+        const VecD var_y = simd::select(valid, keep * simd::fma(alpha * dy, dy, VecD::load(&var_y_[i])), VecD::load(&var_y_[i]));
+        const VecD cov = simd::select(valid, keep * simd::fma(adx, dy, VecD::load(&cov_xy_[i])), VecD::load(&cov_xy_[i]));
+        const VecD new_mean_x = simd::select(valid, simd::fma(alpha, dx, mean_x), VecD::load(&mean_x_[i]));
+        const VecD new_mean_y = simd::select(valid, simd::fma(alpha, dy, mean_y), VecD::load(&mean_y_[i]));
+        const VecD new_count = simd::select(valid, count + one, count);
+        new_mean_x.store(&mean_x_[i]);
+        new_mean_y.store(&mean_y_[i]);
+        var_x.store(&var_x_[i]);
+        var_y.store(&var_y_[i]);
+        cov.store(&cov_xy_[i]);
+        new_count.store(&count_[i]);
+        
+        // Hedge ratio and the spread's moments at that ratio
+        const VecD beta = cov / var_x;
+        const VecD spread_mean = new_mean_y - beta * new_mean_x;
+        const VecD spread_var = var_y - beta * cov;
+        const VecD spread_sd = simd::sqrt(simd::max(spread_var, zero));
+        const MaskD ready = (new_count >= warm) & (var_x > zero) & (spread_var > zero);
+        simd::select(ready, beta, nan).store(&beta_[i]);
+        simd::select(ready, spread_mean, nan).store(&spread_mean_[i]);
+        simd::select(ready, spread_sd, nan).store(&spread_sd_[i]);
+        simd::select(ready, (y - beta * x - spread_mean) / spread_sd, nan).store(&z_score_[i]);
+        
+        simd::select(valid, y, nan).store(&history_y_[row + i]);
+        simd::select(valid, x, nan).store(&history_x_[row + i]);
+    }
+    ++rows_;
+    ++sample_count_;
+    
+    // Only pairs that passed their last test can change signal here
+    applyTestResults();
+    for (uint32_t pair : tradable_pairs_) {
+        updateSignal(pair);
+    }
+    
+    if (running_ && now >= next_test_ && rows_ >= config_.min_samples) {
+        submitTest();
+        next_test_ = now + config_.test_interval;
+    }
+    return true;
+}
+
+double CointegrationEngine::getCorrelation(size_t index) const {
+    return std::isnan(beta_[index]) ? kNaN : cov_xy_[index] / std::sqrt(var_x_[index] * var_y_[index]);
+}
+
+bool CointegrationEngine::find(const InstrumentId& y_id, const InstrumentId& x_id, size_t& index) const {
+    auto y = book_slots_.find(y_id);
+    auto x = book_slots_.find(x_id);
+    if (y == book_slots_.end() || x == book_slots_.end()) {
+        return false;
+    }
+    auto it = pair_index_.find(pairKey(y->second, x->second));
+    if (it == pair_index_.end()) {
+        return false;
+    }
+    index = it->second;
+    return true;
+}
+
+uint32_t CointegrationEngine::bookSlot(const InstrumentId& instrument_id) {
+    auto it = book_slots_.find(instrument_id);
+    if (it != book_slots_.end()) {
+        return it->second;
+    }
+    uint32_t slot = static_cast<uint32_t>(book_mid_.size());
+    book_mid_.push_back(kNaN);
+    book_dependents_.emplace_back();
+    book_slots_[instrument_id] = slot;
+    return slot;
+}
+
+void CointegrationEngine::resizeColumns() {
+    const size_t padded = simd::padLanes(pairs_.size());
+    if (padded == stride_) {
+        return;
+    }
+    
+    for (auto* column : {&y_, &x_, &beta_, &spread_mean_, &spread_sd_, &z_score_, &test_statistic_}) {
+        column->resize(padded, kNaN);
+    }
+    for (auto* column : {&count_, &mean_x_, &mean_y_, &var_x_, &var_y_, &cov_xy_}) {
+        column->resize(padded, 0.0);
+    }
+    cointegrated_.resize(padded, 0);
+    signal_.resize(padded, 0);
+    
+    // The ring is laid out for the padded width, so growing it restarts the
+    // history (pairs are registered before the feed starts)
+    stride_ = padded;
+    history_y_.assign(config_.history_length * stride_, kNaN);
+    history_x_.assign(config_.history_length * stride_, kNaN);
+    rows_ = 0;
+}
+
+void CointegrationEngine::updateSignal(size_t index) {
+    const int current = signal_[index];
+    const double z = z_score_[index];
+    int next = current;
+    if (!cointegrated_[index] || !(std::fabs(getCorrelation(index)) >= config_.min_correlation)) {
+        next = 0;
+    } else if (std::isfinite(z)) {
+        // Short the spread when it is rich, long when cheap; hold until it reverts
+        if (z >= config_.entry_z) {
+            next = -1;
+        } else if (z <= -config_.entry_z) {
+            next = 1;
+        } else if (std::fabs(z) <= config_.exit_z) {
+            next = 0;
+        }
+    }
+    if (next == current) {
+        return;
+    }
+    
+    signal_[index] = static_cast<int8_t>(next);
+    ++signal_changes_;
+    if (signal_callback_) {
+        signal_callback_(index, next, z);
+    }
+}
+
+void CointegrationEngine::submitTest() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (job_pending_) {
+        return;  // Previous test still running; try again next interval
+    }
+    
+    // Unroll the ring into time order
+    const size_t rows = static_cast<size_t>(std::min<uint64_t>(rows_, config_.history_length));
+    const size_t oldest = static_cast<size_t>((rows_ - rows) % config_.history_length);
+    job_.y.resize(rows * stride_);
+    job_.x.resize(rows * stride_);
+    for (size_t r = 0; r < rows; ++r) {
+        size_t source = ((oldest + r) % config_.history_length) * stride_;
+        std::copy_n(&history_y_[source], stride_, &job_.y[r * stride_]);
+        std::copy_n(&history_x_[source], stride_, &job_.x[r * stride_]);
+    }
+    job_.rows = rows;
+    job_.pairs = pairs_.size();
+    job_.stride = stride_;
+    job_pending_ = true;
+    job_ready_.notify_one();
+}
+
+void CointegrationEngine::applyTestResults() {
+    if (!results_ready_.exchange(false, std::memory_order_acquire)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const size_t count = std::min(results_.size(), pairs_.size());
+        std::copy_n(results_.begin(), count, test_statistic_.begin());
+    }
+    
+    // Signal callbacks run outside the lock
+    tradable_pairs_.clear();
+    for (size_t pair = 0; pair < pairs_.size(); ++pair) {
+        cointegrated_[pair] = test_statistic_[pair] < config_.adf_critical_value ? 1 : 0;
+        if (cointegrated_[pair]) {
+            tradable_pairs_.push_back(static_cast<uint32_t>(pair));
+        }
+        updateSignal(pair);  // Pairs that failed go flat
+    }
+}
+
+void CointegrationEngine::workerLoop() {
+    std::vector<double> statistics;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            job_ready_.wait(lock, [this]() { return !running_ || job_pending_; });
+            if (!running_) {
+                return;
+            }
+        }
+        
+        // The owner leaves job_ alone while it is pending
+        statistics.assign(job_.pairs, kNaN);
+        for (size_t pair = 0; pair < job_.pairs; ++pair) {
+            statistics[pair] = engleGrangerStatistic(&job_.y[pair], &job_.x[pair], job_.rows, job_.stride,
+                                                     config_.min_samples);
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            results_.swap(statistics);
+            job_pending_ = false;
+        }
+        results_ready_.store(true, std::memory_order_release);
+        ++tests_completed_;
+    }
+}
+
+} // namespace arbitrage
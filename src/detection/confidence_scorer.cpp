@@ -0,0 +1,189 @@
+#include "confidence_scorer.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace arbitrage {
+
+namespace {
+
+int64_t toNanos(Timestamp time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+} // namespace
+
+ConfidenceScorer::ConfidenceScorer(const ConfidenceConfig& config) {
+    setConfig(config);
+}
+
+void ConfidenceScorer::setConfig(const ConfidenceConfig& config) {
+    config_ = config;
+    config_.depth_levels = std::max<size_t>(config_.depth_levels, 1);
+    config_.spread_alpha = std::clamp(config_.spread_alpha, 1e-6, 1.0);
+    auto half_life = std::chrono::duration_cast<std::chrono::nanoseconds>(config_.freshness_half_life).count();
+    decay_per_ns_ = half_life > 0 ? std::log(2.0) / static_cast<double>(half_life) : 0.0;
+    
+    for (size_t index = 0; index < instrument_ids_.size(); ++index) {
+        refreshStatic(index);
+    }
+}
+
+size_t ConfidenceScorer::addInstrument(const InstrumentId& instrument_id) {
+    size_t index;
+    if (find(instrument_id, index)) {
+        return index;
+    }
+    
+    index = instrument_ids_.size();
+    instrument_ids_.push_back(instrument_id);
+    instrument_index_[instrument_id] = index;
+    update_ns_.push_back(0);
+    depth_notional_.push_back(0.0);
+    spread_mean_.push_back(0.0);
+    spread_variance_.push_back(0.0);
+    static_score_.push_back(0.0);
+    return index;
+}
+
+bool ConfidenceScorer::find(const InstrumentId& instrument_id, size_t& index) const {
+    auto it = instrument_index_.find(instrument_id);
+    if (it == instrument_index_.end()) {
+        return false;
+    }
+    index = it->second;
+    return true;
+}
+
+void ConfidenceScorer::onBookUpdate(size_t index, const OrderBook& book, Timestamp update_time) {
+    if (book.bids.empty() || book.asks.empty()) {
+        // One-sided book: no depth on the missing side
+        depth_notional_[index] = 0.0;
+        refreshStatic(index);
+        return;
+    }
+    
+    double bid_notional = 0.0, ask_notional = 0.0;
+    size_t bid_levels = std::min(book.bids.size(), config_.depth_levels);
+    size_t ask_levels = std::min(book.asks.size(), config_.depth_levels);
+    for (size_t level = 0; level < bid_levels; ++level) {
+        bid_notional += book.bids[level].price * book.bids[level].volume;
+    }
+    for (size_t level = 0; level < ask_levels; ++level) {
+        ask_notional += book.asks[level].price * book.asks[level].volume;
+    }
+    depth_notional_[index] = std::min(bid_notional, ask_notional);
+    
+    double mid = book.getMidPrice();
+    double spread = mid > 0.0 ? book.getSpread() / mid : 0.0;
+    if (update_ns_[index] == 0) {
+        spread_mean_[index] = spread;
+        spread_variance_[index] = 0.0;
+    } else {
+        double diff = spread - spread_mean_[index];
+        double increment = config_.spread_alpha * diff;
+        spread_mean_[index] += increment;
+        spread_variance_[index] = (1.0 - config_.spread_alpha) * (spread_variance_[index] + diff * increment);
+    }
+    
+    update_ns_[index] = std::max<int64_t>(toNanos(update_time), 1);
+    refreshStatic(index);
+}
+
+bool ConfidenceScorer::onBookUpdate(const InstrumentId& instrument_id, const OrderBook& book,
+                                    Timestamp update_time) {
+    size_t index;
+    if (!find(instrument_id, index)) {
+        return false;
+    }
+    onBookUpdate(index, book, update_time);
+    return true;
+}
+
+double ConfidenceScorer::getLegScore(size_t index, Timestamp now) const {
+    if (update_ns_[index] == 0) {
+        return 0.0;
+    }
+    double age_ns = static_cast<double>(std::max<int64_t>(toNanos(now) - update_ns_[index], 0));
+    return static_score_[index] * std::exp(-age_ns * decay_per_ns_);
+}
+
+double ConfidenceScorer::score(const size_t* legs, size_t count, Timestamp now) const {
+    if (count == 0) {
+        return 0.0;
+    }
+    double weakest = 1.0;
+    for (size_t i = 0; i < count; ++i) {
+        weakest = std::min(weakest, getLegScore(legs[i], now));
+    }
+    return weakest;
+}
+
+bool ConfidenceScorer::accept(const size_t* legs, size_t count, Timestamp now, double& out) {
+    out = count > 0 ? 1.0 : 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        // Freshness only lowers a leg: its static score bounds it from above
+        double bound = update_ns_[legs[i]] != 0 ? static_score_[legs[i]] : 0.0;
+        if (bound < config_.threshold) {
+            out = bound;
+            ++early_reject_count_;
+            ++rejected_count_;
+            return false;
+        }
+        out = std::min(out, getLegScore(legs[i], now));
+        if (out < config_.threshold) {
+            ++rejected_count_;
+            return false;
+        }
+    }
+    if (count == 0) {
+        ++rejected_count_;
+        return false;
+    }
+    ++accepted_count_;
+    return true;
+}
+
+bool ConfidenceScorer::scoreSynthetic(SyntheticPrice& synthetic, Timestamp now) {
+    return acceptIds(synthetic.component_instruments, now, synthetic.confidence_score);
+}
+
+bool ConfidenceScorer::scoreOpportunity(ArbitrageOpportunity& opportunity, Timestamp now) {
+    return acceptIds(opportunity.leg_instruments, now, opportunity.confidence_score);
+}
+
+double ConfidenceScorer::getSpreadVolatility(size_t index) const {
+    return std::sqrt(spread_variance_[index]);
+}
+
+bool ConfidenceScorer::acceptIds(const std::vector<InstrumentId>& legs, Timestamp now, double& out) {
+    scratch_.clear();
+    for (const auto& leg : legs) {
+        size_t index;
+        if (!find(leg, index)) {
+            out = 0.0;
+            ++early_reject_count_;
+            ++rejected_count_;
+            return false;
+        }
+        scratch_.push_back(index);
+    }
+    return accept(scratch_.data(), scratch_.size(), now, out);
+}
+
+void ConfidenceScorer::refreshStatic(size_t index) {
+    double depth = config_.liquidity_threshold > 0.0
+                       ? std::min(depth_notional_[index] / config_.liquidity_threshold, 1.0)
+                       : 1.0;
+    double mean = spread_mean_[index];
+    double deviation = std::sqrt(spread_variance_[index]);
+    // Jitter within the tolerance is normal for a live book; only the excess counts
+    double stability = 1.0;
+    if (mean < 0.0 || (mean == 0.0 && deviation > 0.0)) {
+        stability = 0.0;
+    } else if (mean > 0.0) {
+        stability = 1.0 / (1.0 + std::max(deviation / mean - config_.spread_tolerance, 0.0));
+    }
+    static_score_[index] = depth * stability;
+}
+
+} // namespace arbitrage
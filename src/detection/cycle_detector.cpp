@@ -0,0 +1,362 @@
+#include "cycle_detector.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace arbitrage {
+
+namespace {
+
+constexpr double kInfinity = std::numeric_limits<double>::infinity();
+
+uint64_t linkKey(uint32_t from, uint32_t to) {
+    return (static_cast<uint64_t>(from) << 32) | to;
+}
+
+} // namespace
+
+CurrencyCycleDetector::CurrencyCycleDetector(const CycleDetectorConfig& config) : config_(config) {
+    config_.max_cycle_length = std::max<size_t>(config_.max_cycle_length, 2);
+    log_fee_ = -std::log1p(-std::clamp(config_.fee_rate, 0.0, 0.5));
+    max_weight_ = -std::log1p(std::max(config_.min_profit, 0.0));
+}
+
+size_t CurrencyCycleDetector::addInstruments(const std::vector<Instrument>& instruments) {
+    // Direct conversion books into the pivot, by the currency they convert
+    std::unordered_map<std::string, const Instrument*> conversions;
+    if (normalizer_) {
+        for (const auto& instrument : instruments) {
+            if (instrument.type != InstrumentType::SPOT || !normalizer_->isConversionBook(instrument.id)) {
+                continue;
+            }
+            if (instrument.quote_asset == normalizer_->getPivot()) {
+                conversions.emplace(instrument.base_asset, &instrument);
+            } else if (instrument.base_asset == normalizer_->getPivot()) {
+                conversions.emplace(instrument.quote_asset, &instrument);
+            }
+        }
+    }
+    
+    // Raw books first, so the conversion books exist when cross-quote books are joined to the pivot
+    size_t added = 0;
+    std::vector<std::pair<const Instrument*, const Instrument*>> cross_quote;
+    for (const auto& instrument : instruments) {
+        if (instrument.type != InstrumentType::SPOT) {
+            continue;
+        }
+        auto conversion = conversions.find(instrument.quote_asset);
+        if (conversion != conversions.end() && !normalizer_->isConversionBook(instrument.id)) {
+            cross_quote.emplace_back(&instrument, conversion->second);
+        } else if (addPair(instrument.id, instrument.base_asset, instrument.quote_asset, instrument.exchange)) {
+            ++added;
+        }
+    }
+    for (const auto& [instrument, conversion] : cross_quote) {
+        auto it = pair_index_.find(conversion->id);
+        if (it != pair_index_.end() &&
+            addPair(instrument->id, instrument->base_asset, normalizer_->getPivot(), instrument->exchange)) {
+            pairs_.back().conversion = it->second;
+            pairs_.back().conversion_inverted = conversion->base_asset == normalizer_->getPivot();
+            normalized_pairs_.push_back(static_cast<uint32_t>(pairs_.size() - 1));
+            ++added;
+        }
+    }
+    return added;
+}
+
+bool CurrencyCycleDetector::addPair(const InstrumentId& instrument_id, const std::string& base,
+                                    const std::string& quote, Exchange exchange) {
+    if (base.empty() || quote.empty() || base == quote || pair_index_.count(instrument_id) != 0) {
+        return false;
+    }
+    
+    Pair pair;
+    pair.instrument_id = instrument_id;
+    pair.exchange = exchange;
+    pair.base = addCurrency(base);
+    pair.quote = addCurrency(quote);
+    
+    uint32_t index = static_cast<uint32_t>(pairs_.size());
+    pair_index_[instrument_id] = index;
+    pairs_.push_back(pair);
+    weights_.push_back(kInfinity);
+    weights_.push_back(kInfinity);
+    
+    // Sell edge base -> quote, buy edge quote -> base
+    for (uint32_t edge : {2 * index, 2 * index + 1}) {
+        uint32_t from = edgeFrom(edge);
+        uint32_t to = edgeTo(edge);
+        Link* link = findLink(from, to);
+        if (!link) {
+            link_slot_[linkKey(from, to)] = static_cast<uint32_t>(links_[from].size());
+            links_[from].push_back(Link{to, kNoEdge, kInfinity, {}});
+            link = &links_[from].back();
+        }
+        link->edges.push_back(edge);
+    }
+    return true;
+}
+
+size_t CurrencyCycleDetector::onTopOfBook(const TopOfBook& top, Timestamp now,
+                                          std::vector<ArbitrageOpportunity>& out) {
+    auto it = pair_index_.find(top.instrument_id);
+    if (it == pair_index_.end()) {
+        return 0;
+    }
+    
+    uint32_t index = it->second;
+    Pair& pair = pairs_[index];
+    pair.bid_volume = top.bid_volume;
+    pair.ask_volume = top.ask_volume;
+    if (pair.raw_bid == top.bid_price && pair.raw_ask == top.ask_price) {
+        return 0;  // Sizes only; no weight moved
+    }
+    pair.raw_bid = top.bid_price;
+    pair.raw_ask = top.ask_price;
+    size_t found = reprice(index, now, out);
+    
+    // A conversion tick moves every book quoted through it
+    for (uint32_t normalized : normalized_pairs_) {
+        if (pairs_[normalized].conversion == index) {
+            found += reprice(normalized, now, out);
+        }
+    }
+    return found;
+}
+
+double CurrencyCycleDetector::getEdgeWeight(const std::string& from, const std::string& to) const {
+    auto from_it = currency_index_.find(from);
+    auto to_it = currency_index_.find(to);
+    if (from_it == currency_index_.end() || to_it == currency_index_.end()) {
+        return kInfinity;
+    }
+    const Link* link = findLink(from_it->second, to_it->second);
+    return link ? link->weight : kInfinity;
+}
+
+uint32_t CurrencyCycleDetector::edgeFrom(uint32_t edge) const {
+    const Pair& pair = pairs_[edge / 2];
+    return edge % 2 == 0 ? pair.base : pair.quote;
+}
+
+uint32_t CurrencyCycleDetector::edgeTo(uint32_t edge) const {
+    const Pair& pair = pairs_[edge / 2];
+    return edge % 2 == 0 ? pair.quote : pair.base;
+}
+
+size_t CurrencyCycleDetector::reprice(uint32_t index, Timestamp now, std::vector<ArbitrageOpportunity>& out) {
+    Pair& pair = pairs_[index];
+    Price bid = pair.raw_bid, ask = pair.raw_ask;
+    double fee = log_fee_;
+    if (pair.conversion != kNoPair) {
+        // Executable in the pivot: the quote currency is sold at the conversion
+        // book's touch after a sale, and bought at it before a purchase
+        const Pair& conversion = pairs_[pair.conversion];
+        bool quoted = conversion.raw_bid > 0.0 && conversion.raw_ask > 0.0;
+        double sell_rate = pair.conversion_inverted ? 1.0 / conversion.raw_ask : conversion.raw_bid;
+        double buy_rate = pair.conversion_inverted ? 1.0 / conversion.raw_bid : conversion.raw_ask;
+        bid = quoted ? bid * sell_rate : 0.0;
+        ask = quoted ? ask * buy_rate : 0.0;
+        fee += log_fee_;
+    }
+    if (pair.bid == bid && pair.ask == ask) {
+        return 0;
+    }
+    pair.bid = bid;
+    pair.ask = ask;
+    
+    bool priced = bid > 0.0 && ask > 0.0;
+    weights_[2 * index] = priced ? -std::log(bid) + fee : kInfinity;
+    weights_[2 * index + 1] = priced ? std::log(ask) + fee : kInfinity;
+    
+    // Refresh both links before searching: a cycle out of one edge may close
+    // through the other direction of the same pair
+    bool moved[2];
+    for (uint32_t side = 0; side < 2; ++side) {
+        uint32_t edge = 2 * index + side;
+        moved[side] = refreshBest(edgeFrom(edge), edgeTo(edge));
+    }
+    
+    size_t found = 0;
+    for (uint32_t side = 0; side < 2; ++side) {
+        // Search only if the pair's cheapest edge moved and this book is it
+        uint32_t edge = 2 * index + side;
+        if (moved[side] && findLink(edgeFrom(edge), edgeTo(edge))->best == edge) {
+            search(edge, now, out, found);
+        }
+    }
+    return found;
+}
+
+uint32_t CurrencyCycleDetector::addCurrency(const std::string& currency) {
+    auto it = currency_index_.find(currency);
+    if (it != currency_index_.end()) {
+        return it->second;
+    }
+    uint32_t index = static_cast<uint32_t>(currencies_.size());
+    currencies_.push_back(currency);
+    currency_index_[currency] = index;
+    links_.emplace_back();
+    on_path_.push_back(0);
+    return index;
+}
+
+CurrencyCycleDetector::Link* CurrencyCycleDetector::findLink(uint32_t from, uint32_t to) {
+    auto it = link_slot_.find(linkKey(from, to));
+    return it != link_slot_.end() ? &links_[from][it->second] : nullptr;
+}
+
+const CurrencyCycleDetector::Link* CurrencyCycleDetector::findLink(uint32_t from, uint32_t to) const {
+    auto it = link_slot_.find(linkKey(from, to));
+    return it != link_slot_.end() ? &links_[from][it->second] : nullptr;
+}
+
+bool CurrencyCycleDetector::refreshBest(uint32_t from, uint32_t to) {
+    Link* link = findLink(from, to);
+    uint32_t best = kNoEdge;
+    double weight = kInfinity;
+    for (uint32_t edge : link->edges) {
+        if (weights_[edge] < weight) {
+            weight = weights_[edge];
+            best = edge;
+        }
+    }
+    bool changed = best != link->best || weight != link->weight;
+    link->best = best;
+    link->weight = weight;
+    return changed && best != kNoEdge;
+}
+
+void CurrencyCycleDetector::search(uint32_t edge, Timestamp now, std::vector<ArbitrageOpportunity>& out,
+                                   size_t& found) {
+    ++search_count_;
+    uint32_t from = edgeFrom(edge);
+    uint32_t to = edgeTo(edge);
+    
+    path_.assign(1, edge);
+    on_path_[from] = 1;
+    on_path_[to] = 1;
+    extend(to, from, weights_[edge], now, out, found);
+    on_path_[from] = 0;
+    on_path_[to] = 0;
+}
+
+void CurrencyCycleDetector::extend(uint32_t node, uint32_t target, double weight, Timestamp now,
+                                   std::vector<ArbitrageOpportunity>& out, size_t& found) {
+    ++path_count_;
+    size_t depth = path_.size();
+    
+    // Close the cycle back to the searched edge's tail; a round trip through
+    // the same book is not an arbitrage
+    const Link* close = findLink(node, target);
+    if (close && close->best != kNoEdge && !(depth == 1 && close->best / 2 == path_[0] / 2)) {
+        double total = weight + close->weight;
+        if (total < max_weight_) {
+            path_.push_back(close->best);
+            if (reported()) {
+                emit(total, now, out);
+                ++found;
+            }
+            path_.pop_back();
+        }
+    }
+    
+    if (depth + 2 > config_.max_cycle_length) {
+        return;
+    }
+    for (const Link& link : links_[node]) {
+        if (on_path_[link.to] || link.best == kNoEdge) {
+            continue;
+        }
+        on_path_[link.to] = 1;
+        path_.push_back(link.best);
+        extend(link.to, target, weight + link.weight, now, out, found);
+        path_.pop_back();
+        on_path_[link.to] = 0;
+    }
+}
+
+void CurrencyCycleDetector::expand(const std::vector<uint32_t>& cycle) {
+    // A normalized edge trades its book and its conversion book; the
+    // conversion comes first when buying, since it supplies the quote currency
+    legs_.clear();
+    for (uint32_t edge : cycle) {
+        const Pair& pair = pairs_[edge / 2];
+        bool sell = edge % 2 == 0;
+        if (pair.conversion == kNoPair) {
+            legs_.push_back(edge);
+            continue;
+        }
+        // Selling the quote currency is a sale of a quote/pivot book and a purchase of a pivot/quote one
+        uint32_t convert = 2 * pair.conversion + (sell == pair.conversion_inverted ? 1 : 0);
+        if (sell) {
+            legs_.push_back(edge);
+            legs_.push_back(convert);
+        } else {
+            legs_.push_back(convert);
+            legs_.push_back(edge);
+        }
+    }
+}
+
+bool CurrencyCycleDetector::reported() {
+    expand(path_);
+    
+    // A book traded twice (a conversion book also on the path) is not one trade per book
+    for (size_t i = 0; i < legs_.size(); ++i) {
+        for (size_t j = i + 1; j < legs_.size(); ++j) {
+            if (legs_[i] / 2 == legs_[j] / 2) {
+                return false;
+            }
+        }
+    }
+    // Three-book triangles, conversions included, are the spread scanner's
+    return config_.report_triangles || legs_.size() != 3;
+}
+
+void CurrencyCycleDetector::emit(double weight, Timestamp now, std::vector<ArbitrageOpportunity>& out) {
+    ++cycle_count_;
+    
+    // Start the cycle at its lowest edge so every rotation gets the same id
+    std::vector<uint32_t> cycle(path_);
+    std::rotate(cycle.begin(), std::min_element(cycle.begin(), cycle.end()), cycle.end());
+    expand(cycle);
+    
+    // Largest amount of the start currency every leg's top level can absorb
+    double fee = 1.0 - config_.fee_rate;
+    double rate = 1.0;
+    double start_amount = kInfinity;
+    for (uint32_t edge : legs_) {
+        const Pair& pair = pairs_[edge / 2];
+        bool sell = edge % 2 == 0;
+        double max_input = sell ? pair.bid_volume : pair.ask_volume * pair.raw_ask;
+        start_amount = std::min(start_amount, max_input / rate);
+        rate *= sell ? pair.raw_bid * fee : fee / pair.raw_ask;
+    }
+    
+    ArbitrageOpportunity opportunity;
+    opportunity.type = ArbitrageType::CROSS_SYNTHETIC;
+    opportunity.opportunity_id = "CYCLE";
+    double amount = start_amount;
+    for (uint32_t edge : legs_) {
+        const Pair& pair = pairs_[edge / 2];
+        bool sell = edge % 2 == 0;
+        opportunity.opportunity_id += (sell ? ":S:" : ":B:") + pair.instrument_id;
+        opportunity.leg_instruments.push_back(pair.instrument_id);
+        opportunity.leg_exchanges.push_back(pair.exchange);
+        opportunity.leg_sides.push_back(sell ? OrderSide::SELL : OrderSide::BUY);
+        opportunity.leg_prices.push_back(sell ? pair.raw_bid : pair.raw_ask);
+        opportunity.leg_volumes.push_back(sell ? amount : amount / pair.raw_ask);
+        amount *= sell ? pair.raw_bid * fee : fee / pair.raw_ask;
+    }
+    
+    double profit_ratio = std::exp(-weight) - 1.0;
+    opportunity.expected_profit_percentage = profit_ratio;
+    opportunity.expected_profit = start_amount * profit_ratio;  // In the start currency
+    opportunity.detection_time = now;
+    opportunity.expiry_time = now + config_.opportunity_ttl;
+    opportunity.is_active = true;
+    out.push_back(std::move(opportunity));
+}
+
+} // namespace arbitrage
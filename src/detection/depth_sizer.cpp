@@ -0,0 +1,147 @@
+#include "depth_sizer.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace arbitrage {
+
+DepthSizer::DepthSizer(const DepthSizerConfig& config) {
+    setConfig(config);
+}
+
+void DepthSizer::setConfig(const DepthSizerConfig& config) {
+    config_ = config;
+    config_.max_curve_points = std::max<size_t>(config_.max_curve_points, 1);
+    curve_.clear();
+    curve_.reserve(config_.max_curve_points);
+}
+
+bool DepthSizer::size(const SizingLeg* legs, size_t count, SizingResult& result) {
+    result = SizingResult();
+    curve_.clear();
+    if (count == 0 || count > kMaxLegs) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (legs[i].book == nullptr || !(legs[i].ratio > 0.0)) {
+            return false;
+        }
+        cursors_[i] = Cursor{0, 0.0, 0.0, 0.0};
+    }
+    
+    std::array<double, kMaxLegs> prices;
+    std::array<double, kMaxLegs> steps;
+    while (true) {
+        // Prices of the current segment and the size to the nearest boundary
+        double marginal = 0.0, marginal_cost = 0.0, marginal_proceeds = 0.0;
+        double step = std::numeric_limits<double>::infinity();
+        bool exhausted = false;
+        for (size_t i = 0; i < count && !exhausted; ++i) {
+            const auto& levels = legs[i].side == OrderSide::BUY ? legs[i].book->asks : legs[i].book->bids;
+            Cursor& cursor = cursors_[i];
+            while (cursor.level < levels.size() && levels[cursor.level].volume <= cursor.filled) {
+                ++cursor.level;
+                cursor.filled = 0.0;
+            }
+            if (cursor.level == levels.size()) {
+                exhausted = true;
+                break;
+            }
+            
+            prices[i] = levels[cursor.level].price;
+            double value = legs[i].weight * legs[i].ratio * prices[i];
+            if (legs[i].side == OrderSide::BUY) {
+                marginal -= value;
+                marginal_cost += value;
+            } else {
+                marginal += value;
+                marginal_proceeds += value;
+            }
+            steps[i] = (levels[cursor.level].volume - cursor.filled) / legs[i].ratio;
+            step = std::min(step, steps[i]);
+        }
+        if (exhausted) {
+            break;
+        }
+        
+        // Books only get worse: the first segment below the edge ends the walk
+        double basis = marginal_cost > 0.0 ? marginal_cost : marginal_proceeds;
+        double edge = basis > 0.0 ? marginal / basis : 0.0;
+        if (!(edge >= config_.min_profit)) {
+            break;
+        }
+        if (marginal_cost > 0.0 && result.cost + marginal_cost * step > config_.max_position_size) {
+            step = std::max(config_.max_position_size - result.cost, 0.0) / marginal_cost;
+            result.capped = true;
+        }
+        if (!(step > 0.0)) {
+            break;
+        }
+        
+        for (size_t i = 0; i < count; ++i) {
+            Cursor& cursor = cursors_[i];
+            double quantity = legs[i].ratio * step;
+            cursor.volume += quantity;
+            cursor.notional += quantity * prices[i];
+            if (steps[i] == step) {
+                // This leg's level is used up (exactly, whatever the rounding)
+                ++cursor.level;
+                cursor.filled = 0.0;
+            } else {
+                cursor.filled += quantity;
+            }
+        }
+        result.size += step;
+        result.cost += marginal_cost * step;
+        result.profit += marginal * step;
+        
+        SizingPoint point{result.size, result.cost, result.profit, edge};
+        if (curve_.size() < config_.max_curve_points) {
+            curve_.push_back(point);
+        } else {
+            curve_.back() = point;  // Out of room: keep the end of the curve
+        }
+        if (result.capped) {
+            break;
+        }
+    }
+    return result.size > 0.0;
+}
+
+double DepthSizer::getAveragePrice(size_t leg) const {
+    const Cursor& cursor = cursors_[leg];
+    return cursor.volume > 0.0 ? cursor.notional / cursor.volume : 0.0;
+}
+
+bool DepthSizer::sizeOpportunity(ArbitrageOpportunity& opportunity, const OrderBook* const* books,
+                                 const double* weights) {
+    const size_t count = opportunity.leg_sides.size();
+    if (count == 0 || count > kMaxLegs) {
+        return false;
+    }
+    
+    // Keep the detector's leg proportions, measured in units of the first leg
+    bool proportional = opportunity.leg_volumes.size() == count && opportunity.leg_volumes[0] > 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        legs_[i].book = books[i];
+        legs_[i].side = opportunity.leg_sides[i];
+        legs_[i].ratio = proportional ? opportunity.leg_volumes[i] / opportunity.leg_volumes[0] : 1.0;
+        legs_[i].weight = weights != nullptr ? weights[i] : 1.0;
+    }
+    
+    SizingResult result;
+    if (!size(legs_.data(), count, result)) {
+        return false;
+    }
+    
+    opportunity.leg_volumes.resize(count);
+    opportunity.leg_prices.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        opportunity.leg_volumes[i] = cursors_[i].volume;
+        opportunity.leg_prices[i] = getAveragePrice(i);
+    }
+    opportunity.expected_profit = result.profit;
+    opportunity.expected_profit_percentage = result.cost > 0.0 ? result.profit / result.cost : 0.0;
+    return true;
+}
+
+} // namespace arbitrage
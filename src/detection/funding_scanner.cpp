@@ -0,0 +1,278 @@
+#include "funding_scanner.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace arbitrage {
+
+FundingRateScanner::FundingRateScanner(const FundingScannerConfig& config) : config_(config) {
+}
+
+size_t FundingRateScanner::addPerpetual(const InstrumentId& perp_id, const std::string& underlying) {
+    auto it = perp_index_.find(perp_id);
+    if (it != perp_index_.end()) {
+        return it->second;
+    }
+    
+    size_t group;
+    if (!findGroup(underlying, group)) {
+        group = underlyings_.size();
+        underlyings_.push_back(underlying);
+        group_perps_.emplace_back();
+        group_venues_.emplace_back();
+        best_edge_.push_back(-std::numeric_limits<double>::infinity());
+        best_long_.push_back(kNone);
+        best_short_.push_back(kNone);
+        open_.push_back(0);
+        group_index_[underlying] = group;
+        ranking_.push_back(group);  // -infinity ranks last
+    }
+    
+    size_t index = perp_ids_.size();
+    perp_ids_.push_back(perp_id);
+    perp_groups_.push_back(group);
+    basis_.push_back(std::numeric_limits<double>::quiet_NaN());
+    perp_bid_.push_back(0.0);
+    perp_ask_.push_back(0.0);
+    perp_index_[perp_id] = index;
+    group_perps_[group].push_back(index);
+    return index;
+}
+
+size_t FundingRateScanner::addInstruments(const std::vector<Instrument>& instruments) {
+    size_t added = 0;
+    for (const auto& instrument : instruments) {
+        if (instrument.type == InstrumentType::PERPETUAL_SWAP && !instrument.base_asset.empty()) {
+            addPerpetual(instrument.id, instrument.base_asset);
+            ++added;
+        }
+    }
+    return added;
+}
+
+void FundingRateScanner::setSnapshotTimers(TimingWheel& wheel, ReevaluateCallback callback) {
+    wheel_ = &wheel;
+    reevaluate_callback_ = std::move(callback);
+}
+
+bool FundingRateScanner::onFundingRate(const FundingRate& funding, Timestamp now,
+                                       std::vector<ArbitrageOpportunity>& out) {
+    size_t perp;
+    if (funding.exchange_id.empty() || !findPerpetual(funding.instrument_id, perp)) {
+        return false;
+    }
+    
+    size_t venue = findOrAddVenue(perp, funding.exchange_id);
+    if (history_ != nullptr && venue_series_[venue] == kNone) {
+        history_->find(funding.instrument_id, funding.exchange_id, venue_series_[venue]);
+    }
+    current_rate_[venue] = funding.current_rate;
+    predicted_rate_[venue] = funding.predicted_rate;
+    next_funding_time_[venue] = funding.next_funding_time;
+    scheduleSnapshot(venue);
+    return evaluate(perp_groups_[perp], now, false, out);
+}
+
+bool FundingRateScanner::onBasis(size_t perp, double basis, Price perp_bid, Price perp_ask, Timestamp now,
+                                 std::vector<ArbitrageOpportunity>& out) {
+    // A first quote makes the perp's pairs priceable
+    const bool quoted = perp_bid_[perp] > 0.0 && perp_ask_[perp] > 0.0;
+    const Price previous_spread = perp_ask_[perp] - perp_bid_[perp];
+    perp_bid_[perp] = perp_bid;
+    perp_ask_[perp] = perp_ask;
+    const size_t group = perp_groups_[perp];
+    if (!quoted && perp_bid > 0.0 && perp_ask > 0.0) {
+        basis_[perp] = basis;
+        return evaluate(group, now, false, out);
+    }
+    const bool basis_moved = basis != basis_[perp];
+    basis_[perp] = basis;
+    
+    // The entry cost follows the quoted spread; a mid move at an unchanged
+    // spread shifts it negligibly and is picked up by the next evaluation
+    if (perp_ask - perp_bid != previous_spread) {
+        return evaluate(group, now, false, out);
+    }
+    
+    // With a single perp every pair is that perp on two venues: no basis cost
+    if (!basis_moved || group_perps_[group].size() < 2) {
+        return false;
+    }
+    return evaluate(group, now, false, out);
+}
+
+bool FundingRateScanner::reevaluate(size_t group, Timestamp now, std::vector<ArbitrageOpportunity>& out) {
+    return evaluate(group, now, true, out);
+}
+
+bool FundingRateScanner::findPerpetual(const InstrumentId& perp_id, size_t& index) const {
+    auto it = perp_index_.find(perp_id);
+    if (it == perp_index_.end()) {
+        return false;
+    }
+    index = it->second;
+    return true;
+}
+
+bool FundingRateScanner::findGroup(const std::string& underlying, size_t& group) const {
+    auto it = group_index_.find(underlying);
+    if (it == group_index_.end()) {
+        return false;
+    }
+    group = it->second;
+    return true;
+}
+
+const ExchangeId& FundingRateScanner::getLongVenue(size_t group) const {
+    static const ExchangeId kEmpty;
+    return best_long_[group] == kNone ? kEmpty : venue_exchanges_[best_long_[group]];
+}
+
+const ExchangeId& FundingRateScanner::getShortVenue(size_t group) const {
+    static const ExchangeId kEmpty;
+    return best_short_[group] == kNone ? kEmpty : venue_exchanges_[best_short_[group]];
+}
+
+size_t FundingRateScanner::findOrAddVenue(size_t perp, const ExchangeId& exchange_id) {
+    auto& venues = group_venues_[perp_groups_[perp]];
+    for (size_t venue : venues) {
+        if (venue_perps_[venue] == perp && venue_exchanges_[venue] == exchange_id) {
+            return venue;
+        }
+    }
+    
+    size_t venue = venue_perps_.size();
+    venue_perps_.push_back(perp);
+    venue_exchanges_.push_back(exchange_id);
+    current_rate_.push_back(0.0);
+    predicted_rate_.push_back(0.0);
+    next_funding_time_.emplace_back();
+    snapshot_timers_.push_back(0);
+    venue_series_.push_back(kNone);
+    venues.push_back(venue);
+    return venue;
+}
+
+void FundingRateScanner::scheduleSnapshot(size_t venue) {
+    if (wheel_ == nullptr || next_funding_time_[venue].time_since_epoch().count() == 0 ||
+        next_funding_time_[venue] <= wheel_->now()) {
+        return;
+    }
+    
+    // One pending re-evaluation per venue; a newer print replaces it. Inside
+    // the lead time already, it runs on the next advance.
+    wheel_->cancel(snapshot_timers_[venue]);
+    Timestamp deadline = std::max(next_funding_time_[venue] - config_.lead_time, wheel_->now());
+    const size_t group = perp_groups_[venue_perps_[venue]];
+    snapshot_timers_[venue] = wheel_->scheduleAt(deadline, [this, venue, group]() {
+        snapshot_timers_[venue] = 0;
+        if (reevaluate_callback_) {
+            reevaluate_callback_(group);
+        }
+    });
+}
+
+double FundingRateScanner::expectedRate(size_t venue, double& variance) const {
+    if (history_ == nullptr || venue_series_[venue] == kNone) {
+        variance = 0.0;
+        return current_rate_[venue];
+    }
+    const FundingHistory& series = history_->getSeries(venue_series_[venue]);
+    const double volatility = series.getEwmaVolatility();
+    variance = volatility * volatility;
+    return series.getEwma();
+}
+
+bool FundingRateScanner::evaluate(size_t group, Timestamp now, bool snapshot,
+                                  std::vector<ArbitrageOpportunity>& out) {
+    ++evaluation_count_;
+    
+    // Every ordered (long, short) venue pair; an underlying has a handful
+    const auto& venues = group_venues_[group];
+    expected_.resize(venues.size());
+    variance_.resize(venues.size());
+    for (size_t i = 0; i < venues.size(); ++i) {
+        expected_[i] = expectedRate(venues[i], variance_[i]);
+    }
+    double best = -std::numeric_limits<double>::infinity();
+    size_t best_long = kNone, best_short = kNone;
+    auto spreadCost = [this](size_t perp) {
+        return (perp_ask_[perp] - perp_bid_[perp]) / (0.5 * (perp_ask_[perp] + perp_bid_[perp]));
+    };
+    for (size_t i = 0; i < venues.size(); ++i) {
+        for (size_t j = 0; j < venues.size(); ++j) {
+            const size_t a = venues[i], b = venues[j];
+            if (a == b || predicted_rate_[b] < predicted_rate_[a]) {
+                continue;  // The next window reverses the spread
+            }
+            const size_t long_perp = venue_perps_[a], short_perp = venue_perps_[b];
+            if (!(perp_bid_[long_perp] > 0.0 && perp_ask_[long_perp] > 0.0 && perp_bid_[short_perp] > 0.0 &&
+                  perp_ask_[short_perp] > 0.0)) {
+                continue;  // No two-sided quote to price the entry at yet
+            }
+            double basis_cost = 0.0;
+            if (long_perp != short_perp) {
+                basis_cost = basis_[long_perp] - basis_[short_perp];
+                if (std::isnan(basis_cost)) {
+                    continue;  // Cannot price the entry yet
+                }
+                basis_cost = std::max(basis_cost, 0.0);
+            }
+            const double risk = config_.volatility_penalty * std::sqrt(variance_[i] + variance_[j]);
+            double edge = expected_[j] - expected_[i] - risk - basis_cost - spreadCost(long_perp) -
+                          spreadCost(short_perp);
+            if (edge > best) {
+                best = edge;
+                best_long = a;
+                best_short = b;
+            }
+        }
+    }
+    
+    const bool changed = best_long != best_long_[group] || best_short != best_short_[group];
+    const bool was_open = open_[group] != 0;
+    best_edge_[group] = best;
+    best_long_[group] = best_long;
+    best_short_[group] = best_short;
+    open_[group] = best >= config_.min_rate_spread;
+    rerank(group);
+    
+    if (!open_[group] || (was_open && !changed && !snapshot)) {
+        return false;
+    }
+    emit(group, now, snapshot, out);
+    return true;
+}
+
+void FundingRateScanner::rerank(size_t group) {
+    ranking_.erase(std::find(ranking_.begin(), ranking_.end(), group));
+    auto position = std::upper_bound(ranking_.begin(), ranking_.end(), best_edge_[group],
+                                     [this](double edge, size_t other) { return edge > best_edge_[other]; });
+    ranking_.insert(position, group);
+}
+
+void FundingRateScanner::emit(size_t group, Timestamp now, bool snapshot, std::vector<ArbitrageOpportunity>& out) {
+    const size_t long_venue = best_long_[group], short_venue = best_short_[group];
+    const size_t long_perp = venue_perps_[long_venue], short_perp = venue_perps_[short_venue];
+    ++report_count_;
+    
+    // Long where funding is cheap, short where it is rich, one contract each
+    ArbitrageOpportunity opportunity;
+    opportunity.type = ArbitrageType::FUNDING_RATE_ARBITRAGE;
+    opportunity.opportunity_id = "FUNDING:" + underlyings_[group] + ":" + venue_exchanges_[long_venue] + ":" +
+                                 venue_exchanges_[short_venue];
+    opportunity.leg_instruments = {perp_ids_[long_perp], perp_ids_[short_perp]};
+    opportunity.leg_exchanges = {stringToExchange(venue_exchanges_[long_venue]),
+                                 stringToExchange(venue_exchanges_[short_venue])};
+    opportunity.leg_sides = {OrderSide::BUY, OrderSide::SELL};
+    opportunity.leg_prices = {perp_ask_[long_perp], perp_bid_[short_perp]};
+    opportunity.leg_volumes = {1.0, 1.0};
+    opportunity.expected_profit_percentage = best_edge_[group];
+    opportunity.expected_profit = best_edge_[group] * 0.5 * (perp_ask_[long_perp] + perp_bid_[short_perp]);
+    opportunity.detection_time = now;
+    opportunity.expiry_time = now + config_.opportunity_ttl;
+    opportunity.is_active = true;
+    opportunity.reannounce = snapshot;  // Still open at the snapshot: publish again
+    out.push_back(std::move(opportunity));
+}
+
+} // namespace arbitrage
@@ -0,0 +1,307 @@
+#include "spread_scanner.hpp"
+#include "simd.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <unordered_set>
+
+namespace arbitrage {
+
+namespace {
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+} // namespace
+
+SpotSpreadScanner::SpotSpreadScanner(const SpreadScannerConfig& config)
+    : config_(config),
+      fee_factor_(std::pow(1.0 - config.fee_rate, 3)) {
+}
+
+size_t SpotSpreadScanner::addInstruments(const std::vector<Instrument>& instruments) {
+    // Every venue's book for a pair, so parallel books each close their own triangles
+    std::unordered_map<std::string, std::vector<const Instrument*>> books;
+    std::vector<std::string> currencies;
+    std::unordered_set<std::string> seen;
+    for (const auto& instrument : instruments) {
+        if (instrument.type != InstrumentType::SPOT || instrument.base_asset.empty() ||
+            instrument.quote_asset.empty() || instrument.base_asset == instrument.quote_asset) {
+            continue;
+        }
+        books[instrument.base_asset + "/" + instrument.quote_asset].push_back(&instrument);
+        for (const auto* currency : {&instrument.base_asset, &instrument.quote_asset}) {
+            if (seen.insert(*currency).second) {
+                currencies.push_back(*currency);
+            }
+        }
+    }
+    
+    // Listed books for base/quote in either orientation
+    struct Leg {
+        const Instrument* book;
+        bool inverted;
+    };
+    auto lookup = [&books](const std::string& base, const std::string& quote, std::vector<Leg>& legs) {
+        legs.clear();
+        for (bool inverted : {false, true}) {
+            auto it = books.find(inverted ? quote + "/" + base : base + "/" + quote);
+            if (it != books.end()) {
+                for (const Instrument* book : it->second) {
+                    legs.push_back(Leg{book, inverted});
+                }
+            }
+        }
+        return !legs.empty();
+    };
+    
+    size_t added = 0;
+    std::vector<Leg> leg1s, leg2s;
+    for (const auto& instrument : instruments) {
+        if (instrument.type != InstrumentType::SPOT ||
+            books.count(instrument.base_asset + "/" + instrument.quote_asset) == 0) {
+            continue;
+        }
+        const Instrument* real = &instrument;
+        for (const auto& currency : currencies) {
+            if (currency == real->base_asset || currency == real->quote_asset ||
+                !lookup(real->base_asset, currency, leg1s) || !lookup(currency, real->quote_asset, leg2s)) {
+                continue;
+            }
+            for (const Leg& leg1 : leg1s) {
+                for (const Leg& leg2 : leg2s) {
+                    if (!addPair(real->id, leg1.book->id, leg1.inverted, leg2.book->id, leg2.inverted)) {
+                        continue;
+                    }
+                    const Pair& pair = pairs_.back();
+                    book_exchanges_[pair.real] = real->exchange;
+                    book_exchanges_[pair.leg1] = leg1.book->exchange;
+                    book_exchanges_[pair.leg2] = leg2.book->exchange;
+                    ++added;
+                }
+            }
+        }
+    }
+    return added;
+}
+
+bool SpotSpreadScanner::addPair(const InstrumentId& real_id, const InstrumentId& leg1_id, bool leg1_inverted,
+                                const InstrumentId& leg2_id, bool leg2_inverted) {
+    if (real_id == leg1_id || real_id == leg2_id || leg1_id == leg2_id) {
+        return false;
+    }
+    
+    // The three books of a triangle form one trade whichever is called real
+    std::array<InstrumentId, 3> books = {real_id, leg1_id, leg2_id};
+    std::sort(books.begin(), books.end());
+    std::string triangle = books[0] + "|" + books[1] + "|" + books[2];
+    if (triangles_.count(triangle) != 0) {
+        return false;
+    }
+    
+    uint32_t index = static_cast<uint32_t>(pairs_.size());
+    Pair pair;
+    pair.real = bookSlot(real_id);
+    pair.leg1 = bookSlot(leg1_id);
+    pair.leg2 = bookSlot(leg2_id);
+    pair.leg1_inverted = leg1_inverted;
+    pair.leg2_inverted = leg2_inverted;
+    pairs_.push_back(pair);
+    triangles_[triangle] = index;
+    pair_index_.emplace(real_id, index);
+    resizeColumns();
+    
+    // Seed the new lane from books already seen
+    const uint32_t slots[] = {pair.real, pair.leg1, pair.leg2};
+    for (uint8_t role = 0; role < 3; ++role) {
+        Dependent dependent{index, role};
+        book_dependents_[slots[role]].push_back(dependent);
+        store(dependent, books_[slots[role]]);
+    }
+    markDirty(index);
+    return true;
+}
+
+bool SpotSpreadScanner::onTopOfBook(const TopOfBook& top) {
+    auto it = book_slots_.find(top.instrument_id);
+    if (it == book_slots_.end()) {
+        return false;
+    }
+    
+    books_[it->second] = top;
+    for (const Dependent& dependent : book_dependents_[it->second]) {
+        store(dependent, top);
+        markDirty(dependent.pair);
+    }
+    return true;
+}
+
+size_t SpotSpreadScanner::scan(Timestamp now, std::vector<ArbitrageOpportunity>& out) {
+    using simd::VecD;
+    
+    // edge > min_profit without a division: real_bid * fees > (1 + min_profit) * synthetic_ask
+    const VecD fees = VecD::broadcast(fee_factor_);
+    const VecD hurdle = VecD::broadcast(1.0 + config_.min_profit);
+    
+    size_t found = 0;
+    for (uint32_t block : dirty_blocks_) {
+        dirty_[block] = 0;
+        const size_t i = block * simd::kLanes;
+        VecD synthetic_bid = VecD::load(&leg1_bid_[i]) * VecD::load(&leg2_bid_[i]);
+        VecD synthetic_ask = VecD::load(&leg1_ask_[i]) * VecD::load(&leg2_ask_[i]);
+        simd::MaskD sell = VecD::load(&real_bid_[i]) * fees > hurdle * synthetic_ask;
+        simd::MaskD buy = synthetic_bid * fees > hurdle * VecD::load(&real_ask_[i]);
+        scanned_count_ += std::min(simd::kLanes, pairs_.size() - i);
+        
+        // NaN lanes (unpriced or padding) fail both comparisons
+        uint32_t sell_bits = simd::toBits(sell);
+        uint32_t buy_bits = simd::toBits(buy);
+        while (sell_bits != 0) {
+            emit(static_cast<uint32_t>(i) + __builtin_ctz(sell_bits), true, now, out);
+            sell_bits &= sell_bits - 1;
+            ++found;
+        }
+        while (buy_bits != 0) {
+            emit(static_cast<uint32_t>(i) + __builtin_ctz(buy_bits), false, now, out);
+            buy_bits &= buy_bits - 1;
+            ++found;
+        }
+    }
+    dirty_blocks_.clear();
+    survivor_count_ += found;
+    return found;
+}
+
+size_t SpotSpreadScanner::scanAll(Timestamp now, std::vector<ArbitrageOpportunity>& out) {
+    for (uint32_t pair = 0; pair < pairs_.size(); pair += simd::kLanes) {
+        markDirty(pair);
+    }
+    return scan(now, out);
+}
+
+bool SpotSpreadScanner::find(const InstrumentId& real_id, size_t& index) const {
+    auto it = pair_index_.find(real_id);
+    if (it == pair_index_.end()) {
+        return false;
+    }
+    index = it->second;
+    return true;
+}
+
+double SpotSpreadScanner::getSellRealEdge(size_t index) const {
+    return real_bid_[index] * fee_factor_ / getSyntheticAsk(index) - 1.0;
+}
+
+double SpotSpreadScanner::getBuyRealEdge(size_t index) const {
+    return getSyntheticBid(index) * fee_factor_ / real_ask_[index] - 1.0;
+}
+
+const InstrumentId& SpotSpreadScanner::getRealId(size_t index) const {
+    return books_[pairs_[index].real].instrument_id;
+}
+
+uint32_t SpotSpreadScanner::bookSlot(const InstrumentId& instrument_id) {
+    auto it = book_slots_.find(instrument_id);
+    if (it != book_slots_.end()) {
+        return it->second;
+    }
+    
+    uint32_t slot = static_cast<uint32_t>(books_.size());
+    TopOfBook top;
+    top.instrument_id = instrument_id;
+    books_.push_back(top);
+    book_exchanges_.push_back(Exchange::UNKNOWN);
+    book_dependents_.emplace_back();
+    book_slots_[instrument_id] = slot;
+    return slot;
+}
+
+void SpotSpreadScanner::store(const Dependent& dependent, const TopOfBook& top) {
+    double bid = top.bid_price, ask = top.ask_price;
+    if (!(bid > 0.0 && ask > 0.0)) {
+        bid = ask = kNaN;
+    }
+    
+    const Pair& pair = pairs_[dependent.pair];
+    bool inverted = (dependent.role == 1 && pair.leg1_inverted) || (dependent.role == 2 && pair.leg2_inverted);
+    if (inverted) {
+        // Quote/base book: buying base/quote is selling it
+        double inverted_bid = 1.0 / ask;
+        ask = 1.0 / bid;
+        bid = inverted_bid;
+    }
+    
+    std::vector<double>* columns[3][2] = {
+        {&real_bid_, &real_ask_}, {&leg1_bid_, &leg1_ask_}, {&leg2_bid_, &leg2_ask_}};
+    (*columns[dependent.role][0])[dependent.pair] = bid;
+    (*columns[dependent.role][1])[dependent.pair] = ask;
+}
+
+void SpotSpreadScanner::markDirty(uint32_t pair) {
+    uint32_t block = pair / static_cast<uint32_t>(simd::kLanes);
+    if (!dirty_[block]) {
+        dirty_[block] = 1;
+        dirty_blocks_.push_back(block);
+    }
+}
+
+void SpotSpreadScanner::emit(uint32_t index, bool sell_real, Timestamp now, std::vector<ArbitrageOpportunity>& out) {
+    const Pair& pair = pairs_[index];
+    const TopOfBook& real = books_[pair.real];
+    const TopOfBook& leg1 = books_[pair.leg1];
+    const TopOfBook& leg2 = books_[pair.leg2];
+    
+    // Oriented prices of the synthetic side: bought at the ask when the real
+    // book is sold, sold at the bid otherwise
+    double real_price = sell_real ? real_bid_[index] : real_ask_[index];
+    double leg1_price = sell_real ? leg1_ask_[index] : leg1_bid_[index];
+    double leg2_price = sell_real ? leg2_ask_[index] : leg2_bid_[index];
+    
+    // A leg traded in its listed orientation buys when the synthetic is bought
+    auto legSide = [sell_real](bool inverted) {
+        return sell_real != inverted ? OrderSide::BUY : OrderSide::SELL;
+    };
+    auto available = [](const TopOfBook& top, OrderSide side) {
+        return side == OrderSide::BUY ? top.ask_volume : top.bid_volume;
+    };
+    OrderSide real_side = sell_real ? OrderSide::SELL : OrderSide::BUY;
+    OrderSide leg1_side = legSide(pair.leg1_inverted);
+    OrderSide leg2_side = legSide(pair.leg2_inverted);
+    
+    // Base units each leg trades per unit of A: leg1 moves A (or C if
+    // inverted), leg2 moves C (or B if inverted)
+    double leg1_units = pair.leg1_inverted ? leg1_price : 1.0;
+    double leg2_units = pair.leg2_inverted ? leg1_price * leg2_price : leg1_price;
+    double quantity = std::min({available(real, real_side), available(leg1, leg1_side) / leg1_units,
+                                available(leg2, leg2_side) / leg2_units});
+    
+    double edge = sell_real ? getSellRealEdge(index) : getBuyRealEdge(index);
+    
+    ArbitrageOpportunity opportunity;
+    opportunity.type = ArbitrageType::REAL_VS_SYNTHETIC_SPOT;
+    opportunity.opportunity_id = std::string("RVS:") + (sell_real ? "S:" : "B:") + real.instrument_id + ":" +
+                                 leg1.instrument_id + ":" + leg2.instrument_id;
+    opportunity.leg_instruments = {real.instrument_id, leg1.instrument_id, leg2.instrument_id};
+    opportunity.leg_exchanges = {book_exchanges_[pair.real], book_exchanges_[pair.leg1],
+                                 book_exchanges_[pair.leg2]};
+    opportunity.leg_sides = {real_side, leg1_side, leg2_side};
+    opportunity.leg_prices = {real_price, pair.leg1_inverted ? 1.0 / leg1_price : leg1_price,
+                              pair.leg2_inverted ? 1.0 / leg2_price : leg2_price};
+    opportunity.leg_volumes = {quantity, quantity * leg1_units, quantity * leg2_units};
+    opportunity.expected_profit_percentage = edge;
+    opportunity.expected_profit = quantity * real_price * edge;  // In the real book's quote currency
+    opportunity.detection_time = now;
+    opportunity.expiry_time = now + config_.opportunity_ttl;
+    opportunity.is_active = true;
+    out.push_back(std::move(opportunity));
+}
+
+void SpotSpreadScanner::resizeColumns() {
+    size_t padded = simd::padLanes(pairs_.size());
+    for (auto* column : {&real_bid_, &real_ask_, &leg1_bid_, &leg1_ask_, &leg2_bid_, &leg2_ask_}) {
+        column->resize(padded, kNaN);
+    }
+    dirty_.resize(padded / simd::kLanes, 0);
+}
+
+} // namespace arbitrage
@@ -1,6 +1,19 @@
 #include "config_manager.hpp"
 #include "logger.hpp"
 #include "performance_monitor.hpp"
+#include "shard_manager.hpp"
+#include "event_loop.hpp"
+#include "engine_clock.hpp"
+#include "market_replay.hpp"
+#include "perpetual_pricer.hpp"
+#include "futures_pricer.hpp"
+#include "synthetic_construction.hpp"
+#include "cycle_detector.hpp"
+#include "spread_scanner.hpp"
+#include "cointegration_engine.hpp"
+#include "basis_detector.hpp"
+#include "funding_scanner.hpp"
+#include <algorithm>
 #include <iostream>
 #include <csignal>
 #include <atomic>
@@ -15,7 +28,10 @@ public:
     ArbitrageEngine() = default;
     ~ArbitrageEngine() = default;
     
-    bool initialize(const std::string& config_file);
+    // A non-empty replay_file switches the engine to deterministic replay:
+    // recorded events run through the strategy shards on this thread under a
+    // simulated clock instead of live feeds
+    bool initialize(const std::string& config_file, const std::string& replay_file = "");
     void run();
     void shutdown();
     
@@ -23,26 +39,30 @@ private:
     bool setupSignalHandlers();
     void printSystemInfo();
     void printConfiguration();
+    bool setupStrategyShards();
+    bool setupReplay(const std::string& replay_file);
+    void runReplay();
     
+    EventLoop event_loop_;
+    ShardManager shard_manager_;
+    std::unique_ptr<MarketReplay> replay_;
+    std::shared_ptr<CointegrationEngine> cointegration_;
     std::atomic<bool> running_{false};
     std::atomic<bool> shutdown_requested_{false};
 };
 
-// Global instance for signal handling
-std::atomic<ArbitrageEngine*> g_engine_instance{nullptr};
+// Signals that trigger a graceful shutdown
+const std::vector<int> kShutdownSignals = {SIGINT, SIGTERM, SIGQUIT};
 
-// Signal handler
-void signalHandler(int signal) {
-    std::cout << "\nReceived signal " << signal << std::endl;
-    
-    ArbitrageEngine* engine = g_engine_instance.load();
-    if (engine) {
-        engine->shutdown();
-    }
-}
-
-bool ArbitrageEngine::initialize(const std::string& config_file) {
+bool ArbitrageEngine::initialize(const std::string& config_file, const std::string& replay_file) {
     try {
+        // Route signals to the event loop; this must happen before any thread
+        // (logger flusher, shards, monitor) is created so they inherit the mask
+        if (!setupSignalHandlers()) {
+            std::cerr << "Failed to setup signal handlers" << std::endl;
+            return false;
+        }
+    
         // Initialize configuration manager
         auto& config_manager = ConfigManager::getInstance();
         if (!config_manager.loadConfig(config_file)) {
@@ -90,9 +110,16 @@ bool ArbitrageEngine::initialize(const std::string& config_file) {
             }, 80.0  // 80% threshold
         );
         
-        // Setup signal handlers
-        if (!setupSignalHandlers()) {
-            LOG_ERROR("Failed to setup signal handlers");
+        // Replay switches to simulated time before any shard (and its timers)
+        // is created
+        if (!replay_file.empty() && !setupReplay(replay_file)) {
+            LOG_ERROR("Failed to setup replay from {}", replay_file);
+            return false;
+        }
+        
+        // Partition instruments into strategy shards
+        if (!setupStrategyShards()) {
+            LOG_ERROR("Failed to setup strategy shards");
             return false;
         }
         
@@ -110,15 +137,22 @@ bool ArbitrageEngine::initialize(const std::string& config_file) {
 }
 
 void ArbitrageEngine::run() {
+    if (replay_) {
+        runReplay();
+        return;
+    }
+    
     LOG_INFO("Starting Synthetic Arbitrage Detection Engine...");
     
     running_ = true;
-    g_engine_instance = this;
     
     // Start performance monitoring
     auto& perf_monitor = PerformanceMonitor::getInstance();
     perf_monitor.start();
     
+    // Start strategy shards (one thread per shard, pinned per core)
+    shard_manager_.start();
+    
     // TODO: Phase 2 - Initialize exchange connections
     // TODO: Phase 3 - Initialize pricing models
     // TODO: Phase 4 - Initialize arbitrage detection
@@ -126,19 +160,15 @@ void ArbitrageEngine::run() {
     
     LOG_INFO("Engine is running. Press Ctrl+C to stop.");
     
-    // Main loop - placeholder for now
-    while (running_ && !shutdown_requested_) {
-        try {
-            // TODO: Process market data
-            // TODO: Detect arbitrage opportunities
-            // TODO: Execute trades
-            // TODO: Monitor risk
+    // TODO: Process market data
+    // TODO: Detect arbitrage opportunities
+    // TODO: Execute trades
+    // TODO: Monitor risk
             
-            // For now, just sleep to demonstrate the framework
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            
-            // Simulate some activity for testing
-            static int counter = 0;
+    // Simulate some activity for testing on a 100ms timer
+    int counter = 0;
+    event_loop_.addTimer(std::chrono::milliseconds(100), std::chrono::milliseconds(100),
+        [&counter, &perf_monitor]() {
             if (++counter % 10 == 0) {
                 perf_monitor.recordMessageProcessed();
                 perf_monitor.recordLatency(5.0 + (counter % 10));
@@ -148,20 +178,32 @@ void ArbitrageEngine::run() {
                     LOG_INFO("Simulated opportunity detected (counter: {})", counter);
                 }
             }
-            
-        } catch (const std::exception& e) {
-            LOG_ERROR("Exception in main loop: {}", e.what());
         }
+    );
+            
+    // Main loop - blocks in epoll until a timer, wakeup or signal fires
+    if (!shutdown_requested_) {
+        event_loop_.run();
     }
     
     LOG_INFO("Engine main loop stopped");
 }
 
 void ArbitrageEngine::shutdown() {
+    if (shutdown_requested_.exchange(true)) {
+        return;
+    }
+    
     LOG_INFO("Shutting down Synthetic Arbitrage Detection Engine...");
     
-    shutdown_requested_ = true;
     running_ = false;
+    event_loop_.stop();
+    
+    // Stop strategy shards before the monitor so final metrics are complete
+    shard_manager_.stop();
+    if (cointegration_) {
+        cointegration_->stop();
+    }
     
     // Stop performance monitoring
     auto& perf_monitor = PerformanceMonitor::getInstance();
@@ -172,7 +214,26 @@ void ArbitrageEngine::shutdown() {
     LOG_INFO("Final Statistics:");
     LOG_INFO("  Messages Processed: {}", metrics.messages_processed);
     LOG_INFO("  Opportunities Detected: {}", metrics.opportunities_detected);
+    const auto& merger = shard_manager_.getMerger();
+    LOG_INFO("  Opportunities Merged/Updated/Suppressed: {}/{}/{}", merger.getOpportunitiesMerged(),
+             merger.getOpportunitiesUpdated(), merger.getOpportunitiesSuppressed());
     LOG_INFO("  Trades Executed: {}", metrics.trades_executed);
+    LOG_INFO("  Conflated Book Updates: {}", metrics.conflated_updates);
+    LOG_INFO("  Stale Input Rejections: {}", metrics.stale_rejections);
+    uint64_t confident = 0, unconfident = 0;
+    for (size_t shard = 0; shard < shard_manager_.getShardCount(); ++shard) {
+        confident += shard_manager_.getShard(shard).getConfidenceScorer().getAcceptedCount();
+        unconfident += shard_manager_.getShard(shard).getConfidenceScorer().getRejectedCount();
+    }
+    LOG_INFO("  Confidence Accepted/Rejected: {}/{}", confident, unconfident);
+    for (Exchange exchange : {Exchange::OKX, Exchange::BINANCE, Exchange::BYBIT, Exchange::UNKNOWN}) {
+        for (DetectionStage stage : {DetectionStage::SHARD, DetectionStage::MERGER}) {
+            uint64_t rejections = perf_monitor.getStaleRejections(exchange, stage);
+            if (rejections > 0) {
+                LOG_INFO("    {} ({}): {}", exchangeToString(exchange), detectionStageToString(stage), rejections);
+            }
+        }
+    }
     LOG_INFO("  Average Latency: {:.2f}ms", metrics.average_latency_ms);
     LOG_INFO("  Max Latency: {:.2f}ms", metrics.max_latency_ms);
     LOG_INFO("  Memory Usage: {:.2f}MB", metrics.memory_usage_mb);
@@ -189,17 +250,339 @@ void ArbitrageEngine::shutdown() {
 
 bool ArbitrageEngine::setupSignalHandlers() {
     try {
-        signal(SIGINT, signalHandler);   // Ctrl+C
-        signal(SIGTERM, signalHandler);  // Termination request
-        signal(SIGQUIT, signalHandler);  // Quit signal
+        // SIGINT (Ctrl+C), SIGTERM (termination request), SIGQUIT (quit)
+        if (!EventLoop::blockSignals(kShutdownSignals)) {
+            return false;
+        }
         
-        return true;
+        auto handler_id = event_loop_.addSignalHandler(kShutdownSignals, [this](int signal) {
+            std::cout << "\nReceived signal " << signal << std::endl;
+            shutdown();
+        });
+        return handler_id != 0;
     } catch (const std::exception& e) {
         LOG_ERROR("Failed to setup signal handlers: {}", e.what());
         return false;
     }
 }
 
+bool ArbitrageEngine::setupStrategyShards() {
+    try {
+        auto& config_manager = ConfigManager::getInstance();
+        const auto& system_config = config_manager.getSystemConfig();
+        
+        if (!shard_manager_.initialize(config_manager.getEnabledInstruments(),
+                                       static_cast<size_t>(system_config.thread_pool_size))) {
+            return false;
+        }
+        
+        shard_manager_.getMerger().setOpportunityCallback(
+            [this](const ArbitrageOpportunity& opportunity) {
+                if (replay_) {
+                    replay_->recordOpportunity(opportunity);
+                    LOG_DEBUG("Opportunity {} detected: expected profit {:.4f}",
+                              opportunity.opportunity_id, opportunity.expected_profit);
+                    return;
+                }
+                LOG_INFO("Opportunity {} detected: expected profit {:.4f}, input age {}us",
+                         opportunity.opportunity_id, opportunity.expected_profit,
+                         std::chrono::duration_cast<std::chrono::microseconds>(opportunity.receive_age).count());
+            }
+        );
+        shard_manager_.getMerger().setExpiryCallback(
+            [](const std::string& opportunity_id) {
+                LOG_DEBUG("Opportunity {} expired", opportunity_id);
+            }
+        );
+        
+        // Per-shard pricing stages; every shard owns its own instances. Book
+        // updates feed the pricers' inputs and the shard's dependency graph
+        // reprices the affected synthetics once per event batch.
+        const auto& arbitrage_config = config_manager.getArbitrageConfig();
+        LatencyBudgetConfig budget_config;
+        budget_config.max_age = std::chrono::milliseconds(arbitrage_config.max_latency_ms);
+        shard_manager_.getMerger().getLatencyBudget().setConfig(budget_config);
+        ConfidenceConfig confidence_config;
+        confidence_config.threshold = arbitrage_config.confidence_threshold;
+        confidence_config.liquidity_threshold = arbitrage_config.liquidity_threshold;
+        if (arbitrage_config.max_latency_ms > 0) {
+            // A book at the edge of the latency budget keeps ~97% of its score
+            confidence_config.freshness_half_life = std::chrono::milliseconds(20 * arbitrage_config.max_latency_ms);
+        }
+        DepthSizerConfig sizer_config;
+        sizer_config.min_profit = arbitrage_config.min_profit_threshold;
+        sizer_config.max_position_size = arbitrage_config.max_position_size;
+        BasisDetectorConfig basis_config;
+        basis_config.min_basis = arbitrage_config.basis_spread_threshold;
+        FundingScannerConfig funding_config;
+        funding_config.min_rate_spread = arbitrage_config.funding_rate_threshold;
+        shard_manager_.configureShards([&arbitrage_config, &confidence_config, &sizer_config, &budget_config,
+                                        &basis_config, &funding_config](StrategyShard& shard) {
+            shard.getConfidenceScorer().setConfig(confidence_config);
+            shard.getLatencyBudget().setConfig(budget_config);
+            shard.getDepthSizer().setConfig(sizer_config);
+            
+            // Cross-venue funding spreads per underlying: re-ranked on funding
+            // prints and perp basis moves, and again ahead of each venue's
+            // funding snapshot, with expected funding taken from the shard's
+            // history. Their edge is carry, not a price difference the books
+            // could be walked for, so they are scored but unsized.
+            auto emitAll = [&shard](std::vector<ArbitrageOpportunity>& found) {
+                for (auto& opportunity : found) {
+                    shard.emitScored(std::move(opportunity));
+                }
+            };
+            auto funding_scanner = std::make_shared<FundingRateScanner>(funding_config);
+            if (funding_scanner->addInstruments(shard.getInstruments()) > 0) {
+                FundingRateScanner* scanner = funding_scanner.get();
+                funding_scanner->setFundingHistory(shard.getFundingHistory());
+                funding_scanner->setSnapshotTimers(shard.getTimingWheel(), [&shard, scanner, emitAll](size_t group) {
+                    std::vector<ArbitrageOpportunity> found;
+                    if (scanner->reevaluate(group, shard.getTimingWheel().now(), found)) {
+                        emitAll(found);
+                    }
+                });
+                shard.addEventHandler([funding_scanner, emitAll](StrategyShard&, const MarketEvent& event) {
+                    std::vector<ArbitrageOpportunity> found;
+                    if (event.type == MarketEventType::FUNDING_RATE &&
+                        funding_scanner->onFundingRate(event.funding, getEngineTimestamp(), found)) {
+                        emitAll(found);
+                    }
+                });
+                LOG_INFO("Strategy shard {}: funding scan over {} perps in {} underlyings", shard.getShardId(),
+                         funding_scanner->size(), funding_scanner->getGroupCount());
+            }
+            
+            // Basis anomalies on every perp and future of the shard, checked
+            // each time a pricer recomputes a basis
+            auto basis_detector = std::make_shared<BasisSpreadDetector>(basis_config);
+            auto addBasisContract = [&shard, &basis_detector](const InstrumentId& derivative_id,
+                                                              const InstrumentId& spot_id) {
+                return basis_detector->addContract(derivative_id, shard.getInstrument(derivative_id)->exchange,
+                                                   spot_id, shard.getInstrument(spot_id)->exchange);
+            };
+            // The spot leg is weighted to fair value, so the depth walk sizes
+            // the deviation from carry rather than the raw spot/derivative gap
+            auto checkBasis = [&shard, basis_detector](size_t contract, Price derivative_mid, Price fair_value,
+                                                       Price spot_mid) {
+                std::vector<ArbitrageOpportunity> found;
+                Timestamp now = getEngineTimestamp();
+                if (basis_detector->update(contract, derivative_mid, fair_value, spot_mid, now, found)) {
+                    const double weights[2] = {1.0, fair_value / spot_mid};
+                    for (auto& opportunity : found) {
+                        shard.emitSized(std::move(opportunity), weights);
+                    }
+                }
+            };
+            
+            auto perp_pricer = std::make_shared<PerpetualFairValueEngine>();
+            if (perp_pricer->addInstruments(shard.getInstruments()) > 0) {
+                perp_pricer->registerDependencies(shard.getDependencyGraph());
+                shard.addEventHandler([perp_pricer](StrategyShard&, const MarketEvent& event) {
+                    perp_pricer->onMarketEvent(event, getEngineTimestamp());
+                });
+                const size_t first = basis_detector->size();
+                for (size_t index = 0; index < perp_pricer->size(); ++index) {
+                    addBasisContract(perp_pricer->getPerpetualId(index), perp_pricer->getSpotId(index));
+                }
+                // Perp basis moves also feed the funding scanner's entry cost
+                std::vector<size_t> funding_perps(perp_pricer->size());
+                std::vector<uint8_t> funded(perp_pricer->size(), 0);
+                for (size_t index = 0; index < perp_pricer->size(); ++index) {
+                    funded[index] = funding_scanner->findPerpetual(perp_pricer->getPerpetualId(index),
+                                                                   funding_perps[index]);
+                }
+                const PerpetualFairValueEngine* pricer = perp_pricer.get();
+                FundingRateScanner* scanner = funding_scanner.get();
+                perp_pricer->setBasisCallback([&shard, checkBasis, emitAll, pricer, scanner, funding_perps, funded,
+                                               first](size_t index) {
+                    const Price perp_mid = pricer->getPerpPrice(index), fair_value = pricer->getFairValue(index);
+                    checkBasis(first + index, perp_mid, fair_value, pricer->getSpotPrice(index));
+                    const OrderBook* book = shard.getOrderBook(pricer->getPerpetualId(index));
+                    if (!funded[index] || !(fair_value > 0.0) || book == nullptr) {
+                        return;
+                    }
+                    std::vector<ArbitrageOpportunity> found;
+                    double basis = (perp_mid - fair_value) / fair_value;
+                    if (scanner->onBasis(funding_perps[index], basis, book->getBestBid(), book->getBestAsk(),
+                                         getEngineTimestamp(), found)) {
+                        emitAll(found);
+                    }
+                });
+            }
+            
+            auto futures_pricer = std::make_shared<FuturesCarryPricer>();
+            if (futures_pricer->addInstruments(shard.getInstruments(), getEngineTimestamp()) > 0) {
+                for (const auto& [quote, rate] : arbitrage_config.carry_rates) {
+                    futures_pricer->setRate(quote, rate);
+                }
+                futures_pricer->startRefreshTimer(shard.getTimingWheel());
+                futures_pricer->registerDependencies(shard.getDependencyGraph());
+                shard.addEventHandler([futures_pricer](StrategyShard&, const MarketEvent& event) {
+                    futures_pricer->onMarketEvent(event, getEngineTimestamp());
+                });
+                const size_t first = basis_detector->size();
+                for (size_t index = 0; index < futures_pricer->size(); ++index) {
+                    addBasisContract(futures_pricer->getFutureId(index), futures_pricer->getSpotId(index));
+                }
+                const FuturesCarryPricer* pricer = futures_pricer.get();
+                futures_pricer->setBasisCallback([checkBasis, pricer, first](size_t index) {
+                    checkBasis(first + index, pricer->getFuturePrice(index), pricer->getFairValue(index),
+                               pricer->getSpotPrice(index));
+                });
+            }
+            if (basis_detector->size() > 0) {
+                LOG_INFO("Strategy shard {}: basis anomaly detection on {} contracts", shard.getShardId(),
+                         basis_detector->size());
+            }
+            
+            // Configured constructions whose legs all live on this shard;
+            // kernels are selected here, once
+            auto construction_engine = std::make_shared<SyntheticConstructionEngine>();
+            for (const auto& definition : arbitrage_config.constructions) {
+                bool local = std::all_of(definition.legs.begin(), definition.legs.end(),
+                                         [&shard](const InstrumentId& leg) { return shard.getInstrument(leg) != nullptr; });
+                if (local && !construction_engine->add(definition)) {
+                    LOG_WARN("Synthetic construction {} does not fit shape {}; skipped",
+                             definition.id, constructionShapeToString(definition.shape));
+                }
+            }
+            if (construction_engine->size() > 0) {
+                construction_engine->registerDependencies(shard.getDependencyGraph());
+                shard.addEventHandler([construction_engine](StrategyShard&, const MarketEvent& event) {
+                    construction_engine->onMarketEvent(event, getEngineTimestamp());
+                });
+                LOG_INFO("Strategy shard {}: {} synthetic constructions ({} specialized)", shard.getShardId(),
+                         construction_engine->size(), construction_engine->getSpecializedCount());
+            }
+        });
+        
+        // Cross-venue currency cycles span shards, so they are detected on
+        // the merger from the published tops; cross-quote books are compared
+        // in the normalizer's pivot. Merger detectors size to the top level
+        // (no depth crosses shards), so these are not depth-sized.
+        CycleDetectorConfig cycle_config;
+        cycle_config.min_profit = arbitrage_config.min_profit_threshold;
+        cycle_config.report_triangles = false;  // Left to the spread scanner below
+        auto cycle_detector = std::make_shared<CurrencyCycleDetector>(cycle_config);
+        cycle_detector->setQuoteNormalizer(&shard_manager_.getMerger().getQuoteNormalizer());
+        if (cycle_detector->addInstruments(config_manager.getEnabledInstruments()) > 0) {
+            shard_manager_.getMerger().addCrossShardDetector(
+                [cycle_detector](const OpportunityMerger::TopOfBookTable& tops,
+                                 const std::vector<InstrumentId>& changed, std::vector<ArbitrageOpportunity>& out) {
+                    const Timestamp now = getEngineTimestamp();
+                    for (const auto& instrument_id : changed) {
+                        auto it = tops.find(instrument_id);
+                        if (it != tops.end()) {
+                            cycle_detector->onTopOfBook(it->second, now, out);
+                        }
+                    }
+                });
+            LOG_INFO("Cycle detection over {} currencies, {} books ({} normalized, max length {})",
+                     cycle_detector->getCurrencyCount(), cycle_detector->getPairCount(),
+                     cycle_detector->getNormalizedPairCount(), cycle_config.max_cycle_length);
+        }
+        
+        // Real vs synthetic spot triangles also mix books from several shards;
+        // a batch's tops are stored first and its touched pairs scanned once
+        SpreadScannerConfig scanner_config;
+        scanner_config.min_profit = arbitrage_config.min_profit_threshold;
+        auto spread_scanner = std::make_shared<SpotSpreadScanner>(scanner_config);
+        if (spread_scanner->addInstruments(config_manager.getEnabledInstruments()) > 0) {
+            shard_manager_.getMerger().addCrossShardDetector(
+                [spread_scanner](const OpportunityMerger::TopOfBookTable& tops,
+                                 const std::vector<InstrumentId>& changed, std::vector<ArbitrageOpportunity>& out) {
+                    bool touched = false;
+                    for (const auto& instrument_id : changed) {
+                        auto it = tops.find(instrument_id);
+                        touched |= it != tops.end() && spread_scanner->onTopOfBook(it->second);
+                    }
+                    if (touched) {
+                        spread_scanner->scan(getEngineTimestamp(), out);
+                    }
+                });
+            LOG_INFO("Real vs synthetic spot scan over {} triangles", spread_scanner->size());
+        }
+        
+        // Statistical pairs: z-scores advance with the merged tops, moments on
+        // a grid timer on the merger's wheel, and cointegration is re-tested
+        // on the engine's own worker thread. Signals are logged only: a
+        // spread position has no locked-in edge to publish as an opportunity.
+        CointegrationConfig cointegration_config;
+        cointegration_config.min_correlation = arbitrage_config.correlation_threshold;
+        auto cointegration = std::make_shared<CointegrationEngine>(cointegration_config);
+        if (cointegration->addInstruments(config_manager.getEnabledInstruments()) > 0) {
+            const CointegrationEngine* engine = cointegration.get();
+            cointegration->setSignalCallback([engine](size_t pair, int signal, double z_score) {
+                LOG_DEBUG("Statistical pair {} signal {} at z {:.2f} (beta {:.4f})", pair, signal, z_score,
+                          engine->getHedgeRatio(pair));
+            });
+            cointegration->start();
+            cointegration->startSampleTimer(shard_manager_.getMerger().getTimingWheel());
+            shard_manager_.getMerger().addCrossShardDetector(
+                [cointegration](const OpportunityMerger::TopOfBookTable& tops,
+                                const std::vector<InstrumentId>& changed, std::vector<ArbitrageOpportunity>&) {
+                    for (const auto& instrument_id : changed) {
+                        auto it = tops.find(instrument_id);
+                        if (it != tops.end()) {
+                            cointegration->onTopOfBook(it->second);
+                        }
+                    }
+                });
+            cointegration_ = cointegration;
+            LOG_INFO("Statistical pairs: {} pairs on a {}ms grid", cointegration->size(),
+                     cointegration_config.sample_interval.count());
+        }
+        
+        return true;
+        
+    } catch (const std::exception& e) {
+        LOG_ERROR("Failed to setup strategy shards: {}", e.what());
+        return false;
+    }
+}
+
+bool ArbitrageEngine::setupReplay(const std::string& replay_file) {
+    try {
+        replay_ = std::make_unique<MarketReplay>();
+        if (!replay_->load(replay_file) || replay_->getEvents().empty()) {
+            LOG_ERROR("No replayable events in {}", replay_file);
+            return false;
+        }
+        
+        EngineClock::getInstance().useSimulatedTime(replay_->getStartTime());
+        LOG_INFO("Replay mode: {} events, simulated clock starts at {:.3f}ms",
+                 replay_->getEvents().size(), timestampToMs(replay_->getStartTime()));
+        return true;
+    
+    } catch (const std::exception& e) {
+        LOG_ERROR("Failed to load replay: {}", e.what());
+        return false;
+    }
+}
+
+void ArbitrageEngine::runReplay() {
+    LOG_INFO("Replaying {} recorded events...", replay_->getEvents().size());
+    running_ = true;
+    
+    // Keep signals serviced between batches so Ctrl+C still stops a long replay
+    auto stats = replay_->run(shard_manager_, [this]() {
+        event_loop_.runOnce(0);
+        return !shutdown_requested_;
+    });
+    
+    LOG_INFO("Replay completed:");
+    LOG_INFO("  Events Replayed: {}", stats.events_replayed);
+    LOG_INFO("  Simulated Span: {:.3f}s",
+             std::chrono::duration<double>(stats.last_event_time - stats.first_event_time).count());
+    LOG_INFO("  Wall Time: {:.3f}s", stats.wall_time_seconds);
+    LOG_INFO("  Throughput: {:.0f} events/sec", stats.events_per_second);
+    LOG_INFO("  Opportunities: {}", stats.opportunities);
+    LOG_INFO("  Opportunity Digest: {:016x}", stats.opportunity_digest);
+    
+    shutdown();
+}
+
 void ArbitrageEngine::printSystemInfo() {
     LOG_INFO("System Information:");
     LOG_INFO("  CPU Cores: {}", std::thread::hardware_concurrency());
@@ -222,6 +605,7 @@ void ArbitrageEngine::printConfiguration() {
         LOG_INFO("  Thread Pool Size: {}", config.thread_pool_size);
         LOG_INFO("  Memory Pool Size: {:.2f}MB", config.memory_pool_size / 1024.0 / 1024.0);
         LOG_INFO("  Performance Monitoring: {}", config.performance_monitoring ? "enabled" : "disabled");
+        LOG_INFO("  Strategy Shards: {}", shard_manager_.getShardCount());
         
         // Print enabled exchanges
         auto enabled_exchanges = ConfigManager::getInstance().getEnabledExchanges();
@@ -255,10 +639,20 @@ int main(int argc, char* argv[]) {
     try {
         // Default configuration file
         std::string config_file = "config/engine_config.json";
+        std::string replay_file;
         
-        // Parse command line arguments
-        if (argc > 1) {
-            config_file = argv[1];
+        // Parse command line arguments: [config_file] [--replay events.jsonl]
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--replay") {
+                if (i + 1 >= argc) {
+                    std::cerr << "--replay requires a file argument" << std::endl;
+                    return 1;
+                }
+                replay_file = argv[++i];
+            } else {
+                config_file = arg;
+            }
         }
         
         std::cout << "Synthetic Arbitrage Detection Engine v1.0.0" << std::endl;
@@ -266,7 +660,10 @@ int main(int argc, char* argv[]) {
         
         // Create and initialize engine
         arbitrage::ArbitrageEngine engine;
-        if (!engine.initialize(config_file)) {
+        if (!replay_file.empty()) {
+            std::cout << "Replaying market events from: " << replay_file << std::endl;
+        }
+        if (!engine.initialize(config_file, replay_file)) {
             std::cerr << "Failed to initialize engine" << std::endl;
             return 1;
         }
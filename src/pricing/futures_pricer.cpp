@@ -0,0 +1,253 @@
+#include "futures_pricer.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace arbitrage {
+
+namespace {
+
+constexpr double kSecondsPerYear = 365.0 * 24.0 * 3600.0;
+
+} // namespace
+
+FuturesCarryPricer::FuturesCarryPricer(std::chrono::milliseconds refresh_interval)
+    : refresh_interval_(refresh_interval.count() > 0 ? refresh_interval : std::chrono::milliseconds(1000)) {
+}
+
+size_t FuturesCarryPricer::addFuture(const InstrumentId& future_id, const InstrumentId& spot_id,
+                                     const std::string& rate_key, Timestamp expiry_time, Timestamp now) {
+    size_t index;
+    if (findFuture(future_id, index)) {
+        return index;
+    }
+    
+    auto slot_it = rate_slots_.find(rate_key);
+    if (slot_it == rate_slots_.end()) {
+        slot_it = rate_slots_.emplace(rate_key, rates_.size()).first;
+        rates_.push_back(0.0);
+        rate_dependents_.emplace_back();
+    }
+    
+    index = future_ids_.size();
+    future_ids_.push_back(future_id);
+    spot_ids_.push_back(spot_id);
+    rate_slot_.push_back(slot_it->second);
+    expiry_time_.push_back(expiry_time);
+    calculation_time_.emplace_back();
+    future_index_[future_id] = index;
+    spot_dependents_[spot_id].push_back(index);
+    rate_dependents_[slot_it->second].push_back(index);
+    
+    time_to_expiry_.push_back(0.0);
+    discount_factor_.push_back(1.0);
+    spot_mid_.push_back(0.0);
+    future_mid_.push_back(0.0);
+    fair_value_.push_back(0.0);
+    basis_spread_.push_back(0.0);
+    dirty_.push_back(0);
+    
+    refreshContract(index, now);
+    return index;
+}
+
+size_t FuturesCarryPricer::addInstruments(const std::vector<Instrument>& instruments, Timestamp now) {
+    size_t added = 0;
+    for (const auto& future : instruments) {
+        if (future.type != InstrumentType::FUTURES || future.expiry_time.time_since_epoch().count() == 0) {
+            continue;
+        }
+        
+        const Instrument* best = nullptr;
+        for (const auto& spot : instruments) {
+            if (spot.type != InstrumentType::SPOT || spot.base_asset != future.base_asset ||
+                spot.quote_asset != future.quote_asset) {
+                continue;
+            }
+            if (!best || (spot.exchange == future.exchange && best->exchange != future.exchange)) {
+                best = &spot;
+            }
+        }
+        if (best) {
+            addFuture(future.id, best->id, future.quote_asset, future.expiry_time, now);
+            ++added;
+        }
+    }
+    return added;
+}
+
+void FuturesCarryPricer::setRate(const std::string& rate_key, double annual_rate) {
+    auto it = rate_slots_.find(rate_key);
+    if (it == rate_slots_.end() || rates_[it->second] == annual_rate) {
+        return;
+    }
+    
+    size_t slot = it->second;
+    rates_[slot] = annual_rate;
+    for (size_t index : rate_dependents_[slot]) {
+        discount_factor_[index] = std::exp(-annual_rate * time_to_expiry_[index]);
+        markDirty(index);
+    }
+}
+
+void FuturesCarryPricer::setBasisCallback(BasisCallback callback) {
+    basis_callback_ = std::move(callback);
+}
+
+void FuturesCarryPricer::updateSpotPrice(const InstrumentId& spot_id, Price mid) {
+    auto it = spot_dependents_.find(spot_id);
+    if (it == spot_dependents_.end()) {
+        return;
+    }
+    for (size_t index : it->second) {
+        if (spot_mid_[index] != mid) {
+            spot_mid_[index] = mid;
+            markDirty(index);
+        }
+    }
+}
+
+void FuturesCarryPricer::updateFuturePrice(const InstrumentId& future_id, Price mid) {
+    size_t index;
+    if (findFuture(future_id, index) && future_mid_[index] != mid) {
+        // Only the basis moves; fair value is unaffected
+        future_mid_[index] = mid;
+        basis_spread_[index] = mid - fair_value_[index];
+        basis_moved_ = true;
+        if (basis_callback_) {
+            basis_callback_(index);
+        }
+    }
+}
+
+size_t FuturesCarryPricer::reprice(Timestamp now) {
+    size_t repriced = dirty_list_.size();
+    for (size_t index : dirty_list_) {
+        priceContract(index, now);
+        dirty_[index] = 0;
+    }
+    dirty_list_.clear();
+    reprice_count_ += repriced;
+    return repriced;
+}
+
+void FuturesCarryPricer::refreshExpiryTable(Timestamp now) {
+    for (size_t index = 0; index < future_ids_.size(); ++index) {
+        refreshContract(index, now);
+        priceContract(index, now);
+        dirty_[index] = 0;
+    }
+    dirty_list_.clear();
+    reprice_count_ += future_ids_.size();
+    ++refresh_count_;
+}
+
+void FuturesCarryPricer::startRefreshTimer(TimingWheel& wheel) {
+    wheel.scheduleAfter(refresh_interval_, [this, &wheel]() {
+        refreshExpiryTable(wheel.now());
+        startRefreshTimer(wheel);
+    });
+}
+
+DependencyGraph::NodeId FuturesCarryPricer::registerDependencies(DependencyGraph& graph) {
+    graph_node_ = graph.addNode("futures_carry", [this](Timestamp now) {
+        bool changed = reprice(now) > 0 || basis_moved_;
+        basis_moved_ = false;
+        return changed;
+    });
+    for (size_t index = 0; index < future_ids_.size(); ++index) {
+        graph.addDependency(future_ids_[index], graph_node_);
+        graph.addDependency(spot_ids_[index], graph_node_);
+    }
+    return graph_node_;
+}
+
+bool FuturesCarryPricer::onMarketEvent(const MarketEvent& event, Timestamp now) {
+    switch (event.type) {
+        case MarketEventType::BOOK_UPDATE: {
+            if (event.book.bids.empty() || event.book.asks.empty()) {
+                return false;
+            }
+            Price mid = event.book.getMidPrice();
+            size_t index;
+            bool is_future = findFuture(event.instrument_id, index);
+            if (is_future) {
+                updateFuturePrice(event.instrument_id, mid);
+            } else {
+                updateSpotPrice(event.instrument_id, mid);
+            }
+            if (graph_node_ != DependencyGraph::kInvalidNode) {
+                return false;  // Repriced by the dependency graph at the end of the batch
+            }
+            return reprice(now) > 0 || is_future;
+        }
+        case MarketEventType::INSTRUMENT_EXPIRY: {
+            // Expired contracts converge onto spot
+            size_t index;
+            if (!findFuture(event.instrument_id, index)) {
+                return false;
+            }
+            refreshContract(index, now);
+            markDirty(index);
+            return reprice(now) > 0;
+        }
+        default:
+            return false;
+    }
+}
+
+bool FuturesCarryPricer::getSyntheticPrice(const InstrumentId& future_id, SyntheticPrice& out) const {
+    size_t index;
+    if (!findFuture(future_id, index) || spot_mid_[index] <= 0.0 || future_mid_[index] <= 0.0) {
+        return false;
+    }
+    
+    out.synthetic_instrument_id = future_id;
+    out.calculated_price = fair_value_[index];
+    out.fair_value = fair_value_[index];
+    out.basis_spread = basis_spread_[index];
+    out.component_instruments.assign(1, spot_ids_[index]);
+    out.component_weights.assign(1, 1.0 / discount_factor_[index]);
+    out.calculation_time = calculation_time_[index];
+    return true;
+}
+
+bool FuturesCarryPricer::findFuture(const InstrumentId& future_id, size_t& index) const {
+    auto it = future_index_.find(future_id);
+    if (it == future_index_.end()) {
+        return false;
+    }
+    index = it->second;
+    return true;
+}
+
+double FuturesCarryPricer::getImpliedCarry(size_t index) const {
+    double t = time_to_expiry_[index];
+    if (t <= 0.0 || spot_mid_[index] <= 0.0 || future_mid_[index] <= 0.0) {
+        return 0.0;
+    }
+    return std::log(future_mid_[index] / spot_mid_[index]) / t;
+}
+
+void FuturesCarryPricer::markDirty(size_t index) {
+    if (!dirty_[index]) {
+        dirty_[index] = 1;
+        dirty_list_.push_back(index);
+    }
+}
+
+void FuturesCarryPricer::refreshContract(size_t index, Timestamp now) {
+    double seconds = std::chrono::duration<double>(expiry_time_[index] - now).count();
+    time_to_expiry_[index] = std::max(seconds, 0.0) / kSecondsPerYear;
+    discount_factor_[index] = std::exp(-rates_[rate_slot_[index]] * time_to_expiry_[index]);
+}
+
+void FuturesCarryPricer::priceContract(size_t index, Timestamp now) {
+    fair_value_[index] = spot_mid_[index] / discount_factor_[index];
+    basis_spread_[index] = future_mid_[index] - fair_value_[index];
+    calculation_time_[index] = now;
+    if (basis_callback_) {
+        basis_callback_(index);
+    }
+}
+
+} // namespace arbitrage
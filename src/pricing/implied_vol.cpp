@@ -0,0 +1,236 @@
+#include "implied_vol.hpp"
+#include "simd_math.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace arbitrage {
+
+namespace {
+
+constexpr double kMinTime = 1e-12;
+constexpr double kMinVega = 1e-300;  // Far-wing vega underflows; the step is clamped instead
+constexpr double kMinPrice = 1e-300;
+constexpr double kSqrt2Pi = 2.50662827463100050242;
+constexpr double kInvPi = 0.31830988618379067154;
+
+// Corrado-Miller approximation of sigma from the call-equivalent price, with
+// both legs discounted so carry and rates drop out of the formula
+double initialGuess(double call_price, double s_df, double k_df, double sqrt_t) {
+    double half_diff = 0.5 * (s_df - k_df);
+    double a = call_price - half_diff;
+    double disc = std::max(a * a - 4.0 * half_diff * half_diff * kInvPi, 0.0);
+    return kSqrt2Pi / (s_df + k_df) * (a + std::sqrt(disc)) / sqrt_t;
+}
+
+} // namespace
+
+void ImpliedVolStats::merge(const ImpliedVolStats& other) {
+    batches += other.batches;
+    options += other.options;
+    converged += other.converged;
+    unconverged += other.unconverged;
+    out_of_bounds += other.out_of_bounds;
+    iterations += other.iterations;
+    max_iterations = std::max(max_iterations, other.max_iterations);
+}
+
+ImpliedVolStats ImpliedVolSolver::solve(OptionBatch& batch, bool warm_start) {
+    using simd::VecD;
+    using simd::MaskD;
+    
+    const VecD zero = VecD::broadcast(0.0);
+    const VecD one = VecD::broadcast(1.0);
+    const VecD half = VecD::broadcast(0.5);
+    const VecD min_time = VecD::broadcast(kMinTime);
+    const VecD min_vega = VecD::broadcast(kMinVega);
+    const VecD min_price = VecD::broadcast(kMinPrice);
+    const VecD min_vol = VecD::broadcast(config_.min_volatility);
+    const VecD max_vol = VecD::broadcast(config_.max_volatility);
+    const VecD tolerance = VecD::broadcast(config_.tolerance);
+    const VecD nan = VecD::broadcast(std::numeric_limits<double>::quiet_NaN());
+    const VecD halley_low = VecD::broadcast(0.5);
+    const VecD halley_high = VecD::broadcast(2.0);
+    const VecD sqrt_2pi = VecD::broadcast(kSqrt2Pi);
+    const VecD inv_pi = VecD::broadcast(kInvPi);
+    
+    double lane_offsets[simd::kLanes];
+    for (size_t lane = 0; lane < simd::kLanes; ++lane) {
+        lane_offsets[lane] = static_cast<double>(lane);
+    }
+    const VecD lane_offset = VecD::load(lane_offsets);
+    const VecD live_count = VecD::broadcast(static_cast<double>(batch.size()));
+    
+    ImpliedVolStats result;
+    result.batches = 1;
+    result.options = batch.size();
+    
+    const size_t count = simd::padLanes(batch.size());
+    for (size_t i = 0; i < count; i += simd::kLanes) {
+        VecD s = VecD::load(&batch.spot[i]);
+        VecD k = VecD::load(&batch.strike[i]);
+        VecD t = simd::max(VecD::load(&batch.time_to_expiry[i]), min_time);
+        VecD r = VecD::load(&batch.rate[i]);
+        VecD q = VecD::load(&batch.carry[i]);
+        VecD phi = VecD::load(&batch.sign[i]);
+        VecD quote = VecD::load(&batch.market_price[i]);
+        VecD previous = VecD::load(&batch.volatility[i]);
+        
+        VecD sqrt_t = simd::sqrt(t);
+        VecD s_df = s * simd::exp(-(q * t));
+        VecD k_df = k * simd::exp(-(r * t));
+        VecD forward_diff = s_df - k_df;
+        VecD log_moneyness = simd::log(s_df / k_df);
+        
+        // Padding lanes and quotes outside (intrinsic, upper bound) are not solved
+        MaskD is_call = phi > zero;
+        VecD lower = simd::max(phi * forward_diff, zero);
+        VecD upper = simd::select(is_call, s_df, k_df);
+        MaskD in_batch = (VecD::broadcast(static_cast<double>(i)) + lane_offset) < live_count;
+        MaskD valid = in_batch & (quote > lower) & (upper > quote);
+        
+        VecD call = simd::select(is_call, quote, quote + forward_diff);
+        VecD a = call - half * forward_diff;
+        VecD disc = simd::max(a * a - forward_diff * forward_diff * inv_pi, zero);
+        VecD guess = sqrt_2pi / (s_df + k_df) * (a + simd::sqrt(disc)) / sqrt_t;
+        VecD vol = simd::min(simd::max(guess, min_vol), max_vol);
+        if (warm_start) {
+            vol = simd::select((previous >= min_vol) & (max_vol >= previous), previous, vol);
+        }
+        
+        // Iterate on the log of the out-of-the-money price (parity strips the
+        // intrinsic value), which stays well conditioned for far wings whose
+        // prices span many orders of magnitude
+        VecD psi = simd::select(forward_diff > zero, -one, one);
+        VecD log_target = simd::log(simd::max(quote - lower, min_price));
+        
+        VecD steps = zero;
+        MaskD active = valid;
+        for (int iteration = 0; iteration < config_.max_iterations && simd::toBits(active) != 0; ++iteration) {
+            VecD std_dev = vol * sqrt_t;
+            VecD d1 = simd::fma(half * std_dev, std_dev, log_moneyness) / std_dev;
+            VecD d2 = d1 - std_dev;
+            VecD model = simd::max(psi * (s_df * simd::normCdf(psi * d1) - k_df * simd::normCdf(psi * d2)), min_price);
+            VecD vega = simd::max(s_df * simd::normPdf(d1) * sqrt_t, min_vega);
+            
+            // f = ln(model / target); Halley: newton / (1 - newton * f'' / (2 f'))
+            // with f' = vega / model and f'' / f' = volga / vega - vega / model
+            VecD f = simd::log(model) - log_target;
+            VecD newton = f * model / vega;
+            VecD curvature = d1 * d2 / vol - vega / model;
+            VecD denominator = one - half * newton * curvature;
+            MaskD stable = (denominator > halley_low) & (halley_high > denominator);
+            VecD step = simd::select(stable, newton / denominator, newton);
+            // Damped: vol at most halves per step and a step past the upper
+            // bound goes halfway to it, so a poor start contracts instead of
+            // bouncing between the bounds
+            VecD next = simd::max(vol - step, simd::max(half * vol, min_vol));
+            next = simd::select(next > max_vol, half * (vol + max_vol), next);
+            
+            steps = steps + simd::select(active, one, zero);
+            VecD moved = simd::abs(next - vol);
+            vol = simd::select(active, next, vol);
+            active = active & (moved >= tolerance);
+        }
+        
+        // Unsolvable quotes report NaN; padding lanes keep their benign inputs
+        vol = simd::select(valid, vol, nan);
+        simd::select(in_batch, vol, previous).store(&batch.volatility[i]);
+        
+        double lane_steps[simd::kLanes];
+        steps.store(lane_steps);
+        uint32_t valid_bits = simd::toBits(valid);
+        uint32_t active_bits = simd::toBits(active);
+        for (size_t lane = 0; lane < simd::kLanes && i + lane < batch.size(); ++lane) {
+            if (!(valid_bits & (1u << lane))) {
+                ++result.out_of_bounds;
+                continue;
+            }
+            uint32_t lane_iterations = static_cast<uint32_t>(lane_steps[lane]);
+            result.iterations += lane_iterations;
+            result.max_iterations = std::max(result.max_iterations, lane_iterations);
+            if (active_bits & (1u << lane)) {
+                ++result.unconverged;
+            } else {
+                ++result.converged;
+            }
+        }
+    }
+    
+    stats_.merge(result);
+    return result;
+}
+
+ImpliedVolStats ImpliedVolSolver::solveReference(OptionBatch& batch, bool warm_start) {
+    auto cdf = [](double x) { return 0.5 * std::erfc(-x / std::sqrt(2.0)); };
+    const double inv_sqrt_2pi = 1.0 / kSqrt2Pi;
+    
+    ImpliedVolStats result;
+    result.batches = 1;
+    result.options = batch.size();
+    
+    for (size_t i = 0; i < batch.size(); ++i) {
+        double t = std::max(batch.time_to_expiry[i], kMinTime);
+        double phi = batch.sign[i];
+        double quote = batch.market_price[i];
+        double sqrt_t = std::sqrt(t);
+        double s_df = batch.spot[i] * std::exp(-batch.carry[i] * t);
+        double k_df = batch.strike[i] * std::exp(-batch.rate[i] * t);
+        double log_moneyness = std::log(s_df / k_df);
+        
+        double lower = std::max(phi * (s_df - k_df), 0.0);
+        double upper = phi > 0.0 ? s_df : k_df;
+        if (!(quote > lower && quote < upper)) {
+            batch.volatility[i] = std::numeric_limits<double>::quiet_NaN();
+            ++result.out_of_bounds;
+            continue;
+        }
+        
+        double call = phi > 0.0 ? quote : quote + s_df - k_df;
+        double vol = std::clamp(initialGuess(call, s_df, k_df, sqrt_t),
+                                config_.min_volatility, config_.max_volatility);
+        double previous = batch.volatility[i];
+        if (warm_start && previous >= config_.min_volatility && previous <= config_.max_volatility) {
+            vol = previous;
+        }
+        
+        double psi = s_df > k_df ? -1.0 : 1.0;
+        double log_target = std::log(std::max(quote - lower, kMinPrice));
+        
+        uint32_t steps = 0;
+        bool converged = false;
+        while (!converged && steps < static_cast<uint32_t>(config_.max_iterations)) {
+            double std_dev = vol * sqrt_t;
+            double d1 = (log_moneyness + 0.5 * std_dev * std_dev) / std_dev;
+            double d2 = d1 - std_dev;
+            double model = std::max(psi * (s_df * cdf(psi * d1) - k_df * cdf(psi * d2)), kMinPrice);
+            double vega = std::max(s_df * inv_sqrt_2pi * std::exp(-0.5 * d1 * d1) * sqrt_t, kMinVega);
+            
+            double newton = (std::log(model) - log_target) * model / vega;
+            double denominator = 1.0 - 0.5 * newton * (d1 * d2 / vol - vega / model);
+            double step = denominator > 0.5 && denominator < 2.0 ? newton / denominator : newton;
+            double next = std::max(vol - step, std::max(0.5 * vol, config_.min_volatility));
+            if (next > config_.max_volatility) {
+                next = 0.5 * (vol + config_.max_volatility);
+            }
+            
+            ++steps;
+            converged = std::fabs(next - vol) < config_.tolerance;
+            vol = next;
+        }
+        
+        batch.volatility[i] = vol;
+        result.iterations += steps;
+        result.max_iterations = std::max(result.max_iterations, steps);
+        if (converged) {
+            ++result.converged;
+        } else {
+            ++result.unconverged;
+        }
+    }
+    
+    stats_.merge(result);
+    return result;
+}
+
+} // namespace arbitrage
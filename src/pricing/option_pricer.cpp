@@ -0,0 +1,131 @@
+#include "option_pricer.hpp"
+#include "simd_math.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace arbitrage {
+
+namespace {
+
+// Keeps d1/d2 finite at expiry or zero vol; the Greeks degrade to their limits
+constexpr double kMinTime = 1e-12;
+constexpr double kMinStdDev = 1e-12;
+
+} // namespace
+
+size_t OptionBatch::add(double spot_price, double strike_price, double years, double vol,
+                        double rate_value, double carry_value, bool is_call) {
+    size_t index = count_;
+    resize(count_ + 1);
+    spot[index] = spot_price;
+    strike[index] = strike_price;
+    time_to_expiry[index] = years;
+    volatility[index] = vol;
+    rate[index] = rate_value;
+    carry[index] = carry_value;
+    sign[index] = is_call ? 1.0 : -1.0;
+    return index;
+}
+
+void OptionBatch::resize(size_t count) {
+    size_t padded = simd::padLanes(count);
+    if (padded > spot.size()) {
+        padded = std::max(padded, spot.size() * 2);
+    }
+    
+    // Padding lanes hold an at-the-money call so they never produce NaNs
+    spot.resize(padded, 1.0);
+    strike.resize(padded, 1.0);
+    time_to_expiry.resize(padded, 1.0);
+    volatility.resize(padded, 0.5);
+    rate.resize(padded, 0.0);
+    carry.resize(padded, 0.0);
+    sign.resize(padded, 1.0);
+    market_price.resize(padded, 0.0);
+    for (auto* column : {&price, &delta, &gamma, &vega, &theta}) {
+        column->resize(padded, 0.0);
+    }
+    count_ = count;
+}
+
+void OptionBatch::setSpot(double spot_price) {
+    std::fill(spot.begin(), spot.begin() + count_, spot_price);
+}
+
+void BlackScholesPricer::priceBatch(OptionBatch& batch) {
+    using simd::VecD;
+    
+    const VecD half = VecD::broadcast(0.5);
+    const VecD min_time = VecD::broadcast(kMinTime);
+    const VecD min_std_dev = VecD::broadcast(kMinStdDev);
+    
+    const size_t count = simd::padLanes(batch.size());
+    for (size_t i = 0; i < count; i += simd::kLanes) {
+        VecD s = VecD::load(&batch.spot[i]);
+        VecD k = VecD::load(&batch.strike[i]);
+        VecD t = simd::max(VecD::load(&batch.time_to_expiry[i]), min_time);
+        VecD vol = VecD::load(&batch.volatility[i]);
+        VecD r = VecD::load(&batch.rate[i]);
+        VecD q = VecD::load(&batch.carry[i]);
+        VecD phi = VecD::load(&batch.sign[i]);
+        
+        VecD sqrt_t = simd::sqrt(t);
+        VecD std_dev = simd::max(vol * sqrt_t, min_std_dev);
+        VecD d1 = simd::fma(r - q + half * vol * vol, t, simd::log(s / k)) / std_dev;
+        VecD d2 = d1 - std_dev;
+        
+        VecD carry_df = simd::exp(-(q * t));
+        VecD rate_df = simd::exp(-(r * t));
+        VecD n_d1 = simd::normCdf(phi * d1);
+        VecD n_d2 = simd::normCdf(phi * d2);
+        VecD pdf_d1 = simd::normPdf(d1);
+        
+        VecD s_df = s * carry_df;
+        VecD k_df = k * rate_df;
+        VecD s_df_pdf = s_df * pdf_d1;
+        
+        (phi * (s_df * n_d1 - k_df * n_d2)).store(&batch.price[i]);
+        (phi * carry_df * n_d1).store(&batch.delta[i]);
+        (carry_df * pdf_d1 / (s * std_dev)).store(&batch.gamma[i]);
+        (s_df_pdf * sqrt_t).store(&batch.vega[i]);
+        
+        VecD decay = -(s_df_pdf * vol * half / sqrt_t);
+        VecD carry_terms = phi * (q * s_df * n_d1 - r * k_df * n_d2);
+        (decay + carry_terms).store(&batch.theta[i]);
+    }
+}
+
+void BlackScholesPricer::priceReference(OptionBatch& batch) {
+    const double inv_sqrt_2pi = 0.39894228040143267794;
+    auto cdf = [](double x) { return 0.5 * std::erfc(-x / std::sqrt(2.0)); };
+    
+    for (size_t i = 0; i < batch.size(); ++i) {
+        double s = batch.spot[i];
+        double k = batch.strike[i];
+        double t = std::max(batch.time_to_expiry[i], kMinTime);
+        double vol = batch.volatility[i];
+        double r = batch.rate[i];
+        double q = batch.carry[i];
+        double phi = batch.sign[i];
+        
+        double sqrt_t = std::sqrt(t);
+        double std_dev = std::max(vol * sqrt_t, kMinStdDev);
+        double d1 = (std::log(s / k) + (r - q + 0.5 * vol * vol) * t) / std_dev;
+        double d2 = d1 - std_dev;
+        
+        double carry_df = std::exp(-q * t);
+        double rate_df = std::exp(-r * t);
+        double n_d1 = cdf(phi * d1);
+        double n_d2 = cdf(phi * d2);
+        double pdf_d1 = inv_sqrt_2pi * std::exp(-0.5 * d1 * d1);
+        
+        batch.price[i] = phi * (s * carry_df * n_d1 - k * rate_df * n_d2);
+        batch.delta[i] = phi * carry_df * n_d1;
+        batch.gamma[i] = carry_df * pdf_d1 / (s * std_dev);
+        batch.vega[i] = s * carry_df * pdf_d1 * sqrt_t;
+        batch.theta[i] = -s * carry_df * pdf_d1 * vol / (2.0 * sqrt_t) +
+                         phi * (q * s * carry_df * n_d1 - r * k * rate_df * n_d2);
+    }
+}
+
+} // namespace arbitrage
@@ -0,0 +1,217 @@
+#include "perpetual_pricer.hpp"
+#include "engine_clock.hpp"
+#include "simd.hpp"
+#include <algorithm>
+
+namespace arbitrage {
+
+PerpetualFairValueEngine::PerpetualFairValueEngine(std::chrono::seconds funding_interval)
+    : funding_interval_s_(static_cast<double>(std::max<int64_t>(1, funding_interval.count()))),
+      origin_(getEngineTimestamp()) {
+}
+
+size_t PerpetualFairValueEngine::addPerpetual(const InstrumentId& perp_id, const InstrumentId& spot_id) {
+    auto it = perp_index_.find(perp_id);
+    if (it != perp_index_.end()) {
+        return it->second;
+    }
+    
+    size_t index = perp_ids_.size();
+    perp_ids_.push_back(perp_id);
+    spot_ids_.push_back(spot_id);
+    calculation_time_.emplace_back();
+    perp_index_[perp_id] = index;
+    spot_dependents_[spot_id].push_back(index);
+    resizeColumns();
+    return index;
+}
+
+size_t PerpetualFairValueEngine::addInstruments(const std::vector<Instrument>& instruments) {
+    size_t added = 0;
+    for (const auto& perp : instruments) {
+        if (perp.type != InstrumentType::PERPETUAL_SWAP) {
+            continue;
+        }
+        
+        const Instrument* best = nullptr;
+        for (const auto& spot : instruments) {
+            if (spot.type != InstrumentType::SPOT || spot.base_asset != perp.base_asset ||
+                spot.quote_asset != perp.quote_asset) {
+                continue;
+            }
+            if (!best || (spot.exchange == perp.exchange && best->exchange != perp.exchange)) {
+                best = &spot;
+            }
+        }
+        if (best) {
+            addPerpetual(perp.id, best->id);
+            ++added;
+        }
+    }
+    return added;
+}
+
+void PerpetualFairValueEngine::setBasisCallback(BasisCallback callback) {
+    basis_callback_ = std::move(callback);
+}
+
+void PerpetualFairValueEngine::updateSpotPrice(const InstrumentId& spot_id, Price mid) {
+    auto it = spot_dependents_.find(spot_id);
+    if (it == spot_dependents_.end()) {
+        return;
+    }
+    for (size_t index : it->second) {
+        spot_mid_[index] = mid;
+    }
+}
+
+void PerpetualFairValueEngine::updatePerpPrice(const InstrumentId& perp_id, Price mid) {
+    size_t index;
+    if (findPerpetual(perp_id, index)) {
+        perp_mid_[index] = mid;
+    }
+}
+
+void PerpetualFairValueEngine::updateFundingRate(const FundingRate& funding) {
+    size_t index;
+    if (findPerpetual(funding.instrument_id, index)) {
+        funding_rate_[index] = funding.current_rate;
+        next_funding_s_[index] = toSeconds(funding.next_funding_time);
+    }
+}
+
+void PerpetualFairValueEngine::computeAll(Timestamp now) {
+    using simd::VecD;
+    
+    const VecD now_s = VecD::broadcast(toSeconds(now));
+    const VecD inv_interval = VecD::broadcast(1.0 / funding_interval_s_);
+    const VecD zero = VecD::broadcast(0.0);
+    const VecD one = VecD::broadcast(1.0);
+    
+    // Columns are padded, so the loop covers the tail with inert lanes
+    const size_t padded = spot_mid_.size();
+    for (size_t i = 0; i < padded; i += simd::kLanes) {
+        VecD spot = VecD::load(&spot_mid_[i]);
+        VecD tau = (VecD::load(&next_funding_s_[i]) - now_s) * inv_interval;
+        tau = simd::min(simd::max(tau, zero), one);
+        
+        VecD fair = simd::fma(spot * VecD::load(&funding_rate_[i]), tau, spot);
+        fair.store(&fair_value_[i]);
+        (VecD::load(&perp_mid_[i]) - fair).store(&basis_spread_[i]);
+    }
+    std::fill(calculation_time_.begin(), calculation_time_.end(), now);
+    if (basis_callback_) {
+        for (size_t index = 0; index < perp_ids_.size(); ++index) {
+            basis_callback_(index);
+        }
+    }
+}
+
+void PerpetualFairValueEngine::compute(size_t index, Timestamp now) {
+    double tau = (next_funding_s_[index] - toSeconds(now)) / funding_interval_s_;
+    tau = std::min(std::max(tau, 0.0), 1.0);
+    
+    double spot = spot_mid_[index];
+    fair_value_[index] = std::fma(spot * funding_rate_[index], tau, spot);
+    basis_spread_[index] = perp_mid_[index] - fair_value_[index];
+    calculation_time_[index] = now;
+    if (basis_callback_) {
+        basis_callback_(index);
+    }
+}
+
+size_t PerpetualFairValueEngine::registerDependencies(DependencyGraph& graph) {
+    graph_nodes_.clear();
+    for (size_t index = 0; index < perp_ids_.size(); ++index) {
+        auto node = graph.addNode(perp_ids_[index], [this, index](Timestamp now) {
+            compute(index, now);
+            return true;
+        });
+        graph.addDependency(perp_ids_[index], node);
+        graph.addDependency(spot_ids_[index], node);
+        graph_nodes_.push_back(node);
+    }
+    return graph_nodes_.size();
+}
+
+bool PerpetualFairValueEngine::onMarketEvent(const MarketEvent& event, Timestamp now) {
+    switch (event.type) {
+        case MarketEventType::BOOK_UPDATE: {
+            if (event.book.bids.empty() || event.book.asks.empty()) {
+                return false;
+            }
+            Price mid = event.book.getMidPrice();
+            if (!graph_nodes_.empty()) {
+                // Repriced by the dependency graph at the end of the batch
+                updatePerpPrice(event.instrument_id, mid);
+                updateSpotPrice(event.instrument_id, mid);
+                return false;
+            }
+            
+            size_t index;
+            if (findPerpetual(event.instrument_id, index)) {
+                perp_mid_[index] = mid;
+                compute(index, now);
+                return true;
+            }
+            auto it = spot_dependents_.find(event.instrument_id);
+            if (it == spot_dependents_.end()) {
+                return false;
+            }
+            for (size_t dependent : it->second) {
+                spot_mid_[dependent] = mid;
+                compute(dependent, now);
+            }
+            return true;
+        }
+        case MarketEventType::FUNDING_RATE:
+            updateFundingRate(event.funding);
+            computeAll(now);
+            return true;
+        case MarketEventType::FUNDING_TIME:
+            // Carry window rolled over
+            computeAll(now);
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool PerpetualFairValueEngine::getSyntheticPrice(const InstrumentId& perp_id, SyntheticPrice& out) const {
+    size_t index;
+    if (!findPerpetual(perp_id, index) || spot_mid_[index] <= 0.0 || perp_mid_[index] <= 0.0) {
+        return false;
+    }
+    
+    out.synthetic_instrument_id = perp_id;
+    out.calculated_price = fair_value_[index];
+    out.fair_value = fair_value_[index];
+    out.basis_spread = basis_spread_[index];
+    out.component_instruments.assign(1, spot_ids_[index]);
+    out.component_weights.assign(1, 1.0);
+    out.calculation_time = calculation_time_[index];
+    return true;
+}
+
+bool PerpetualFairValueEngine::findPerpetual(const InstrumentId& perp_id, size_t& index) const {
+    auto it = perp_index_.find(perp_id);
+    if (it == perp_index_.end()) {
+        return false;
+    }
+    index = it->second;
+    return true;
+}
+
+double PerpetualFairValueEngine::toSeconds(Timestamp time) const {
+    return std::chrono::duration<double>(time - origin_).count();
+}
+
+void PerpetualFairValueEngine::resizeColumns() {
+    size_t padded = simd::padLanes(perp_ids_.size());
+    for (auto* column : {&spot_mid_, &perp_mid_, &funding_rate_, &next_funding_s_,
+                         &fair_value_, &basis_spread_}) {
+        column->resize(padded, 0.0);
+    }
+}
+
+} // namespace arbitrage
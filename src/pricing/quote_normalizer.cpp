@@ -0,0 +1,276 @@
+#include "quote_normalizer.hpp"
+#include <cmath>
+#include <limits>
+
+namespace arbitrage {
+
+namespace {
+
+constexpr size_t kNone = std::numeric_limits<size_t>::max();
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+} // namespace
+
+QuoteNormalizer::QuoteNormalizer(const QuoteNormalizerConfig& config) : config_(config) {
+    addCurrency(config_.pivot);
+    for (const auto& [currency, rate] : config_.fixed_rates) {
+        size_t index = addCurrency(currency);
+        if (index != 0) {
+            fixed_rate_[index] = rate;
+        }
+    }
+    rebuildTree();
+}
+
+size_t QuoteNormalizer::addInstruments(const std::vector<Instrument>& instruments) {
+    for (const auto& instrument : instruments) {
+        addInstrument(instrument.id, instrument.quote_asset);
+    }
+    
+    // A spot pair between two quote currencies converts one into the other
+    size_t books = 0;
+    for (const auto& instrument : instruments) {
+        size_t base;
+        if (instrument.type == InstrumentType::SPOT && findCurrency(instrument.base_asset, base) &&
+            addConversionBook(instrument.id, instrument.base_asset, instrument.quote_asset)) {
+            ++books;
+        }
+    }
+    return books;
+}
+
+size_t QuoteNormalizer::addInstrument(const InstrumentId& instrument_id, const std::string& quote_asset) {
+    size_t index;
+    if (find(instrument_id, index)) {
+        return index;
+    }
+    
+    size_t currencies = currencies_.size();
+    size_t currency = addCurrency(quote_asset);
+    
+    index = instrument_ids_.size();
+    instrument_ids_.push_back(instrument_id);
+    instrument_index_[instrument_id] = index;
+    quote_currency_.push_back(currency);
+    raw_bid_.push_back(kNaN);
+    raw_ask_.push_back(kNaN);
+    bid_.push_back(kNaN);
+    ask_.push_back(kNaN);
+    quoted_[currency].push_back(index);
+    
+    if (currencies_.size() != currencies) {
+        rebuildTree();
+    }
+    return index;
+}
+
+bool QuoteNormalizer::addConversionBook(const InstrumentId& instrument_id, const std::string& base_currency,
+                                        const std::string& quote_currency) {
+    if (base_currency == quote_currency || book_index_.count(instrument_id) != 0) {
+        return false;
+    }
+    
+    ConversionBook book;
+    book.base = addCurrency(base_currency);
+    book.quote = addCurrency(quote_currency);
+    book.mid = kNaN;
+    book_index_[instrument_id] = books_.size();
+    books_.push_back(std::move(book));
+    rebuildTree();
+    return true;
+}
+
+bool QuoteNormalizer::onTopOfBook(const TopOfBook& top) {
+    if (top.bid_price <= 0.0 || top.ask_price <= 0.0) {
+        return false;
+    }
+    
+    bool changed = false;
+    auto book_it = book_index_.find(top.instrument_id);
+    if (book_it != book_index_.end()) {
+        changed = updateConversion(book_it->second, 0.5 * (top.bid_price + top.ask_price));
+    }
+    
+    size_t index;
+    if (find(top.instrument_id, index) && (raw_bid_[index] != top.bid_price || raw_ask_[index] != top.ask_price)) {
+        raw_bid_[index] = top.bid_price;
+        raw_ask_[index] = top.ask_price;
+        renormalize(index);
+        changed = true;
+    }
+    return changed;
+}
+
+double QuoteNormalizer::getRate(const std::string& from, const std::string& to) const {
+    size_t from_index, to_index;
+    if (!findCurrency(from, from_index) || !findCurrency(to, to_index)) {
+        return kNaN;
+    }
+    return getRate(from_index, to_index);
+}
+
+double QuoteNormalizer::convert(Price price, const std::string& from, const std::string& to) const {
+    return price * getRate(from, to);
+}
+
+bool QuoteNormalizer::find(const InstrumentId& instrument_id, size_t& index) const {
+    auto it = instrument_index_.find(instrument_id);
+    if (it == instrument_index_.end()) {
+        return false;
+    }
+    index = it->second;
+    return true;
+}
+
+double QuoteNormalizer::getRelativeSpread(size_t sell, size_t buy) const {
+    return (bid_[sell] - ask_[buy]) / ask_[buy];
+}
+
+bool QuoteNormalizer::findCurrency(const std::string& currency, size_t& index) const {
+    auto it = currency_index_.find(currency);
+    if (it == currency_index_.end()) {
+        return false;
+    }
+    index = it->second;
+    return true;
+}
+
+size_t QuoteNormalizer::addCurrency(const std::string& currency) {
+    size_t index;
+    if (findCurrency(currency, index)) {
+        return index;
+    }
+    
+    index = currencies_.size();
+    currencies_.push_back(currency);
+    currency_index_[currency] = index;
+    to_pivot_.push_back(index == 0 ? 1.0 : kNaN);
+    fixed_rate_.push_back(kNaN);
+    quoted_.emplace_back();
+    parent_book_.push_back(kNone);
+    parent_.push_back(kNone);
+    rates_.assign(currencies_.size() * currencies_.size(), kNaN);
+    return index;
+}
+
+void QuoteNormalizer::rebuildTree() {
+    size_t n = currencies_.size();
+    std::vector<uint8_t> reached(n, 0);
+    std::vector<size_t> order;
+    parent_book_.assign(n, kNone);
+    parent_.assign(n, kNone);
+    
+    // Breadth-first from the pivot over conversion books; currencies the books
+    // do not reach hang off their fixed rate, if any
+    reached[0] = 1;
+    order.push_back(0);
+    for (size_t head = 0;; ++head) {
+        if (head == order.size()) {
+            size_t seed = kNone;
+            for (size_t c = 0; c < n && seed == kNone; ++c) {
+                if (!reached[c] && !std::isnan(fixed_rate_[c])) {
+                    seed = c;
+                }
+            }
+            if (seed == kNone) {
+                break;
+            }
+            reached[seed] = 1;
+            order.push_back(seed);
+        }
+        
+        size_t current = order[head];
+        for (size_t b = 0; b < books_.size(); ++b) {
+            size_t other = books_[b].base == current ? books_[b].quote
+                         : books_[b].quote == current ? books_[b].base : kNone;
+            if (other != kNone && !reached[other]) {
+                reached[other] = 1;
+                parent_book_[other] = b;
+                parent_[other] = current;
+                order.push_back(other);
+            }
+        }
+    }
+    
+    // Each tree edge re-derives its child and every descendant, parents first
+    for (size_t b = 0; b < books_.size(); ++b) {
+        auto& subtree = books_[b].subtree;
+        subtree.clear();
+        for (size_t c : order) {
+            for (size_t walk = c; walk != kNone; walk = parent_[walk]) {
+                if (parent_book_[walk] == b) {
+                    subtree.push_back(c);
+                    break;
+                }
+            }
+        }
+    }
+    
+    for (size_t c = 0; c < n; ++c) {
+        to_pivot_[c] = kNaN;
+    }
+    for (size_t c : order) {
+        derive(c);
+    }
+    for (size_t c = 0; c < n; ++c) {
+        refreshMatrix(c);
+    }
+    for (size_t i = 0; i < instrument_ids_.size(); ++i) {
+        renormalize(i);
+    }
+}
+
+void QuoteNormalizer::derive(size_t currency) {
+    if (currency == 0) {
+        to_pivot_[0] = 1.0;
+        return;
+    }
+    
+    size_t b = parent_book_[currency];
+    if (b == kNone) {
+        to_pivot_[currency] = fixed_rate_[currency];
+        return;
+    }
+    
+    // 1 base = mid quote
+    const ConversionBook& book = books_[b];
+    double parent_rate = to_pivot_[parent_[currency]];
+    to_pivot_[currency] = book.base == currency ? book.mid * parent_rate : parent_rate / book.mid;
+}
+
+void QuoteNormalizer::refreshMatrix(size_t currency) {
+    size_t n = currencies_.size();
+    for (size_t j = 0; j < n; ++j) {
+        rates_[currency * n + j] = to_pivot_[currency] / to_pivot_[j];
+        rates_[j * n + currency] = to_pivot_[j] / to_pivot_[currency];
+    }
+}
+
+void QuoteNormalizer::renormalize(size_t instrument) {
+    double factor = to_pivot_[quote_currency_[instrument]];
+    bid_[instrument] = raw_bid_[instrument] * factor;
+    ask_[instrument] = raw_ask_[instrument] * factor;
+    ++renormalized_count_;
+}
+
+bool QuoteNormalizer::updateConversion(size_t book, double mid) {
+    ConversionBook& conversion = books_[book];
+    if (conversion.mid == mid) {
+        return false;
+    }
+    conversion.mid = mid;
+    
+    // Off-tree books are redundant paths and do not move the matrix
+    for (size_t currency : conversion.subtree) {
+        derive(currency);
+    }
+    for (size_t currency : conversion.subtree) {
+        refreshMatrix(currency);
+        for (size_t instrument : quoted_[currency]) {
+            renormalize(instrument);
+        }
+    }
+    return !conversion.subtree.empty();
+}
+
+} // namespace arbitrage
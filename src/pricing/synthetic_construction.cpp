@@ -0,0 +1,168 @@
+#include "synthetic_construction.hpp"
+#include <cmath>
+#include <limits>
+
+namespace arbitrage {
+
+bool SyntheticConstructionEngine::add(const SyntheticDefinition& definition) {
+    const size_t legs = definition.legs.size();
+    if (definition.id.empty() || legs == 0 || definition.weights.size() != legs ||
+        definition_index_.count(definition.id) != 0) {
+        return false;
+    }
+    
+    // Specialized shapes take their sign pattern from the weights
+    size_t expected_legs = constructionLegCount(definition.shape);
+    if (expected_legs != 0 && legs != expected_legs) {
+        return false;
+    }
+    unsigned negative_mask = 0;
+    for (size_t leg = 0; leg < legs && leg < 32; ++leg) {
+        if (definition.weights[leg] < 0.0) {
+            negative_mask |= 1u << leg;
+        }
+    }
+    
+    ConstructionKernel kernel = &kernels::genericLinear;
+    switch (definition.shape) {
+        case ConstructionShape::SPOT_PERP:
+            kernel = kernels::kSpotPerpKernels[negative_mask];
+            break;
+        case ConstructionShape::TRIANGULAR:
+            // Exponents only: every weight must be +1 or -1
+            for (double weight : definition.weights) {
+                if (std::fabs(weight) != 1.0) {
+                    return false;
+                }
+            }
+            kernel = kernels::kTriangularKernels[negative_mask];
+            break;
+        case ConstructionShape::BOX:
+            kernel = kernels::kBoxKernels[negative_mask];
+            break;
+        default:
+            break;
+    }
+    bool specialized = definition.shape != ConstructionShape::GENERIC;
+    
+    size_t index = definitions_.size();
+    definitions_.push_back(definition);
+    kernel_.push_back(kernel);
+    specialized_.push_back(specialized ? 1 : 0);
+    leg_offset_.push_back(static_cast<uint32_t>(leg_slots_.size()));
+    leg_count_.push_back(static_cast<uint32_t>(legs));
+    for (size_t leg = 0; leg < legs; ++leg) {
+        uint32_t slot = priceSlot(definition.legs[leg]);
+        leg_slots_.push_back(slot);
+        // Specialized kernels apply the sign themselves
+        leg_weights_.push_back(specialized ? std::fabs(definition.weights[leg]) : definition.weights[leg]);
+        slot_dependents_[slot].push_back(index);
+    }
+    definition_index_[definition.id] = index;
+    value_.push_back(std::numeric_limits<double>::quiet_NaN());
+    calculation_time_.emplace_back();
+    return true;
+}
+
+void SyntheticConstructionEngine::updatePrice(const InstrumentId& instrument_id, Price price) {
+    auto it = price_slots_.find(instrument_id);
+    if (it != price_slots_.end()) {
+        prices_[it->second] = price;
+    }
+}
+
+double SyntheticConstructionEngine::evaluate(size_t index, Timestamp now) {
+    uint32_t offset = leg_offset_[index];
+    value_[index] = kernel_[index](prices_.data(), &leg_slots_[offset], &leg_weights_[offset], leg_count_[index]);
+    calculation_time_[index] = now;
+    return value_[index];
+}
+
+void SyntheticConstructionEngine::evaluateAll(Timestamp now) {
+    for (size_t index = 0; index < definitions_.size(); ++index) {
+        evaluate(index, now);
+    }
+}
+
+size_t SyntheticConstructionEngine::registerDependencies(DependencyGraph& graph) {
+    graph_nodes_.clear();
+    for (size_t index = 0; index < definitions_.size(); ++index) {
+        auto node = graph.addNode(definitions_[index].id, [this, index](Timestamp now) {
+            double previous = value_[index];
+            double current = evaluate(index, now);
+            // An unpriced construction stays NaN; NaN != NaN must not count as a change
+            return !(current == previous) && !(std::isnan(current) && std::isnan(previous));
+        });
+        for (const auto& leg : definitions_[index].legs) {
+            graph.addDependency(leg, node);
+        }
+        graph_nodes_.push_back(node);
+    }
+    return graph_nodes_.size();
+}
+
+bool SyntheticConstructionEngine::onMarketEvent(const MarketEvent& event, Timestamp now) {
+    if (event.type != MarketEventType::BOOK_UPDATE || event.book.bids.empty() || event.book.asks.empty()) {
+        return false;
+    }
+    auto it = price_slots_.find(event.instrument_id);
+    if (it == price_slots_.end()) {
+        return false;
+    }
+    
+    prices_[it->second] = event.book.getMidPrice();
+    if (!graph_nodes_.empty()) {
+        return false;  // Evaluated by the dependency graph at the end of the batch
+    }
+    for (size_t index : slot_dependents_[it->second]) {
+        evaluate(index, now);
+    }
+    return true;
+}
+
+bool SyntheticConstructionEngine::getSyntheticPrice(const std::string& synthetic_id, SyntheticPrice& out) const {
+    size_t index;
+    if (!find(synthetic_id, index) || !std::isfinite(value_[index])) {
+        return false;
+    }
+    
+    const auto& definition = definitions_[index];
+    out.synthetic_instrument_id = definition.id;
+    out.calculated_price = value_[index];
+    out.fair_value = value_[index];
+    out.component_instruments = definition.legs;
+    out.component_weights = definition.weights;
+    out.calculation_time = calculation_time_[index];
+    return true;
+}
+
+bool SyntheticConstructionEngine::find(const std::string& synthetic_id, size_t& index) const {
+    auto it = definition_index_.find(synthetic_id);
+    if (it == definition_index_.end()) {
+        return false;
+    }
+    index = it->second;
+    return true;
+}
+
+size_t SyntheticConstructionEngine::getSpecializedCount() const {
+    size_t count = 0;
+    for (uint8_t flag : specialized_) {
+        count += flag;
+    }
+    return count;
+}
+
+uint32_t SyntheticConstructionEngine::priceSlot(const InstrumentId& instrument_id) {
+    auto it = price_slots_.find(instrument_id);
+    if (it != price_slots_.end()) {
+        return it->second;
+    }
+    uint32_t slot = static_cast<uint32_t>(prices_.size());
+    prices_.push_back(std::numeric_limits<double>::quiet_NaN());
+    slot_dependents_.emplace_back();
+    price_slots_.emplace(instrument_id, slot);
+    return slot;
+}
+
+} // namespace arbitrage
@@ -0,0 +1,316 @@
+#include "vol_surface.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace arbitrage {
+
+namespace {
+
+constexpr size_t kParams = 5;
+constexpr size_t kMinQuotes = kParams;
+constexpr double kMaxRho = 0.999;
+constexpr double kMinSigma = 1e-4;
+
+using ParamVector = std::array<double, kParams>;
+
+ParamVector toVector(const SviParams& p) {
+    return {p.a, p.b, p.rho, p.m, p.sigma};
+}
+
+// Keep parameters inside the region where w(k) is a valid (non-negative) smile
+SviParams project(const ParamVector& v) {
+    SviParams p;
+    p.b = std::max(v[1], 0.0);
+    p.rho = std::clamp(v[2], -kMaxRho, kMaxRho);
+    p.m = v[3];
+    p.sigma = std::max(v[4], kMinSigma);
+    p.a = std::max(v[0], -p.b * p.sigma * std::sqrt(1.0 - p.rho * p.rho));
+    return p;
+}
+
+// Solve the 5x5 system a * x = rhs by Gaussian elimination with partial pivoting
+bool solveLinear(std::array<std::array<double, kParams>, kParams> a, ParamVector rhs, ParamVector& x) {
+    for (size_t col = 0; col < kParams; ++col) {
+        size_t pivot = col;
+        for (size_t row = col + 1; row < kParams; ++row) {
+            if (std::fabs(a[row][col]) > std::fabs(a[pivot][col])) {
+                pivot = row;
+            }
+        }
+        if (std::fabs(a[pivot][col]) < 1e-300) {
+            return false;
+        }
+        std::swap(a[col], a[pivot]);
+        std::swap(rhs[col], rhs[pivot]);
+        
+        for (size_t row = col + 1; row < kParams; ++row) {
+            double factor = a[row][col] / a[col][col];
+            for (size_t k = col; k < kParams; ++k) {
+                a[row][k] -= factor * a[col][k];
+            }
+            rhs[row] -= factor * rhs[col];
+        }
+    }
+    for (size_t col = kParams; col-- > 0;) {
+        double sum = rhs[col];
+        for (size_t k = col + 1; k < kParams; ++k) {
+            sum -= a[col][k] * x[k];
+        }
+        x[col] = sum / a[col][col];
+    }
+    return true;
+}
+
+} // namespace
+
+double SviParams::totalVariance(double k) const {
+    double d = k - m;
+    return a + b * (rho * d + std::sqrt(d * d + sigma * sigma));
+}
+
+VolatilitySurface::VolatilitySurface(const VolSurfaceConfig& config) : config_(config) {
+    config_.time_buckets = std::max<size_t>(config_.time_buckets, 1);
+    bucket_years_ = config_.max_years / config_.time_buckets;
+    rebuildTimeIndex();
+}
+
+size_t VolatilitySurface::addExpiry(double years, double forward) {
+    Slice slice;
+    slice.years = years;
+    slice.forward = forward;
+    slices_.push_back(std::move(slice));
+    rebuildTimeIndex();
+    return slices_.size() - 1;
+}
+
+void VolatilitySurface::setTimeToExpiry(size_t slice, double years) {
+    // The smile is stored per unit time (fitted_years), so rolling T needs no refit
+    slices_[slice].years = years;
+    rebuildTimeIndex();
+}
+
+void VolatilitySurface::setForward(size_t slice, double forward) {
+    Slice& s = slices_[slice];
+    s.forward = forward;
+    if (!(std::fabs(forward / s.fitted_forward - 1.0) <= config_.forward_tolerance)) {
+        s.dirty = true;
+    }
+}
+
+size_t VolatilitySurface::addQuote(size_t slice, double strike, double vol, double weight) {
+    Slice& s = slices_[slice];
+    s.strike.push_back(strike);
+    s.vol.push_back(vol);
+    s.weight.push_back(weight);
+    s.fitted_vol.push_back(std::numeric_limits<double>::quiet_NaN());
+    s.dirty = true;
+    return s.strike.size() - 1;
+}
+
+void VolatilitySurface::updateQuote(size_t slice, size_t quote, double vol) {
+    Slice& s = slices_[slice];
+    s.vol[quote] = vol;
+    
+    double fitted = s.fitted_vol[quote];
+    if (std::isnan(vol) && std::isnan(fitted)) {
+        return;
+    }
+    if (!(std::fabs(vol - fitted) <= config_.vol_tolerance)) {
+        s.dirty = true;
+    }
+}
+
+size_t VolatilitySurface::refit() {
+    size_t refitted = 0;
+    for (Slice& slice : slices_) {
+        if (!slice.dirty) {
+            ++stats_.clean_skips;
+            continue;
+        }
+        fitSlice(slice);
+        ++refitted;
+    }
+    return refitted;
+}
+
+void VolatilitySurface::fitSlice(Slice& slice) {
+    fit_k_.clear();
+    fit_w_.clear();
+    fit_weight_.clear();
+    for (size_t i = 0; i < slice.strike.size(); ++i) {
+        if (std::isfinite(slice.vol[i]) && slice.vol[i] > 0.0 && slice.weight[i] > 0.0) {
+            fit_k_.push_back(std::log(slice.strike[i] / slice.forward));
+            fit_w_.push_back(slice.vol[i] * slice.vol[i] * slice.years);
+            fit_weight_.push_back(slice.weight[i]);
+        }
+    }
+    
+    const size_t n = fit_k_.size();
+    auto cost = [&](const SviParams& p) {
+        double sum = 0.0;
+        for (size_t j = 0; j < n; ++j) {
+            double r = p.totalVariance(fit_k_[j]) - fit_w_[j];
+            sum += fit_weight_[j] * r * r;
+        }
+        return sum;
+    };
+    
+    SviParams params = slice.params;
+    if (n < kMinQuotes) {
+        // Too few quotes for a smile: flat at the mean variance
+        double mean = 0.0;
+        for (double w : fit_w_) {
+            mean += w / std::max<size_t>(n, 1);
+        }
+        params = SviParams();
+        params.a = mean;
+        params.b = 0.0;
+    } else {
+        if (!slice.fitted) {
+            // Cold start: flat at the lowest variance with a mild smile
+            params = SviParams();
+            params.a = *std::min_element(fit_w_.begin(), fit_w_.end()) * 0.5;
+            params.b = std::max(params.a, 1e-4);
+        }
+        
+        // Levenberg-Marquardt on the weighted total-variance residuals
+        double current = cost(params);
+        double lambda = 1e-3;
+        for (int iteration = 0; iteration < config_.max_fit_iterations; ++iteration) {
+            ++stats_.fit_iterations;
+            
+            std::array<std::array<double, kParams>, kParams> jtj{};
+            ParamVector jtr{};
+            for (size_t j = 0; j < n; ++j) {
+                double d = fit_k_[j] - params.m;
+                double root = std::sqrt(d * d + params.sigma * params.sigma);
+                ParamVector grad = {1.0, params.rho * d + root, params.b * d,
+                                    -params.b * (params.rho + d / root), params.b * params.sigma / root};
+                double r = params.totalVariance(fit_k_[j]) - fit_w_[j];
+                for (size_t p = 0; p < kParams; ++p) {
+                    jtr[p] += fit_weight_[j] * grad[p] * r;
+                    for (size_t q = 0; q < kParams; ++q) {
+                        jtj[p][q] += fit_weight_[j] * grad[p] * grad[q];
+                    }
+                }
+            }
+            
+            bool accepted = false;
+            double improvement = 0.0;
+            while (!accepted && lambda < 1e12) {
+                auto damped = jtj;
+                for (size_t p = 0; p < kParams; ++p) {
+                    damped[p][p] += lambda * jtj[p][p] + 1e-18;
+                }
+                ParamVector step{};
+                ParamVector rhs;
+                for (size_t p = 0; p < kParams; ++p) {
+                    rhs[p] = -jtr[p];
+                }
+                if (solveLinear(damped, rhs, step)) {
+                    ParamVector trial = toVector(params);
+                    for (size_t p = 0; p < kParams; ++p) {
+                        trial[p] += step[p];
+                    }
+                    SviParams candidate = project(trial);
+                    double candidate_cost = cost(candidate);
+                    if (candidate_cost < current) {
+                        improvement = current - candidate_cost;
+                        params = candidate;
+                        current = candidate_cost;
+                        lambda = std::max(lambda / 3.0, 1e-12);
+                        accepted = true;
+                        break;
+                    }
+                }
+                lambda *= 4.0;
+            }
+            if (!accepted || improvement <= 1e-12 * current + 1e-24) {
+                break;
+            }
+        }
+    }
+    
+    slice.params = params;
+    slice.fitted = true;
+    slice.dirty = false;
+    slice.fitted_years = slice.years;
+    slice.fitted_forward = slice.forward;
+    slice.fitted_vol = slice.vol;
+    ++stats_.refits;
+    
+    double squared = 0.0;
+    for (size_t j = 0; j < n; ++j) {
+        double model = std::sqrt(std::max(params.totalVariance(fit_k_[j]), 0.0) / slice.years);
+        double quoted = std::sqrt(fit_w_[j] / slice.years);
+        squared += (model - quoted) * (model - quoted);
+    }
+    stats_.last_rmse = n > 0 ? std::sqrt(squared / n) : 0.0;
+}
+
+double VolatilitySurface::getSliceVolatility(size_t slice, double strike) const {
+    const Slice& s = slices_[slice];
+    if (!s.fitted || s.fitted_years <= 0.0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    double w = s.params.totalVariance(std::log(strike / s.forward));
+    return std::sqrt(std::max(w, 0.0) / s.fitted_years);
+}
+
+double VolatilitySurface::sliceTotalVariance(size_t slice, double strike) const {
+    double vol = getSliceVolatility(slice, strike);
+    return vol * vol * slices_[slice].years;
+}
+
+double VolatilitySurface::getVolatility(double strike, double years) const {
+    if (order_.empty()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    
+    // Bucket gives the slices expiring before the bucket start; at most a few
+    // more lie between the bucket start and the requested time
+    size_t bucket = years > 0.0 ? std::min(static_cast<size_t>(years / bucket_years_), time_index_.size() - 1) : 0;
+    size_t position = time_index_[bucket];
+    while (position < order_.size() && slices_[order_[position]].years <= years) {
+        ++position;
+    }
+    
+    if (position == 0) {
+        return getSliceVolatility(order_.front(), strike);
+    }
+    if (position == order_.size()) {
+        return getSliceVolatility(order_.back(), strike);
+    }
+    
+    size_t lower = order_[position - 1];
+    size_t upper = order_[position];
+    double t_lower = slices_[lower].years;
+    double t_upper = slices_[upper].years;
+    double w_lower = sliceTotalVariance(lower, strike);
+    double w_upper = sliceTotalVariance(upper, strike);
+    double w = w_lower + (w_upper - w_lower) * (years - t_lower) / (t_upper - t_lower);
+    return std::sqrt(std::max(w, 0.0) / years);
+}
+
+void VolatilitySurface::rebuildTimeIndex() {
+    order_.resize(slices_.size());
+    for (size_t i = 0; i < order_.size(); ++i) {
+        order_[i] = i;
+    }
+    std::stable_sort(order_.begin(), order_.end(),
+                     [this](size_t a, size_t b) { return slices_[a].years < slices_[b].years; });
+    
+    time_index_.assign(config_.time_buckets, 0);
+    size_t position = 0;
+    for (size_t bucket = 0; bucket < time_index_.size(); ++bucket) {
+        double bucket_start = bucket * bucket_years_;
+        while (position < order_.size() && slices_[order_[position]].years <= bucket_start) {
+            ++position;
+        }
+        time_index_[bucket] = static_cast<uint32_t>(position);
+    }
+}
+
+} // namespace arbitrage
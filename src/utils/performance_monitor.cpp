@@ -36,6 +36,12 @@ void PerformanceMonitor::start() {
     }
     
     monitoring_enabled_ = true;
+    
+    // Collect on a timerfd; stop() wakes the loop immediately
+    event_loop_ = std::make_unique<EventLoop>();
+    event_loop_->addTimer(std::chrono::milliseconds(monitoring_interval_ms_),
+                          std::chrono::milliseconds(monitoring_interval_ms_),
+                          [this]() { collectMetrics(); });
     monitoring_thread_ = std::make_unique<std::thread>(&PerformanceMonitor::monitoringLoop, this);
     
     LOG_INFO("Performance monitor started");
@@ -47,10 +53,14 @@ void PerformanceMonitor::stop() {
     }
     
     monitoring_enabled_ = false;
+    if (event_loop_) {
+        event_loop_->stop();
+    }
     
     if (monitoring_thread_ && monitoring_thread_->joinable()) {
         monitoring_thread_->join();
     }
+    event_loop_.reset();
     
     LOG_INFO("Performance monitor stopped");
 }
@@ -67,6 +77,16 @@ void PerformanceMonitor::recordTradeExecuted() {
     metrics_.trades_executed.fetch_add(1, std::memory_order_relaxed);
 }
 
+void PerformanceMonitor::recordConflatedUpdates(uint64_t count) {
+    metrics_.conflated_updates.fetch_add(count, std::memory_order_relaxed);
+}
+
+void PerformanceMonitor::recordStaleRejection(Exchange exchange, DetectionStage stage) {
+    metrics_.stale_rejections.fetch_add(1, std::memory_order_relaxed);
+    stale_rejections_[static_cast<size_t>(exchange)][static_cast<size_t>(stage)].fetch_add(
+        1, std::memory_order_relaxed);
+}
+
 void PerformanceMonitor::recordLatency(double latency_ms) {
     // Update max latency
     double current_max = metrics_.max_latency_ms.load(std::memory_order_relaxed);
@@ -100,6 +120,8 @@ PerformanceMetrics PerformanceMonitor::getMetrics() const {
     current_metrics.messages_processed = metrics_.messages_processed.load();
     current_metrics.opportunities_detected = metrics_.opportunities_detected.load();
     current_metrics.trades_executed = metrics_.trades_executed.load();
+    current_metrics.conflated_updates = metrics_.conflated_updates.load();
+    current_metrics.stale_rejections = metrics_.stale_rejections.load();
     current_metrics.average_latency_ms = metrics_.average_latency_ms.load();
     current_metrics.max_latency_ms = metrics_.max_latency_ms.load();
     current_metrics.memory_usage_mb = metrics_.memory_usage_mb.load();
@@ -114,6 +136,11 @@ void PerformanceMonitor::resetMetrics() {
     metrics_.reset();
     latency_count_ = 0;
     latency_sum_ = 0.0;
+    for (auto& by_stage : stale_rejections_) {
+        for (auto& count : by_stage) {
+            count = 0;
+        }
+    }
     LOG_INFO("Performance metrics reset");
 }
 
@@ -129,6 +156,19 @@ uint64_t PerformanceMonitor::getTradesExecuted() const {
     return metrics_.trades_executed.load(std::memory_order_relaxed);
 }
 
+uint64_t PerformanceMonitor::getConflatedUpdates() const {
+    return metrics_.conflated_updates.load(std::memory_order_relaxed);
+}
+
+uint64_t PerformanceMonitor::getStaleRejections() const {
+    return metrics_.stale_rejections.load(std::memory_order_relaxed);
+}
+
+uint64_t PerformanceMonitor::getStaleRejections(Exchange exchange, DetectionStage stage) const {
+    return stale_rejections_[static_cast<size_t>(exchange)][static_cast<size_t>(stage)].load(
+        std::memory_order_relaxed);
+}
+
 double PerformanceMonitor::getAverageLatency() const {
     return metrics_.average_latency_ms.load(std::memory_order_relaxed);
 }
@@ -173,34 +213,39 @@ void PerformanceMonitor::setCpuAlertCallback(AlertCallback callback, double thre
 }
 
 void PerformanceMonitor::monitoringLoop() {
-    while (monitoring_enabled_) {
-        try {
-            // Update system metrics
-            recordMemoryUsage(getCurrentMemoryUsage());
-            recordCpuUsage(getCurrentCpuUsage());
-            
-            // Check alerts
-            checkAlerts();
-            
-            // Log performance metrics
-            auto metrics = getMetrics();
-            LOG_PERFORMANCE("Messages: {}, Opportunities: {}, Trades: {}, "
-                          "Avg Latency: {:.2f}ms, Max Latency: {:.2f}ms, "
-                          "Memory: {:.2f}MB, CPU: {:.2f}%",
-                          metrics.messages_processed,
-                          metrics.opportunities_detected,
-                          metrics.trades_executed,
-                          metrics.average_latency_ms,
-                          metrics.max_latency_ms,
-                          metrics.memory_usage_mb,
-                          metrics.cpu_usage_percentage);
-            
-            // Sleep for the monitoring interval
-            std::this_thread::sleep_for(std::chrono::milliseconds(monitoring_interval_ms_));
-            
-        } catch (const std::exception& e) {
-            LOG_ERROR("Error in performance monitoring loop: {}", e.what());
-        }
+    event_loop_->run();
+}
+
+void PerformanceMonitor::collectMetrics() {
+    if (!monitoring_enabled_) {
+        return;
+    }
+    
+    try {
+        // Update system metrics
+        recordMemoryUsage(getCurrentMemoryUsage());
+        recordCpuUsage(getCurrentCpuUsage());
+        
+        // Check alerts
+        checkAlerts();
+        
+        // Log performance metrics
+        auto metrics = getMetrics();
+        LOG_PERFORMANCE("Messages: {}, Opportunities: {}, Trades: {}, Conflated: {}, Stale: {}, "
+                      "Avg Latency: {:.2f}ms, Max Latency: {:.2f}ms, "
+                      "Memory: {:.2f}MB, CPU: {:.2f}%",
+                      metrics.messages_processed,
+                      metrics.opportunities_detected,
+                      metrics.trades_executed,
+                      metrics.conflated_updates,
+                      metrics.stale_rejections,
+                      metrics.average_latency_ms,
+                      metrics.max_latency_ms,
+                      metrics.memory_usage_mb,
+                      metrics.cpu_usage_percentage);
+        
+    } catch (const std::exception& e) {
+        LOG_ERROR("Error in performance monitoring loop: {}", e.what());
     }
 }
 
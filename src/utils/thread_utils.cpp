@@ -0,0 +1,30 @@
+#include "thread_utils.hpp"
+#include "logger.hpp"
+#include <pthread.h>
+#include <sched.h>
+
+namespace arbitrage {
+
+bool pinThreadToCore(std::thread& thread, int cpu_core) {
+    if (cpu_core < 0) {
+        return false;
+    }
+    
+    unsigned int cores = std::thread::hardware_concurrency();
+    if (cores == 0) {
+        cores = 1;
+    }
+    
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(static_cast<unsigned int>(cpu_core) % cores, &cpuset);
+    
+    int rc = pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpuset);
+    if (rc != 0) {
+        LOG_WARN("Failed to pin thread to core {} (error {})", cpu_core, rc);
+        return false;
+    }
+    return true;
+}
+
+} // namespace arbitrage
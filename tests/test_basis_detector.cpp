@@ -0,0 +1,280 @@
+#include <gtest/gtest.h>
+#include "basis_detector.hpp"
+#include "perpetual_pricer.hpp"
+#include "futures_pricer.hpp"
+#include "strategy_shard.hpp"
+#include "opportunity_merger.hpp"
+#include "engine_clock.hpp"
+#include "test_helpers.hpp"
+#include <cmath>
+
+namespace arbitrage {
+
+namespace {
+
+const Timestamp kStart = Timestamp(std::chrono::seconds(1700000000));
+
+// Small deterministic wobble around a 5bp basis
+double quietBasis(size_t t) {
+    return 0.0005 + 0.0001 * std::sin(t * 0.9);
+}
+
+BasisDetectorConfig testConfig() {
+    BasisDetectorConfig config;
+    config.min_basis = 0.001;
+    config.time_constant = std::chrono::seconds(30);
+    config.min_samples = 20;
+    return config;
+}
+
+// Feed one observation per second at fair value 100
+size_t feedQuiet(BasisSpreadDetector& detector, size_t index, size_t count, Timestamp& now,
+                 std::vector<ArbitrageOpportunity>& out) {
+    size_t reports = 0;
+    for (size_t t = 0; t < count; ++t) {
+        reports += detector.update(index, 100.0 * (1.0 + quietBasis(t)), 100.0, 99.9, now, out);
+        now += std::chrono::seconds(1);
+    }
+    return reports;
+}
+
+} // namespace
+
+TEST(BasisDetectorTest, RollingStatsAndOneReportPerExcursion) {
+    BasisSpreadDetector detector(testConfig());
+    size_t index = detector.addContract("BTC-PERPETUAL_PERPETUAL_SWAP", Exchange::OKX, "BTC/USDT_SPOT", Exchange::OKX);
+    EXPECT_EQ(detector.addContract("BTC-PERPETUAL_PERPETUAL_SWAP", Exchange::OKX, "BTC/USDT_SPOT", Exchange::OKX),
+              index);
+    
+    Timestamp now = kStart;
+    std::vector<ArbitrageOpportunity> out;
+    EXPECT_EQ(feedQuiet(detector, index, 60, now, out), 0u);
+    
+    // Time-weighted EWMA reference: alpha = dt / (dt + 30s) with dt = 1s
+    const double alpha = 1.0 / 31.0;
+    double mean = quietBasis(0), variance = 0.0;
+    for (size_t t = 1; t < 60; ++t) {
+        double deviation = quietBasis(t) - mean;
+        mean += alpha * deviation;
+        variance = (1.0 - alpha) * (variance + alpha * deviation * deviation);
+    }
+    EXPECT_NEAR(detector.getMean(index), mean, 1e-15);
+    EXPECT_NEAR(detector.getStdDev(index), std::sqrt(variance), 1e-12);
+    EXPECT_NEAR(detector.getBasis(index), quietBasis(59), 1e-12);
+    
+    // The perp trades 30bp rich: sell it, buy spot
+    ASSERT_TRUE(detector.update(index, 100.3, 100.0, 99.9, now, out));
+    ASSERT_EQ(out.size(), 1u);
+    const ArbitrageOpportunity& report = out[0];
+    EXPECT_EQ(report.type, ArbitrageType::BASIS_SPREAD_ARBITRAGE);
+    EXPECT_EQ(report.opportunity_id, "BASIS:S:BTC-PERPETUAL_PERPETUAL_SWAP");
+    EXPECT_EQ(report.leg_sides, (std::vector<OrderSide>{OrderSide::SELL, OrderSide::BUY}));
+    EXPECT_EQ(report.leg_instruments[1], "BTC/USDT_SPOT");
+    EXPECT_EQ(report.leg_exchanges[0], Exchange::OKX);
+    EXPECT_NEAR(report.expected_profit, 0.3, 1e-9);
+    EXPECT_NEAR(report.expected_profit_percentage, 0.003, 1e-12);
+    EXPECT_EQ(report.expiry_time, now + std::chrono::milliseconds(500));
+    EXPECT_GT(detector.getZScore(index), 3.0);
+    EXPECT_TRUE(detector.isAnomalous(index));
+    
+    // Still rich a second later: the same excursion, no new report
+    now += std::chrono::seconds(1);
+    EXPECT_FALSE(detector.update(index, 100.3, 100.0, 99.9, now, out));
+    EXPECT_TRUE(detector.isAnomalous(index));
+    
+    // Back to normal ends it; the next excursion, cheap this time, reports again
+    now += std::chrono::seconds(1);
+    EXPECT_FALSE(detector.update(index, 100.0 * (1.0 + quietBasis(0)), 100.0, 99.9, now, out));
+    EXPECT_FALSE(detector.isAnomalous(index));
+    now += std::chrono::seconds(1);
+    ASSERT_TRUE(detector.update(index, 99.7, 100.0, 99.9, now, out));
+    ASSERT_EQ(out.size(), 2u);
+    EXPECT_EQ(out[1].opportunity_id, "BASIS:B:BTC-PERPETUAL_PERPETUAL_SWAP");
+    EXPECT_EQ(out[1].leg_sides[0], OrderSide::BUY);
+    EXPECT_EQ(detector.getAnomalyCount(), 2u);
+}
+
+TEST(BasisDetectorTest, ThresholdsWarmupAndTimeWeighting) {
+    BasisSpreadDetector detector(testConfig());
+    size_t index = detector.addContract("ETH-3M", Exchange::BINANCE, "ETH/USDT_SPOT", Exchange::BINANCE);
+    Timestamp now = kStart;
+    std::vector<ArbitrageOpportunity> out;
+    
+    // Not warmed up yet: even a wild basis is only recorded
+    EXPECT_FALSE(detector.update(index, 101.0, 100.0, 99.9, now, out));
+    EXPECT_TRUE(std::isnan(detector.getZScore(index)));
+    
+    // Missing inputs are ignored
+    EXPECT_FALSE(detector.update(index, 0.0, 100.0, 99.9, now, out));
+    EXPECT_FALSE(detector.update(index, 100.0, 100.0, 0.0, now, out));
+    EXPECT_EQ(detector.getUpdateCount(), 1u);
+    
+    // A burst of ticks at one timestamp carries no extra weight
+    BasisSpreadDetector burst(testConfig());
+    burst.addContract("ETH-3M", Exchange::BINANCE, "ETH/USDT_SPOT", Exchange::BINANCE);
+    Timestamp b = kStart;
+    for (size_t t = 0; t < 40; ++t) {
+        for (int repeat = 0; repeat < 5; ++repeat) {
+            burst.update(0, 100.0 * (1.0 + quietBasis(t)), 100.0, 99.9, b, out);
+        }
+        b += std::chrono::seconds(1);
+    }
+    BasisSpreadDetector single(testConfig());
+    single.addContract("ETH-3M", Exchange::BINANCE, "ETH/USDT_SPOT", Exchange::BINANCE);
+    Timestamp c = kStart;
+    feedQuiet(single, 0, 40, c, out);
+    EXPECT_DOUBLE_EQ(burst.getMean(0), single.getMean(0));
+    EXPECT_DOUBLE_EQ(burst.getStdDev(0), single.getStdDev(0));
+    
+    // A large z on a basis under min_basis is not an opportunity
+    double tiny = single.getMean(0) + 6.0 * single.getStdDev(0);
+    ASSERT_LT(tiny, 0.001);
+    EXPECT_FALSE(single.update(0, 100.0 * (1.0 + tiny), 100.0, 99.9, c, out));
+    EXPECT_GT(single.getZScore(0), 3.0);
+    EXPECT_TRUE(out.empty());
+}
+
+TEST(BasisDetectorTest, HysteresisLanesAndLateTicks) {
+    BasisDetectorConfig config = testConfig();
+    config.min_basis = 0.0001;
+    BasisSpreadDetector detector(config);
+    size_t btc = detector.addContract("BTC-PERPETUAL_PERPETUAL_SWAP", Exchange::OKX, "BTC/USDT_SPOT", Exchange::OKX);
+    size_t eth = detector.addContract("ETH-PERPETUAL_PERPETUAL_SWAP", Exchange::OKX, "ETH/USDT_SPOT", Exchange::OKX);
+    size_t found;
+    ASSERT_TRUE(detector.find("ETH-PERPETUAL_PERPETUAL_SWAP", found));
+    EXPECT_EQ(found, eth);
+    
+    Timestamp now = kStart, eth_now = kStart;
+    std::vector<ArbitrageOpportunity> out;
+    feedQuiet(detector, btc, 60, now, out);
+    feedQuiet(detector, eth, 60, eth_now, out);
+    
+    // Basis at the given z-score against the statistics before the tick
+    auto at = [&detector, btc](double z) {
+        return 100.0 * (1.0 + detector.getMean(btc) + z * detector.getStdDev(btc));
+    };
+    
+    ASSERT_TRUE(detector.update(btc, at(10.0), 100.0, 99.9, now, out));
+    EXPECT_FALSE(detector.isAnomalous(eth));
+    
+    // Between z_exit and z_threshold the excursion holds without a new report
+    now += std::chrono::seconds(1);
+    EXPECT_FALSE(detector.update(btc, at(2.0), 100.0, 99.9, now, out));
+    EXPECT_TRUE(detector.isAnomalous(btc));
+    now += std::chrono::seconds(1);
+    EXPECT_FALSE(detector.update(btc, at(0.5), 100.0, 99.9, now, out));
+    EXPECT_FALSE(detector.isAnomalous(btc));
+    EXPECT_EQ(out.size(), 1u);
+    
+    // A tick stamped before the last one is scored but does not move the statistics
+    double mean = detector.getMean(btc), deviation = detector.getStdDev(btc);
+    EXPECT_FALSE(detector.update(btc, at(0.5), 100.0, 99.9, now - std::chrono::seconds(5), out));
+    EXPECT_DOUBLE_EQ(detector.getMean(btc), mean);
+    EXPECT_DOUBLE_EQ(detector.getStdDev(btc), deviation);
+    
+    // The other lane never saw any of it
+    EXPECT_NEAR(detector.getBasis(eth), quietBasis(59), 1e-12);
+    EXPECT_EQ(detector.getAnomalyCount(), 1u);
+}
+
+TEST(BasisDetectorTest, PricersReportEveryBasisChange) {
+    std::vector<size_t> perp_updates;
+    PerpetualFairValueEngine perp_pricer;
+    perp_pricer.addPerpetual("PERP0", "SPOT0");
+    perp_pricer.addPerpetual("PERP1", "SPOT1");
+    perp_pricer.setBasisCallback([&perp_updates](size_t index) { perp_updates.push_back(index); });
+    EXPECT_EQ(perp_pricer.getSpotId(1), "SPOT1");
+    
+    perp_pricer.updateSpotPrice("SPOT1", 100.0);
+    perp_pricer.updatePerpPrice("PERP1", 100.2);
+    perp_pricer.compute(1, kStart);
+    EXPECT_EQ(perp_updates, std::vector<size_t>{1});
+    EXPECT_DOUBLE_EQ(perp_pricer.getPerpPrice(1), 100.2);
+    EXPECT_DOUBLE_EQ(perp_pricer.getSpotPrice(1), 100.0);
+    perp_pricer.computeAll(kStart);  // Funding pass: every perp
+    EXPECT_EQ(perp_updates, (std::vector<size_t>{1, 0, 1}));
+    
+    // Futures: a reprice and a futures tick (which moves only the basis)
+    std::vector<size_t> future_updates;
+    FuturesCarryPricer futures_pricer;
+    futures_pricer.addFuture("BTC-3M", "BTC-SPOT", "USDT", kStart + std::chrono::hours(24 * 91), kStart);
+    futures_pricer.setRate("USDT", 0.05);
+    futures_pricer.setBasisCallback([&future_updates](size_t index) { future_updates.push_back(index); });
+    futures_pricer.updateSpotPrice("BTC-SPOT", 40000.0);
+    EXPECT_EQ(futures_pricer.reprice(kStart), 1u);
+    futures_pricer.updateFuturePrice("BTC-3M", 40600.0);
+    EXPECT_EQ(future_updates, (std::vector<size_t>{0, 0}));
+    EXPECT_EQ(futures_pricer.getFutureId(0), "BTC-3M");
+    EXPECT_DOUBLE_EQ(futures_pricer.getFuturePrice(0), 40600.0);
+    
+    // Wired the way the shards do it, a rich future is reported from its tick
+    BasisSpreadDetector detector(testConfig());
+    detector.addContract("BTC-3M", Exchange::OKX, "BTC-SPOT", Exchange::OKX);
+    std::vector<ArbitrageOpportunity> out;
+    Timestamp now = kStart;
+    futures_pricer.setBasisCallback([&](size_t index) {
+        detector.update(index, futures_pricer.getFuturePrice(index), futures_pricer.getFairValue(index),
+                        futures_pricer.getSpotPrice(index), now, out);
+    });
+    for (size_t t = 0; t < 60; ++t) {
+        futures_pricer.updateFuturePrice("BTC-3M", futures_pricer.getFairValue(0) * (1.0 + quietBasis(t)));
+        now += std::chrono::seconds(1);
+    }
+    EXPECT_TRUE(out.empty());
+    futures_pricer.updateFuturePrice("BTC-3M", futures_pricer.getFairValue(0) * 1.004);
+    ASSERT_EQ(out.size(), 1u);
+    EXPECT_EQ(out[0].leg_instruments, (std::vector<InstrumentId>{"BTC-3M", "BTC-SPOT"}));
+    EXPECT_DOUBLE_EQ(out[0].leg_prices[1], 40000.0);
+}
+
+TEST(BasisDetectorTest, ShardSizesDatedFutureAgainstFairValue) {
+    EngineClock::getInstance().useSimulatedTime(kStart);
+    {
+        OpportunityMerger merger;
+        std::vector<ArbitrageOpportunity> published;
+        merger.setOpportunityCallback(
+            [&published](const ArbitrageOpportunity& opportunity) { published.push_back(opportunity); });
+        StrategyShard shard(0, &merger);
+        const Instrument spot = makeInstrument("BTC/USDT", "BTC", InstrumentType::SPOT);
+        const Instrument future = makeInstrument("BTC-20261225", "BTC", InstrumentType::FUTURES);
+        shard.addInstrument(spot);
+        shard.addInstrument(future);
+        ConfidenceConfig confidence;
+        confidence.liquidity_threshold = 50.0;
+        shard.getConfidenceScorer().setConfig(confidence);
+        shard.processEvent(makeBookEvent(spot.id, 99.99, 100.01, kStart, kStart));
+        shard.processEvent(makeBookEvent(future.id, 100.39, 100.41, kStart, kStart));
+        
+        // In contango at 5% carry fair value sits ~95bp over spot; the future
+        // at 40bp over is cheap to it: buy the future, sell spot
+        const double carry = 1.0095, fair_value = 100.0 * carry;
+        BasisSpreadDetector detector(testConfig());
+        size_t index = detector.addContract(future.id, Exchange::UNKNOWN, spot.id, Exchange::UNKNOWN);
+        Timestamp now = kStart;
+        std::vector<ArbitrageOpportunity> found;
+        for (size_t t = 0; t < 60; ++t) {
+            detector.update(index, fair_value * (1.0 + quietBasis(t)), fair_value, 100.0, now, found);
+            now += std::chrono::seconds(1);
+        }
+        ASSERT_TRUE(detector.update(index, 100.4, fair_value, 100.0, now, found));
+        ASSERT_EQ(found.size(), 1u);
+        EXPECT_EQ(found[0].leg_sides, (std::vector<OrderSide>{OrderSide::BUY, OrderSide::SELL}));
+        
+        // Against the raw spot bid the trade loses; against fair value it is the anomaly
+        EXPECT_FALSE(shard.emitSized(found[0]));
+        const double weights[2] = {1.0, fair_value / 100.0};
+        ASSERT_TRUE(shard.emitSized(found[0], weights));
+        shard.advanceTimers(kStart);
+        merger.processPending();
+        ASSERT_EQ(published.size(), 1u);
+        const double edge = 99.99 * carry - 100.41;
+        EXPECT_DOUBLE_EQ(published[0].leg_volumes[0], 1.0);
+        EXPECT_NEAR(published[0].expected_profit, edge, 1e-9);
+        EXPECT_NEAR(published[0].expected_profit_percentage, edge / 100.41, 1e-12);
+        EXPECT_DOUBLE_EQ(published[0].leg_prices[0], 100.41);
+        EXPECT_DOUBLE_EQ(published[0].leg_prices[1], 99.99);
+    }
+    EngineClock::getInstance().useRealTime();
+}
+
+} // namespace arbitrage
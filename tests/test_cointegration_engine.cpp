@@ -0,0 +1,244 @@
+#include <gtest/gtest.h>
+#include "cointegration_engine.hpp"
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <thread>
+
+namespace arbitrage {
+
+namespace {
+
+const Timestamp kStart{std::chrono::seconds(1000)};
+
+TopOfBook makeLogTop(const InstrumentId& instrument_id, double log_mid) {
+    TopOfBook top;
+    top.instrument_id = instrument_id;
+    top.bid_price = top.ask_price = std::exp(log_mid);
+    top.bid_volume = top.ask_volume = 1.0;
+    return top;
+}
+
+// Scalar reference of one pair's EWMA moments
+struct ReferencePair {
+    double n = 0.0, mean_x = 0.0, mean_y = 0.0, var_x = 0.0, var_y = 0.0, cov = 0.0;
+    
+    void update(double y, double x, double alpha) {
+        if (n == 0.0) {
+            mean_x = x;
+            mean_y = y;
+        }
+        double dx = x - mean_x, dy = y - mean_y;
+        var_x = (1.0 - alpha) * (var_x + alpha * dx * dx);
+        var_y = (1.0 - alpha) * (var_y + alpha * dy * dy);
+        cov = (1.0 - alpha) * (cov + alpha * dx * dy);
+        mean_x += alpha * dx;
+        mean_y += alpha * dy;
+        n += 1.0;
+    }
+    double beta() const { return cov / var_x; }
+    double spreadMean() const { return mean_y - beta() * mean_x; }
+    double spreadStdDev() const { return std::sqrt(var_y - beta() * cov); }
+};
+
+// y cointegrated with x (stationary AR(1) residual), w an independent walk
+struct Series {
+    std::vector<double> x, y, w;
+};
+
+Series makeSeries(size_t length) {
+    std::mt19937 rng(42);
+    std::normal_distribution<double> step(0.0, 0.01);
+    std::normal_distribution<double> noise(0.0, 0.002);
+    Series series;
+    double x = std::log(100.0), w = std::log(50.0), residual = 0.0;
+    for (size_t t = 0; t < length; ++t) {
+        x += step(rng);
+        w += step(rng);
+        residual = 0.5 * residual + noise(rng);
+        series.x.push_back(x);
+        series.y.push_back(0.5 + 1.5 * x + residual);
+        series.w.push_back(w);
+    }
+    return series;
+}
+
+// Feed the series one grid point apart and wait for the first background test
+void feedAndTest(CointegrationEngine& engine, const Series& series, Timestamp& now) {
+    const auto interval = std::chrono::milliseconds(1);
+    for (size_t t = 0; t < series.x.size(); ++t) {
+        engine.onTopOfBook(makeLogTop("X/USD_SPOT", series.x[t]));
+        engine.onTopOfBook(makeLogTop("Y/USD_SPOT", series.y[t]));
+        engine.onTopOfBook(makeLogTop("W/USD_SPOT", series.w[t]));
+        engine.sample(now);
+        now += interval;
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (engine.getTestsCompleted() == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    // The next grid step applies the results
+    engine.sample(now);
+    now += interval;
+}
+
+CointegrationConfig testConfig() {
+    CointegrationConfig config;
+    config.sample_interval = std::chrono::milliseconds(1);
+    config.min_samples = 250;
+    config.test_interval = std::chrono::hours(1);
+    return config;
+}
+
+} // namespace
+
+TEST(CointegrationEngineTest, GridPassMatchesScalarMomentsAcrossPairs) {
+    CointegrationConfig config;
+    config.sample_interval = std::chrono::milliseconds(1);
+    config.min_samples = 20;
+    CointegrationEngine engine(config);
+    
+    // More pairs than one vector, all hedged against the same x
+    const size_t pairs = 11;
+    for (size_t k = 0; k < pairs; ++k) {
+        ASSERT_TRUE(engine.addPair("Y" + std::to_string(k) + "/USD_SPOT", "X/USD_SPOT"));
+    }
+    EXPECT_FALSE(engine.addPair("X/USD_SPOT", "Y0/USD_SPOT"));
+    EXPECT_FALSE(engine.onTopOfBook(makeLogTop("Z/USD_SPOT", 1.0)));
+    
+    std::vector<ReferencePair> reference(pairs);
+    auto yAt = [](size_t k, size_t t, double x) {
+        return 0.2 * k + (1.0 + 0.1 * k) * x + 0.003 * std::cos(t * (0.7 + 0.05 * k));
+    };
+    Timestamp now = kStart;
+    double x = 0.0;
+    for (size_t t = 0; t < 60; ++t) {
+        x = std::log(100.0) + 0.01 * std::sin(t * 0.3) + 0.001 * t;
+        engine.onTopOfBook(makeLogTop("X/USD_SPOT", x));
+        for (size_t k = 0; k < pairs; ++k) {
+            double y = yAt(k, t, x);
+            engine.onTopOfBook(makeLogTop("Y" + std::to_string(k) + "/USD_SPOT", y));
+            reference[k].update(y, x, config.ewma_alpha);
+        }
+        ASSERT_TRUE(engine.sample(now));
+        EXPECT_FALSE(engine.sample(now));  // Same grid point
+        if (t == 10) {
+            EXPECT_TRUE(std::isnan(engine.getHedgeRatio(3)));  // Still warming up
+        }
+        now += config.sample_interval;
+    }
+    EXPECT_EQ(engine.getSampleCount(), 60u);
+    
+    for (size_t k = 0; k < pairs; ++k) {
+        const double y = yAt(k, 59, x);
+        const auto& expected = reference[k];
+        EXPECT_NEAR(engine.getHedgeRatio(k), expected.beta(), 1e-9 * std::fabs(expected.beta()));
+        EXPECT_NEAR(engine.getSpreadMean(k), expected.spreadMean(), 1e-9);
+        EXPECT_NEAR(engine.getSpreadStdDev(k), expected.spreadStdDev(), 1e-9);
+        double z = (y - expected.beta() * x - expected.spreadMean()) / expected.spreadStdDev();
+        EXPECT_NEAR(engine.getZScore(k), z, 1e-6 * std::max(1.0, std::fabs(z)));
+    }
+    
+    // A tick refreshes the z-scores from the current moments, no grid step needed
+    size_t index;
+    ASSERT_TRUE(engine.find("Y3/USD_SPOT", "X/USD_SPOT", index));
+    EXPECT_EQ(index, 3u);
+    double beta = engine.getHedgeRatio(3);
+    engine.onTopOfBook(makeLogTop("X/USD_SPOT", x + 0.01));
+    double z = (yAt(3, 59, x) - beta * (x + 0.01) - engine.getSpreadMean(3)) / engine.getSpreadStdDev(3);
+    EXPECT_NEAR(engine.getZScore(3), z, 1e-9 * std::max(1.0, std::fabs(z)));
+    
+    // A one-sided book leaves its pair unpriced and its moments untouched
+    TopOfBook one_sided = makeLogTop("Y3/USD_SPOT", 1.0);
+    one_sided.bid_price = 0.0;
+    engine.onTopOfBook(one_sided);
+    EXPECT_TRUE(std::isnan(engine.getZScore(3)));
+    ASSERT_TRUE(engine.sample(now));
+    EXPECT_EQ(engine.getHedgeRatio(3), beta);
+    EXPECT_NE(engine.getHedgeRatio(4), reference[4].beta());
+}
+
+TEST(CointegrationEngineTest, BackgroundTestSeparatesCointegratedPairs) {
+    CointegrationEngine engine(testConfig());
+    ASSERT_TRUE(engine.addPair("Y/USD_SPOT", "X/USD_SPOT"));
+    ASSERT_TRUE(engine.addPair("W/USD_SPOT", "X/USD_SPOT"));
+    engine.start();
+    EXPECT_TRUE(engine.isRunning());
+    
+    Timestamp now = kStart;
+    feedAndTest(engine, makeSeries(300), now);
+    ASSERT_EQ(engine.getTestsCompleted(), 1u);
+    EXPECT_LT(engine.getTestStatistic(0), -6.0);
+    EXPECT_TRUE(engine.isCointegrated(0));
+    EXPECT_GT(engine.getTestStatistic(1), testConfig().adf_critical_value);
+    EXPECT_FALSE(engine.isCointegrated(1));
+    EXPECT_NEAR(engine.getHedgeRatio(0), 1.5, 0.1);
+    
+    // Not due again for an hour
+    engine.sample(now);
+    engine.stop();
+    EXPECT_FALSE(engine.isRunning());
+    EXPECT_EQ(engine.getTestsCompleted(), 1u);
+}
+
+TEST(CointegrationEngineTest, SignalsNeedCointegrationAndUseHysteresis) {
+    CointegrationEngine engine(testConfig());
+    ASSERT_TRUE(engine.addPair("Y/USD_SPOT", "X/USD_SPOT"));
+    ASSERT_TRUE(engine.addPair("W/USD_SPOT", "X/USD_SPOT"));
+    std::vector<std::pair<size_t, int>> signals;
+    engine.setSignalCallback([&signals](size_t pair, int signal, double) { signals.emplace_back(pair, signal); });
+    engine.start();
+    
+    Timestamp now = kStart;
+    const Series series = makeSeries(300);
+    feedAndTest(engine, series, now);
+    ASSERT_TRUE(engine.isCointegrated(0));
+    ASSERT_GE(std::fabs(engine.getCorrelation(0)), 0.8);
+    signals.clear();
+    const uint64_t changes = engine.getSignalChanges();
+    
+    // Move y to a chosen z against the last x
+    const double x = series.x.back();
+    auto moveTo = [&](double z) {
+        double y = engine.getHedgeRatio(0) * x + engine.getSpreadMean(0) + z * engine.getSpreadStdDev(0);
+        engine.onTopOfBook(makeLogTop("Y/USD_SPOT", y));
+    };
+    moveTo(3.0);
+    EXPECT_EQ(engine.getSignal(0), -1);   // Spread rich: short it
+    moveTo(1.0);
+    EXPECT_EQ(engine.getSignal(0), -1);   // Inside the band: hold
+    moveTo(0.2);
+    EXPECT_EQ(engine.getSignal(0), 0);
+    moveTo(-2.5);
+    EXPECT_EQ(engine.getSignal(0), 1);
+    EXPECT_EQ(signals, (std::vector<std::pair<size_t, int>>{{0, -1}, {0, 0}, {0, 1}}));
+    
+    // The independent walk never signals, however far it strays
+    engine.onTopOfBook(makeLogTop("W/USD_SPOT", series.w.back() + 1.0));
+    EXPECT_GT(std::fabs(engine.getZScore(1)), 3.0);
+    EXPECT_EQ(engine.getSignal(1), 0);
+    EXPECT_EQ(engine.getSignalChanges() - changes, 3u);
+}
+
+TEST(CointegrationEngineTest, SampleTimerFollowsTheGrid) {
+    CointegrationConfig config;
+    config.sample_interval = std::chrono::milliseconds(100);
+    CointegrationEngine engine(config);
+    ASSERT_TRUE(engine.addPair("ETH/USDT_SPOT", "BTC/USDT_SPOT"));
+    engine.onTopOfBook(makeLogTop("ETH/USDT_SPOT", 7.6));
+    engine.onTopOfBook(makeLogTop("BTC/USDT_SPOT", 10.6));
+    
+    // Grid points come from the wheel, not from book updates
+    TimingWheel wheel(std::chrono::milliseconds(1), kStart + std::chrono::milliseconds(30));
+    engine.startSampleTimer(wheel);
+    EXPECT_EQ(wheel.size(), 1u);
+    wheel.advance(kStart + std::chrono::milliseconds(99));
+    EXPECT_EQ(engine.getSampleCount(), 0u);
+    wheel.advance(kStart + std::chrono::milliseconds(100));
+    EXPECT_EQ(engine.getSampleCount(), 1u);
+    wheel.advance(kStart + std::chrono::milliseconds(550));
+    EXPECT_EQ(engine.getSampleCount(), 5u);
+    EXPECT_EQ(wheel.size(), 1u);  // Always one pending grid point
+}
+
+} // namespace arbitrage
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include "confidence_scorer.hpp"
+#include "strategy_shard.hpp"
+#include <cmath>
+
+namespace arbitrage {
+
+namespace {
+
+const Timestamp kStart = Timestamp(std::chrono::hours(24 * 365 * 50));
+
+OrderBook makeBook(Price bid, Price ask, Volume volume, size_t levels = 1) {
+    OrderBook book;
+    for (size_t level = 0; level < levels; ++level) {
+        book.bids.push_back({bid - level, volume, kStart});
+        book.asks.push_back({ask + level, volume, kStart});
+    }
+    return book;
+}
+
+} // namespace
+
+TEST(ConfidenceScorerTest, FeaturesCombineIntoLegScore) {
+    ConfidenceConfig config;
+    config.liquidity_threshold = 100000.0;
+    config.depth_levels = 2;
+    ConfidenceScorer scorer(config);
+    size_t leg = scorer.addInstrument("BTC/USDT_SPOT");
+    EXPECT_EQ(scorer.getLegScore(leg, kStart), 0.0);  // No book yet
+    
+    // Two levels of 1 BTC per side: 39999 + 39998 notional on the bid side
+    scorer.onBookUpdate(leg, makeBook(39999.0, 40001.0, 1.0, 3), kStart);
+    EXPECT_DOUBLE_EQ(scorer.getDepthNotional(leg), 39999.0 + 39998.0);
+    EXPECT_DOUBLE_EQ(scorer.getSpreadMean(leg), 2.0 / 40000.0);
+    EXPECT_DOUBLE_EQ(scorer.getLegScore(leg, kStart), (39999.0 + 39998.0) / 100000.0);
+    
+    // Freshness halves every 200ms
+    double fresh = scorer.getLegScore(leg, kStart);
+    EXPECT_NEAR(scorer.getLegScore(leg, kStart + std::chrono::milliseconds(500)), fresh * std::pow(2.0, -2.5),
+                1e-12);
+    EXPECT_EQ(scorer.getLegScore(leg, kStart - std::chrono::seconds(1)), fresh);  // Clock skew clamps to fresh
+    
+    // A spread jumping tenfold is past the tolerance: mean m, deviation s ->
+    // 1 / (1 + s / m - 0.5)
+    scorer.onBookUpdate(leg, makeBook(39990.0, 40010.0, 10.0, 3), kStart);
+    double m = scorer.getSpreadMean(leg);
+    double s = scorer.getSpreadVolatility(leg);
+    EXPECT_GT(s / m, 0.5);
+    EXPECT_DOUBLE_EQ(scorer.getStaticScore(leg), 1.0 / (1.0 + s / m - 0.5));
+    
+    // One-sided book has no depth
+    OrderBook one_sided = makeBook(39999.0, 40001.0, 5.0);
+    one_sided.asks.clear();
+    scorer.onBookUpdate(leg, one_sided, kStart);
+    EXPECT_EQ(scorer.getLegScore(leg, kStart), 0.0);
+}
+
+TEST(ConfidenceScorerTest, EarlyRejectStopsAtWeakLeg) {
+    ConfidenceScorer scorer;
+    size_t deep = scorer.addInstrument("BTC-PERPETUAL_PERPETUAL_SWAP");
+    size_t thin = scorer.addInstrument("BTC/USDT_SPOT");
+    scorer.onBookUpdate(deep, makeBook(39999.0, 40001.0, 5.0), kStart);
+    scorer.onBookUpdate(thin, makeBook(39999.0, 40001.0, 0.1), kStart);
+    
+    double score = 0.0;
+    size_t strong[] = {deep};
+    EXPECT_TRUE(scorer.accept(strong, 1, kStart + std::chrono::milliseconds(10), score));
+    EXPECT_NEAR(score, std::pow(2.0, -0.05), 1e-12);
+    
+    // Thin leg fails on its static bound, before freshness is evaluated
+    size_t legs[] = {deep, thin};
+    EXPECT_FALSE(scorer.accept(legs, 2, kStart, score));
+    EXPECT_NEAR(score, 3999.9 / 10000.0, 1e-12);
+    EXPECT_EQ(scorer.getEarlyRejectCount(), 1u);
+    
+    // Stale but otherwise perfect leg is rejected on the full score
+    EXPECT_FALSE(scorer.accept(strong, 1, kStart + std::chrono::milliseconds(100), score));
+    EXPECT_EQ(scorer.getEarlyRejectCount(), 1u);
+    EXPECT_EQ(scorer.getRejectedCount(), 2u);
+    EXPECT_EQ(scorer.getAcceptedCount(), 1u);
+    
+    // Id-based scoring fills the candidate's confidence
+    ArbitrageOpportunity opportunity;
+    opportunity.leg_instruments = {"BTC-PERPETUAL_PERPETUAL_SWAP", "BTC/USDT_SPOT"};
+    EXPECT_FALSE(scorer.scoreOpportunity(opportunity, kStart));
+    EXPECT_NEAR(opportunity.confidence_score, 0.39999, 1e-12);
+    
+    SyntheticPrice synthetic;
+    synthetic.component_instruments = {"BTC-PERPETUAL_PERPETUAL_SWAP"};
+    EXPECT_TRUE(scorer.scoreSynthetic(synthetic, kStart));
+    EXPECT_EQ(synthetic.confidence_score, 1.0);
+    synthetic.component_instruments.push_back("UNKNOWN");
+    EXPECT_FALSE(scorer.scoreSynthetic(synthetic, kStart));
+}
+
+TEST(ConfidenceScorerTest, DefaultThresholdPassesJitteringBook) {
+    // Deep book whose spread flips between one and two ticks, as most do
+    ConfidenceScorer scorer;
+    size_t leg = scorer.addInstrument("BTC/USDT_SPOT");
+    size_t wide = scorer.addInstrument("ETH/USDT_SPOT");
+    for (int update = 0; update < 200; ++update) {
+        Price spread = update % 2 == 0 ? 0.1 : 0.2;
+        scorer.onBookUpdate(leg, makeBook(40000.0, 40000.0 + spread, 5.0), kStart);
+        // Spread swinging between one and ten ticks is not a steady book
+        spread = update % 2 == 0 ? 0.1 : 1.0;
+        scorer.onBookUpdate(wide, makeBook(40000.0, 40000.0 + spread, 5.0), kStart);
+    }
+    EXPECT_LT(scorer.getSpreadVolatility(leg) / scorer.getSpreadMean(leg), 0.5);
+    EXPECT_DOUBLE_EQ(scorer.getStaticScore(leg), 1.0);
+    EXPECT_LT(scorer.getStaticScore(wide), 0.8);
+    
+    // At the default 0.95 a fresh book passes, as does one at the 10ms budget
+    // with the half-life the engine derives from it
+    ConfidenceConfig config;
+    config.freshness_half_life = std::chrono::milliseconds(200);
+    scorer.setConfig(config);
+    double score = 0.0;
+    size_t legs[] = {leg};
+    EXPECT_TRUE(scorer.accept(legs, 1, kStart + std::chrono::milliseconds(10), score));
+    EXPECT_GT(score, 0.96);
+    EXPECT_FALSE(scorer.accept(legs, 1, kStart + std::chrono::milliseconds(100), score));
+    size_t wide_legs[] = {wide};
+    EXPECT_FALSE(scorer.accept(wide_legs, 1, kStart, score));
+}
+
+TEST(ConfidenceScorerTest, ShardKeepsFeaturesCurrent) {
+    StrategyShard shard(0, nullptr);
+    Instrument instrument;
+    instrument.id = "ETH/USDT_SPOT";
+    shard.addInstrument(instrument);
+    
+    MarketEvent event;
+    event.type = MarketEventType::BOOK_UPDATE;
+    event.instrument_id = instrument.id;
+    event.exchange_time = kStart;
+    event.book = makeBook(1999.0, 2001.0, 10.0);
+    shard.processEvent(event);
+    
+    ConfidenceScorer& scorer = shard.getConfidenceScorer();
+    size_t leg;
+    ASSERT_TRUE(scorer.find(instrument.id, leg));
+    EXPECT_DOUBLE_EQ(scorer.getDepthNotional(leg), 19990.0);
+    EXPECT_DOUBLE_EQ(scorer.getLegScore(leg, kStart), 1.0);
+    
+    // Raising the liquidity bar rescales the stored features
+    ConfidenceConfig config;
+    config.liquidity_threshold = 39980.0;
+    scorer.setConfig(config);
+    EXPECT_DOUBLE_EQ(scorer.getLegScore(leg, kStart), 0.5);
+}
+
+} // namespace arbitrage
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include "conflating_queue.hpp"
+
+namespace arbitrage {
+
+namespace {
+
+MarketEvent makeEvent(MarketEventType type, const InstrumentId& instrument_id, uint64_t sequence,
+                      Price bid = 100.0) {
+    MarketEvent event;
+    event.type = type;
+    event.instrument_id = instrument_id;
+    event.sequence = sequence;
+    if (type == MarketEventType::BOOK_UPDATE) {
+        event.book.bids.push_back({bid, 1.0, getCurrentTimestamp()});
+        event.book.asks.push_back({bid + 1.0, 1.0, getCurrentTimestamp()});
+    }
+    return event;
+}
+
+} // namespace
+
+TEST(ConflatingEventQueueTest, BookUpdatesConflateInPlace) {
+    ConflatingEventQueue queue;
+    
+    EXPECT_TRUE(queue.push(makeEvent(MarketEventType::BOOK_UPDATE, "BTC", 1, 100.0)));
+    EXPECT_FALSE(queue.push(makeEvent(MarketEventType::TRADE, "ETH", 2)));
+    EXPECT_FALSE(queue.push(makeEvent(MarketEventType::BOOK_UPDATE, "BTC", 3, 101.0)));
+    EXPECT_FALSE(queue.push(makeEvent(MarketEventType::BOOK_UPDATE, "ETH", 4, 50.0)));
+    EXPECT_FALSE(queue.push(makeEvent(MarketEventType::BOOK_UPDATE, "BTC", 5, 102.0)));
+    EXPECT_EQ(queue.size(), 3);
+    EXPECT_EQ(queue.getConflatedCount(), 2);
+    
+    std::vector<MarketEvent> out;
+    ASSERT_EQ(queue.drain(out), 3);
+    
+    // Newest BTC book, in the position of the first queued BTC book
+    EXPECT_EQ(out[0].type, MarketEventType::BOOK_UPDATE);
+    EXPECT_EQ(out[0].instrument_id, "BTC");
+    EXPECT_EQ(out[0].sequence, 5);
+    EXPECT_EQ(out[0].first_sequence, 1);
+    EXPECT_EQ(out[0].conflated_updates, 2);
+    EXPECT_EQ(out[0].book.getBestBid(), 102.0);
+    
+    EXPECT_EQ(out[1].type, MarketEventType::TRADE);
+    EXPECT_EQ(out[2].instrument_id, "ETH");
+    EXPECT_EQ(out[2].conflated_updates, 0);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(ConflatingEventQueueTest, TradesAndFundingAreNeverConflated) {
+    ConflatingEventQueue queue;
+    for (uint64_t seq = 1; seq <= 3; ++seq) {
+        queue.push(makeEvent(MarketEventType::TRADE, "BTC", seq));
+        queue.push(makeEvent(MarketEventType::FUNDING_RATE, "BTC", seq + 10));
+    }
+    
+    std::vector<MarketEvent> out;
+    EXPECT_EQ(queue.drain(out), 6);
+    EXPECT_EQ(queue.getConflatedCount(), 0);
+}
+
+TEST(ConflatingEventQueueTest, BooksNeverOvertakeTradesOfTheSameInstrument) {
+    ConflatingEventQueue queue;
+    queue.push(makeEvent(MarketEventType::BOOK_UPDATE, "BTC", 1, 100.0));
+    queue.push(makeEvent(MarketEventType::TRADE, "BTC", 2));
+    queue.push(makeEvent(MarketEventType::BOOK_UPDATE, "BTC", 3, 101.0));
+    queue.push(makeEvent(MarketEventType::FUNDING_RATE, "BTC", 4));
+    queue.push(makeEvent(MarketEventType::BOOK_UPDATE, "BTC", 5, 102.0));
+    queue.push(makeEvent(MarketEventType::BOOK_UPDATE, "BTC", 6, 103.0));
+    EXPECT_EQ(queue.getConflatedCount(), 1);
+    
+    // The trade is seen against the book it printed on, not a later one;
+    // only the two books after the funding event merge
+    std::vector<MarketEvent> out;
+    ASSERT_EQ(queue.drain(out), 5);
+    std::vector<uint64_t> sequences;
+    for (const auto& event : out) {
+        sequences.push_back(event.sequence);
+    }
+    EXPECT_EQ(sequences, (std::vector<uint64_t>{1, 2, 3, 4, 6}));
+    EXPECT_EQ(out[0].book.getBestBid(), 100.0);
+    EXPECT_EQ(out[2].book.getBestBid(), 101.0);
+    EXPECT_EQ(out[4].first_sequence, 5);
+    EXPECT_EQ(out[4].conflated_updates, 1);
+}
+
+TEST(ConflatingEventQueueTest, DrainEndsConflationWindow) {
+    ConflatingEventQueue queue;
+    std::vector<MarketEvent> out;
+    
+    queue.push(makeEvent(MarketEventType::BOOK_UPDATE, "BTC", 1));
+    queue.drain(out);
+    
+    // The consumer has caught up, so the next book starts a fresh run
+    EXPECT_TRUE(queue.push(makeEvent(MarketEventType::BOOK_UPDATE, "BTC", 2)));
+    queue.drain(out);
+    ASSERT_EQ(out.size(), 1);
+    EXPECT_EQ(out[0].first_sequence, 2);
+    EXPECT_EQ(out[0].conflated_updates, 0);
+}
+
+} // namespace arbitrage
@@ -1,7 +1,9 @@
 #include <gtest/gtest.h>
 #include "config_manager.hpp"
+#include "engine_clock.hpp"
 #include "logger.hpp"
 #include "performance_monitor.hpp"
+#include <algorithm>
 #include <fstream>
 #include <filesystem>
 
@@ -77,6 +79,24 @@ protected:
                         "enabled": true,
                         "contract_size": 1.0,
                         "tick_size": 0.1
+                    },
+                    {
+                        "symbol": "BTC-20261225",
+                        "underlying": "BTC",
+                        "quote": "USDT",
+                        "type": "futures",
+                        "enabled": true,
+                        "tick_size": 0.1,
+                        "expiry": "2026-12-25T08:00:00Z"
+                    },
+                    {
+                        "symbol": "BTC-20250926",
+                        "underlying": "BTC",
+                        "quote": "USDT",
+                        "type": "futures",
+                        "enabled": true,
+                        "tick_size": 0.1,
+                        "expiry": "2025-09-26T08:00:00Z"
                     }
                 ]
             },
@@ -93,6 +113,21 @@ protected:
                     "max_leverage": 5.0,
                     "stop_loss_percentage": 0.01,
                     "take_profit_percentage": 0.005
+                },
+                "synthetic_construction": {
+                    "liquidity_threshold": 25000.0,
+                    "correlation_threshold": 0.75,
+                    "funding_rate_threshold": 0.0003,
+                    "basis_spread_threshold": 0.002,
+                    "carry_rates": {"USDT": 0.05},
+                    "constructions": [
+                        {
+                            "id": "BTC-PERP-BASIS",
+                            "shape": "spot_perp",
+                            "legs": ["BTC-PERPETUAL_PERPETUAL_SWAP", "BTC/USDT_SPOT"],
+                            "weights": [1.0, -1.0]
+                        }
+                    ]
                 }
             }
         })";
@@ -144,7 +179,7 @@ TEST_F(ConfigManagerTest, InstrumentConfiguration) {
     EXPECT_TRUE(config_manager.loadConfig(test_config_file_));
     
     auto enabled_instruments = config_manager.getEnabledInstruments();
-    EXPECT_EQ(enabled_instruments.size(), 2);
+    EXPECT_EQ(enabled_instruments.size(), 3);
     
     // Check spot instrument
     bool found_spot = false;
@@ -173,6 +208,37 @@ TEST_F(ConfigManagerTest, InstrumentConfiguration) {
         }
     }
     EXPECT_TRUE(found_derivative);
+    
+    // Dated contracts carry their expiry (2026-12-25 08:00 UTC)
+    bool found_future = false;
+    for (const auto& instrument : enabled_instruments) {
+        if (instrument.id == "BTC-20261225_FUTURES") {
+            found_future = true;
+            EXPECT_EQ(instrument.expiry_time, Timestamp(std::chrono::seconds(1798185600)));
+        }
+    }
+    EXPECT_TRUE(found_future);
+}
+
+TEST_F(ConfigManagerTest, ExpiredFuturesAreSkipped) {
+    auto& config_manager = ConfigManager::getInstance();
+    
+    // The September 2025 contract has expired: loading warns and skips it
+    ASSERT_TRUE(config_manager.loadConfig(test_config_file_));
+    auto enabled_instruments = config_manager.getEnabledInstruments();
+    auto listed = [&enabled_instruments](const InstrumentId& id) {
+        return std::any_of(enabled_instruments.begin(), enabled_instruments.end(),
+                           [&id](const Instrument& instrument) { return instrument.id == id; });
+    };
+    EXPECT_FALSE(listed("BTC-20250926_FUTURES"));
+    EXPECT_TRUE(listed("BTC-20261225_FUTURES"));
+    
+    // A replay of its last month still trades it
+    EngineClock::getInstance().useSimulatedTime(Timestamp(std::chrono::seconds(1756684800)));  // 2025-09-01
+    enabled_instruments = config_manager.getEnabledInstruments();
+    EngineClock::getInstance().useRealTime();
+    EXPECT_TRUE(listed("BTC-20250926_FUTURES"));
+    EXPECT_EQ(enabled_instruments.size(), 4u);
 }
 
 TEST_F(ConfigManagerTest, ArbitrageConfiguration) {
@@ -189,6 +255,18 @@ TEST_F(ConfigManagerTest, ArbitrageConfiguration) {
     EXPECT_EQ(arbitrage_config.max_leverage, 5.0);
     EXPECT_EQ(arbitrage_config.stop_loss_percentage, 0.01);
     EXPECT_EQ(arbitrage_config.take_profit_percentage, 0.005);
+    
+    EXPECT_EQ(arbitrage_config.liquidity_threshold, 25000.0);
+    EXPECT_EQ(arbitrage_config.correlation_threshold, 0.75);
+    EXPECT_EQ(arbitrage_config.funding_rate_threshold, 0.0003);
+    EXPECT_EQ(arbitrage_config.basis_spread_threshold, 0.002);
+    ASSERT_EQ(arbitrage_config.carry_rates.size(), 1u);
+    EXPECT_EQ(arbitrage_config.carry_rates.at("USDT"), 0.05);
+    ASSERT_EQ(arbitrage_config.constructions.size(), 1u);
+    EXPECT_EQ(arbitrage_config.constructions[0].id, "BTC-PERP-BASIS");
+    EXPECT_EQ(arbitrage_config.constructions[0].shape, ConstructionShape::SPOT_PERP);
+    EXPECT_EQ(arbitrage_config.constructions[0].legs.size(), 2u);
+    EXPECT_EQ(arbitrage_config.constructions[0].weights[1], -1.0);
 }
 
 class PerformanceMonitorTest : public ::testing::Test {
@@ -196,6 +274,7 @@ protected:
     void SetUp() override {
         perf_monitor_ = &PerformanceMonitor::getInstance();
         perf_monitor_->initialize(100);  // 100ms interval for faster testing
+        perf_monitor_->resetMetrics();   // Earlier suites may have processed events
     }
     
     void TearDown() override {
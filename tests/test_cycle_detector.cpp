@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+#include "cycle_detector.hpp"
+#include "test_helpers.hpp"
+#include <cmath>
+
+namespace arbitrage {
+
+TEST(CycleDetectorTest, TriangleFoundInBothDirections) {
+    CurrencyCycleDetector detector;
+    ASSERT_TRUE(detector.addPair("BTC/USDT", "BTC", "USDT"));
+    ASSERT_TRUE(detector.addPair("ETH/USDT", "ETH", "USDT"));
+    ASSERT_TRUE(detector.addPair("ETH/BTC", "ETH", "BTC"));
+    EXPECT_FALSE(detector.addPair("ETH/BTC", "ETH", "BTC"));
+    EXPECT_EQ(detector.getCurrencyCount(), 3u);
+    
+    Timestamp now = getCurrentTimestamp();
+    std::vector<ArbitrageOpportunity> out;
+    EXPECT_EQ(detector.onTopOfBook(makeTop("BTC/USDT", 40000.0, 40001.0, 2.0), now, out), 0u);
+    EXPECT_EQ(detector.onTopOfBook(makeTop("ETH/USDT", 2000.0, 2000.5, 10.0), now, out), 0u);
+    EXPECT_EQ(detector.onTopOfBook(makeTop("ETH/BTC", 0.04999, 0.05001, 10.0), now, out), 0u);
+    EXPECT_DOUBLE_EQ(detector.getEdgeWeight("BTC", "USDT"), -std::log(40000.0));
+    
+    // ETH cheap in BTC: USDT -> BTC -> ETH -> USDT, reported from its lowest edge
+    ASSERT_EQ(detector.onTopOfBook(makeTop("ETH/BTC", 0.0489, 0.049, 10.0), now, out), 1u);
+    const ArbitrageOpportunity& cheap = out.back();
+    EXPECT_EQ(cheap.type, ArbitrageType::CROSS_SYNTHETIC);
+    EXPECT_EQ(cheap.opportunity_id, "CYCLE:B:BTC/USDT:B:ETH/BTC:S:ETH/USDT");
+    EXPECT_NEAR(cheap.expected_profit_percentage, 2000.0 / 40001.0 / 0.049 - 1.0, 1e-12);
+    ASSERT_EQ(cheap.leg_sides.size(), 3u);
+    EXPECT_EQ(cheap.leg_sides[0], OrderSide::BUY);
+    EXPECT_EQ(cheap.leg_sides[2], OrderSide::SELL);
+    // Sized by the tightest top level: 10 ETH on both ETH books, which needs 0.49 BTC
+    EXPECT_NEAR(cheap.leg_volumes[0], 0.49, 1e-12);
+    EXPECT_NEAR(cheap.leg_volumes[1], 10.0, 1e-9);
+    EXPECT_NEAR(cheap.leg_volumes[2], 10.0, 1e-9);
+    EXPECT_NEAR(cheap.expected_profit, 0.49 * 40001.0 * cheap.expected_profit_percentage, 1e-6);
+    
+    // ETH rich in BTC: the opposite orientation
+    out.clear();
+    ASSERT_EQ(detector.onTopOfBook(makeTop("ETH/BTC", 0.0515, 0.0516, 10.0), now, out), 1u);
+    EXPECT_EQ(out.back().opportunity_id, "CYCLE:S:BTC/USDT:B:ETH/USDT:S:ETH/BTC");
+    EXPECT_NEAR(out.back().expected_profit_percentage, 0.0515 * 40000.0 / 2000.5 - 1.0, 1e-12);
+    
+    // Sizes alone do not trigger a search
+    uint64_t searches = detector.getSearchCount();
+    EXPECT_EQ(detector.onTopOfBook(makeTop("ETH/BTC", 0.0515, 0.0516, 3.0), now, out), 0u);
+    EXPECT_EQ(detector.getSearchCount(), searches);
+}
+
+TEST(CycleDetectorTest, CrossVenueRoundTripUsesCheapestParallelBook) {
+    CurrencyCycleDetector detector;
+    detector.addPair("BTC/USDT@OKX", "BTC", "USDT", Exchange::OKX);
+    detector.addPair("BTC/USDT@BINANCE", "BTC", "USDT", Exchange::BINANCE);
+    detector.addPair("BTC/USDT@BYBIT", "BTC", "USDT", Exchange::BYBIT);
+    
+    Timestamp now = getCurrentTimestamp();
+    std::vector<ArbitrageOpportunity> out;
+    detector.onTopOfBook(makeTop("BTC/USDT@OKX", 40000.0, 40001.0), now, out);
+    detector.onTopOfBook(makeTop("BTC/USDT@BYBIT", 40010.0, 40012.0), now, out);
+    EXPECT_TRUE(out.empty());
+    
+    // Binance bid clears the OKX ask by 0.25%
+    ASSERT_EQ(detector.onTopOfBook(makeTop("BTC/USDT@BINANCE", 40101.0, 40102.0), now, out), 1u);
+    EXPECT_EQ(out[0].leg_exchanges[0], Exchange::OKX);
+    EXPECT_EQ(out[0].leg_sides[0], OrderSide::BUY);
+    EXPECT_EQ(out[0].leg_exchanges[1], Exchange::BINANCE);
+    EXPECT_EQ(out[0].leg_sides[1], OrderSide::SELL);
+    EXPECT_NEAR(out[0].expected_profit_percentage, 40101.0 / 40001.0 - 1.0, 1e-12);
+    
+    // A worse quote on a venue that is not the best changes no best edge
+    uint64_t searches = detector.getSearchCount();
+    detector.onTopOfBook(makeTop("BTC/USDT@BYBIT", 40009.0, 40013.0), now, out);
+    EXPECT_EQ(detector.getSearchCount(), searches);
+}
+
+TEST(CycleDetectorTest, CycleLengthIsBounded) {
+    for (size_t max_length : {3u, 4u}) {
+        CycleDetectorConfig config;
+        config.max_cycle_length = max_length;
+        config.fee_rate = 0.001;
+        CurrencyCycleDetector detector(config);
+        detector.addPair("A/USD", "A", "USD");
+        detector.addPair("B/A", "B", "A");
+        detector.addPair("C/B", "C", "B");
+        detector.addPair("C/USD", "C", "USD");
+        
+        // USD -> A -> B -> C -> USD gains 5% before 4 x 0.1% fees
+        Timestamp now = getCurrentTimestamp();
+        std::vector<ArbitrageOpportunity> out;
+        detector.onTopOfBook(makeTop("A/USD", 0.99, 1.0), now, out);
+        detector.onTopOfBook(makeTop("B/A", 0.99, 1.0), now, out);
+        detector.onTopOfBook(makeTop("C/B", 0.99, 1.0), now, out);
+        detector.onTopOfBook(makeTop("C/USD", 1.05, 1.06), now, out);
+        if (max_length == 3) {
+            EXPECT_TRUE(out.empty());
+        } else {
+            ASSERT_EQ(out.size(), 1u);
+            EXPECT_NEAR(out[0].expected_profit_percentage, 1.05 * std::pow(0.999, 4) - 1.0, 1e-12);
+        }
+    }
+}
+
+TEST(CycleDetectorTest, CrossQuoteBooksCompareInPivot) {
+    auto spot = [](const std::string& base, const std::string& quote, Exchange exchange) {
+        Instrument instrument;
+        instrument.id = base + "/" + quote + "@" + exchangeToString(exchange);
+        instrument.type = InstrumentType::SPOT;
+        instrument.exchange = exchange;
+        instrument.base_asset = base;
+        instrument.quote_asset = quote;
+        return instrument;
+    };
+    std::vector<Instrument> instruments = {spot("BTC", "USDT", Exchange::OKX), spot("BTC", "USDC", Exchange::BINANCE),
+                                           spot("USDC", "USDT", Exchange::BINANCE)};
+    QuoteNormalizer normalizer;
+    normalizer.addInstruments(instruments);
+    CurrencyCycleDetector detector;
+    detector.setQuoteNormalizer(&normalizer);
+    ASSERT_EQ(detector.addInstruments(instruments), 3u);
+    EXPECT_EQ(detector.getNormalizedPairCount(), 1u);
+    
+    Timestamp now = getCurrentTimestamp();
+    std::vector<ArbitrageOpportunity> out;
+    auto feed = [&](const TopOfBook& top) { return detector.onTopOfBook(top, now, out); };
+    
+    // Unpriced conversion: the USDC book has no edge yet
+    feed(makeTop("BTC/USDT@OKX", 40000.0, 40001.0));
+    EXPECT_EQ(feed(makeTop("BTC/USDC@BINANCE", 40100.0, 40101.0)), 0u);
+    
+    // USDC at 0.997 USDT puts the 40100 USDC bid below the OKX ask...
+    EXPECT_EQ(feed(makeTop("USDC/USDT@BINANCE", 0.9969, 0.9971)), 0u);
+    // ...and a wide conversion book charges its spread: a 1.001 mid sold at
+    // its 0.9985 bid still does not clear it
+    EXPECT_EQ(feed(makeTop("USDC/USDT@BINANCE", 0.9985, 1.0035)), 0u);
+    EXPECT_TRUE(out.empty());
+    
+    // At a 1.0009 bid it clears the OKX ask: the conversion tick alone re-prices it
+    ASSERT_EQ(feed(makeTop("USDC/USDT@BINANCE", 1.0009, 1.0011)), 1u);
+    const ArbitrageOpportunity& round_trip = out.back();
+    EXPECT_EQ(round_trip.opportunity_id, "CYCLE:B:BTC/USDT@OKX:S:BTC/USDC@BINANCE:S:USDC/USDT@BINANCE");
+    EXPECT_NEAR(round_trip.expected_profit_percentage, 40100.0 * 1.0009 / 40001.0 - 1.0, 1e-12);
+    
+    // The USDC proceeds are sold back into USDT, so the trade closes in USDT
+    ASSERT_EQ(round_trip.leg_instruments.size(), 3u);
+    EXPECT_EQ(round_trip.leg_sides,
+              (std::vector<OrderSide>{OrderSide::BUY, OrderSide::SELL, OrderSide::SELL}));
+    EXPECT_DOUBLE_EQ(round_trip.leg_prices[0], 40001.0);
+    EXPECT_DOUBLE_EQ(round_trip.leg_prices[1], 40100.0);
+    EXPECT_DOUBLE_EQ(round_trip.leg_prices[2], 1.0009);
+    EXPECT_DOUBLE_EQ(round_trip.leg_volumes[2], round_trip.leg_volumes[1] * 40100.0);
+    
+    // Left to the spread scanner, the same three books are not reported here
+    CycleDetectorConfig config;
+    config.report_triangles = false;
+    CurrencyCycleDetector scanned(config);
+    scanned.setQuoteNormalizer(&normalizer);
+    scanned.addInstruments(instruments);
+    std::vector<ArbitrageOpportunity> none;
+    scanned.onTopOfBook(makeTop("BTC/USDT@OKX", 40000.0, 40001.0), now, none);
+    scanned.onTopOfBook(makeTop("BTC/USDC@BINANCE", 40100.0, 40101.0), now, none);
+    EXPECT_EQ(scanned.onTopOfBook(makeTop("USDC/USDT@BINANCE", 1.0009, 1.0011), now, none), 0u);
+}
+
+TEST(CycleDetectorTest, InvertedConversionBookLegs) {
+    // USDC quoted against the pivot the other way round: USDT/USDC
+    std::vector<Instrument> instruments = {makeSpot("BTC", "USDT"), makeSpot("BTC", "USDC"), makeSpot("USDT", "USDC")};
+    QuoteNormalizer normalizer;
+    ASSERT_EQ(normalizer.addInstruments(instruments), 1u);
+    CurrencyCycleDetector detector;
+    detector.setQuoteNormalizer(&normalizer);
+    ASSERT_EQ(detector.addInstruments(instruments), 3u);
+    EXPECT_EQ(detector.getNormalizedPairCount(), 1u);
+    
+    Timestamp now = getCurrentTimestamp();
+    std::vector<ArbitrageOpportunity> out;
+    detector.onTopOfBook(makeTop("BTC/USDT_SPOT", 40200.0, 40201.0), now, out);
+    detector.onTopOfBook(makeTop("USDT/USDC_SPOT", 0.9990, 0.9992), now, out);
+    
+    // Buying BTC in USDC first buys the USDC by selling USDT at 0.9990
+    ASSERT_EQ(detector.onTopOfBook(makeTop("BTC/USDC_SPOT", 40000.0, 40001.0), now, out), 1u);
+    const ArbitrageOpportunity& round_trip = out.back();
+    EXPECT_EQ(round_trip.leg_instruments,
+              (std::vector<InstrumentId>{"BTC/USDT_SPOT", "USDT/USDC_SPOT", "BTC/USDC_SPOT"}));
+    EXPECT_EQ(round_trip.leg_sides, (std::vector<OrderSide>{OrderSide::SELL, OrderSide::SELL, OrderSide::BUY}));
+    EXPECT_NEAR(round_trip.expected_profit_percentage, 40200.0 * 0.9990 / 40001.0 - 1.0, 1e-12);
+    // The USDT sold buys exactly the USDC the BTC costs
+    EXPECT_NEAR(round_trip.leg_volumes[1] * 0.9990, round_trip.leg_volumes[2] * 40001.0, 1e-9);
+}
+
+TEST(CycleDetectorTest, TrianglesLeftToSpreadScanner) {
+    CycleDetectorConfig config;
+    config.report_triangles = false;
+    CurrencyCycleDetector detector(config);
+    detector.addPair("BTC/USDT", "BTC", "USDT");
+    detector.addPair("ETH/USDT", "ETH", "USDT");
+    detector.addPair("ETH/BTC", "ETH", "BTC");
+    detector.addPair("BTC/USDT@OKX", "BTC", "USDT", Exchange::OKX);
+    
+    Timestamp now = getCurrentTimestamp();
+    std::vector<ArbitrageOpportunity> out;
+    detector.onTopOfBook(makeTop("BTC/USDT", 40000.0, 40001.0), now, out);
+    detector.onTopOfBook(makeTop("ETH/USDT", 2000.0, 2000.5), now, out);
+    EXPECT_EQ(detector.onTopOfBook(makeTop("ETH/BTC", 0.0489, 0.049), now, out), 0u);
+    EXPECT_EQ(detector.getCycleCount(), 0u);
+    
+    // Cross-venue round trips are still reported
+    ASSERT_EQ(detector.onTopOfBook(makeTop("BTC/USDT@OKX", 40101.0, 40102.0), now, out), 1u);
+    EXPECT_EQ(out.back().leg_instruments.size(), 2u);
+}
+
+} // namespace arbitrage
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include "dependency_graph.hpp"
+#include "strategy_shard.hpp"
+#include "perpetual_pricer.hpp"
+#include "test_helpers.hpp"
+
+namespace arbitrage {
+
+TEST(DependencyGraphTest, BookUpdatesRecomputeOnlyAffectedSynthetics) {
+    DependencyGraph graph;
+    std::vector<std::string> recomputed;
+    auto recorder = [&recomputed](const std::string& name) {
+        return [&recomputed, name](Timestamp) {
+            recomputed.push_back(name);
+            return true;
+        };
+    };
+    
+    SyntheticPrice btc_perp;
+    btc_perp.synthetic_instrument_id = "BTC-PERP-FAIR";
+    btc_perp.component_instruments = {"BTC-SPOT", "BTC-PERP"};
+    SyntheticPrice eth_btc;
+    eth_btc.synthetic_instrument_id = "ETH/BTC-SYNTH";
+    eth_btc.component_instruments = {"ETH-SPOT", "BTC-SPOT"};
+    graph.addSynthetic(btc_perp, recorder("BTC-PERP-FAIR"));
+    graph.addSynthetic(eth_btc, recorder("ETH/BTC-SYNTH"));
+    
+    EXPECT_EQ(graph.getDependents("BTC-SPOT").size(), 2u);
+    EXPECT_EQ(graph.getDependents("SOL-SPOT").size(), 0u);
+    
+    // Three ticks of the same book in one batch: one recompute per consumer
+    EXPECT_EQ(graph.markInstrumentDirty("BTC-PERP"), 1u);
+    EXPECT_EQ(graph.markInstrumentDirty("BTC-PERP"), 0u);
+    EXPECT_EQ(graph.markInstrumentDirty("BTC-PERP"), 0u);
+    EXPECT_EQ(graph.markInstrumentDirty("SOL-SPOT"), 0u);
+    EXPECT_EQ(graph.flush(getCurrentTimestamp()), 1u);
+    EXPECT_EQ(recomputed, std::vector<std::string>{"BTC-PERP-FAIR"});
+    EXPECT_EQ(graph.getCoalescedCount(), 2u);
+    
+    recomputed.clear();
+    graph.markInstrumentDirty("BTC-SPOT");
+    graph.markInstrumentDirty("ETH-SPOT");
+    EXPECT_EQ(graph.flush(getCurrentTimestamp()), 2u);
+    EXPECT_EQ(recomputed.size(), 2u);
+    EXPECT_FALSE(graph.hasPending());
+    EXPECT_EQ(graph.flush(getCurrentTimestamp()), 0u);
+}
+
+TEST(DependencyGraphTest, DetectorsRunAfterTheirSynthetics) {
+    DependencyGraph graph;
+    std::vector<std::string> order;
+    bool spread_changed = true;
+    
+    // Nodes added in the "wrong" order: detector first
+    auto detector = graph.addNode("basis_detector", [&](Timestamp) {
+        order.push_back("detector");
+        return false;
+    });
+    auto fair_value = graph.addNode("fair_value", [&](Timestamp) {
+        order.push_back("fair_value");
+        return true;
+    });
+    auto spread = graph.addNode("spread", [&](Timestamp) {
+        order.push_back("spread");
+        return spread_changed;
+    });
+    graph.addDependency("BTC-SPOT", fair_value);
+    graph.addDependency("BTC-SPOT", spread);
+    graph.addDependency("BTC-PERP", detector);
+    ASSERT_TRUE(graph.addNodeDependency(fair_value, spread));
+    ASSERT_TRUE(graph.addNodeDependency(spread, detector));
+    EXPECT_FALSE(graph.addNodeDependency(detector, fair_value));  // Cycle
+    EXPECT_EQ(graph.getRank(detector), 2u);
+    
+    graph.markInstrumentDirty("BTC-PERP");
+    graph.markInstrumentDirty("BTC-SPOT");
+    graph.flush(getCurrentTimestamp());
+    EXPECT_EQ(order, (std::vector<std::string>{"fair_value", "spread", "detector"}));
+    
+    // Unchanged upstream output does not wake the detector
+    order.clear();
+    spread_changed = false;
+    graph.markInstrumentDirty("BTC-SPOT");
+    graph.flush(getCurrentTimestamp());
+    EXPECT_EQ(order, (std::vector<std::string>{"fair_value", "spread"}));
+}
+
+TEST(DependencyGraphTest, ShardRepricesOncePerEventBatch) {
+    Instrument spot;
+    spot.id = "BTC/USDT_SPOT";
+    spot.base_asset = "BTC";
+    spot.quote_asset = "USDT";
+    spot.type = InstrumentType::SPOT;
+    Instrument perp = spot;
+    perp.id = "BTC-PERPETUAL_PERPETUAL_SWAP";
+    perp.type = InstrumentType::PERPETUAL_SWAP;
+    
+    StrategyShard shard(0, nullptr);
+    shard.addInstrument(spot);
+    shard.addInstrument(perp);
+    
+    PerpetualFairValueEngine pricer;
+    ASSERT_EQ(pricer.addInstruments(shard.getInstruments()), 1u);
+    ASSERT_EQ(pricer.registerDependencies(shard.getDependencyGraph()), 1u);
+    shard.addEventHandler([&pricer](StrategyShard&, const MarketEvent& event) {
+        pricer.onMarketEvent(event, getEngineTimestamp());
+    });
+    
+    std::vector<MarketEvent> batch;
+    for (int i = 0; i < 5; ++i) {
+        batch.push_back(makeBookEvent(spot.id, 100.0 + i, 101.0 + i));
+        batch.push_back(makeBookEvent(perp.id, 102.0 + i, 103.0 + i));
+    }
+    shard.processBatch(batch);
+    
+    const auto& graph = shard.getDependencyGraph();
+    EXPECT_EQ(graph.getRecomputeCount(), 1u);
+    EXPECT_EQ(graph.getCoalescedCount(), 9u);
+    EXPECT_NEAR(pricer.getBasisSpread(0), 106.5 - 104.5, 1e-9);  // Zero funding: fair = spot
+    
+    // Outside a batch every event flushes on its own
+    shard.processEvent(makeBookEvent(spot.id, 200.0, 201.0));
+    EXPECT_EQ(graph.getRecomputeCount(), 2u);
+    EXPECT_NEAR(pricer.getFairValue(0), 200.5, 1e-9);
+}
+
+} // namespace arbitrage
@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include "depth_sizer.hpp"
+#include "strategy_shard.hpp"
+
+namespace arbitrage {
+
+namespace {
+
+OrderBook makeBook(const InstrumentId& instrument_id, std::vector<std::pair<Price, Volume>> bids,
+                   std::vector<std::pair<Price, Volume>> asks) {
+    OrderBook book;
+    book.instrument_id = instrument_id;
+    for (const auto& [price, volume] : bids) {
+        book.bids.emplace_back(price, volume, Timestamp());
+    }
+    for (const auto& [price, volume] : asks) {
+        book.asks.emplace_back(price, volume, Timestamp());
+    }
+    return book;
+}
+
+// Buy spot through the asks, sell the perp into the bids
+const OrderBook kSpot = makeBook("BTC/USDT_SPOT", {{99.0, 10.0}}, {{100.0, 1.0}, {100.5, 2.0}, {101.0, 5.0}});
+const OrderBook kPerp = makeBook("BTC-PERPETUAL_PERPETUAL_SWAP", {{101.0, 1.5}, {100.8, 1.0}, {100.6, 5.0}},
+                                 {{102.0, 10.0}});
+
+} // namespace
+
+TEST(DepthSizerTest, WalksBooksUntilMarginalEdgeFails) {
+    DepthSizer sizer;
+    SizingLeg legs[2];
+    legs[0].book = &kSpot;
+    legs[0].side = OrderSide::BUY;
+    legs[1].book = &kPerp;
+    legs[1].side = OrderSide::SELL;
+    
+    SizingResult result;
+    ASSERT_TRUE(sizer.size(legs, 2, result));
+    // Segments: 1 @ (100, 101), 0.5 @ (100.5, 101), 1 @ (100.5, 100.8); the
+    // next, (100.5, 100.6), earns 0.1 / 100.5 < 0.1%
+    EXPECT_DOUBLE_EQ(result.size, 2.5);
+    EXPECT_DOUBLE_EQ(result.cost, 250.75);
+    EXPECT_NEAR(result.profit, 1.55, 1e-12);
+    EXPECT_FALSE(result.capped);
+    
+    const auto& curve = sizer.getCurve();
+    ASSERT_EQ(curve.size(), 3u);
+    EXPECT_DOUBLE_EQ(curve[0].size, 1.0);
+    EXPECT_DOUBLE_EQ(curve[0].marginal_edge, 0.01);
+    EXPECT_DOUBLE_EQ(curve[1].size, 1.5);
+    EXPECT_NEAR(curve[1].profit, 1.25, 1e-12);
+    EXPECT_NEAR(curve[2].marginal_edge, 0.3 / 100.5, 1e-15);
+    EXPECT_DOUBLE_EQ(sizer.getAveragePrice(0), 100.3);
+    EXPECT_DOUBLE_EQ(sizer.getAveragePrice(1), 100.92);
+    
+    // Nothing clears a 2% edge
+    DepthSizerConfig config;
+    config.min_profit = 0.02;
+    sizer.setConfig(config);
+    EXPECT_FALSE(sizer.size(legs, 2, result));
+    EXPECT_TRUE(sizer.getCurve().empty());
+}
+
+TEST(DepthSizerTest, PositionCapEndsInsideASegment) {
+    DepthSizerConfig config;
+    config.max_position_size = 200.0;
+    DepthSizer sizer(config);
+    SizingLeg legs[2];
+    legs[0].book = &kSpot;
+    legs[0].side = OrderSide::BUY;
+    legs[1].book = &kPerp;
+    legs[1].side = OrderSide::SELL;
+    
+    SizingResult result;
+    ASSERT_TRUE(sizer.size(legs, 2, result));
+    EXPECT_TRUE(result.capped);
+    EXPECT_DOUBLE_EQ(result.cost, 200.0);
+    double last = (200.0 - 150.25) / 100.5;
+    EXPECT_NEAR(result.size, 1.5 + last, 1e-12);
+    EXPECT_NEAR(result.profit, 1.25 + 0.3 * last, 1e-12);
+    EXPECT_EQ(sizer.getCurve().size(), 3u);
+    
+    // A book that runs out ends the walk too
+    OrderBook thin = makeBook("BTC/USDT_SPOT", {}, {{100.0, 0.25}});
+    legs[0].book = &thin;
+    ASSERT_TRUE(sizer.size(legs, 2, result));
+    EXPECT_DOUBLE_EQ(result.size, 0.25);
+    EXPECT_FALSE(result.capped);
+}
+
+TEST(DepthSizerTest, RejectsUnusableLegsAndKeepsCurveEnd) {
+    DepthSizerConfig config;
+    config.max_curve_points = 2;
+    DepthSizer sizer(config);
+    SizingLeg legs[DepthSizer::kMaxLegs + 1];
+    legs[0].book = &kSpot;
+    legs[0].side = OrderSide::BUY;
+    legs[1].book = &kPerp;
+    legs[1].side = OrderSide::SELL;
+    
+    // Out of curve room: the last point is overwritten so the end survives
+    SizingResult result;
+    ASSERT_TRUE(sizer.size(legs, 2, result));
+    EXPECT_DOUBLE_EQ(result.size, 2.5);
+    ASSERT_EQ(sizer.getCurve().size(), 2u);
+    EXPECT_DOUBLE_EQ(sizer.getCurve()[0].size, 1.0);
+    EXPECT_DOUBLE_EQ(sizer.getCurve()[1].size, result.size);
+    EXPECT_NEAR(sizer.getCurve()[1].profit, result.profit, 1e-12);
+    
+    EXPECT_FALSE(sizer.size(legs, 0, result));
+    EXPECT_FALSE(sizer.size(legs, DepthSizer::kMaxLegs + 1, result));
+    
+    legs[1].ratio = 0.0;
+    EXPECT_FALSE(sizer.size(legs, 2, result));
+    EXPECT_DOUBLE_EQ(result.size, 0.0);
+    EXPECT_TRUE(sizer.getCurve().empty());
+    
+    legs[1].ratio = 1.0;
+    legs[1].book = nullptr;
+    EXPECT_FALSE(sizer.size(legs, 2, result));
+    
+    // No bids to sell into: not even a first segment
+    OrderBook empty = makeBook("BTC-PERPETUAL_PERPETUAL_SWAP", {}, {{102.0, 10.0}});
+    legs[1].book = &empty;
+    EXPECT_FALSE(sizer.size(legs, 2, result));
+}
+
+TEST(DepthSizerTest, ShardSizesOpportunityOnLocalBooks) {
+    StrategyShard shard(0, nullptr);
+    for (const OrderBook* book : {&kSpot, &kPerp}) {
+        MarketEvent event;
+        event.type = MarketEventType::BOOK_UPDATE;
+        event.instrument_id = book->instrument_id;
+        event.book = *book;
+        shard.processEvent(event);
+    }
+    
+    // Detector sized 2 perp contracts per spot unit from the top of book
+    ArbitrageOpportunity opportunity;
+    opportunity.leg_instruments = {kSpot.instrument_id, kPerp.instrument_id};
+    opportunity.leg_sides = {OrderSide::BUY, OrderSide::SELL};
+    opportunity.leg_volumes = {0.5, 1.0};
+    opportunity.expected_profit = 123.0;
+    ASSERT_TRUE(shard.sizeOpportunity(opportunity));
+    
+    // At two contracts per unit every segment clears the edge, so the walk
+    // ends where the perp bids run out: 7.5 contracts against 3.75 spot
+    EXPECT_DOUBLE_EQ(opportunity.leg_volumes[0], 3.75);
+    EXPECT_DOUBLE_EQ(opportunity.leg_volumes[1], 7.5);
+    double cost = 100.0 + 2.0 * 100.5 + 0.75 * 101.0;
+    double proceeds = 1.5 * 101.0 + 100.8 + 5.0 * 100.6;
+    EXPECT_NEAR(opportunity.expected_profit, proceeds - cost, 1e-9);
+    EXPECT_NEAR(opportunity.expected_profit_percentage, (proceeds - cost) / cost, 1e-12);
+    EXPECT_NEAR(opportunity.leg_prices[0], cost / 3.75, 1e-12);
+    
+    // A leg whose book is not on this shard
+    ArbitrageOpportunity remote = opportunity;
+    remote.leg_instruments[1] = "ETH-PERPETUAL_PERPETUAL_SWAP";
+    EXPECT_FALSE(shard.sizeOpportunity(remote));
+    EXPECT_EQ(remote.leg_volumes, opportunity.leg_volumes);
+}
+
+} // namespace arbitrage
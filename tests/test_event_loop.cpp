@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include "event_loop.hpp"
+#include <atomic>
+#include <csignal>
+#include <pthread.h>
+#include <thread>
+
+namespace arbitrage {
+
+TEST(EventLoopTest, OneShotTimerFires) {
+    EventLoop loop;
+    ASSERT_TRUE(loop.isValid());
+    
+    int fired = 0;
+    loop.addTimer(std::chrono::milliseconds(1), std::chrono::nanoseconds(0), [&]() {
+        ++fired;
+        loop.stop();
+    });
+    
+    auto start = std::chrono::steady_clock::now();
+    loop.run();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    
+    EXPECT_EQ(fired, 1);
+    EXPECT_LT(elapsed, std::chrono::milliseconds(100));
+}
+
+TEST(EventLoopTest, PeriodicTimerAndRemove) {
+    EventLoop loop;
+    
+    int fired = 0;
+    EventLoop::SourceId timer_id = 0;
+    timer_id = loop.addTimer(std::chrono::milliseconds(1), std::chrono::milliseconds(1), [&]() {
+        if (++fired == 3) {
+            // Removing a source from its own callback is allowed
+            EXPECT_TRUE(loop.remove(timer_id));
+            loop.stop();
+        }
+    });
+    ASSERT_NE(timer_id, 0);
+    
+    loop.run();
+    EXPECT_EQ(fired, 3);
+    EXPECT_FALSE(loop.remove(timer_id));
+}
+
+TEST(EventLoopTest, WakeupFromAnotherThread) {
+    EventLoop loop;
+    
+    std::atomic<int> woken{0};
+    auto wakeup_id = loop.addWakeup([&]() {
+        ++woken;
+        loop.stop();
+    });
+    ASSERT_NE(wakeup_id, 0);
+    
+    std::thread notifier([&]() { loop.notify(wakeup_id); });
+    loop.run();
+    notifier.join();
+    
+    EXPECT_EQ(woken.load(), 1);
+}
+
+TEST(EventLoopTest, StopBeforeRunIsNotLost) {
+    EventLoop loop;
+    loop.stop();
+    loop.run();  // returns immediately
+    EXPECT_TRUE(loop.isStopRequested());
+}
+
+TEST(EventLoopTest, SignalDeliveredThroughSignalfd) {
+    ASSERT_TRUE(EventLoop::blockSignals({SIGUSR1}));
+    
+    EventLoop loop;
+    int received = 0;
+    ASSERT_NE(loop.addSignalHandler({SIGUSR1}, [&](int signal) {
+        received = signal;
+        loop.stop();
+    }), 0);
+    
+    // Thread-directed so it stays pending on this (blocking) thread
+    pthread_kill(pthread_self(), SIGUSR1);
+    loop.run();
+    
+    EXPECT_EQ(received, SIGUSR1);
+}
+
+} // namespace arbitrage
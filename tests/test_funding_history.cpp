@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include "funding_history.hpp"
+#include "strategy_shard.hpp"
+#include <cmath>
+#include <random>
+
+namespace arbitrage {
+
+namespace {
+
+const Timestamp kEpoch = Timestamp(std::chrono::hours(24 * 365 * 50));
+
+Timestamp fundingTime(int index) {
+    return kEpoch + std::chrono::hours(8) * index;
+}
+
+FundingStats bruteForce(const std::vector<double>& rates, size_t first, size_t last) {
+    FundingStats stats;
+    stats.count = last - first;
+    for (size_t i = first; i < last; ++i) {
+        stats.sum += rates[i];
+    }
+    stats.mean = stats.sum / stats.count;
+    double square = 0.0;
+    for (size_t i = first; i < last; ++i) {
+        square += (rates[i] - stats.mean) * (rates[i] - stats.mean);
+    }
+    stats.volatility = stats.count > 1 ? std::sqrt(square / (stats.count - 1)) : 0.0;
+    return stats;
+}
+
+} // namespace
+
+TEST(FundingHistoryTest, RollingStatisticsMatchRecomputationAcrossWrap) {
+    FundingHistoryConfig config;
+    config.capacity = 64;
+    config.rolling_window = 21;
+    config.ewma_alpha = 0.2;
+    FundingHistory history(config);
+    
+    std::mt19937_64 rng(3);
+    std::normal_distribution<double> noise(0.0, 0.00005);
+    std::vector<double> rates;
+    double ewma = 0.0;
+    for (int i = 0; i < 1000; ++i) {
+        double rate = 0.0001 + noise(rng);
+        ASSERT_TRUE(history.record(fundingTime(i), rate));
+        rates.push_back(rate);
+        ewma = i == 0 ? rate : ewma + 0.2 * (rate - ewma);
+        
+        size_t window = std::min<size_t>(rates.size(), 21);
+        FundingStats expected = bruteForce(rates, rates.size() - window, rates.size());
+        FundingStats rolling = history.getRollingStats();
+        ASSERT_EQ(rolling.count, expected.count);
+        ASSERT_NEAR(rolling.mean, expected.mean, 1e-16);
+        ASSERT_NEAR(rolling.volatility, expected.volatility, 1e-12);
+        ASSERT_NEAR(history.getEwma(), ewma, 1e-16);
+    }
+    EXPECT_EQ(history.size(), 64u);
+    EXPECT_EQ(history.getTotalRecorded(), 1000u);
+    EXPECT_EQ(history.getRate(0), rates[1000 - 64]);
+    EXPECT_EQ(history.getTime(63), fundingTime(999));
+    EXPECT_GT(history.getEwmaVolatility(), 0.0);
+    
+    // Out-of-order prints are rejected
+    EXPECT_FALSE(history.record(fundingTime(998), 0.5));
+    EXPECT_EQ(history.getLatestRate(), rates.back());
+}
+
+TEST(FundingHistoryTest, SameFundingTimeReplacesNewestPrint) {
+    FundingHistory history;
+    history.record(fundingTime(0), 0.0001);
+    history.record(fundingTime(1), 0.0002);
+    double ewma_before = history.getEwma();
+    
+    // Venue revises the rate for the pending settlement twice
+    history.record(fundingTime(2), 0.0009);
+    history.record(fundingTime(2), 0.0003);
+    EXPECT_EQ(history.size(), 3u);
+    EXPECT_EQ(history.getLatestRate(), 0.0003);
+    
+    FundingStats rolling = history.getRollingStats();
+    EXPECT_NEAR(rolling.mean, 0.0002, 1e-18);
+    EXPECT_NEAR(rolling.volatility, 0.0001, 1e-15);
+    EXPECT_NEAR(history.getEwma(), ewma_before + 0.1 * (0.0003 - ewma_before), 1e-18);
+}
+
+TEST(FundingHistoryTest, TimeRangeQueries) {
+    FundingHistoryConfig config;
+    config.capacity = 16;
+    FundingHistory history(config);
+    std::vector<double> rates;
+    for (int i = 0; i < 40; ++i) {
+        rates.push_back(0.0001 * (i % 7) - 0.0002);
+        history.record(fundingTime(i), rates.back());
+    }
+    
+    // Retained prints are 24..39
+    FundingStats stats = history.query(fundingTime(30), fundingTime(35));
+    FundingStats expected = bruteForce(rates, 30, 36);
+    EXPECT_EQ(stats.count, 6u);
+    EXPECT_NEAR(stats.sum, expected.sum, 1e-16);
+    EXPECT_NEAR(stats.volatility, expected.volatility, 1e-15);
+    
+    // Bounds between prints, and ranges clipped to what is retained
+    stats = history.query(fundingTime(30) - std::chrono::minutes(1), fundingTime(35) + std::chrono::minutes(1));
+    EXPECT_EQ(stats.count, 6u);
+    EXPECT_EQ(history.query(fundingTime(0), fundingTime(25)).count, 2u);
+    EXPECT_EQ(history.query(fundingTime(41), fundingTime(50)).count, 0u);
+    EXPECT_EQ(history.query(fundingTime(35), fundingTime(30)).count, 0u);
+}
+
+TEST(FundingHistoryTest, ShardRecordsSeriesPerVenue) {
+    StrategyShard shard(0, nullptr);
+    const char* venues[] = {"OKX", "BINANCE", "BYBIT"};
+    for (int i = 0; i < 3; ++i) {
+        for (int v = 0; v < 3; ++v) {
+            MarketEvent event;
+            event.type = MarketEventType::FUNDING_RATE;
+            event.instrument_id = "BTC-PERPETUAL_PERPETUAL_SWAP";
+            event.exchange_id = venues[v];
+            event.funding.instrument_id = event.instrument_id;
+            event.funding.exchange_id = event.exchange_id;
+            event.funding.current_rate = 0.0001 * (v + 1) + 0.00001 * i;
+            event.funding.funding_time = fundingTime(i);
+            event.funding.next_funding_time = fundingTime(i + 1);
+            shard.processEvent(event);
+        }
+    }
+    
+    const FundingHistoryStore& store = shard.getFundingHistory();
+    ASSERT_EQ(store.getVenueSeries("BTC-PERPETUAL_PERPETUAL_SWAP").size(), 3u);
+    const FundingHistory* bybit = store.get("BTC-PERPETUAL_PERPETUAL_SWAP", "BYBIT");
+    ASSERT_NE(bybit, nullptr);
+    EXPECT_EQ(bybit->size(), 3u);
+    EXPECT_NEAR(bybit->getRollingStats().mean, 0.00031, 1e-18);
+    EXPECT_EQ(store.get("BTC-PERPETUAL_PERPETUAL_SWAP", "DERIBIT"), nullptr);
+    EXPECT_TRUE(store.getVenueSeries("ETH-PERPETUAL_PERPETUAL_SWAP").empty());
+}
+
+} // namespace arbitrage
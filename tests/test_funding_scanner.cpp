@@ -0,0 +1,301 @@
+#include <gtest/gtest.h>
+#include "funding_scanner.hpp"
+#include "opportunity_merger.hpp"
+#include <cmath>
+
+namespace arbitrage {
+
+namespace {
+
+const Timestamp kStart = Timestamp(std::chrono::seconds(1700000000));
+const InstrumentId kBtcPerp = "BTC-PERPETUAL_PERPETUAL_SWAP";
+const InstrumentId kEthPerp = "ETH-PERPETUAL_PERPETUAL_SWAP";
+
+FundingRate makeFunding(const InstrumentId& perp_id, const ExchangeId& venue, double current, double predicted,
+                        Timestamp next_funding_time = Timestamp()) {
+    FundingRate funding;
+    funding.instrument_id = perp_id;
+    funding.exchange_id = venue;
+    funding.current_rate = current;
+    funding.predicted_rate = predicted;
+    funding.next_funding_time = next_funding_time;
+    funding.timestamp = kStart;
+    return funding;
+}
+
+} // namespace
+
+TEST(FundingScannerTest, CrossVenueSpreadReportsOnceAndReranks) {
+    FundingRateScanner scanner;
+    size_t btc = scanner.addPerpetual(kBtcPerp, "BTC");
+    size_t eth = scanner.addPerpetual(kEthPerp, "ETH");
+    EXPECT_EQ(scanner.addPerpetual(kBtcPerp, "BTC"), btc);
+    std::vector<ArbitrageOpportunity> out;
+    EXPECT_FALSE(scanner.onBasis(btc, 0.0, 39999.0, 40001.0, kStart, out));  // Only the quote is of use here
+    scanner.onBasis(eth, 0.0, 1999.5, 2000.5, kStart, out);
+    
+    // One venue alone has nothing to compare against
+    EXPECT_FALSE(scanner.onFundingRate(makeFunding(kBtcPerp, "OKX", 0.0001, 0.0001), kStart, out));
+    EXPECT_TRUE(std::isinf(scanner.getBestEdge(scanner.getGroup(btc))));
+    EXPECT_FALSE(scanner.onFundingRate(makeFunding("UNKNOWN", "OKX", 0.01, 0.01), kStart, out));
+    
+    // Bybit pays 4bp more: long OKX, short Bybit, less 0.5bp per leg to cross the book
+    ASSERT_TRUE(scanner.onFundingRate(makeFunding(kBtcPerp, "BYBIT", 0.0005, 0.0003), kStart, out));
+    ASSERT_EQ(out.size(), 1u);
+    const size_t group = scanner.getGroup(btc);
+    EXPECT_EQ(out[0].type, ArbitrageType::FUNDING_RATE_ARBITRAGE);
+    EXPECT_EQ(out[0].opportunity_id, "FUNDING:BTC:OKX:BYBIT");
+    EXPECT_EQ(out[0].leg_exchanges, (std::vector<Exchange>{Exchange::OKX, Exchange::BYBIT}));
+    EXPECT_EQ(out[0].leg_sides, (std::vector<OrderSide>{OrderSide::BUY, OrderSide::SELL}));
+    EXPECT_NEAR(out[0].expected_profit_percentage, 0.0003, 1e-15);
+    EXPECT_NEAR(out[0].expected_profit, 12.0, 1e-9);
+    EXPECT_EQ(out[0].expiry_time, kStart + std::chrono::seconds(1));
+    EXPECT_TRUE(scanner.isOpen(group));
+    
+    // A re-print keeping the same pair open is silent; a better pair reports
+    EXPECT_FALSE(scanner.onFundingRate(makeFunding(kBtcPerp, "BYBIT", 0.0006, 0.0003), kStart, out));
+    ASSERT_TRUE(scanner.onFundingRate(makeFunding(kBtcPerp, "BINANCE", -0.0002, 0.0), kStart, out));
+    EXPECT_EQ(out.back().opportunity_id, "FUNDING:BTC:BINANCE:BYBIT");
+    EXPECT_NEAR(scanner.getBestEdge(group), 0.0007, 1e-15);
+    EXPECT_EQ(scanner.getVenueCount(), 3u);
+    
+    // A predicted reversal takes Bybit out; Binance against OKX remains
+    EXPECT_TRUE(scanner.onFundingRate(makeFunding(kBtcPerp, "BYBIT", 0.0006, -0.0005), kStart, out));
+    EXPECT_EQ(scanner.getLongVenue(group), "BINANCE");
+    EXPECT_EQ(scanner.getShortVenue(group), "OKX");
+    EXPECT_NEAR(scanner.getBestEdge(group), 0.0002, 1e-15);
+    
+    // ETH outranks BTC once its spread is wider (after 10bp to cross its book);
+    // under the threshold it is not open
+    EXPECT_EQ(scanner.getRanking(), (std::vector<size_t>{group, scanner.getGroup(eth)}));
+    scanner.onFundingRate(makeFunding(kEthPerp, "OKX", 0.0, 0.0), kStart, out);
+    scanner.onFundingRate(makeFunding(kEthPerp, "BINANCE", 0.002, 0.002), kStart, out);
+    EXPECT_NEAR(scanner.getBestEdge(scanner.getGroup(eth)), 0.001, 1e-15);
+    EXPECT_EQ(scanner.getRanking().front(), scanner.getGroup(eth));
+    size_t before = out.size();
+    scanner.onFundingRate(makeFunding(kEthPerp, "BINANCE", 0.00005, 0.001), kStart, out);
+    EXPECT_FALSE(scanner.isOpen(scanner.getGroup(eth)));
+    EXPECT_EQ(scanner.getRanking().front(), group);
+    EXPECT_EQ(out.size(), before);
+}
+
+TEST(FundingScannerTest, BasisMovesRerankOnlyWhenRelevant) {
+    FundingRateScanner scanner;
+    std::vector<Instrument> instruments(3);
+    instruments[0].id = kBtcPerp;
+    instruments[0].type = InstrumentType::PERPETUAL_SWAP;
+    instruments[0].base_asset = "BTC";
+    instruments[1].id = "BTC-USDC-PERPETUAL_PERPETUAL_SWAP";
+    instruments[1].type = InstrumentType::PERPETUAL_SWAP;
+    instruments[1].base_asset = "BTC";
+    instruments[2].id = "BTC/USDT_SPOT";
+    instruments[2].type = InstrumentType::SPOT;
+    instruments[2].base_asset = "BTC";
+    ASSERT_EQ(scanner.addInstruments(instruments), 2u);
+    ASSERT_EQ(scanner.getGroupCount(), 1u);
+    size_t usdt, usdc;
+    ASSERT_TRUE(scanner.findPerpetual(kBtcPerp, usdt));
+    ASSERT_TRUE(scanner.findPerpetual("BTC-USDC-PERPETUAL_PERPETUAL_SWAP", usdc));
+    
+    // Different contracts cannot be paired until both bases are known
+    std::vector<ArbitrageOpportunity> out;
+    scanner.onFundingRate(makeFunding(kBtcPerp, "OKX", 0.0001, 0.0001), kStart, out);
+    scanner.onFundingRate(makeFunding("BTC-USDC-PERPETUAL_PERPETUAL_SWAP", "BINANCE", 0.0006, 0.0006), kStart, out);
+    EXPECT_TRUE(out.empty());
+    scanner.onBasis(usdt, 0.0001, 39999.0, 40000.0, kStart, out);
+    ASSERT_TRUE(scanner.onBasis(usdc, 0.0, 40010.0, 40011.0, kStart, out));
+    // 5bp spread less 1bp basis and a one-tick book on each leg
+    const double crossing = 1.0 / 39999.5 + 1.0 / 40010.5;
+    EXPECT_NEAR(scanner.getBestEdge(0), 0.0004 - crossing, 1e-15);
+    // Long leg bought at its ask, short leg sold at its bid
+    EXPECT_EQ(out[0].leg_prices, (std::vector<Price>{40000.0, 40010.0}));
+    
+    // Only moves of the basis or the quoted spread re-rank; a cheaper long leg costs nothing
+    uint64_t evaluations = scanner.getEvaluationCount();
+    EXPECT_FALSE(scanner.onBasis(usdc, 0.0, 40011.0, 40012.0, kStart, out));
+    EXPECT_EQ(scanner.getEvaluationCount(), evaluations);
+    scanner.onBasis(usdt, -0.0002, 39999.0, 40000.0, kStart, out);
+    EXPECT_EQ(scanner.getEvaluationCount(), evaluations + 1);
+    EXPECT_NEAR(scanner.getBestEdge(0), 0.0005 - (1.0 / 39999.5 + 1.0 / 40011.5), 1e-15);
+    
+    // A wider book costs more to cross
+    scanner.onBasis(usdc, 0.0, 40009.0, 40012.0, kStart, out);
+    EXPECT_EQ(scanner.getEvaluationCount(), evaluations + 2);
+    EXPECT_NEAR(scanner.getBestEdge(0), 0.0005 - (1.0 / 39999.5 + 3.0 / 40010.5), 1e-15);
+    
+    // A rich long leg eats the spread
+    scanner.onBasis(usdt, 0.0005, 39999.0, 40000.0, kStart, out);
+    EXPECT_FALSE(scanner.isOpen(0));
+    
+    // With one perp per underlying basis moves never re-rank
+    FundingRateScanner single;
+    size_t perp = single.addPerpetual(kEthPerp, "ETH");
+    single.onBasis(perp, 0.0, 1999.0, 2001.0, kStart, out);
+    single.onFundingRate(makeFunding(kEthPerp, "OKX", 0.0, 0.0), kStart, out);
+    single.onFundingRate(makeFunding(kEthPerp, "BYBIT", 0.003, 0.003), kStart, out);
+    EXPECT_TRUE(single.isOpen(0));
+    evaluations = single.getEvaluationCount();
+    EXPECT_FALSE(single.onBasis(perp, 0.01, 1999.0, 2001.0, kStart, out));
+    EXPECT_EQ(single.getEvaluationCount(), evaluations);
+    
+    // ...but its spread still prices the entry: crossing a 20bp book on both
+    // legs costs more than the 30bp funding spread
+    EXPECT_FALSE(single.onBasis(perp, 0.01, 1998.0, 2002.0, kStart, out));
+    EXPECT_EQ(single.getEvaluationCount(), evaluations + 1);
+    EXPECT_FALSE(single.isOpen(0));
+}
+
+TEST(FundingScannerTest, HistorySmoothsExpectedFunding) {
+    FundingHistoryStore history;
+    FundingRateScanner scanner, raw;
+    scanner.setFundingHistory(history);
+    size_t perp = scanner.addPerpetual(kBtcPerp, "BTC");
+    raw.addPerpetual(kBtcPerp, "BTC");
+    std::vector<ArbitrageOpportunity> out, raw_out;
+    scanner.onBasis(perp, 0.0, 39999.0, 40001.0, kStart, out);
+    raw.onBasis(perp, 0.0, 39999.0, 40001.0, kStart, raw_out);
+    
+    // Recorded before the scanner sees it, as the shard does
+    Timestamp settlement = kStart;
+    auto print = [&](const ExchangeId& venue, double rate) {
+        FundingRate funding = makeFunding(kBtcPerp, venue, rate, rate);
+        funding.funding_time = settlement;
+        history.record(funding);
+        raw.onFundingRate(funding, kStart, raw_out);
+        return scanner.onFundingRate(funding, kStart, out);
+    };
+    for (int window = 0; window < 5; ++window, settlement += std::chrono::hours(8)) {
+        print("OKX", 0.0001);
+        print("BYBIT", 0.0001);
+    }
+    
+    // One spiking print opens the spread on its face, not against a history
+    // of paying the same as OKX
+    EXPECT_FALSE(print("BYBIT", 0.0010));
+    EXPECT_TRUE(raw.isOpen(0));
+    EXPECT_FALSE(scanner.isOpen(0));
+    const FundingHistory* bybit = history.get(kBtcPerp, "BYBIT");
+    ASSERT_NE(bybit, nullptr);
+    EXPECT_NEAR(scanner.getBestEdge(0), bybit->getEwma() - 0.0001 - 0.5 * bybit->getEwmaVolatility() - 0.0001,
+                1e-15);
+    
+    // A spread paid window after window is reported
+    for (int window = 0; window < 30 && !scanner.isOpen(0); ++window) {
+        settlement += std::chrono::hours(8);
+        print("OKX", 0.0001);
+        print("BYBIT", 0.0010);
+    }
+    ASSERT_TRUE(scanner.isOpen(0));
+    ASSERT_EQ(out.size(), 1u);
+    EXPECT_EQ(out[0].opportunity_id, "FUNDING:BTC:OKX:BYBIT");
+    EXPECT_LT(out[0].expected_profit_percentage, raw.getBestEdge(0));
+}
+
+TEST(FundingScannerTest, SnapshotTimersReevaluateAheadOfFunding) {
+    FundingScannerConfig config;
+    config.lead_time = std::chrono::seconds(60);
+    FundingRateScanner scanner(config);
+    TimingWheel wheel(std::chrono::milliseconds(1), kStart);
+    std::vector<size_t> due;
+    scanner.setSnapshotTimers(wheel, [&due](size_t group) { due.push_back(group); });
+    size_t perp = scanner.addPerpetual(kBtcPerp, "BTC");
+    std::vector<ArbitrageOpportunity> out;
+    scanner.onBasis(perp, 0.0, 39999.0, 40001.0, kStart, out);
+    
+    const Timestamp okx_funding = kStart + std::chrono::hours(8);
+    const Timestamp bybit_funding = kStart + std::chrono::hours(1);
+    scanner.onFundingRate(makeFunding(kBtcPerp, "OKX", 0.0001, 0.0001, okx_funding), kStart, out);
+    scanner.onFundingRate(makeFunding(kBtcPerp, "BYBIT", 0.0005, 0.0005, kStart + std::chrono::minutes(30)), kStart,
+                          out);
+    ASSERT_EQ(out.size(), 1u);
+    
+    // A newer Bybit print moves its pending re-evaluation
+    scanner.onFundingRate(makeFunding(kBtcPerp, "BYBIT", 0.0005, 0.0005, bybit_funding), kStart, out);
+    EXPECT_EQ(wheel.size(), 2u);
+    wheel.advance(kStart + std::chrono::minutes(30));
+    EXPECT_TRUE(due.empty());
+    wheel.advance(bybit_funding - std::chrono::seconds(61));
+    EXPECT_TRUE(due.empty());
+    wheel.advance(bybit_funding - std::chrono::seconds(60));
+    ASSERT_EQ(due, std::vector<size_t>{0});
+    
+    // The re-evaluation reports the open spread again
+    ASSERT_TRUE(scanner.reevaluate(due[0], wheel.now(), out));
+    ASSERT_EQ(out.size(), 2u);
+    EXPECT_EQ(out[1].opportunity_id, out[0].opportunity_id);
+    EXPECT_EQ(out[1].detection_time, wheel.now());
+    EXPECT_FALSE(out[0].reannounce);
+    EXPECT_TRUE(out[1].reannounce);
+    EXPECT_EQ(scanner.getReportCount(), 2u);
+    
+    wheel.advance(okx_funding - std::chrono::seconds(60));
+    EXPECT_EQ(due.size(), 2u);
+    EXPECT_TRUE(wheel.empty());
+    
+    // Prints for snapshots already past schedule nothing
+    scanner.onFundingRate(makeFunding(kBtcPerp, "OKX", 0.0001, 0.0001, kStart), wheel.now(), out);
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(FundingScannerTest, UnquotedPerpsAreNotReported) {
+    FundingRateScanner scanner;
+    size_t perp = scanner.addPerpetual(kBtcPerp, "BTC");
+    std::vector<ArbitrageOpportunity> out;
+    
+    // The spread is open but there is no price to enter at
+    EXPECT_FALSE(scanner.onFundingRate(makeFunding(kBtcPerp, "OKX", 0.0001, 0.0001), kStart, out));
+    EXPECT_FALSE(scanner.onFundingRate(makeFunding(kBtcPerp, "BYBIT", 0.0005, 0.0005), kStart, out));
+    EXPECT_FALSE(scanner.isOpen(scanner.getGroup(perp)));
+    EXPECT_FALSE(scanner.onBasis(perp, 0.0, 0.0, 40001.0, kStart, out));  // One-sided book
+    EXPECT_TRUE(out.empty());
+    
+    // The first two-sided quote reports it, even with a single perp
+    ASSERT_TRUE(scanner.onBasis(perp, 0.0, 39999.0, 40001.0, kStart, out));
+    ASSERT_EQ(out.size(), 1u);
+    EXPECT_EQ(out[0].leg_prices, (std::vector<Price>{40001.0, 39999.0}));
+    EXPECT_GT(out[0].expected_profit, 0.0);
+}
+
+TEST(FundingScannerTest, MergedReportSurvivesTopsAndReannounces) {
+    FundingRateScanner scanner;
+    size_t perp = scanner.addPerpetual(kBtcPerp, "BTC");
+    std::vector<ArbitrageOpportunity> out;
+    scanner.onBasis(perp, 0.0, 39999.0, 40001.0, kStart, out);
+    scanner.onFundingRate(makeFunding(kBtcPerp, "OKX", 0.0001, 0.0001), kStart, out);
+    ASSERT_TRUE(scanner.onFundingRate(makeFunding(kBtcPerp, "BYBIT", 0.0005, 0.0005), kStart, out));
+    
+    OpportunityMerger merger;
+    size_t published = 0;
+    merger.setOpportunityCallback([&published](const ArbitrageOpportunity&) { ++published; });
+    TopOfBook top;
+    top.instrument_id = kBtcPerp;
+    top.bid_price = 39999.0;
+    top.ask_price = 40001.0;
+    merger.publishTopOfBook(top);
+    merger.processPending();
+    
+    // Legs priced at the touch stay valid while the book does not move through them
+    for (auto& opportunity : out) {
+        opportunity.expiry_time = getCurrentTimestamp() + std::chrono::seconds(10);
+    }
+    merger.publishOpportunities(out);
+    merger.processPending();
+    ASSERT_EQ(published, 1u);
+    merger.publishTopOfBook(top);
+    top.bid_price = 40000.0;
+    merger.publishTopOfBook(top);
+    merger.processPending();
+    EXPECT_EQ(merger.getOpportunitiesInvalidated(), 0u);
+    EXPECT_EQ(merger.getRanking().size(), 1u);
+    
+    // A snapshot re-report of the still-open record is published again
+    out.clear();
+    ASSERT_TRUE(scanner.reevaluate(scanner.getGroup(perp), kStart, out));
+    out[0].expiry_time = getCurrentTimestamp() + std::chrono::seconds(10);
+    merger.publishOpportunities(out);
+    merger.processPending();
+    EXPECT_EQ(published, 2u);
+    EXPECT_EQ(merger.getOpportunitiesUpdated(), 0u);
+}
+
+} // namespace arbitrage
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "futures_pricer.hpp"
+#include "test_helpers.hpp"
+#include <cmath>
+
+namespace arbitrage {
+
+namespace {
+
+const Timestamp kNow = Timestamp(std::chrono::seconds(1700000000));
+const double kYear = 365.0 * 24.0 * 3600.0;
+
+Timestamp inDays(int days) {
+    return kNow + std::chrono::hours(24 * days);
+}
+
+} // namespace
+
+class FuturesPricerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // A BTC curve on USDT carry and one ETH contract on USDC carry
+        pricer_.addFuture("BTC-1M", "BTC-SPOT", "USDT", inDays(30), kNow);
+        pricer_.addFuture("BTC-3M", "BTC-SPOT", "USDT", inDays(91), kNow);
+        pricer_.addFuture("BTC-6M", "BTC-SPOT", "USDT", inDays(182), kNow);
+        pricer_.addFuture("ETH-3M", "ETH-SPOT", "USDC", inDays(91), kNow);
+        pricer_.setRate("USDT", 0.05);
+        pricer_.setRate("USDC", 0.04);
+        pricer_.reprice(kNow);
+    }
+    
+    FuturesCarryPricer pricer_;
+};
+
+TEST_F(FuturesPricerTest, CostOfCarryFairValue) {
+    pricer_.onMarketEvent(makeBookEvent("BTC-SPOT", 39999.5, 40000.5, kNow), kNow);
+    pricer_.onMarketEvent(makeBookEvent("BTC-3M", 40599.5, 40600.5, kNow), kNow);
+    
+    size_t index;
+    ASSERT_TRUE(pricer_.findFuture("BTC-3M", index));
+    double t = 91 * 86400.0 / kYear;
+    EXPECT_NEAR(pricer_.getTimeToExpiry(index), t, 1e-12);
+    EXPECT_NEAR(pricer_.getDiscountFactor(index), std::exp(-0.05 * t), 1e-12);
+    
+    SyntheticPrice price;
+    ASSERT_TRUE(pricer_.getSyntheticPrice("BTC-3M", price));
+    EXPECT_NEAR(price.fair_value, 40000.0 * std::exp(0.05 * t), 1e-6);
+    EXPECT_NEAR(price.basis_spread, 40600.0 - price.fair_value, 1e-6);
+    EXPECT_NEAR(pricer_.getImpliedCarry(index), std::log(40600.0 / 40000.0) / t, 1e-12);
+    
+    EXPECT_FALSE(pricer_.getSyntheticPrice("BTC-1M", price));  // no futures book yet
+}
+
+TEST_F(FuturesPricerTest, RepricesOnlyChangedInputs) {
+    uint64_t before = pricer_.getRepriceCount();
+    
+    // A BTC spot tick touches the three BTC contracts, not ETH
+    pricer_.updateSpotPrice("BTC-SPOT", 40000.0);
+    EXPECT_EQ(pricer_.reprice(kNow), 3);
+    
+    // Unchanged input: nothing to do
+    pricer_.updateSpotPrice("BTC-SPOT", 40000.0);
+    EXPECT_EQ(pricer_.reprice(kNow), 0);
+    
+    // A USDC rate change touches only the ETH contract
+    pricer_.setRate("USDC", 0.045);
+    EXPECT_EQ(pricer_.reprice(kNow), 1);
+    
+    // Futures book ticks move the basis without a reprice
+    pricer_.onMarketEvent(makeBookEvent("BTC-1M", 40099.5, 40100.5, kNow), kNow);
+    EXPECT_EQ(pricer_.getRepriceCount() - before, 4);
+}
+
+TEST_F(FuturesPricerTest, RefreshTimerAdvancesExpiryTable) {
+    TimingWheel wheel(std::chrono::milliseconds(1), kNow);
+    pricer_.startRefreshTimer(wheel);
+    pricer_.updateSpotPrice("BTC-SPOT", 40000.0);
+    pricer_.reprice(kNow);
+    
+    size_t index;
+    ASSERT_TRUE(pricer_.findFuture("BTC-1M", index));
+    double fair_before = pricer_.getFairValue(index);
+    
+    wheel.advance(kNow + std::chrono::milliseconds(999));
+    EXPECT_EQ(pricer_.getRefreshCount(), 0);
+    wheel.advance(kNow + std::chrono::seconds(10));
+    EXPECT_EQ(pricer_.getRefreshCount(), 10);
+    EXPECT_NEAR(pricer_.getTimeToExpiry(index), (30 * 86400.0 - 10.0) / kYear, 1e-12);
+    EXPECT_LT(pricer_.getFairValue(index), fair_before);
+    
+    // At expiry the contract converges onto spot
+    MarketEvent expiry;
+    expiry.type = MarketEventType::INSTRUMENT_EXPIRY;
+    expiry.instrument_id = "BTC-1M";
+    EXPECT_TRUE(pricer_.onMarketEvent(expiry, inDays(30)));
+    EXPECT_DOUBLE_EQ(pricer_.getFairValue(index), 40000.0);
+}
+
+} // namespace arbitrage
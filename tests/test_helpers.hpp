@@ -0,0 +1,70 @@
+#pragma once
+
+#include "types.hpp"
+#include <string>
+
+namespace arbitrage {
+
+// Shared factories for the unit tests. Files that need a differently shaped
+// fixture (replay ticks, log-price tops, canned opportunities) keep those local.
+
+// Instrument quoted in USDT, keyed symbol_TYPE as ConfigManager keys configured
+// instruments. Given an exchange, the id also gains an exchange segment so a
+// test can list one symbol on several venues; configured instruments carry no
+// exchange, so this keying is test-only.
+inline Instrument makeInstrument(const std::string& symbol, const std::string& base, InstrumentType type,
+                                 Exchange exchange = Exchange::UNKNOWN) {
+    Instrument instrument;
+    instrument.symbol = symbol;
+    instrument.base_asset = base;
+    instrument.quote_asset = "USDT";
+    instrument.type = type;
+    instrument.exchange = exchange;
+    instrument.is_active = true;
+    instrument.tick_size = 0.01;
+    instrument.id = exchange == Exchange::UNKNOWN
+        ? symbol + "_" + instrumentTypeToString(type)
+        : symbol + "_" + exchangeToString(exchange) + "_" + instrumentTypeToString(type);
+    return instrument;
+}
+
+// Spot pair keyed the way the detectors see it, e.g. "ETH/BTC_SPOT"
+inline Instrument makeSpot(const std::string& base, const std::string& quote,
+                           Exchange exchange = Exchange::BINANCE) {
+    Instrument instrument;
+    instrument.symbol = base + "/" + quote;
+    instrument.id = instrument.symbol + "_SPOT";
+    instrument.base_asset = base;
+    instrument.quote_asset = quote;
+    instrument.type = InstrumentType::SPOT;
+    instrument.exchange = exchange;
+    instrument.is_active = true;
+    return instrument;
+}
+
+inline TopOfBook makeTop(const InstrumentId& instrument_id, Price bid, Price ask, Volume volume = 1.0) {
+    TopOfBook top;
+    top.instrument_id = instrument_id;
+    top.bid_price = bid;
+    top.ask_price = ask;
+    top.bid_volume = volume;
+    top.ask_volume = volume;
+    return top;
+}
+
+// One-level book update; levels are stamped with the exchange time when one is
+// given, otherwise with the wall clock
+inline MarketEvent makeBookEvent(const InstrumentId& instrument_id, Price bid, Price ask,
+                                 Timestamp exchange_time = Timestamp{}, Timestamp receive_time = Timestamp{}) {
+    MarketEvent event;
+    event.type = MarketEventType::BOOK_UPDATE;
+    event.instrument_id = instrument_id;
+    event.exchange_time = exchange_time;
+    event.receive_time = receive_time;
+    const Timestamp stamp = exchange_time == Timestamp{} ? getCurrentTimestamp() : exchange_time;
+    event.book.bids.push_back({bid, 1.0, stamp});
+    event.book.asks.push_back({ask, 1.0, stamp});
+    return event;
+}
+
+} // namespace arbitrage
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include "implied_vol.hpp"
+#include <cmath>
+#include <random>
+
+namespace arbitrage {
+
+namespace {
+
+// Random chain priced at known vols; market_price holds the model price
+OptionBatch makeQuotedChain(size_t count, std::vector<double>& true_vols, double spot = 40000.0) {
+    std::mt19937_64 rng(5);
+    std::uniform_real_distribution<double> log_moneyness(-1.0, 1.0);
+    std::uniform_real_distribution<double> years(1.0 / 365.0, 2.0);
+    std::uniform_real_distribution<double> vol(0.05, 2.0);
+    
+    OptionBatch batch;
+    true_vols.clear();
+    for (size_t i = 0; i < count; ++i) {
+        true_vols.push_back(vol(rng));
+        batch.add(spot, spot * std::exp(log_moneyness(rng)), years(rng), true_vols.back(), 0.05, 0.01, i % 2 == 0);
+    }
+    BlackScholesPricer::priceReference(batch);
+    batch.market_price = batch.price;
+    return batch;
+}
+
+} // namespace
+
+TEST(ImpliedVolTest, RecoversVolatilityAcrossChain) {
+    std::vector<double> true_vols;
+    OptionBatch batch = makeQuotedChain(4001, true_vols);
+    OptionBatch reference = batch;
+    
+    ImpliedVolSolver solver;
+    ImpliedVolStats stats = solver.solve(batch);
+    ImpliedVolStats reference_stats = solver.solveReference(reference);
+    
+    EXPECT_EQ(stats.options, 4001u);
+    EXPECT_EQ(stats.unconverged, 0u);
+    EXPECT_EQ(stats.converged + stats.out_of_bounds, stats.options);
+    EXPECT_LT(stats.out_of_bounds, 200u);  // Far ITM quotes with no time value left
+    EXPECT_LT(stats.averageIterations(), 5.0);
+    EXPECT_EQ(reference_stats.unconverged, 0u);
+    
+    for (size_t i = 0; i < batch.size(); ++i) {
+        // Vol is only identified where the price responds to it
+        if (std::isnan(batch.volatility[i]) || batch.vega[i] < 1e-3) {
+            continue;
+        }
+        EXPECT_NEAR(batch.volatility[i], true_vols[i], 1e-8) << i;
+        EXPECT_NEAR(batch.volatility[i], reference.volatility[i], 1e-8) << i;
+    }
+    
+    EXPECT_EQ(solver.getStats().batches, 2u);
+    EXPECT_EQ(solver.getStats().options, 8002u);
+}
+
+TEST(ImpliedVolTest, QuotesOutsideBoundsReportNaN) {
+    OptionBatch batch;
+    batch.add(100.0, 90.0, 0.5, 0.5, 0.0, 0.0, true);
+    batch.market_price[0] = 5.0;    // Below intrinsic
+    batch.add(100.0, 110.0, 0.5, 0.5, 0.0, 0.0, true);
+    batch.market_price[1] = 120.0;  // Above spot
+    batch.add(100.0, 110.0, 0.5, 0.5, 0.0, 0.0, false);
+    batch.market_price[2] = 12.0;   // Valid put
+    
+    ImpliedVolSolver solver;
+    ImpliedVolStats stats = solver.solve(batch);
+    
+    EXPECT_TRUE(std::isnan(batch.volatility[0]));
+    EXPECT_TRUE(std::isnan(batch.volatility[1]));
+    EXPECT_TRUE(std::isfinite(batch.volatility[2]));
+    EXPECT_EQ(stats.out_of_bounds, 2u);
+    EXPECT_EQ(stats.converged, 1u);
+    
+    // Padding lanes keep their benign inputs for the pricing kernels
+    for (size_t i = batch.size(); i < batch.paddedSize(); ++i) {
+        EXPECT_EQ(batch.volatility[i], 0.5);
+    }
+}
+
+TEST(ImpliedVolTest, WarmStartAfterUnderlyingTick) {
+    std::vector<double> true_vols;
+    OptionBatch batch = makeQuotedChain(1024, true_vols);
+    ImpliedVolSolver solver;
+    ImpliedVolStats cold = solver.solve(batch);
+    
+    // Underlying moves 5bp and quotes reprice at unchanged vols
+    OptionBatch ticked = makeQuotedChain(1024, true_vols, 40020.0);
+    ticked.volatility = batch.volatility;
+    ImpliedVolStats warm = solver.solve(ticked, true);
+    
+    EXPECT_EQ(warm.unconverged, 0u);
+    EXPECT_LT(warm.iterations, cold.iterations);
+    for (size_t i = 0; i < ticked.size(); ++i) {
+        if (std::isnan(ticked.volatility[i]) || ticked.vega[i] < 1e-3) {
+            continue;
+        }
+        EXPECT_NEAR(ticked.volatility[i], true_vols[i], 1e-8) << i;
+    }
+}
+
+} // namespace arbitrage
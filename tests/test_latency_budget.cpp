@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+#include "latency_budget.hpp"
+#include "strategy_shard.hpp"
+#include "opportunity_merger.hpp"
+#include "performance_monitor.hpp"
+#include "engine_clock.hpp"
+#include "test_helpers.hpp"
+#include <algorithm>
+
+namespace arbitrage {
+
+namespace {
+
+const Timestamp kStart = Timestamp(std::chrono::seconds(1700000000));
+const InstrumentId kSpot = "BTC/USDT_SPOT";
+const InstrumentId kPerp = "BTC-PERPETUAL_PERPETUAL_SWAP";
+
+ArbitrageOpportunity makeBasis() {
+    ArbitrageOpportunity opportunity;
+    opportunity.opportunity_id = "BASIS";
+    opportunity.type = ArbitrageType::BASIS_SPREAD_ARBITRAGE;
+    opportunity.leg_instruments = {kSpot, kPerp};
+    opportunity.leg_exchanges = {Exchange::OKX, Exchange::BYBIT};
+    opportunity.leg_sides = {OrderSide::BUY, OrderSide::SELL};
+    opportunity.leg_prices = {40000.0, 40040.0};
+    opportunity.leg_volumes = {1.0, 1.0};
+    return opportunity;
+}
+
+} // namespace
+
+TEST(LatencyBudgetTest, StampsOldestInputAndRejectsOverBudget) {
+    LatencyBudgetConfig config;
+    config.max_age = std::chrono::milliseconds(10);
+    LatencyBudget budget(config);
+    auto& monitor = PerformanceMonitor::getInstance();
+    const uint64_t okx = monitor.getStaleRejections(Exchange::OKX, DetectionStage::SHARD);
+    const uint64_t bybit = monitor.getStaleRejections(Exchange::BYBIT, DetectionStage::SHARD);
+    
+    // Ages are taken per clock from whichever leg is oldest by it
+    ArbitrageOpportunity opportunity = makeBasis();
+    InputTimes legs[2] = {{kStart - std::chrono::milliseconds(8), kStart - std::chrono::milliseconds(2)},
+                          {kStart - std::chrono::milliseconds(5), kStart - std::chrono::milliseconds(4)}};
+    EXPECT_TRUE(budget.admit(opportunity, legs, 2, DetectionStage::SHARD, kStart));
+    EXPECT_EQ(opportunity.exchange_age, std::chrono::milliseconds(8));
+    EXPECT_EQ(opportunity.receive_age, std::chrono::milliseconds(4));
+    
+    // Unknown times do not count; a venue clock ahead of ours is not negative age
+    InputTimes partial[2] = {{Timestamp(), kStart - std::chrono::milliseconds(1)},
+                             {kStart + std::chrono::milliseconds(3), Timestamp()}};
+    EXPECT_TRUE(budget.admit(opportunity, partial, 2, DetectionStage::SHARD, kStart));
+    EXPECT_EQ(opportunity.exchange_age, std::chrono::nanoseconds(0));
+    EXPECT_EQ(opportunity.receive_age, std::chrono::milliseconds(1));
+    
+    // Over budget by either clock rejects, charged to the oldest leg's venue
+    legs[1].receive_time = kStart - std::chrono::milliseconds(11);
+    EXPECT_FALSE(budget.admit(opportunity, legs, 2, DetectionStage::SHARD, kStart));
+    EXPECT_EQ(opportunity.receive_age, std::chrono::milliseconds(11));
+    legs[1].receive_time = kStart;
+    legs[0].exchange_time = kStart - std::chrono::milliseconds(20);
+    EXPECT_FALSE(budget.admit(opportunity, legs, 2, DetectionStage::SHARD, kStart));
+    EXPECT_EQ(monitor.getStaleRejections(Exchange::BYBIT, DetectionStage::SHARD), bybit + 1);
+    EXPECT_EQ(monitor.getStaleRejections(Exchange::OKX, DetectionStage::SHARD), okx + 1);
+    EXPECT_EQ(budget.getAdmittedCount(), 2u);
+    EXPECT_EQ(budget.getRejectedCount(), 2u);
+    
+    // A zero budget only stamps
+    config.max_age = std::chrono::milliseconds(0);
+    budget.setConfig(config);
+    EXPECT_TRUE(budget.admit(opportunity, legs, 2, DetectionStage::SHARD, kStart));
+    EXPECT_EQ(opportunity.exchange_age, std::chrono::milliseconds(20));
+}
+
+TEST(LatencyBudgetTest, BudgetBoundaryAndUnattributedRejections) {
+    LatencyBudget budget;
+    auto& monitor = PerformanceMonitor::getInstance();
+    const uint64_t unknown = monitor.getStaleRejections(Exchange::UNKNOWN, DetectionStage::MERGER);
+    const uint64_t okx_shard = monitor.getStaleRejections(Exchange::OKX, DetectionStage::SHARD);
+    
+    // Exactly at the budget is still in it
+    ArbitrageOpportunity opportunity = makeBasis();
+    InputTimes legs[2] = {{kStart - std::chrono::milliseconds(10), kStart - std::chrono::milliseconds(10)},
+                          {kStart, kStart}};
+    EXPECT_TRUE(budget.admit(opportunity, legs, 2, DetectionStage::MERGER, kStart));
+    EXPECT_EQ(opportunity.exchange_age, std::chrono::milliseconds(10));
+    
+    // No known input time at all: nothing to hold against it
+    InputTimes unset[2];
+    EXPECT_TRUE(budget.admit(opportunity, unset, 2, DetectionStage::MERGER, kStart));
+    EXPECT_EQ(opportunity.exchange_age, std::chrono::nanoseconds(0));
+    EXPECT_EQ(opportunity.receive_age, std::chrono::nanoseconds(0));
+    
+    // A candidate without venues is still rejected, charged to UNKNOWN at its stage
+    opportunity.leg_exchanges.clear();
+    legs[0].receive_time = kStart - std::chrono::milliseconds(11);
+    EXPECT_FALSE(budget.admit(opportunity, legs, 2, DetectionStage::MERGER, kStart));
+    EXPECT_EQ(monitor.getStaleRejections(Exchange::UNKNOWN, DetectionStage::MERGER), unknown + 1);
+    EXPECT_EQ(monitor.getStaleRejections(Exchange::OKX, DetectionStage::SHARD), okx_shard);
+    EXPECT_EQ(budget.getAdmittedCount(), 2u);
+    EXPECT_EQ(budget.getRejectedCount(), 1u);
+}
+
+TEST(LatencyBudgetTest, ShardDropsCandidatesOnStaleBooks) {
+    EngineClock::getInstance().useSimulatedTime(kStart);
+    {
+        OpportunityMerger merger;
+        StrategyShard shard(0, &merger);
+        LatencyBudgetConfig config;
+        config.max_age = std::chrono::milliseconds(10);
+        shard.getLatencyBudget().setConfig(config);
+        auto& monitor = PerformanceMonitor::getInstance();
+        const uint64_t bybit = monitor.getStaleRejections(Exchange::BYBIT, DetectionStage::SHARD);
+        
+        shard.processEvent(makeBookEvent(kSpot, 39999.0, 40000.0, kStart, kStart));
+        shard.processEvent(makeBookEvent(kPerp, 40040.0, 40041.0, kStart, kStart));
+        EngineClock::getInstance().advanceTo(kStart + std::chrono::milliseconds(4));
+        ArbitrageOpportunity fresh = makeBasis();
+        ASSERT_TRUE(shard.admitOpportunity(fresh));
+        shard.emitOpportunity(std::move(fresh));
+        
+        // The spot book keeps ticking; the perp feed goes quiet
+        EngineClock::getInstance().advanceTo(kStart + std::chrono::milliseconds(12));
+        shard.processEvent(makeBookEvent(kSpot, 39998.0, 39999.0, kStart + std::chrono::milliseconds(12),
+                                         kStart + std::chrono::milliseconds(12)));
+        ArbitrageOpportunity stale = makeBasis();
+        EXPECT_FALSE(shard.admitOpportunity(stale));
+        EXPECT_EQ(monitor.getStaleRejections(Exchange::BYBIT, DetectionStage::SHARD), bybit + 1);
+        
+        // A stale candidate is dropped before it is scored or its books walked
+        const ConfidenceScorer& scorer = shard.getConfidenceScorer();
+        const uint64_t scored = scorer.getAcceptedCount() + scorer.getRejectedCount();
+        EXPECT_FALSE(shard.emitSized(makeBasis()));
+        EXPECT_FALSE(shard.emitScored(makeBasis()));
+        EXPECT_EQ(scorer.getAcceptedCount() + scorer.getRejectedCount(), scored);
+        EXPECT_EQ(monitor.getStaleRejections(Exchange::BYBIT, DetectionStage::SHARD), bybit + 3);
+        
+        // Published opportunities carry their input ages
+        std::vector<ArbitrageOpportunity> published;
+        merger.setOpportunityCallback(
+            [&published](const ArbitrageOpportunity& opportunity) { published.push_back(opportunity); });
+        shard.advanceTimers(kStart + std::chrono::milliseconds(12));
+        merger.processPending();
+        ASSERT_EQ(published.size(), 1u);
+        EXPECT_EQ(published[0].receive_age, std::chrono::milliseconds(4));
+        
+        // An unchanged top is re-published once it is half the budget older,
+        // so the merger's copy stays fresh
+        TopOfBook top;
+        shard.processEvent(makeBookEvent(kSpot, 39998.0, 39999.0, kStart + std::chrono::milliseconds(14),
+                                         kStart + std::chrono::milliseconds(14)));
+        merger.processPending();
+        ASSERT_TRUE(merger.getTopOfBook(kSpot, top));
+        EXPECT_EQ(top.receive_time, kStart + std::chrono::milliseconds(12));
+        shard.processEvent(makeBookEvent(kSpot, 39998.0, 39999.0, kStart + std::chrono::milliseconds(17),
+                                         kStart + std::chrono::milliseconds(17)));
+        merger.processPending();
+        ASSERT_TRUE(merger.getTopOfBook(kSpot, top));
+        EXPECT_EQ(top.receive_time, kStart + std::chrono::milliseconds(17));
+        EXPECT_EQ(top.exchange_time, kStart + std::chrono::milliseconds(17));
+    }
+    EngineClock::getInstance().useRealTime();
+}
+
+TEST(LatencyBudgetTest, MergerRejectsCrossShardLegsFromStaleTops) {
+    EngineClock::getInstance().useSimulatedTime(kStart);
+    {
+        OpportunityMerger merger;
+        LatencyBudgetConfig config;
+        config.max_age = std::chrono::milliseconds(10);
+        merger.getLatencyBudget().setConfig(config);
+        // Re-checks the basis whenever the perp moves
+        merger.addCrossShardDetector([](const OpportunityMerger::TopOfBookTable& tops,
+                                        const std::vector<InstrumentId>& changed,
+                                        std::vector<ArbitrageOpportunity>& out) {
+            if (std::find(changed.begin(), changed.end(), kPerp) != changed.end() && tops.count(kSpot)) {
+                out.push_back(makeBasis());
+            }
+        });
+        std::vector<ArbitrageOpportunity> published;
+        merger.setOpportunityCallback(
+            [&published](const ArbitrageOpportunity& opportunity) { published.push_back(opportunity); });
+        auto& monitor = PerformanceMonitor::getInstance();
+        const uint64_t okx = monitor.getStaleRejections(Exchange::OKX, DetectionStage::MERGER);
+        
+        TopOfBook spot, perp;
+        spot.instrument_id = kSpot;
+        spot.exchange_time = spot.receive_time = kStart;
+        perp.instrument_id = kPerp;
+        perp.exchange_time = kStart + std::chrono::milliseconds(2);
+        perp.receive_time = kStart + std::chrono::milliseconds(3);
+        merger.publishTopOfBook(spot);
+        merger.publishTopOfBook(perp);
+        EngineClock::getInstance().advanceTo(kStart + std::chrono::milliseconds(5));
+        merger.processPending();
+        ASSERT_EQ(published.size(), 1u);
+        EXPECT_EQ(published[0].exchange_age, std::chrono::milliseconds(5));
+        EXPECT_EQ(merger.getCrossShardOpportunities(), 1u);
+        
+        // The perp moves; the spot top it would trade against is 15ms old
+        EngineClock::getInstance().advanceTo(kStart + std::chrono::milliseconds(15));
+        perp.receive_time = kStart + std::chrono::milliseconds(15);
+        merger.publishTopOfBook(perp);
+        merger.processPending();
+        EXPECT_EQ(published.size(), 1u);
+        EXPECT_EQ(merger.getCrossShardOpportunities(), 1u);
+        EXPECT_EQ(merger.getLatencyBudget().getRejectedCount(), 1u);
+        EXPECT_EQ(monitor.getStaleRejections(Exchange::OKX, DetectionStage::MERGER), okx + 1);
+    }
+    EngineClock::getInstance().useRealTime();
+}
+
+} // namespace arbitrage
@@ -0,0 +1,237 @@
+#include <gtest/gtest.h>
+#include "opportunity_dedup.hpp"
+#include "opportunity_merger.hpp"
+#include "engine_clock.hpp"
+#include "performance_monitor.hpp"
+#include "test_helpers.hpp"
+
+namespace arbitrage {
+
+namespace {
+
+const Timestamp kStart = Timestamp(std::chrono::seconds(1700000000));
+
+// Buy spot on OKX, sell the perp on Bybit
+ArbitrageOpportunity makeBasis(Price spot_ask, Price perp_bid, Timestamp now = kStart) {
+    ArbitrageOpportunity opportunity;
+    opportunity.opportunity_id = "BASIS";
+    opportunity.type = ArbitrageType::BASIS_SPREAD_ARBITRAGE;
+    opportunity.leg_instruments = {"BTC/USDT_SPOT", "BTC-PERPETUAL_PERPETUAL_SWAP"};
+    opportunity.leg_exchanges = {Exchange::OKX, Exchange::BYBIT};
+    opportunity.leg_sides = {OrderSide::BUY, OrderSide::SELL};
+    opportunity.leg_prices = {spot_ask, perp_bid};
+    opportunity.leg_volumes = {1.0, 1.0};
+    opportunity.expected_profit = perp_bid - spot_ask;
+    opportunity.expected_profit_percentage = (perp_bid - spot_ask) / spot_ask;
+    opportunity.detection_time = now;
+    opportunity.expiry_time = now + std::chrono::milliseconds(500);
+    return opportunity;
+}
+
+} // namespace
+
+TEST(OpportunityDedupTest, KeysCoverTypeAndLegsOnly) {
+    const uint64_t key = OpportunityDeduplicator::computeKey(makeBasis(40000.0, 40040.0));
+    EXPECT_NE(key, 0u);
+    
+    // Prices, sizes, ids and times do not change the key
+    ArbitrageOpportunity repriced = makeBasis(40010.0, 40100.0, kStart + std::chrono::seconds(5));
+    repriced.opportunity_id = "OTHER";
+    repriced.leg_volumes = {3.0, 3.0};
+    EXPECT_EQ(OpportunityDeduplicator::computeKey(repriced), key);
+    
+    // Type, side, venue and leg order do
+    ArbitrageOpportunity variant = makeBasis(40000.0, 40040.0);
+    variant.type = ArbitrageType::FUNDING_RATE_ARBITRAGE;
+    EXPECT_NE(OpportunityDeduplicator::computeKey(variant), key);
+    variant = makeBasis(40000.0, 40040.0);
+    variant.leg_sides = {OrderSide::SELL, OrderSide::BUY};
+    EXPECT_NE(OpportunityDeduplicator::computeKey(variant), key);
+    variant = makeBasis(40000.0, 40040.0);
+    variant.leg_exchanges[1] = Exchange::BINANCE;
+    EXPECT_NE(OpportunityDeduplicator::computeKey(variant), key);
+    variant = makeBasis(40000.0, 40040.0);
+    std::swap(variant.leg_instruments[0], variant.leg_instruments[1]);
+    EXPECT_NE(OpportunityDeduplicator::computeKey(variant), key);
+    
+    // Without legs or a lifetime there is nothing to track
+    OpportunityDeduplicator dedup;
+    ArbitrageOpportunity legless;
+    legless.expiry_time = kStart;
+    ArbitrageOpportunity untimed = makeBasis(40000.0, 40040.0);
+    untimed.expiry_time = Timestamp();
+    for (int repeat = 0; repeat < 3; ++repeat) {
+        EXPECT_EQ(dedup.offer(legless, kStart), DedupAction::EMIT);
+        EXPECT_EQ(dedup.offer(untimed, kStart), DedupAction::EMIT);
+    }
+    EXPECT_EQ(dedup.size(), 0u);
+    EXPECT_EQ(untimed.opportunity_key, 0u);
+}
+
+TEST(OpportunityDedupTest, HysteresisSuppressesRepeatsAndFlaps) {
+    DedupConfig config;
+    config.exit_ratio = 0.5;
+    config.reentry_ratio = 1.25;
+    config.rearm_interval = std::chrono::milliseconds(100);
+    config.initial_capacity = 16;
+    OpportunityDeduplicator dedup(config);
+    
+    // 10bp opens a record; repeats down to 5bp only refresh it
+    ArbitrageOpportunity opportunity = makeBasis(40000.0, 40040.0);
+    EXPECT_EQ(dedup.offer(opportunity, kStart), DedupAction::EMIT);
+    const uint64_t key = opportunity.opportunity_key;
+    EXPECT_EQ(key, OpportunityDeduplicator::computeKey(opportunity));
+    EXPECT_TRUE(dedup.isOpen(key));
+    Timestamp now = kStart;
+    for (Price bid : {40050.0, 40030.0, 40025.0}) {
+        now += std::chrono::milliseconds(1);
+        ArbitrageOpportunity repeat = makeBasis(40000.0, bid, now);
+        EXPECT_EQ(dedup.offer(repeat, now), DedupAction::UPDATE);
+    }
+    
+    // Under half the opening edge the record closes
+    now += std::chrono::milliseconds(1);
+    ArbitrageOpportunity weak = makeBasis(40000.0, 40016.0, now);
+    EXPECT_EQ(dedup.offer(weak, now), DedupAction::CLOSE);
+    EXPECT_FALSE(dedup.isOpen(key));
+    
+    // Flapping back within the rearm interval needs 1.25x the opening edge
+    ArbitrageOpportunity back = makeBasis(40000.0, 40045.0, now);
+    EXPECT_EQ(dedup.offer(back, now + std::chrono::milliseconds(50)), DedupAction::SUPPRESS);
+    EXPECT_EQ(dedup.offer(back, now + std::chrono::milliseconds(99)), DedupAction::SUPPRESS);
+    ArbitrageOpportunity strong = makeBasis(40000.0, 40060.0, now);
+    EXPECT_EQ(dedup.offer(strong, now + std::chrono::milliseconds(99)), DedupAction::EMIT);
+    
+    // A record closed from outside (expiry) rearms at any edge once the interval passed
+    EXPECT_TRUE(dedup.close(key, now + std::chrono::milliseconds(100)));
+    EXPECT_FALSE(dedup.close(key, now + std::chrono::milliseconds(100)));
+    EXPECT_EQ(dedup.offer(back, now + std::chrono::milliseconds(150)), DedupAction::SUPPRESS);
+    EXPECT_EQ(dedup.offer(back, now + std::chrono::milliseconds(200)), DedupAction::EMIT);
+    EXPECT_EQ(dedup.getEmitCount(), 3u);
+    EXPECT_EQ(dedup.getUpdateCount(), 3u);
+    EXPECT_EQ(dedup.getCloseCount(), 2u);
+    EXPECT_EQ(dedup.getSuppressCount(), 3u);
+    
+    // Many distinct keys grow the table; closed ones past rearm make room instead
+    now += std::chrono::seconds(1);
+    for (int i = 0; i < 100; ++i) {
+        ArbitrageOpportunity other = makeBasis(40000.0, 40040.0, now);
+        other.leg_instruments[1] = "PERP" + std::to_string(i);
+        ASSERT_EQ(dedup.offer(other, now), DedupAction::EMIT);
+        dedup.close(other.opportunity_key, now);
+    }
+    EXPECT_TRUE(dedup.isOpen(key));  // Still open after every rebuild
+    EXPECT_GE(dedup.capacity(), 2 * dedup.size());
+    const size_t grown = dedup.capacity();
+    now += std::chrono::seconds(1);
+    for (int i = 0; i < 1000; ++i) {
+        ArbitrageOpportunity other = makeBasis(40000.0, 40040.0, now);
+        other.leg_instruments[1] = "LATER" + std::to_string(i);
+        dedup.offer(other, now);
+        dedup.close(other.opportunity_key, now);
+        now += std::chrono::milliseconds(1);
+    }
+    EXPECT_LE(dedup.capacity(), 4 * grown);
+    EXPECT_TRUE(dedup.isOpen(key));
+}
+
+TEST(OpportunityDedupTest, ReannounceMovesTheBandAndPresetKeysStick) {
+    DedupConfig config;
+    config.rearm_interval = std::chrono::milliseconds(100);
+    OpportunityDeduplicator dedup(config);
+    
+    ArbitrageOpportunity opportunity = makeBasis(40000.0, 40040.0);
+    ASSERT_EQ(dedup.offer(opportunity, kStart), DedupAction::EMIT);
+    const uint64_t key = opportunity.opportunity_key;
+    
+    // A scheduled re-report at 4bp is published and reopens the record there,
+    // so 3bp is now a repeat rather than a fall through the 10bp band
+    Timestamp now = kStart + std::chrono::milliseconds(10);
+    ArbitrageOpportunity snapshot = makeBasis(40000.0, 40016.0, now);
+    snapshot.reannounce = true;
+    EXPECT_EQ(dedup.offer(snapshot, now), DedupAction::EMIT);
+    ArbitrageOpportunity repeat = makeBasis(40000.0, 40012.0, now);
+    EXPECT_EQ(dedup.offer(repeat, now), DedupAction::UPDATE);
+    ArbitrageOpportunity weak = makeBasis(40000.0, 40004.0, now);
+    EXPECT_EQ(dedup.offer(weak, now), DedupAction::CLOSE);
+    
+    // Suppressed flaps do not push the rearm point out
+    ArbitrageOpportunity back = makeBasis(40000.0, 40016.0, now);
+    EXPECT_EQ(dedup.offer(back, now + std::chrono::milliseconds(90)), DedupAction::SUPPRESS);
+    EXPECT_EQ(dedup.offer(back, now + std::chrono::milliseconds(100)), DedupAction::EMIT);
+    EXPECT_TRUE(dedup.isOpen(key));
+    
+    // A key set upstream is used as is
+    ArbitrageOpportunity keyed = makeBasis(40000.0, 40040.0);
+    keyed.leg_instruments[1] = "ETH-PERPETUAL_PERPETUAL_SWAP";
+    keyed.opportunity_key = 12345;
+    EXPECT_EQ(dedup.offer(keyed, now), DedupAction::EMIT);
+    EXPECT_EQ(keyed.opportunity_key, 12345u);
+    EXPECT_TRUE(dedup.isOpen(12345));
+    EXPECT_EQ(dedup.size(), 2u);
+    
+    dedup.clear();
+    EXPECT_EQ(dedup.size(), 0u);
+    EXPECT_FALSE(dedup.isOpen(key));
+    EXPECT_EQ(dedup.offer(repeat, now), DedupAction::EMIT);
+}
+
+TEST(OpportunityDedupTest, MergerPublishesEachRecordOnce) {
+    EngineClock::getInstance().useSimulatedTime(kStart);
+    {
+        OpportunityMerger merger;
+        std::vector<ArbitrageOpportunity> published;
+        merger.setOpportunityCallback(
+            [&published](const ArbitrageOpportunity& opportunity) { published.push_back(opportunity); });
+        std::vector<std::string> retired;
+        merger.setExpiryCallback([&retired](const std::string& opportunity_id) { retired.push_back(opportunity_id); });
+        
+        // A choppy detector reporting the same mispricing on every tick
+        auto& monitor = PerformanceMonitor::getInstance();
+        const uint64_t detected = monitor.getOpportunitiesDetected();
+        Timestamp now = kStart;
+        for (int tick = 0; tick < 50; ++tick) {
+            now += std::chrono::milliseconds(1);
+            EngineClock::getInstance().advanceTo(now);
+            std::vector<ArbitrageOpportunity> batch = {makeBasis(40000.0, 40040.0 + tick % 3, now)};
+            merger.publishOpportunities(batch);
+            merger.processPending();
+        }
+        ASSERT_EQ(published.size(), 1u);
+        EXPECT_NE(published[0].opportunity_key, 0u);
+        EXPECT_EQ(merger.getOpportunitiesUpdated(), 49u);
+        EXPECT_EQ(merger.getOpportunitiesMerged(), 50u);
+        EXPECT_EQ(monitor.getOpportunitiesDetected(), detected + 1);  // Repeats are not new detections
+        
+        // The record carries the latest repeat and its extended lifetime
+        ASSERT_EQ(merger.getRanking().size(), 1u);
+        EXPECT_EQ(merger.getRanking().getBest()->detection_time, now);
+        merger.advanceTimers(kStart + std::chrono::milliseconds(520));
+        EXPECT_TRUE(retired.empty());
+        
+        // A book moving through it ends the record; re-detecting it right away is a flap
+        merger.publishTopOfBook(makeTop("BTC/USDT_SPOT", 40001.0, 40002.0));
+        merger.processPending();
+        EXPECT_EQ(retired.size(), 1u);
+        std::vector<ArbitrageOpportunity> batch = {makeBasis(40002.0, 40040.0, now)};
+        merger.publishOpportunities(batch);
+        merger.processPending();
+        EXPECT_EQ(published.size(), 1u);
+        EXPECT_EQ(merger.getOpportunitiesSuppressed(), 1u);
+        EXPECT_EQ(monitor.getOpportunitiesDetected(), detected + 1);
+        EXPECT_TRUE(merger.getRanking().empty());
+        
+        // After the rearm interval it is a new opportunity
+        now += std::chrono::seconds(1);
+        EngineClock::getInstance().advanceTo(now);
+        batch = {makeBasis(40002.0, 40040.0, now)};
+        merger.publishOpportunities(batch);
+        merger.processPending();
+        EXPECT_EQ(published.size(), 2u);
+        EXPECT_EQ(merger.getRanking().size(), 1u);
+        EXPECT_EQ(monitor.getOpportunitiesDetected(), detected + 2);
+    }
+    EngineClock::getInstance().useRealTime();
+}
+
+} // namespace arbitrage
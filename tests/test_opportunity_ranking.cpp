@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include "opportunity_ranking.hpp"
+#include "opportunity_merger.hpp"
+#include <algorithm>
+#include <map>
+#include <random>
+
+namespace arbitrage {
+
+namespace {
+
+ArbitrageOpportunity makeOpportunity(const std::string& id, double profit, double risk = 0.0) {
+    ArbitrageOpportunity opportunity;
+    opportunity.opportunity_id = id;
+    opportunity.expected_profit = profit;
+    opportunity.risk_score = risk;
+    return opportunity;
+}
+
+std::vector<std::string> topIds(const OpportunityRanking& ranking) {
+    std::vector<std::string> ids;
+    for (const auto* opportunity : ranking.getTopK()) {
+        ids.push_back(opportunity->opportunity_id);
+    }
+    return ids;
+}
+
+} // namespace
+
+TEST(OpportunityRankingTest, ReScoresAcrossTheTopKBoundary) {
+    OpportunityRanking ranking(2);
+    EXPECT_FALSE(ranking.upsert(makeOpportunity("", 1.0)));
+    EXPECT_EQ(ranking.getBest(), nullptr);
+    
+    ASSERT_TRUE(ranking.upsert(makeOpportunity("A", 10.0)));
+    ASSERT_TRUE(ranking.upsert(makeOpportunity("B", 30.0, 0.5)));   // 15
+    ASSERT_TRUE(ranking.upsert(makeOpportunity("C", 20.0)));
+    ASSERT_TRUE(ranking.upsert(makeOpportunity("D", 50.0, 2.0)));   // Risk clamped: 0
+    EXPECT_EQ(ranking.size(), 4u);
+    EXPECT_EQ(topIds(ranking), (std::vector<std::string>{"C", "B"}));
+    
+    double score;
+    ASSERT_TRUE(ranking.getScore("B", score));
+    EXPECT_DOUBLE_EQ(score, 15.0);
+    
+    // Raised from outside the top tier
+    ASSERT_TRUE(ranking.upsert(makeOpportunity("A", 40.0)));
+    EXPECT_EQ(topIds(ranking), (std::vector<std::string>{"A", "C"}));
+    EXPECT_EQ(ranking.size(), 4u);
+    
+    // Lowered out of it
+    ASSERT_TRUE(ranking.updateScore("C", -1.0));
+    EXPECT_EQ(topIds(ranking), (std::vector<std::string>{"A", "B"}));
+    
+    // Removing a top entry promotes the best of the rest
+    ASSERT_TRUE(ranking.remove("A"));
+    EXPECT_FALSE(ranking.remove("A"));
+    EXPECT_FALSE(ranking.updateScore("A", 1.0));
+    EXPECT_FALSE(ranking.contains("A"));
+    EXPECT_EQ(topIds(ranking), (std::vector<std::string>{"B", "D"}));
+    EXPECT_EQ(ranking.getBest()->opportunity_id, "B");
+    
+    ranking.clear();
+    EXPECT_TRUE(ranking.empty());
+    EXPECT_TRUE(ranking.getTopK().empty());
+}
+
+TEST(OpportunityRankingTest, TopViewFollowsReorderAndSlotGrowth) {
+    OpportunityRanking zero(0);
+    EXPECT_EQ(zero.getTopKCapacity(), 1u);
+    
+    OpportunityRanking ranking(3);
+    ranking.upsert(makeOpportunity("A", 30.0));
+    ranking.upsert(makeOpportunity("B", 20.0));
+    ranking.upsert(makeOpportunity("C", 10.0));
+    EXPECT_EQ(topIds(ranking), (std::vector<std::string>{"A", "B", "C"}));
+    
+    // Re-ordering inside the top tier never crosses the boundary but must
+    // still re-sort the view
+    ASSERT_TRUE(ranking.updateScore("C", 40.0));
+    EXPECT_EQ(topIds(ranking), (std::vector<std::string>{"C", "A", "B"}));
+    
+    // Entries that only land below the boundary grow the slot table; the
+    // cached view must not keep pointing into the old storage
+    const auto& before = ranking.getTopK();
+    ASSERT_EQ(before.size(), 3u);
+    for (int i = 0; i < 64; ++i) {
+        ranking.upsert(makeOpportunity("LOW" + std::to_string(i), 1.0));
+    }
+    EXPECT_EQ(ranking.size(), 67u);
+    EXPECT_EQ(topIds(ranking), (std::vector<std::string>{"C", "A", "B"}));
+    EXPECT_DOUBLE_EQ(ranking.getBest()->expected_profit, 10.0);
+    
+    // A freed slot is reused without disturbing the ranking
+    ASSERT_TRUE(ranking.remove("LOW5"));
+    ranking.upsert(makeOpportunity("D", 25.0));
+    EXPECT_EQ(ranking.size(), 67u);
+    EXPECT_EQ(topIds(ranking), (std::vector<std::string>{"C", "A", "D"}));
+}
+
+TEST(OpportunityRankingTest, MatchesFullSortUnderRandomUpdates) {
+    const size_t k = 8;
+    OpportunityRanking ranking(k);
+    std::map<std::string, double> reference;
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> pick_id(0, 63);
+    std::uniform_int_distribution<int> pick_op(0, 9);
+    std::uniform_real_distribution<double> pick_profit(-100.0, 100.0);
+    
+    for (int step = 0; step < 5000; ++step) {
+        std::string id = "OPP" + std::to_string(pick_id(rng));
+        int op = pick_op(rng);
+        if (op < 2) {
+            EXPECT_EQ(ranking.remove(id), reference.erase(id) == 1);
+        } else if (op < 4) {
+            double score = pick_profit(rng);
+            bool known = reference.count(id) != 0;
+            EXPECT_EQ(ranking.updateScore(id, score), known);
+            if (known) {
+                reference[id] = score;
+            }
+        } else {
+            double profit = pick_profit(rng);
+            ranking.upsert(makeOpportunity(id, profit));
+            reference[id] = profit;
+        }
+        
+        if (step % 7 != 0) {
+            continue;
+        }
+        std::vector<double> expected;
+        for (const auto& entry : reference) {
+            expected.push_back(entry.second);
+        }
+        std::sort(expected.begin(), expected.end(), std::greater<double>());
+        expected.resize(std::min(expected.size(), k));
+        
+        const auto& top = ranking.getTopK();
+        ASSERT_EQ(top.size(), expected.size());
+        ASSERT_EQ(ranking.size(), reference.size());
+        for (size_t i = 0; i < top.size(); ++i) {
+            double score;
+            ASSERT_TRUE(ranking.getScore(top[i]->opportunity_id, score));
+            EXPECT_DOUBLE_EQ(score, expected[i]);
+        }
+    }
+}
+
+TEST(OpportunityRankingTest, MergerRanksUntilExpiry) {
+    OpportunityMerger merger;
+    Timestamp now = getCurrentTimestamp();
+    
+    std::vector<ArbitrageOpportunity> opportunities = {
+        makeOpportunity("SHORT", 5.0), makeOpportunity("LONG", 3.0), makeOpportunity("UNTIMED", 9.0)};
+    opportunities[0].expiry_time = now + std::chrono::milliseconds(10);
+    opportunities[1].expiry_time = now + std::chrono::milliseconds(100);
+    merger.publishOpportunities(opportunities);
+    merger.processPending();
+    
+    // Only opportunities with a lifetime are tracked
+    const auto& ranking = merger.getRanking();
+    EXPECT_EQ(ranking.size(), 2u);
+    EXPECT_EQ(ranking.getBest()->opportunity_id, "SHORT");
+    
+    merger.advanceTimers(now + std::chrono::milliseconds(50));
+    EXPECT_EQ(merger.getOpportunitiesExpired(), 1u);
+    ASSERT_EQ(ranking.size(), 1u);
+    EXPECT_EQ(ranking.getBest()->opportunity_id, "LONG");
+}
+
+} // namespace arbitrage
@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include "opportunity_store.hpp"
+#include "opportunity_merger.hpp"
+#include "test_helpers.hpp"
+#include <atomic>
+#include <thread>
+
+namespace arbitrage {
+
+namespace {
+
+// Buy the spot at its ask, sell the perp at its bid
+ArbitrageOpportunity makeBasis(const std::string& id, Price spot_ask, Price perp_bid) {
+    ArbitrageOpportunity opportunity;
+    opportunity.opportunity_id = id;
+    opportunity.leg_instruments = {"BTC/USDT_SPOT", "BTC-PERPETUAL_PERPETUAL_SWAP"};
+    opportunity.leg_sides = {OrderSide::BUY, OrderSide::SELL};
+    opportunity.leg_prices = {spot_ask, perp_bid};
+    opportunity.leg_volumes = {1.0, 1.0};
+    opportunity.expected_profit = perp_bid - spot_ask;
+    return opportunity;
+}
+
+} // namespace
+
+TEST(OpportunityStoreTest, BookMovesInvalidateOnlyDependents) {
+    OpportunityStore store(8);
+    std::vector<std::string> invalidated;
+    store.setInvalidationCallback([&invalidated](const ArbitrageOpportunity& opportunity) {
+        invalidated.push_back(opportunity.opportunity_id);
+    });
+    
+    OpportunityHandle tight = store.insert(makeBasis("TIGHT", 40000.0, 40010.0));
+    OpportunityHandle wide = store.insert(makeBasis("WIDE", 40005.0, 40010.0));
+    ArbitrageOpportunity other;
+    other.opportunity_id = "ETH";
+    other.leg_instruments = {"ETH/USDT_SPOT"};
+    other.leg_sides = {OrderSide::SELL};
+    other.leg_prices = {2000.0};
+    OpportunityHandle eth = store.insert(other);
+    ASSERT_FALSE(tight.isNull());
+    EXPECT_EQ(store.size(), 3u);
+    EXPECT_EQ(store.getDependentCount("BTC/USDT_SPOT"), 2u);
+    EXPECT_TRUE(store.get(tight)->is_active);
+    
+    // Spot ask still at or below both buy prices
+    EXPECT_EQ(store.onTopOfBook(makeTop("BTC/USDT_SPOT", 39999.0, 40000.0)), 0u);
+    // Ask moves through the tighter buy only
+    EXPECT_EQ(store.onTopOfBook(makeTop("BTC/USDT_SPOT", 40001.0, 40002.0)), 1u);
+    EXPECT_FALSE(store.isLive(tight));
+    EXPECT_EQ(store.get(tight), nullptr);
+    EXPECT_TRUE(store.isLive(wide));
+    EXPECT_TRUE(store.find("TIGHT").isNull());
+    EXPECT_EQ(store.getDependentCount("BTC/USDT_SPOT"), 1u);
+    EXPECT_EQ(store.getDependentCount("BTC-PERPETUAL_PERPETUAL_SWAP"), 1u);
+    
+    // Perp bid drops under the sell price; an empty side fails too
+    EXPECT_EQ(store.onTopOfBook(makeTop("BTC-PERPETUAL_PERPETUAL_SWAP", 40009.0, 40011.0)), 1u);
+    EXPECT_EQ(store.onTopOfBook(makeTop("ETH/USDT_SPOT", 0.0, 2001.0)), 1u);
+    EXPECT_FALSE(store.isLive(eth));
+    EXPECT_EQ(invalidated, (std::vector<std::string>{"TIGHT", "WIDE", "ETH"}));
+    EXPECT_EQ(store.getInvalidatedCount(), 3u);
+    EXPECT_EQ(store.size(), 0u);
+    EXPECT_EQ(store.getDependentCount("BTC/USDT_SPOT"), 0u);
+}
+
+TEST(OpportunityStoreTest, LegsSharingABookReleaseTogether) {
+    OpportunityStore store(4);
+    size_t callbacks = 0;
+    store.setInvalidationCallback([&callbacks](const ArbitrageOpportunity&) { ++callbacks; });
+    
+    // Two buy legs on the same book sit next to each other in its list
+    ArbitrageOpportunity ladder;
+    ladder.opportunity_id = "LADDER";
+    ladder.leg_instruments = {"ETH/USDT_SPOT", "ETH/USDT_SPOT"};
+    ladder.leg_sides = {OrderSide::BUY, OrderSide::BUY};
+    ladder.leg_prices = {2000.0, 2001.0};
+    OpportunityHandle first = store.insert(makeBasis("FIRST", 40000.0, 40010.0));
+    OpportunityHandle handle = store.insert(ladder);
+    OpportunityHandle last = store.insert(makeBasis("LAST", 40000.0, 40010.0));
+    ASSERT_FALSE(handle.isNull());
+    EXPECT_EQ(store.getDependentCount("ETH/USDT_SPOT"), 2u);
+    
+    // Books nothing depends on are ignored
+    EXPECT_EQ(store.onTopOfBook(makeTop("SOL/USDT_SPOT", 1.0, 1.1)), 0u);
+    
+    // Failing one leg releases the opportunity once and unlinks both nodes
+    EXPECT_EQ(store.onTopOfBook(makeTop("ETH/USDT_SPOT", 2000.0, 2000.5)), 1u);
+    EXPECT_EQ(callbacks, 1u);
+    EXPECT_FALSE(store.isLive(handle));
+    EXPECT_EQ(store.getDependentCount("ETH/USDT_SPOT"), 0u);
+    EXPECT_TRUE(store.isLive(first));
+    EXPECT_TRUE(store.isLive(last));
+    
+    // A replacement on other books moves its links with it
+    ArbitrageOpportunity moved = makeBasis("FIRST", 40000.0, 40010.0);
+    moved.leg_instruments = {"ETH/USDT_SPOT", "ETH-PERPETUAL_PERPETUAL_SWAP"};
+    store.insert(moved);
+    EXPECT_EQ(store.getDependentCount("BTC/USDT_SPOT"), 1u);
+    EXPECT_EQ(store.getDependentCount("ETH/USDT_SPOT"), 1u);
+    
+    // Explicit removal unlinks without the invalidation callback
+    ASSERT_TRUE(store.remove("LAST"));
+    EXPECT_FALSE(store.remove("LAST"));
+    EXPECT_EQ(store.getDependentCount("BTC/USDT_SPOT"), 0u);
+    EXPECT_EQ(callbacks, 1u);
+    EXPECT_EQ(store.getInvalidatedCount(), 1u);
+}
+
+TEST(OpportunityStoreTest, GenerationsDetectStaleHandles) {
+    OpportunityStore store(2);
+    OpportunityHandle first = store.insert(makeBasis("A", 40000.0, 40010.0));
+    ASSERT_TRUE(store.isLive(first));
+    
+    // Re-detection replaces the opportunity: the old handle goes stale
+    OpportunityHandle again = store.insert(makeBasis("A", 40001.0, 40010.0));
+    EXPECT_FALSE(store.isLive(first));
+    EXPECT_TRUE(store.isLive(again));
+    EXPECT_EQ(store.size(), 1u);
+    EXPECT_EQ(store.find("A").generation, again.generation);
+    EXPECT_DOUBLE_EQ(store.get(again)->leg_prices[0], 40001.0);
+    
+    // Reused slots get a new generation
+    ASSERT_TRUE(store.remove(again));
+    EXPECT_FALSE(store.remove(again));
+    OpportunityHandle reused = store.insert(makeBasis("B", 40000.0, 40010.0));
+    EXPECT_EQ(reused.slot, again.slot);
+    EXPECT_NE(reused.generation, again.generation);
+    EXPECT_FALSE(store.isLive(again));
+    
+    // Full, malformed and null handles
+    EXPECT_FALSE(store.insert(makeBasis("C", 1.0, 2.0)).isNull());
+    EXPECT_TRUE(store.insert(makeBasis("D", 1.0, 2.0)).isNull());
+    ArbitrageOpportunity malformed = makeBasis("E", 1.0, 2.0);
+    malformed.leg_prices.pop_back();
+    store.clear();
+    EXPECT_TRUE(store.insert(malformed).isNull());
+    EXPECT_FALSE(store.isLive(OpportunityHandle()));
+    
+    // Another thread sees the invalidation without a lock
+    OpportunityHandle watched = store.insert(makeBasis("W", 40000.0, 40010.0));
+    std::atomic<bool> seen_live{false};
+    std::thread watcher([&store, &seen_live, watched]() {
+        while (store.isLive(watched)) {
+            seen_live = true;
+        }
+    });
+    while (!seen_live) {
+        std::this_thread::yield();
+    }
+    store.onTopOfBook(makeTop("BTC/USDT_SPOT", 40001.0, 40002.0));
+    watcher.join();
+    EXPECT_FALSE(store.isLive(watched));
+}
+
+TEST(OpportunityStoreTest, MergerRetiresInvalidatedOpportunities) {
+    OpportunityMerger merger;
+    std::vector<std::string> retired;
+    merger.setExpiryCallback([&retired](const std::string& opportunity_id) { retired.push_back(opportunity_id); });
+    
+    Timestamp now = getCurrentTimestamp();
+    std::vector<ArbitrageOpportunity> opportunities = {makeBasis("BASIS", 40000.0, 40010.0)};
+    opportunities[0].expiry_time = now + std::chrono::milliseconds(100);
+    merger.publishOpportunities(opportunities);
+    merger.processPending();
+    ASSERT_EQ(merger.getRanking().size(), 1u);
+    EXPECT_EQ(merger.getOpportunityStore().size(), 1u);
+    
+    merger.publishTopOfBook(makeTop("BTC/USDT_SPOT", 40002.0, 40003.0));
+    merger.processPending();
+    EXPECT_EQ(merger.getOpportunitiesInvalidated(), 1u);
+    EXPECT_TRUE(merger.getRanking().empty());
+    EXPECT_EQ(retired, (std::vector<std::string>{"BASIS"}));
+    
+    // Its expiry timer went with it
+    merger.advanceTimers(now + std::chrono::milliseconds(200));
+    EXPECT_EQ(merger.getOpportunitiesExpired(), 0u);
+    EXPECT_EQ(retired.size(), 1u);
+}
+
+} // namespace arbitrage
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include "option_pricer.hpp"
+#include "simd_math.hpp"
+#include <cmath>
+#include <random>
+
+namespace arbitrage {
+
+namespace {
+
+// Evaluate a vector function on one value broadcast across all lanes
+template <typename Fn>
+double evalLanes(Fn fn, double x) {
+    double in[simd::kLanes];
+    double out[simd::kLanes];
+    std::fill(in, in + simd::kLanes, x);
+    fn(simd::VecD::load(in)).store(out);
+    return out[simd::kLanes - 1];
+}
+
+} // namespace
+
+TEST(SimdMathTest, ApproximationsWithinDocumentedBounds) {
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> exp_domain(-708.0, 709.0);
+    std::uniform_real_distribution<double> log_exponent(-700.0, 700.0);
+    std::uniform_real_distribution<double> cdf_domain(-40.0, 40.0);
+    
+    double exp_error = 0.0, log_error = 0.0, cdf_error = 0.0, pdf_error = 0.0;
+    for (int i = 0; i < 200000; ++i) {
+        double x = exp_domain(rng);
+        exp_error = std::max(exp_error, std::fabs(evalLanes([](simd::VecD v) { return simd::exp(v); }, x) /
+                                                  std::exp(x) - 1.0));
+        
+        double y = std::exp(log_exponent(rng));
+        double log_y = std::log(y);
+        if (std::fabs(log_y) > 1e-3) {
+            log_error = std::max(log_error, std::fabs(evalLanes([](simd::VecD v) { return simd::log(v); }, y) /
+                                                      log_y - 1.0));
+        }
+        
+        double z = cdf_domain(rng);
+        double cdf = 0.5 * std::erfc(-z / std::sqrt(2.0));
+        cdf_error = std::max(cdf_error, std::fabs(evalLanes([](simd::VecD v) { return simd::normCdf(v); }, z) - cdf));
+        double pdf = std::exp(-0.5 * z * z) * 0.39894228040143267794;
+        if (pdf > 1e-300) {
+            pdf_error = std::max(pdf_error, std::fabs(evalLanes([](simd::VecD v) { return simd::normPdf(v); }, z) /
+                                                      pdf - 1.0));
+        }
+    }
+    
+    EXPECT_LT(exp_error, 1e-15);
+    EXPECT_LT(log_error, 2e-15);
+    EXPECT_LT(cdf_error, 1e-15);
+    EXPECT_LT(pdf_error, 1e-15);
+}
+
+TEST(OptionPricerTest, TextbookValuesAndParity) {
+    OptionBatch batch;
+    batch.add(100.0, 100.0, 1.0, 0.2, 0.05, 0.0, true);
+    batch.add(100.0, 100.0, 1.0, 0.2, 0.05, 0.0, false);
+    BlackScholesPricer::priceBatch(batch);
+    
+    EXPECT_NEAR(batch.price[0], 10.450583572185565, 1e-9);
+    EXPECT_NEAR(batch.price[1], 5.573526022256971, 1e-9);
+    EXPECT_NEAR(batch.delta[0], 0.6368306511756191, 1e-12);
+    EXPECT_NEAR(batch.delta[0] - batch.delta[1], 1.0, 1e-12);
+    EXPECT_NEAR(batch.gamma[0], batch.gamma[1], 1e-15);
+    EXPECT_NEAR(batch.vega[0], 37.52403469169379, 1e-9);
+    
+    // Put-call parity: C - P = S - K e^{-rT}
+    EXPECT_NEAR(batch.price[0] - batch.price[1], 100.0 - 100.0 * std::exp(-0.05), 1e-9);
+}
+
+TEST(OptionPricerTest, BatchMatchesScalarReference) {
+    std::mt19937_64 rng(11);
+    std::uniform_real_distribution<double> moneyness(0.5, 1.5);
+    std::uniform_real_distribution<double> years(1.0 / 365.0, 2.0);
+    std::uniform_real_distribution<double> vol(0.2, 1.5);
+    
+    OptionBatch simd_batch;
+    for (int i = 0; i < 1001; ++i) {
+        simd_batch.add(40000.0, 40000.0 * moneyness(rng), years(rng), vol(rng), 0.05, 0.01, i % 2 == 0);
+    }
+    // Edge cases: expired and zero-vol contracts
+    simd_batch.add(40000.0, 35000.0, 0.0, 0.8, 0.05, 0.0, true);
+    simd_batch.add(40000.0, 45000.0, 0.5, 0.0, 0.05, 0.0, false);
+    
+    OptionBatch reference = simd_batch;
+    BlackScholesPricer::priceBatch(simd_batch);
+    BlackScholesPricer::priceReference(reference);
+    
+    for (size_t i = 0; i < simd_batch.size(); ++i) {
+        EXPECT_NEAR(simd_batch.price[i], reference.price[i], 40000.0 * 1e-12) << i;
+        EXPECT_NEAR(simd_batch.delta[i], reference.delta[i], 1e-12) << i;
+        EXPECT_NEAR(simd_batch.gamma[i], reference.gamma[i], 1e-12 * std::max(1.0, reference.gamma[i])) << i;
+        EXPECT_NEAR(simd_batch.vega[i], reference.vega[i], 1e-8) << i;
+        EXPECT_NEAR(simd_batch.theta[i], reference.theta[i], 1e-7) << i;
+    }
+    EXPECT_NEAR(simd_batch.price[1001], 40000.0 - 35000.0, 1e-6);
+    EXPECT_NEAR(simd_batch.price[1002], 45000.0 * std::exp(-0.025) - 40000.0, 1e-6);
+}
+
+} // namespace arbitrage
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include "perpetual_pricer.hpp"
+#include "engine_clock.hpp"
+#include "test_helpers.hpp"
+
+namespace arbitrage {
+
+namespace {
+
+FundingRate makeFunding(const InstrumentId& perp_id, double rate, Timestamp next_funding) {
+    FundingRate funding;
+    funding.instrument_id = perp_id;
+    funding.current_rate = rate;
+    funding.next_funding_time = next_funding;
+    return funding;
+}
+
+} // namespace
+
+TEST(PerpetualPricerTest, VectorPassMatchesScalarFormula) {
+    // Odd count so the padded tail lanes are exercised
+    const size_t count = 37;
+    PerpetualFairValueEngine engine;
+    Timestamp now = getEngineTimestamp();
+    
+    for (size_t i = 0; i < count; ++i) {
+        std::string n = std::to_string(i);
+        engine.addPerpetual("PERP" + n, "SPOT" + n);
+        engine.updateSpotPrice("SPOT" + n, 100.0 + i);
+        engine.updatePerpPrice("PERP" + n, 100.5 + i);
+        engine.updateFundingRate(makeFunding("PERP" + n, 0.0001 * (i % 5) - 0.0002,
+                                             now + std::chrono::minutes(15 * i)));
+    }
+    engine.computeAll(now);
+    
+    for (size_t i = 0; i < count; ++i) {
+        double tau = std::min(15.0 * i / 480.0, 1.0);
+        double rate = 0.0001 * (i % 5) - 0.0002;
+        double fair = (100.0 + i) * (1.0 + rate * tau);
+        EXPECT_NEAR(engine.getFairValue(i), fair, 1e-9) << i;
+        EXPECT_NEAR(engine.getBasisSpread(i), 100.5 + i - fair, 1e-9) << i;
+        
+        double vector_fair = engine.getFairValue(i);
+        engine.compute(i, now);
+        EXPECT_DOUBLE_EQ(engine.getFairValue(i), vector_fair);
+    }
+}
+
+TEST(PerpetualPricerTest, PairsPerpsWithSpotOnSameVenue) {
+    std::vector<Instrument> instruments = {
+        makeInstrument("BTC/USDT", "BTC", InstrumentType::SPOT, Exchange::BINANCE),
+        makeInstrument("BTC/USDT", "BTC", InstrumentType::SPOT, Exchange::OKX),
+        makeInstrument("BTC-PERP", "BTC", InstrumentType::PERPETUAL_SWAP, Exchange::OKX),
+        makeInstrument("ETH-PERP", "ETH", InstrumentType::PERPETUAL_SWAP, Exchange::OKX),  // no spot
+    };
+    
+    PerpetualFairValueEngine engine;
+    EXPECT_EQ(engine.addInstruments(instruments), 1);
+    
+    Timestamp now = getEngineTimestamp();
+    MarketEvent spot;
+    spot.type = MarketEventType::BOOK_UPDATE;
+    spot.instrument_id = instruments[1].id;
+    spot.book.bids.push_back({100.0, 1.0, now});
+    spot.book.asks.push_back({102.0, 1.0, now});
+    EXPECT_TRUE(engine.onMarketEvent(spot, now));
+    
+    SyntheticPrice price;
+    EXPECT_FALSE(engine.getSyntheticPrice(instruments[2].id, price));  // no perp book yet
+    
+    MarketEvent perp = spot;
+    perp.instrument_id = instruments[2].id;
+    perp.book.bids[0].price = 103.0;
+    perp.book.asks[0].price = 103.0;
+    EXPECT_TRUE(engine.onMarketEvent(perp, now));
+    
+    MarketEvent funding;
+    funding.type = MarketEventType::FUNDING_RATE;
+    funding.instrument_id = instruments[2].id;
+    funding.funding = makeFunding(instruments[2].id, 0.001, now + std::chrono::hours(4));
+    EXPECT_TRUE(engine.onMarketEvent(funding, now));
+    
+    ASSERT_TRUE(engine.getSyntheticPrice(instruments[2].id, price));
+    EXPECT_NEAR(price.fair_value, 101.0 * (1.0 + 0.001 * 0.5), 1e-9);
+    EXPECT_NEAR(price.basis_spread, 103.0 - price.fair_value, 1e-9);
+    ASSERT_EQ(price.component_instruments.size(), 1);
+    EXPECT_EQ(price.component_instruments[0], instruments[1].id);
+    
+    // Past the snapshot the carry window is exhausted
+    engine.computeAll(now + std::chrono::hours(5));
+    ASSERT_TRUE(engine.getSyntheticPrice(instruments[2].id, price));
+    EXPECT_NEAR(price.fair_value, 101.0, 1e-9);
+}
+
+} // namespace arbitrage
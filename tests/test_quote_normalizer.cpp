@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include "quote_normalizer.hpp"
+#include "shard_manager.hpp"
+#include "test_helpers.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace arbitrage {
+
+TEST(QuoteNormalizerTest, ConversionTickRenormalizesQuotedInstruments) {
+    QuoteNormalizer normalizer;
+    std::vector<Instrument> instruments = {
+        makeSpot("BTC", "USDT"), makeSpot("BTC", "USDC"), makeSpot("ETH", "USDC"),
+        makeSpot("USDC", "USDT"), makeSpot("BTC", "USD")};
+    EXPECT_EQ(normalizer.addInstruments(instruments), 1u);
+    EXPECT_EQ(normalizer.getPivot(), "USDT");
+    EXPECT_EQ(normalizer.getCurrencyCount(), 3u);
+    
+    size_t btc_usdt, btc_usdc, eth_usdc, btc_usd;
+    ASSERT_TRUE(normalizer.find("BTC/USDT_SPOT", btc_usdt));
+    ASSERT_TRUE(normalizer.find("BTC/USDC_SPOT", btc_usdc));
+    ASSERT_TRUE(normalizer.find("ETH/USDC_SPOT", eth_usdc));
+    ASSERT_TRUE(normalizer.find("BTC/USD_SPOT", btc_usd));
+    
+    EXPECT_TRUE(normalizer.onTopOfBook(makeTop("BTC/USDT_SPOT", 40000.0, 40001.0)));
+    EXPECT_TRUE(normalizer.onTopOfBook(makeTop("BTC/USDC_SPOT", 40030.0, 40031.0)));
+    EXPECT_TRUE(normalizer.onTopOfBook(makeTop("BTC/USD_SPOT", 40010.0, 40011.0)));
+    EXPECT_EQ(normalizer.getNormalizedBid(btc_usdt), 40000.0);
+    EXPECT_EQ(normalizer.getNormalizedBid(btc_usd), 40010.0);  // USD carried at par
+    EXPECT_TRUE(std::isnan(normalizer.getNormalizedBid(btc_usdc)));  // No USDC rate yet
+    
+    // USDC trades at 0.999 USDT: only USDC-quoted instruments (and the
+    // conversion book's own USDT price) move
+    normalizer.onTopOfBook(makeTop("ETH/USDC_SPOT", 2000.0, 2000.5));
+    uint64_t before = normalizer.getRenormalizedCount();
+    EXPECT_TRUE(normalizer.onTopOfBook(makeTop("USDC/USDT_SPOT", 0.9989, 0.9991)));
+    EXPECT_EQ(normalizer.getRenormalizedCount() - before, 3u);
+    EXPECT_DOUBLE_EQ(normalizer.getNormalizedBid(btc_usdc), 40030.0 * 0.999);
+    EXPECT_DOUBLE_EQ(normalizer.getNormalizedAsk(eth_usdc), 2000.5 * 0.999);
+    EXPECT_NEAR(normalizer.getRelativeSpread(btc_usdc, btc_usdt), (40030.0 * 0.999 - 40001.0) / 40001.0, 1e-15);
+    
+    // Matrix stays consistent in both directions
+    EXPECT_DOUBLE_EQ(normalizer.getRate("USDC", "USDT"), 0.999);
+    EXPECT_DOUBLE_EQ(normalizer.getRate("USDT", "USDC"), 1.0 / 0.999);
+    EXPECT_NEAR(normalizer.getRate("USDC", "USD") * normalizer.getRate("USD", "USDT"),
+                normalizer.getRate("USDC", "USDT"), 1e-15);
+    EXPECT_DOUBLE_EQ(normalizer.convert(100.0, "USDC", "USD"), 99.9);
+    EXPECT_TRUE(std::isnan(normalizer.getRate("USDC", "EUR")));
+    
+    // An unchanged conversion mid is a no-op
+    EXPECT_FALSE(normalizer.onTopOfBook(makeTop("USDC/USDT_SPOT", 0.9989, 0.9991)));
+}
+
+TEST(QuoteNormalizerTest, BookReachedFromEitherSideAndChained) {
+    QuoteNormalizerConfig config;
+    config.pivot = "USD";
+    config.fixed_rates.clear();
+    QuoteNormalizer normalizer(config);
+    
+    // USDT/USD book (pivot is the quote), then USDC priced in USDT
+    ASSERT_TRUE(normalizer.addConversionBook("USDT/USD_SPOT", "USDT", "USD"));
+    ASSERT_TRUE(normalizer.addConversionBook("USDC/USDT_SPOT", "USDC", "USDT"));
+    EXPECT_FALSE(normalizer.addConversionBook("USDC/USDT_SPOT", "USDC", "USDT"));
+    normalizer.addInstrument("ETH/USDC_SPOT", "USDC");
+    
+    normalizer.onTopOfBook(makeTop("USDT/USD_SPOT", 1.0004, 1.0006));
+    normalizer.onTopOfBook(makeTop("USDC/USDT_SPOT", 0.9994, 0.9996));
+    normalizer.onTopOfBook(makeTop("ETH/USDC_SPOT", 2000.0, 2001.0));
+    
+    size_t eth;
+    ASSERT_TRUE(normalizer.find("ETH/USDC_SPOT", eth));
+    EXPECT_NEAR(normalizer.getNormalizedBid(eth), 2000.0 * 0.9995 * 1.0005, 1e-9);
+    
+    // A tick on the upper edge re-derives the whole chain
+    normalizer.onTopOfBook(makeTop("USDT/USD_SPOT", 0.9999, 1.0001));
+    EXPECT_NEAR(normalizer.getNormalizedBid(eth), 2000.0 * 0.9995, 1e-9);
+    EXPECT_NEAR(normalizer.getRate("USD", "USDC"), 1.0 / 0.9995, 1e-15);
+}
+
+TEST(QuoteNormalizerTest, MergerNormalizesPublishedTops) {
+    ShardManager manager;
+    std::vector<Instrument> instruments = {
+        makeSpot("BTC", "USDT"), makeSpot("BTC", "USDC"), makeSpot("USDC", "USDT")};
+    ASSERT_TRUE(manager.initialize(instruments, 2));
+    
+    // Detector reads normalized prices for the changed instrument
+    auto& merger = manager.getMerger();
+    double spread = 0.0;
+    merger.addCrossShardDetector([&merger, &spread](const OpportunityMerger::TopOfBookTable&,
+                                                    const std::vector<InstrumentId>& changed,
+                                                    std::vector<ArbitrageOpportunity>&) {
+        auto& normalizer = merger.getQuoteNormalizer();
+        size_t usdc, usdt;
+        if (std::find(changed.begin(), changed.end(), "BTC/USDC_SPOT") != changed.end() && normalizer.find("BTC/USDC_SPOT", usdc) &&
+            normalizer.find("BTC/USDT_SPOT", usdt)) {
+            spread = normalizer.getRelativeSpread(usdc, usdt);
+        }
+    });
+    
+    const char* ids[] = {"USDC/USDT_SPOT", "BTC/USDT_SPOT", "BTC/USDC_SPOT"};
+    const double bids[] = {1.0009, 40000.0, 40000.0};
+    for (int i = 0; i < 3; ++i) {
+        MarketEvent event;
+        event.type = MarketEventType::BOOK_UPDATE;
+        event.instrument_id = ids[i];
+        event.book.instrument_id = ids[i];
+        event.book.bids.push_back({bids[i], 1.0, getCurrentTimestamp()});
+        event.book.asks.push_back({bids[i] == 40000.0 ? 40002.0 : 1.0011, 1.0, getCurrentTimestamp()});
+        manager.submit(event);
+    }
+    merger.processPending();
+    
+    EXPECT_NEAR(spread, (40000.0 * 1.001 - 40002.0) / 40002.0, 1e-12);
+}
+
+TEST(QuoteNormalizerTest, ConfigurationSurvivesInitialize) {
+    // Configured before start; initialize only registers the instruments
+    ShardManager manager;
+    QuoteNormalizerConfig config;
+    config.pivot = "USDC";
+    manager.getMerger().getQuoteNormalizer() = QuoteNormalizer(config);
+    ASSERT_TRUE(manager.initialize({makeSpot("BTC", "USDT"), makeSpot("USDC", "USDT")}, 1));
+    
+    const auto& normalizer = manager.getMerger().getQuoteNormalizer();
+    EXPECT_EQ(normalizer.getPivot(), "USDC");
+    EXPECT_EQ(normalizer.size(), 2u);
+    EXPECT_TRUE(normalizer.isConversionBook("USDC/USDT_SPOT"));
+}
+
+} // namespace arbitrage
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include "market_replay.hpp"
+#include "engine_clock.hpp"
+#include "test_helpers.hpp"
+
+namespace arbitrage {
+
+namespace {
+
+const Timestamp kStart = Timestamp(std::chrono::seconds(1700000000));
+
+MarketEvent makeTick(const InstrumentId& instrument_id, int64_t ms, Price bid, Price ask) {
+    MarketEvent event;
+    event.type = MarketEventType::BOOK_UPDATE;
+    event.instrument_id = instrument_id;
+    event.exchange_id = "OKX";
+    event.exchange_time = kStart + std::chrono::milliseconds(ms);
+    event.receive_time = event.exchange_time + std::chrono::microseconds(300);
+    event.book.bids.push_back({bid, 2.0, event.exchange_time});
+    event.book.asks.push_back({ask, 3.0, event.exchange_time});
+    return event;
+}
+
+struct ReplayResult {
+    ReplayStats stats;
+    std::vector<Timestamp> funding_times;
+};
+
+// Spot/perp basis stage: emit whenever the perp bid clears the spot ask
+ReplayResult replayOnce(MarketReplay& replay) {
+    EngineClock::getInstance().useSimulatedTime(replay.getStartTime());
+    
+    ReplayResult result;
+    {
+        ShardManager manager;
+        manager.initialize({makeInstrument("BTC/USDT", "BTC", InstrumentType::SPOT),
+                            makeInstrument("BTC-PERPETUAL", "BTC", InstrumentType::PERPETUAL_SWAP),
+                            makeInstrument("ETH/USDT", "ETH", InstrumentType::SPOT)}, 2);
+        manager.getMerger().setOpportunityCallback(
+            [&replay](const ArbitrageOpportunity& opportunity) { replay.recordOpportunity(opportunity); });
+        manager.configureShards([&result](StrategyShard& shard) {
+            shard.addEventHandler([&result](StrategyShard& s, const MarketEvent& event) {
+                if (event.type == MarketEventType::FUNDING_TIME) {
+                    result.funding_times.push_back(event.exchange_time);
+                    return;
+                }
+                const OrderBook* spot = s.getOrderBook("BTC/USDT_SPOT");
+                const OrderBook* perp = s.getOrderBook("BTC-PERPETUAL_PERPETUAL_SWAP");
+                if (!spot || !perp || perp->getBestBid() <= spot->getBestAsk()) {
+                    return;
+                }
+                ArbitrageOpportunity opportunity;
+                opportunity.opportunity_id = "BTC-basis";
+                opportunity.type = ArbitrageType::BASIS_SPREAD_ARBITRAGE;
+                opportunity.expected_profit = perp->getBestBid() - spot->getBestAsk();
+                opportunity.detection_time = getEngineTimestamp();
+                s.emitOpportunity(opportunity);
+            });
+        });
+        result.stats = replay.run(manager);
+    }
+    
+    EngineClock::getInstance().useRealTime();
+    return result;
+}
+
+} // namespace
+
+TEST(MarketReplayTest, JsonRoundTrip) {
+    MarketEvent book = makeTick("BTC/USDT_SPOT", 5, 100.5, 100.7);
+    book.sequence = 42;
+    
+    MarketEvent parsed;
+    ASSERT_TRUE(marketEventFromJson(marketEventToJson(book), parsed));
+    EXPECT_EQ(parsed.type, MarketEventType::BOOK_UPDATE);
+    EXPECT_EQ(parsed.instrument_id, book.instrument_id);
+    EXPECT_EQ(parsed.sequence, 42);
+    EXPECT_EQ(parsed.receive_time, book.receive_time);
+    ASSERT_EQ(parsed.book.asks.size(), 1);
+    EXPECT_DOUBLE_EQ(parsed.book.getBestAsk(), 100.7);
+    EXPECT_DOUBLE_EQ(parsed.book.bids[0].volume, 2.0);
+    
+    MarketEvent funding;
+    funding.type = MarketEventType::FUNDING_RATE;
+    funding.instrument_id = "BTC-PERPETUAL_PERPETUAL_SWAP";
+    funding.funding.current_rate = 0.0001;
+    funding.funding.next_funding_time = kStart + std::chrono::hours(8);
+    ASSERT_TRUE(marketEventFromJson(marketEventToJson(funding), parsed));
+    EXPECT_DOUBLE_EQ(parsed.funding.current_rate, 0.0001);
+    EXPECT_EQ(parsed.funding.next_funding_time, funding.funding.next_funding_time);
+    EXPECT_EQ(parsed.funding.instrument_id, funding.instrument_id);
+    
+    EXPECT_FALSE(marketEventFromJson("{\"type\":\"BOOK_UPDATE\"}", parsed));
+    EXPECT_FALSE(marketEventFromJson("not json", parsed));
+}
+
+TEST(MarketReplayTest, ReplayIsDeterministicAndUsesSimulatedTime) {
+    MarketReplay replay;
+    MarketEvent funding;
+    funding.type = MarketEventType::FUNDING_RATE;
+    funding.instrument_id = "BTC-PERPETUAL_PERPETUAL_SWAP";
+    funding.receive_time = kStart;
+    funding.funding.instrument_id = funding.instrument_id;
+    funding.funding.next_funding_time = kStart + std::chrono::seconds(30);
+    replay.addEvent(funding);
+    
+    for (int i = 0; i < 2000; ++i) {
+        Price drift = (i % 50) * 0.1;
+        replay.addEvent(makeTick("BTC/USDT_SPOT", i * 20, 100.0, 100.5));
+        replay.addEvent(makeTick("BTC-PERPETUAL_PERPETUAL_SWAP", i * 20 + 5, 98.0 + drift, 98.2 + drift));
+        replay.addEvent(makeTick("ETH/USDT_SPOT", i * 20 + 7, 10.0, 10.1));
+    }
+    
+    ReplayResult first = replayOnce(replay);
+    ReplayResult second = replayOnce(replay);
+    
+    EXPECT_EQ(first.stats.events_replayed, 6001);
+    EXPECT_GT(first.stats.opportunities, 0);
+    EXPECT_EQ(first.stats.opportunities, second.stats.opportunities);
+    EXPECT_EQ(first.stats.opportunity_digest, second.stats.opportunity_digest);
+    EXPECT_GT(first.stats.events_per_second, 0.0);
+    
+    // Funding snapshot is stamped with its recorded deadline, not wall time
+    ASSERT_EQ(first.funding_times.size(), 1);
+    EXPECT_EQ(first.funding_times[0], funding.funding.next_funding_time);
+    EXPECT_EQ(first.stats.last_event_time, kStart + std::chrono::milliseconds(39987) + std::chrono::microseconds(300));
+}
+
+} // namespace arbitrage
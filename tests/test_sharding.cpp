@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include "shard_manager.hpp"
+#include "test_helpers.hpp"
+#include <atomic>
+
+namespace arbitrage {
+
+class ShardManagerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        instruments_ = {
+            makeInstrument("BTC/USDT", "BTC", InstrumentType::SPOT),
+            makeInstrument("BTC-PERPETUAL", "BTC", InstrumentType::PERPETUAL_SWAP),
+            makeInstrument("ETH/USDT", "ETH", InstrumentType::SPOT),
+            makeInstrument("ETH-PERPETUAL", "ETH", InstrumentType::PERPETUAL_SWAP),
+            makeInstrument("SOL/USDT", "SOL", InstrumentType::SPOT),
+        };
+    }
+    
+    std::vector<Instrument> instruments_;
+};
+
+TEST_F(ShardManagerTest, PartitionsByBaseAsset) {
+    ShardManager manager;
+    ASSERT_TRUE(manager.initialize(instruments_, 2));
+    EXPECT_EQ(manager.getShardCount(), 2);
+    
+    // Every instrument of one underlying lands on the same shard
+    EXPECT_EQ(manager.getShardForInstrument("BTC/USDT_SPOT"),
+              manager.getShardForInstrument("BTC-PERPETUAL_PERPETUAL_SWAP"));
+    EXPECT_EQ(manager.getShardForInstrument("ETH/USDT_SPOT"),
+              manager.getShardForInstrument("ETH-PERPETUAL_PERPETUAL_SWAP"));
+    EXPECT_NE(manager.getShardForAsset("BTC"), manager.getShardForAsset("ETH"));
+    EXPECT_EQ(manager.getShardForAsset("SOL"), manager.getShardForAsset("BTC"));
+}
+
+TEST_F(ShardManagerTest, ShardCountCappedByAssets) {
+    ShardManager manager;
+    ASSERT_TRUE(manager.initialize(instruments_, 16));
+    EXPECT_EQ(manager.getShardCount(), 3);
+}
+
+TEST_F(ShardManagerTest, SynchronousProcessingKeepsStatePerShard) {
+    ShardManager manager;
+    ASSERT_TRUE(manager.initialize(instruments_, 3));
+    
+    std::vector<ArbitrageOpportunity> received;
+    manager.getMerger().setOpportunityCallback(
+        [&received](const ArbitrageOpportunity& opportunity) { received.push_back(opportunity); });
+    manager.configureShards([](StrategyShard& shard) {
+        shard.addEventHandler([](StrategyShard& s, const MarketEvent& event) {
+            const OrderBook* book = s.getOrderBook(event.instrument_id);
+            if (book && book->getBestBid() > 100.0) {
+                ArbitrageOpportunity opportunity;
+                opportunity.opportunity_id = event.instrument_id;
+                s.emitOpportunity(opportunity);
+            }
+        });
+    });
+    
+    manager.submit(makeBookEvent("BTC/USDT_SPOT", 101.0, 102.0));
+    manager.submit(makeBookEvent("ETH/USDT_SPOT", 50.0, 51.0));
+    
+    size_t btc_shard = manager.getShardForInstrument("BTC/USDT_SPOT");
+    size_t eth_shard = manager.getShardForInstrument("ETH/USDT_SPOT");
+    EXPECT_NE(manager.getShard(btc_shard).getOrderBook("BTC/USDT_SPOT"), nullptr);
+    EXPECT_EQ(manager.getShard(btc_shard).getOrderBook("ETH/USDT_SPOT"), nullptr);
+    EXPECT_NE(manager.getShard(eth_shard).getOrderBook("ETH/USDT_SPOT"), nullptr);
+    
+    ASSERT_EQ(received.size(), 1);
+    EXPECT_EQ(received[0].opportunity_id, "BTC/USDT_SPOT");
+}
+
+TEST_F(ShardManagerTest, MergerRunsCrossShardDetectors) {
+    ShardManager manager;
+    ASSERT_TRUE(manager.initialize(instruments_, 3));
+    
+    std::vector<ArbitrageOpportunity> received;
+    manager.getMerger().setOpportunityCallback(
+        [&received](const ArbitrageOpportunity& opportunity) { received.push_back(opportunity); });
+    manager.getMerger().addCrossShardDetector(
+        [](const OpportunityMerger::TopOfBookTable& tops, const std::vector<InstrumentId>&,
+           std::vector<ArbitrageOpportunity>& out) {
+            auto btc = tops.find("BTC/USDT_SPOT");
+            auto eth = tops.find("ETH/USDT_SPOT");
+            if (btc != tops.end() && eth != tops.end() && btc->second.shard_id != eth->second.shard_id) {
+                ArbitrageOpportunity opportunity;
+                opportunity.type = ArbitrageType::CROSS_SYNTHETIC;
+                out.push_back(opportunity);
+            }
+        });
+    
+    manager.submit(makeBookEvent("BTC/USDT_SPOT", 101.0, 102.0));
+    EXPECT_TRUE(received.empty());
+    manager.submit(makeBookEvent("ETH/USDT_SPOT", 50.0, 51.0));
+    ASSERT_EQ(received.size(), 1);
+    EXPECT_EQ(manager.getMerger().getCrossShardOpportunities(), 1);
+    
+    // An unchanged top of book does not cross the shard boundary again
+    manager.submit(makeBookEvent("ETH/USDT_SPOT", 50.0, 51.0));
+    EXPECT_EQ(received.size(), 1);
+}
+
+TEST_F(ShardManagerTest, MergerRunsDetectorsOncePerBatch) {
+    OpportunityMerger merger;
+    std::vector<std::vector<InstrumentId>> calls;
+    std::vector<size_t> table_sizes;
+    merger.addCrossShardDetector([&calls, &table_sizes](const OpportunityMerger::TopOfBookTable& tops,
+                                                        const std::vector<InstrumentId>& changed,
+                                                        std::vector<ArbitrageOpportunity>&) {
+        calls.push_back(changed);
+        table_sizes.push_back(tops.size());
+    });
+    
+    // Every top changed in a batch arrives in one call, a repeat only once
+    merger.publishTopOfBook(makeTop("BTC/USDT_SPOT", 101.0, 102.0));
+    merger.publishTopOfBook(makeTop("ETH/USDT_SPOT", 50.0, 51.0));
+    merger.publishTopOfBook(makeTop("BTC/USDT_SPOT", 101.5, 102.0));
+    merger.processPending();
+    ASSERT_EQ(calls.size(), 1u);
+    EXPECT_EQ(calls[0], (std::vector<InstrumentId>{"BTC/USDT_SPOT", "ETH/USDT_SPOT"}));
+    
+    // The next batch sees the whole table with only its change copied in
+    merger.publishTopOfBook(makeTop("SOL/USDT_SPOT", 20.0, 20.1));
+    merger.processPending();
+    ASSERT_EQ(calls.size(), 2u);
+    EXPECT_EQ(calls[1], std::vector<InstrumentId>{"SOL/USDT_SPOT"});
+    EXPECT_EQ(table_sizes[1], 3u);
+    
+    // A batch without top changes runs no detector
+    std::vector<ArbitrageOpportunity> none;
+    merger.publishOpportunities(none);
+    merger.processPending();
+    EXPECT_EQ(calls.size(), 2u);
+}
+
+TEST_F(ShardManagerTest, ThreadedShardsProcessAllEvents) {
+    ShardManager manager;
+    ASSERT_TRUE(manager.initialize(instruments_, 3));
+    
+    std::atomic<int> handled{0};
+    manager.configureShards([&handled](StrategyShard& shard) {
+        shard.addEventHandler([&handled](StrategyShard&, const MarketEvent&) { ++handled; });
+    });
+    
+    manager.start(false);
+    for (int i = 0; i < 300; ++i) {
+        const auto& instrument = instruments_[i % instruments_.size()];
+        manager.submit(makeBookEvent(instrument.id, 100.0 + i, 101.0 + i));
+    }
+    manager.stop();
+    
+    // Every book update is either processed or conflated into a newer one
+    uint64_t processed = 0;
+    uint64_t conflated = 0;
+    for (size_t i = 0; i < manager.getShardCount(); ++i) {
+        processed += manager.getShard(i).getEventsProcessed();
+        conflated += manager.getShard(i).getConflatedUpdates();
+    }
+    EXPECT_EQ(static_cast<uint64_t>(handled.load()), processed);
+    EXPECT_EQ(processed + conflated, 300);
+}
+
+} // namespace arbitrage
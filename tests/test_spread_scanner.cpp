@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include "spread_scanner.hpp"
+#include "test_helpers.hpp"
+#include <cmath>
+#include <random>
+
+namespace arbitrage {
+
+TEST(SpreadScannerTest, StablecoinTriangleRegisteredOnce) {
+    SpotSpreadScanner scanner;
+    std::vector<Instrument> instruments = {
+        makeSpot("BTC", "USDT"), makeSpot("ETH", "USDT"), makeSpot("BTC", "USDC"), makeSpot("USDC", "USDT")};
+    ASSERT_EQ(scanner.addInstruments(instruments), 1u);
+    size_t index;
+    ASSERT_TRUE(scanner.find("BTC/USDT_SPOT", index));
+    EXPECT_FALSE(scanner.onTopOfBook(makeTop("ETH/USDT_SPOT", 2000.0, 2000.5)));
+    
+    Timestamp now = getCurrentTimestamp();
+    std::vector<ArbitrageOpportunity> out;
+    scanner.onTopOfBook(makeTop("BTC/USDT_SPOT", 40000.0, 40001.0, 2.0));
+    scanner.onTopOfBook(makeTop("BTC/USDC_SPOT", 40000.0, 40001.0, 0.5));
+    EXPECT_EQ(scanner.scan(now, out), 0u);  // Synthetic leg unpriced
+    EXPECT_TRUE(std::isnan(scanner.getSellRealEdge(index)));
+    scanner.onTopOfBook(makeTop("USDC/USDT_SPOT", 0.9999, 1.0001, 100000.0));
+    EXPECT_EQ(scanner.scan(now, out), 0u);
+    EXPECT_NEAR(scanner.getSyntheticBid(index), 40000.0 * 0.9999, 1e-9);
+    
+    // USDC rich: buy BTC for USDT, sell it for USDC, sell the USDC for USDT
+    scanner.onTopOfBook(makeTop("USDC/USDT_SPOT", 1.003, 1.0031, 100000.0));
+    ASSERT_EQ(scanner.scan(now, out), 1u);
+    const ArbitrageOpportunity& opportunity = out.back();
+    EXPECT_EQ(opportunity.type, ArbitrageType::REAL_VS_SYNTHETIC_SPOT);
+    EXPECT_EQ(opportunity.opportunity_id, "RVS:B:BTC/USDT_SPOT:BTC/USDC_SPOT:USDC/USDT_SPOT");
+    EXPECT_NEAR(opportunity.expected_profit_percentage, 40000.0 * 1.003 / 40001.0 - 1.0, 1e-12);
+    ASSERT_EQ(opportunity.leg_sides.size(), 3u);
+    EXPECT_EQ(opportunity.leg_sides[0], OrderSide::BUY);
+    EXPECT_EQ(opportunity.leg_sides[1], OrderSide::SELL);
+    EXPECT_EQ(opportunity.leg_sides[2], OrderSide::SELL);
+    // Capped by the 0.5 BTC on the BTC/USDC bid; the USDC leg sells the proceeds
+    EXPECT_DOUBLE_EQ(opportunity.leg_volumes[0], 0.5);
+    EXPECT_DOUBLE_EQ(opportunity.leg_volumes[2], 0.5 * 40000.0);
+    EXPECT_EQ(opportunity.leg_exchanges[1], Exchange::BINANCE);
+    
+    // Nothing changed since the last scan
+    uint64_t scanned = scanner.getScannedCount();
+    EXPECT_EQ(scanner.scan(now, out), 0u);
+    EXPECT_EQ(scanner.getScannedCount(), scanned);
+}
+
+TEST(SpreadScannerTest, ParallelVenueBooksEachCloseATriangle) {
+    SpotSpreadScanner scanner;
+    Instrument okx = makeSpot("BTC", "USDT");
+    okx.id = "BTC/USDT_OKX";
+    okx.exchange = Exchange::OKX;
+    std::vector<Instrument> instruments = {
+        makeSpot("BTC", "USDT"), okx, makeSpot("BTC", "USDC"), makeSpot("USDC", "USDT")};
+    ASSERT_EQ(scanner.addInstruments(instruments), 2u);
+    
+    // Only the OKX book is cheap; the Binance one alone would show nothing
+    Timestamp now = getCurrentTimestamp();
+    std::vector<ArbitrageOpportunity> out;
+    scanner.onTopOfBook(makeTop("BTC/USDT_SPOT", 40050.0, 40051.0));
+    scanner.onTopOfBook(makeTop("BTC/USDT_OKX", 39900.0, 39901.0));
+    scanner.onTopOfBook(makeTop("BTC/USDC_SPOT", 40050.0, 40051.0));
+    scanner.onTopOfBook(makeTop("USDC/USDT_SPOT", 0.9999, 1.0001));
+    ASSERT_EQ(scanner.scan(now, out), 1u);
+    EXPECT_EQ(out[0].opportunity_id, "RVS:B:BTC/USDT_OKX:BTC/USDC_SPOT:USDC/USDT_SPOT");
+    EXPECT_EQ(out[0].leg_exchanges[0], Exchange::OKX);
+    EXPECT_EQ(out[0].leg_exchanges[1], Exchange::BINANCE);
+}
+
+TEST(SpreadScannerTest, InvertedLegsPriceAndSide) {
+    SpotSpreadScanner scanner;
+    // ETH/BTC against ETH/USDT * USDT/BTC, the latter listed as BTC/USDT
+    ASSERT_TRUE(scanner.addPair("ETH/BTC", "ETH/USDT", false, "BTC/USDT", true));
+    EXPECT_FALSE(scanner.addPair("BTC/USDT", "ETH/BTC", false, "ETH/USDT", true));
+    
+    Timestamp now = getCurrentTimestamp();
+    std::vector<ArbitrageOpportunity> out;
+    scanner.onTopOfBook(makeTop("ETH/USDT", 2000.0, 2000.5, 10.0));
+    scanner.onTopOfBook(makeTop("BTC/USDT", 40000.0, 40001.0, 10.0));
+    scanner.onTopOfBook(makeTop("ETH/BTC", 0.0515, 0.0516, 3.0));
+    ASSERT_EQ(scanner.scan(now, out), 1u);
+    EXPECT_NEAR(scanner.getSyntheticAsk(0), 2000.5 / 40000.0, 1e-15);
+    
+    // ETH rich in BTC: sell it there, buy it with USDT raised by selling BTC
+    const ArbitrageOpportunity& opportunity = out.back();
+    EXPECT_EQ(opportunity.opportunity_id, "RVS:S:ETH/BTC:ETH/USDT:BTC/USDT");
+    EXPECT_NEAR(opportunity.expected_profit_percentage, 0.0515 * 40000.0 / 2000.5 - 1.0, 1e-12);
+    EXPECT_EQ(opportunity.leg_sides[0], OrderSide::SELL);
+    EXPECT_EQ(opportunity.leg_sides[1], OrderSide::BUY);
+    EXPECT_EQ(opportunity.leg_sides[2], OrderSide::SELL);
+    EXPECT_DOUBLE_EQ(opportunity.leg_prices[2], 40000.0);
+    EXPECT_DOUBLE_EQ(opportunity.leg_volumes[0], 3.0);
+    EXPECT_NEAR(opportunity.leg_volumes[2], 3.0 * 2000.5 / 40000.0, 1e-12);
+    EXPECT_NEAR(opportunity.expected_profit, 3.0 * 0.0515 * opportunity.expected_profit_percentage, 1e-12);
+}
+
+TEST(SpreadScannerTest, VectorPassMatchesScalarReference) {
+    SpreadScannerConfig config;
+    config.fee_rate = 0.0002;
+    SpotSpreadScanner scanner(config);
+    const size_t count = 37;  // Not a whole number of vectors
+    for (size_t i = 0; i < count; ++i) {
+        std::string n = std::to_string(i);
+        ASSERT_TRUE(scanner.addPair("R" + n, "A" + n, i % 2 == 0, "B" + n, i % 3 == 0));
+    }
+    
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> price(0.98, 1.02);
+    std::vector<double> bids(3 * count), asks(3 * count);
+    const char* prefixes[] = {"R", "A", "B"};
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t role = 0; role < 3; ++role) {
+            if (i % 11 == 5 && role == 1) {
+                continue;  // Left unpriced
+            }
+            double bid = price(rng);
+            bids[3 * i + role] = bid;
+            asks[3 * i + role] = bid * 1.0001;
+            scanner.onTopOfBook(makeTop(prefixes[role] + std::to_string(i), bid, bid * 1.0001));
+        }
+    }
+    
+    std::vector<ArbitrageOpportunity> out;
+    size_t found = scanner.scan(getCurrentTimestamp(), out);
+    EXPECT_EQ(scanner.getScannedCount(), count);
+    
+    double fees = std::pow(1.0 - config.fee_rate, 3);
+    size_t expected = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (i % 11 == 5) {
+            EXPECT_TRUE(std::isnan(scanner.getSellRealEdge(i)));
+            continue;
+        }
+        // Oriented legs: inverted books swap and reciprocate bid and ask
+        double leg_bid = 1.0, leg_ask = 1.0;
+        for (size_t role = 1; role < 3; ++role) {
+            bool inverted = role == 1 ? i % 2 == 0 : i % 3 == 0;
+            leg_bid *= inverted ? 1.0 / asks[3 * i + role] : bids[3 * i + role];
+            leg_ask *= inverted ? 1.0 / bids[3 * i + role] : asks[3 * i + role];
+        }
+        double sell_edge = bids[3 * i] * fees / leg_ask - 1.0;
+        double buy_edge = leg_bid * fees / asks[3 * i] - 1.0;
+        EXPECT_NEAR(scanner.getSellRealEdge(i), sell_edge, 1e-12);
+        EXPECT_NEAR(scanner.getBuyRealEdge(i), buy_edge, 1e-12);
+        expected += (sell_edge > config.min_profit) + (buy_edge > config.min_profit);
+    }
+    EXPECT_GT(expected, 0u);
+    EXPECT_EQ(found, expected);
+    EXPECT_EQ(out.size(), expected);
+}
+
+} // namespace arbitrage
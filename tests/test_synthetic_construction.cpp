@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include "synthetic_construction.hpp"
+#include <cmath>
+
+namespace arbitrage {
+
+namespace {
+
+SyntheticDefinition makeDefinition(const std::string& id, ConstructionShape shape,
+                                   std::vector<InstrumentId> legs, std::vector<double> weights) {
+    SyntheticDefinition definition;
+    definition.id = id;
+    definition.shape = shape;
+    definition.legs = std::move(legs);
+    definition.weights = std::move(weights);
+    return definition;
+}
+
+} // namespace
+
+TEST(SyntheticConstructionTest, SpecializedKernelsMatchGenericPath) {
+    SyntheticConstructionEngine engine;
+    ASSERT_TRUE(engine.add(makeDefinition("BASIS", ConstructionShape::SPOT_PERP,
+                                          {"BTC-PERP", "BTC-SPOT"}, {1.0, -1.0})));
+    ASSERT_TRUE(engine.add(makeDefinition("BASIS-GENERIC", ConstructionShape::GENERIC,
+                                          {"BTC-PERP", "BTC-SPOT"}, {1.0, -1.0})));
+    ASSERT_TRUE(engine.add(makeDefinition("BOX", ConstructionShape::BOX,
+                                          {"C1", "C2", "P1", "P2"}, {1.0, -1.0, -1.0, 1.0})));
+    ASSERT_TRUE(engine.add(makeDefinition("BOX-GENERIC", ConstructionShape::GENERIC,
+                                          {"C1", "C2", "P1", "P2"}, {1.0, -1.0, -1.0, 1.0})));
+    // ETH/BTC * BTC/USDT / ETH/USDT: 1.0 when the triangle is closed
+    ASSERT_TRUE(engine.add(makeDefinition("TRIANGLE", ConstructionShape::TRIANGULAR,
+                                          {"ETH/BTC", "BTC/USDT", "ETH/USDT"}, {1.0, 1.0, -1.0})));
+    ASSERT_TRUE(engine.add(makeDefinition("SCALED", ConstructionShape::SPOT_PERP,
+                                          {"BTC-PERP", "BTC-SPOT"}, {-2.0, 0.5})));
+    
+    EXPECT_TRUE(engine.isSpecialized(0));
+    EXPECT_FALSE(engine.isSpecialized(1));
+    EXPECT_EQ(engine.getSpecializedCount(), 4u);
+    
+    Timestamp now = getCurrentTimestamp();
+    EXPECT_TRUE(std::isnan(engine.evaluate(0, now)));  // Legs not priced yet
+    
+    engine.updatePrice("BTC-PERP", 40100.0);
+    engine.updatePrice("BTC-SPOT", 40000.0);
+    engine.updatePrice("C1", 1500.0);
+    engine.updatePrice("C2", 700.0);
+    engine.updatePrice("P1", 300.0);
+    engine.updatePrice("P2", 450.0);
+    engine.updatePrice("ETH/BTC", 0.05);
+    engine.updatePrice("BTC/USDT", 40000.0);
+    engine.updatePrice("ETH/USDT", 2002.0);
+    engine.evaluateAll(now);
+    
+    EXPECT_DOUBLE_EQ(engine.getValue(0), 100.0);
+    EXPECT_DOUBLE_EQ(engine.getValue(0), engine.getValue(1));
+    EXPECT_DOUBLE_EQ(engine.getValue(2), 1500.0 - 700.0 - 300.0 + 450.0);
+    EXPECT_DOUBLE_EQ(engine.getValue(2), engine.getValue(3));
+    EXPECT_NEAR(engine.getValue(4), 0.05 * 40000.0 / 2002.0, 1e-15);
+    EXPECT_DOUBLE_EQ(engine.getValue(5), -2.0 * 40100.0 + 0.5 * 40000.0);
+    
+    SyntheticPrice price;
+    ASSERT_TRUE(engine.getSyntheticPrice("BOX", price));
+    EXPECT_EQ(price.component_instruments.size(), 4u);
+    EXPECT_EQ(price.component_weights[1], -1.0);
+    EXPECT_DOUBLE_EQ(price.calculated_price, 950.0);
+}
+
+TEST(SyntheticConstructionTest, RejectsDefinitionsThatDoNotFitTheirShape) {
+    SyntheticConstructionEngine engine;
+    EXPECT_FALSE(engine.add(makeDefinition("SHORT-BOX", ConstructionShape::BOX,
+                                           {"C1", "C2", "P1"}, {1.0, -1.0, -1.0})));
+    EXPECT_FALSE(engine.add(makeDefinition("SCALED-TRIANGLE", ConstructionShape::TRIANGULAR,
+                                           {"A", "B", "C"}, {1.0, 2.0, -1.0})));
+    EXPECT_FALSE(engine.add(makeDefinition("MISMATCHED", ConstructionShape::GENERIC, {"A", "B"}, {1.0})));
+    ASSERT_TRUE(engine.add(makeDefinition("FIVE-LEG", ConstructionShape::GENERIC,
+                                          {"A", "B", "C", "D", "E"}, {1.0, 1.0, 1.0, 1.0, -4.0})));
+    EXPECT_FALSE(engine.add(makeDefinition("FIVE-LEG", ConstructionShape::GENERIC, {"A"}, {1.0})));
+    EXPECT_EQ(engine.size(), 1u);
+}
+
+TEST(SyntheticConstructionTest, GraphEvaluatesAffectedConstructionsPerBatch) {
+    SyntheticConstructionEngine engine;
+    ASSERT_TRUE(engine.add(makeDefinition("BTC-BASIS", ConstructionShape::SPOT_PERP,
+                                          {"BTC-PERP", "BTC-SPOT"}, {1.0, -1.0})));
+    ASSERT_TRUE(engine.add(makeDefinition("ETH-BASIS", ConstructionShape::SPOT_PERP,
+                                          {"ETH-PERP", "ETH-SPOT"}, {1.0, -1.0})));
+    DependencyGraph graph;
+    ASSERT_EQ(engine.registerDependencies(graph), 2u);
+    
+    MarketEvent event;
+    event.type = MarketEventType::BOOK_UPDATE;
+    event.book.bids.push_back({99.0, 1.0, getCurrentTimestamp()});
+    event.book.asks.push_back({101.0, 1.0, getCurrentTimestamp()});
+    event.instrument_id = "BTC-SPOT";
+    EXPECT_FALSE(engine.onMarketEvent(event, getCurrentTimestamp()));  // Deferred to the graph
+    graph.markInstrumentDirty(event.instrument_id);
+    event.instrument_id = "BTC-PERP";
+    event.book.asks[0].price = 103.0;
+    engine.onMarketEvent(event, getCurrentTimestamp());
+    graph.markInstrumentDirty(event.instrument_id);
+    
+    EXPECT_EQ(graph.flush(getCurrentTimestamp()), 1u);
+    EXPECT_DOUBLE_EQ(engine.getValue(0), 1.0);
+    EXPECT_TRUE(std::isnan(engine.getValue(1)));
+    
+    // A construction still missing a leg stays NaN and wakes nothing downstream
+    size_t woken = 0;
+    auto downstream = graph.addNode("ETH-BASIS-SIGNAL", [&woken](Timestamp) { ++woken; return true; });
+    ASSERT_TRUE(graph.addNodeDependency(engine.getGraphNode(1), downstream));
+    event.instrument_id = "ETH-SPOT";
+    event.book.asks[0].price = 101.0;
+    engine.onMarketEvent(event, getCurrentTimestamp());
+    graph.markInstrumentDirty(event.instrument_id);
+    graph.flush(getCurrentTimestamp());
+    EXPECT_TRUE(std::isnan(engine.getValue(1)));
+    EXPECT_EQ(woken, 0u);
+    
+    // ...until it is priced
+    event.instrument_id = "ETH-PERP";
+    event.book.asks[0].price = 103.0;
+    engine.onMarketEvent(event, getCurrentTimestamp());
+    graph.markInstrumentDirty(event.instrument_id);
+    graph.flush(getCurrentTimestamp());
+    EXPECT_DOUBLE_EQ(engine.getValue(1), 1.0);
+    EXPECT_EQ(woken, 1u);
+}
+
+} // namespace arbitrage
@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+#include "timing_wheel.hpp"
+#include "strategy_shard.hpp"
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+
+namespace arbitrage {
+
+namespace {
+
+const Timestamp kStart = Timestamp(std::chrono::seconds(1700000000));
+
+Timestamp at(int64_t ms) {
+    return kStart + std::chrono::milliseconds(ms);
+}
+
+} // namespace
+
+TEST(TimingWheelTest, FiresAtDeadlineNotBefore) {
+    TimingWheel wheel(std::chrono::milliseconds(1), kStart);
+    int fired = 0;
+    wheel.scheduleAt(at(10), [&]() { ++fired; });
+    EXPECT_EQ(wheel.size(), 1);
+    
+    EXPECT_EQ(wheel.advance(at(9)), 0);
+    EXPECT_EQ(fired, 0);
+    EXPECT_EQ(wheel.advance(at(10)), 1);
+    EXPECT_EQ(fired, 1);
+    EXPECT_TRUE(wheel.empty());
+    
+    // Deadlines already in the past fire on the next advance
+    wheel.scheduleAt(at(5), [&]() { ++fired; });
+    wheel.advance(at(10));
+    EXPECT_EQ(fired, 2);
+}
+
+TEST(TimingWheelTest, CancelAndStaleHandles) {
+    TimingWheel wheel(std::chrono::milliseconds(1), kStart);
+    int fired = 0;
+    auto handle = wheel.scheduleAfter(std::chrono::milliseconds(5), [&]() { ++fired; });
+    EXPECT_TRUE(wheel.cancel(handle));
+    EXPECT_FALSE(wheel.cancel(handle));
+    EXPECT_FALSE(wheel.cancel(0));
+    
+    // The freed node is reused; the old handle must not cancel the new timer
+    auto reused = wheel.scheduleAfter(std::chrono::milliseconds(5), [&]() { ++fired; });
+    EXPECT_FALSE(wheel.cancel(handle));
+    wheel.advance(at(5));
+    EXPECT_EQ(fired, 1);
+    EXPECT_FALSE(wheel.cancel(reused));
+}
+
+TEST(TimingWheelTest, FiresInDeadlineOrderAcrossLevels) {
+    TimingWheel wheel(std::chrono::milliseconds(1), kStart);
+    std::vector<int64_t> deadlines = {3, 300, 70000, 255, 256, 65536, 20000000, 1, 300};
+    std::vector<int64_t> order;
+    for (int64_t ms : deadlines) {
+        wheel.scheduleAt(at(ms), [&order, ms]() { order.push_back(ms); });
+    }
+    
+    // Advance in uneven steps so entries cascade at different points
+    for (int64_t now : {2, 299, 1000, 65535, 100000, 30000000}) {
+        wheel.advance(at(now));
+        for (int64_t ms : order) {
+            EXPECT_LE(ms, now);
+        }
+    }
+    
+    auto expected = deadlines;
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(order, expected);
+}
+
+TEST(TimingWheelTest, BeyondSpanDeadlinesStillFire) {
+    // 4 x 8 bits of 1us ticks span ~71 minutes; schedule a day out
+    TimingWheel wheel(std::chrono::microseconds(1), kStart);
+    bool fired = false;
+    wheel.scheduleAt(kStart + std::chrono::hours(24), [&]() { fired = true; });
+    
+    wheel.advance(kStart + std::chrono::hours(24) - std::chrono::microseconds(1));
+    EXPECT_FALSE(fired);
+    wheel.advance(kStart + std::chrono::hours(24));
+    EXPECT_TRUE(fired);
+}
+
+TEST(TimingWheelTest, CallbacksCanRescheduleAndCancel) {
+    TimingWheel wheel(std::chrono::milliseconds(1), kStart);
+    int periodic = 0;
+    bool victim_fired = false;
+    
+    TimingWheel::TimerHandle victim = 0;
+    std::function<void()> tick = [&]() {
+        if (++periodic < 5) {
+            wheel.scheduleAfter(std::chrono::milliseconds(2), tick);
+        }
+    };
+    wheel.scheduleAt(at(2), tick);
+    
+    // Same-tick cancellation of a timer that is already due
+    wheel.scheduleAt(at(10), [&]() { EXPECT_TRUE(wheel.cancel(victim)); });
+    victim = wheel.scheduleAt(at(10), [&]() { victim_fired = true; });
+    
+    wheel.advance(at(100));
+    EXPECT_EQ(periodic, 5);
+    EXPECT_FALSE(victim_fired);
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimingWheelTest, ManyTimersInsertCancelFire) {
+    TimingWheel wheel(std::chrono::milliseconds(1), kStart);
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int64_t> delay(1, 8 * 3600 * 1000);
+    std::uniform_int_distribution<int64_t> step(1, 600 * 1000);
+    
+    const size_t count = 100000;
+    std::vector<TimingWheel::TimerHandle> handles;
+    handles.reserve(count);
+    size_t fired = 0;
+    int64_t previous = 0;
+    int64_t now = 0;
+    for (size_t i = 0; i < count; ++i) {
+        int64_t deadline = delay(rng);
+        handles.push_back(wheel.scheduleAt(at(deadline), [&, deadline]() {
+            // Every timer fires in the advance() that first reaches it
+            EXPECT_GT(deadline, previous);
+            EXPECT_LE(deadline, now);
+            ++fired;
+        }));
+    }
+    size_t cancelled = 0;
+    for (size_t i = 0; i < count; i += 3) {
+        cancelled += wheel.cancel(handles[i]);
+    }
+    EXPECT_EQ(wheel.size(), count - cancelled);
+    
+    while (now < 8 * 3600 * 1000) {
+        previous = now;
+        now += step(rng);
+        wheel.advance(at(now));
+    }
+    EXPECT_EQ(fired, count - cancelled);
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimingWheelTest, NextDeadlineTracksEarliestWork) {
+    TimingWheel wheel(std::chrono::milliseconds(1), kStart);
+    Timestamp deadline;
+    EXPECT_FALSE(wheel.nextDeadline(deadline));
+    
+    auto late = wheel.scheduleAt(at(40), []() {});
+    auto early = wheel.scheduleAt(at(7), []() {});
+    ASSERT_TRUE(wheel.nextDeadline(deadline));
+    EXPECT_EQ(deadline, at(7));
+    wheel.cancel(early);
+    ASSERT_TRUE(wheel.nextDeadline(deadline));
+    EXPECT_EQ(deadline, at(40));
+    
+    // Far deadlines report their cascade point, never later than the deadline
+    wheel.cancel(late);
+    wheel.scheduleAt(at(100000), []() {});
+    ASSERT_TRUE(wheel.nextDeadline(deadline));
+    EXPECT_LE(deadline, at(100000));
+    while (wheel.nextDeadline(deadline)) {
+        wheel.advance(deadline);
+    }
+    EXPECT_EQ(wheel.now(), at(100000));
+    
+    // Past-due timers are due now
+    wheel.scheduleAt(at(5), []() {});
+    ASSERT_TRUE(wheel.nextDeadline(deadline));
+    EXPECT_EQ(deadline, wheel.now());
+}
+
+TEST(TimingWheelTest, RunningShardWakesForItsNextDeadline) {
+    StrategyShard shard(0, nullptr);
+    Instrument future;
+    future.id = "BTC-0329_FUTURES";
+    future.type = InstrumentType::FUTURES;
+    future.expiry_time = getCurrentTimestamp() + std::chrono::milliseconds(30);
+    shard.addInstrument(future);
+    std::atomic<int> expiries{0};
+    shard.addEventHandler([&expiries](StrategyShard&, const MarketEvent& event) {
+        expiries += event.type == MarketEventType::INSTRUMENT_EXPIRY;
+    });
+    
+    shard.start();
+    for (int wait = 0; wait < 200 && expiries == 0; ++wait) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    shard.stop();
+    EXPECT_EQ(expiries, 1);
+}
+
+TEST(TimingWheelTest, ShardDispatchesFundingTimeAndExpiry) {
+    StrategyShard shard(0, nullptr);
+    Timestamp now = getCurrentTimestamp();
+    
+    Instrument future;
+    future.id = "BTC-0329_FUTURES";
+    future.type = InstrumentType::FUTURES;
+    future.expiry_time = now + std::chrono::milliseconds(20);
+    shard.addInstrument(future);
+    shard.addInstrument(future);  // Re-adding does not schedule a second expiry
+    
+    std::vector<MarketEventType> seen;
+    shard.addEventHandler([&seen](StrategyShard&, const MarketEvent& event) { seen.push_back(event.type); });
+    
+    MarketEvent funding;
+    funding.type = MarketEventType::FUNDING_RATE;
+    funding.instrument_id = "BTC-PERPETUAL_PERPETUAL_SWAP";
+    funding.funding.instrument_id = funding.instrument_id;
+    funding.funding.current_rate = 0.0001;
+    funding.funding.next_funding_time = now + std::chrono::milliseconds(10);
+    shard.processEvent(funding);
+    
+    // A newer print for the same perp replaces the pending funding timer
+    funding.funding.current_rate = 0.0002;
+    shard.processEvent(funding);
+    
+    shard.advanceTimers(now + std::chrono::milliseconds(5));
+    EXPECT_EQ(seen.size(), 2);
+    
+    shard.advanceTimers(now + std::chrono::milliseconds(30));
+    ASSERT_EQ(seen.size(), 4);
+    EXPECT_EQ(seen[2], MarketEventType::FUNDING_TIME);
+    EXPECT_EQ(seen[3], MarketEventType::INSTRUMENT_EXPIRY);
+    EXPECT_FALSE(shard.getInstrument(future.id)->is_active);
+}
+
+} // namespace arbitrage
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include "vol_surface.hpp"
+#include <cmath>
+
+namespace arbitrage {
+
+namespace {
+
+constexpr double kForward = 40000.0;
+
+double sviVol(const SviParams& params, double strike, double years) {
+    return std::sqrt(params.totalVariance(std::log(strike / kForward)) / years);
+}
+
+// 21 strikes across +-50% log-moneyness quoted off the given smile
+size_t addSmile(VolatilitySurface& surface, const SviParams& params, double years) {
+    size_t slice = surface.addExpiry(years, kForward);
+    for (int i = -10; i <= 10; ++i) {
+        double strike = kForward * std::exp(0.05 * i);
+        surface.addQuote(slice, strike, sviVol(params, strike, years));
+    }
+    return slice;
+}
+
+SviParams skewedSmile() {
+    SviParams params;
+    params.a = 0.01;
+    params.b = 0.05;
+    params.rho = -0.4;
+    params.m = 0.02;
+    params.sigma = 0.15;
+    return params;
+}
+
+} // namespace
+
+TEST(VolSurfaceTest, FitsSmileAndWarmStartsRefit) {
+    VolatilitySurface surface;
+    SviParams truth = skewedSmile();
+    size_t slice = addSmile(surface, truth, 0.25);
+    
+    EXPECT_EQ(surface.refit(), 1u);
+    uint64_t cold_iterations = surface.getStats().fit_iterations;
+    EXPECT_LT(surface.getStats().last_rmse, 1e-6);
+    for (double strike : {28000.0, 36000.0, 40000.0, 47000.0, 60000.0}) {
+        EXPECT_NEAR(surface.getSliceVolatility(slice, strike), sviVol(truth, strike, 0.25), 1e-5) << strike;
+    }
+    
+    // Whole smile shifts up by 1 vol point
+    for (size_t quote = 0; quote < 21; ++quote) {
+        double strike = kForward * std::exp(0.05 * (static_cast<int>(quote) - 10));
+        surface.updateQuote(slice, quote, sviVol(truth, strike, 0.25) + 0.01);
+    }
+    EXPECT_TRUE(surface.isDirty(slice));
+    EXPECT_EQ(surface.refit(), 1u);
+    uint64_t warm_iterations = surface.getStats().fit_iterations - cold_iterations;
+    
+    EXPECT_LT(warm_iterations, cold_iterations);
+    EXPECT_LT(surface.getStats().last_rmse, 1e-4);
+    EXPECT_NEAR(surface.getSliceVolatility(slice, kForward), sviVol(truth, kForward, 0.25) + 0.01, 1e-4);
+}
+
+TEST(VolSurfaceTest, RefitsOnlySlicesThatMoved) {
+    VolatilitySurface surface;
+    size_t front = addSmile(surface, skewedSmile(), 0.1);
+    size_t back = addSmile(surface, skewedSmile(), 0.5);
+    EXPECT_EQ(surface.refit(), 2u);
+    
+    // Below tolerance: nothing to do
+    surface.updateQuote(front, 10, surface.getSliceVolatility(front, kForward) + 0.0001);
+    surface.setForward(back, kForward * 1.0001);
+    EXPECT_FALSE(surface.isDirty(front));
+    EXPECT_FALSE(surface.isDirty(back));
+    EXPECT_EQ(surface.refit(), 0u);
+    EXPECT_EQ(surface.getStats().clean_skips, 2u);
+    
+    // Beyond tolerance on the back slice only
+    surface.setForward(back, kForward * 1.01);
+    EXPECT_TRUE(surface.isDirty(back));
+    EXPECT_EQ(surface.refit(), 1u);
+    EXPECT_EQ(surface.getStats().refits, 3u);
+    
+    // Out-of-bounds solves report NaN; they drop out of the fit
+    surface.updateQuote(front, 0, std::nan(""));
+    EXPECT_TRUE(surface.isDirty(front));
+    EXPECT_EQ(surface.refit(), 1u);
+    EXPECT_TRUE(std::isfinite(surface.getSliceVolatility(front, kForward)));
+}
+
+TEST(VolSurfaceTest, LookupInterpolatesTotalVarianceInTime) {
+    VolatilitySurface surface;
+    SviParams flat_front;
+    flat_front.a = 0.5 * 0.5 * 0.25;
+    flat_front.b = 0.0;
+    SviParams flat_back;
+    flat_back.a = 0.4 * 0.4 * 1.0;
+    flat_back.b = 0.0;
+    addSmile(surface, flat_back, 1.0);
+    addSmile(surface, flat_front, 0.25);
+    surface.refit();
+    
+    EXPECT_NEAR(surface.getVolatility(kForward, 0.25), 0.5, 1e-6);
+    EXPECT_NEAR(surface.getVolatility(kForward, 1.0), 0.4, 1e-6);
+    
+    // w(0.5) = 0.0625 + (0.16 - 0.0625) / 3
+    EXPECT_NEAR(surface.getVolatility(kForward, 0.5), std::sqrt(0.095 / 0.5), 1e-6);
+    
+    // Flat extrapolation outside the fitted expiries
+    EXPECT_NEAR(surface.getVolatility(kForward, 0.01), 0.5, 1e-6);
+    EXPECT_NEAR(surface.getVolatility(kForward, 3.0), 0.4, 1e-6);
+    
+    // Rolling time to expiry moves the lookup but not the smile
+    surface.setTimeToExpiry(1, 0.2);
+    EXPECT_FALSE(surface.isDirty(1));
+    EXPECT_NEAR(surface.getVolatility(kForward, 0.2), 0.5, 1e-6);
+}
+
+} // namespace arbitrage